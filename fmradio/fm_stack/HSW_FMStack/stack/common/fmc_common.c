@@ -54,6 +54,10 @@ typedef struct {
     /* Shared commands Queue */
     FMC_ListNode                    cmdsQueue;
 
+    /* Number of queued commands of each command type, and the last queued command of each type */
+    FMC_UINT                        numOfQueuedCmds[FMC_MAX_NUM_OF_CMD_TYPES];
+    FmcBaseCmd                      *lastQueuedCmd[FMC_MAX_NUM_OF_CMD_TYPES];
+
     FmciFmTaskClientCallbackFunc    clientTaskCbFunc;
 
     /* Handle to CCM Adapter */
@@ -74,6 +78,7 @@ static _FmcInitState _fmcInitState = _FMC_INIT_STATE_NOT_INITIALIZED;
 static const char _fmcCmdsPoolName[] = "FmcCmdsPool";
 
 static FMC_U8 _fmTimerHandel;
+static FMC_U8 _fmMonitorTimerHandle;
 
 /****************************************************************************
  *
@@ -83,6 +88,8 @@ static FMC_U8 _fmTimerHandel;
 FMC_STATIC void _FMC_TaskEventCallback(FmcOsEvent evtMask);
 FMC_STATIC FmcStatus _FMC_OsInit(void);
 FMC_STATIC FmcStatus _FMC_OsDeinit(void);
+FMC_STATIC void _FMC_IndexQueuedCmd(FmcBaseCmd *cmd);
+FMC_STATIC void _FMC_UnindexQueuedCmd(FmcBaseCmd *cmd);
 
 FmcStatus FMCI_Init(handle_t hMcpf)
 {
@@ -152,6 +159,8 @@ FmcStatus FMCI_Init(handle_t hMcpf)
                         ("FMCI_Init: Cmds pool creation failed (%s)", FMC_DEBUG_FmcStatusStr(status)));
 
     FMC_InitializeListHead(&_fmcData.cmdsQueue);
+    FMC_OS_MemSet(_fmcData.numOfQueuedCmds, 0, sizeof(_fmcData.numOfQueuedCmds));
+    FMC_OS_MemSet(_fmcData.lastQueuedCmd, 0, sizeof(_fmcData.lastQueuedCmd));
 
     /* Initialize common transport layer */
     status = FMC_CORE_Init(hMcpf);
@@ -273,6 +282,11 @@ FmcStatus _FMC_OsInit(void)
     FMC_VERIFY_FATAL((status == FMC_STATUS_SUCCESS), FMC_STATUS_INTERNAL_ERROR, 
                      ("Failed Creating FM Timer (%d)", status));
 
+    status = FMC_OS_CreateTimer(FMC_OS_TASK_HANDLE_FM, (const char *)"FM MONITOR TIMER", &_fmMonitorTimerHandle);
+
+    FMC_VERIFY_FATAL((status == FMC_STATUS_SUCCESS), FMC_STATUS_INTERNAL_ERROR, 
+                     ("Failed Creating FM Monitor Timer (%d)", status));
+
     FMC_FUNC_END();
 
     return status;
@@ -297,6 +311,10 @@ FmcStatus _FMC_OsDeinit(void)
     FMC_VERIFY_FATAL((status == FMC_STATUS_SUCCESS), FMC_STATUS_INTERNAL_ERROR, 
                      ("Failed Destroying FM Timer (%d)", status));
 
+    status = FMC_OS_DestroyTimer(_fmMonitorTimerHandle);
+    FMC_VERIFY_FATAL((status == FMC_STATUS_SUCCESS), FMC_STATUS_INTERNAL_ERROR, 
+                     ("Failed Destroying FM Monitor Timer (%d)", status));
+
     status = FMC_OS_Deinit();
     FMC_VERIFY_FATAL((status == FMC_STATUS_SUCCESS), FMC_STATUS_INTERNAL_ERROR, 
                      ("Failed Destroying FMC OS module (%d)", status));
@@ -331,6 +349,14 @@ FmcStatus FMCI_OS_CancelTimer(void)
     return FMC_OS_CancelTimer(_fmTimerHandel);
 
 }
+FmcStatus FMCI_OS_ResetMonitorTimer(FMC_U32 time)
+{
+    return FMC_OS_ResetTimer(_fmMonitorTimerHandle, time, FMC_OS_EVENT_MONITOR_TIMER_EXPIRED);
+}
+FmcStatus FMCI_OS_CancelMonitorTimer(void)
+{
+    return FMC_OS_CancelTimer(_fmMonitorTimerHandle);
+}
 
 FmcOsSemaphoreHandle FMCI_GetMutex(void)
 {
@@ -347,6 +373,105 @@ FMC_ListNode *FMCI_GetCmdsQueue(void)
     return &_fmcData.cmdsQueue;
 }
 
+void FMCI_InsertCmdToQueue(FmcBaseCmd *cmd)
+{
+    FMC_InsertTailList(&_fmcData.cmdsQueue, &cmd->node);
+
+    _FMC_IndexQueuedCmd(cmd);
+}
+
+void FMCI_RemoveCmdFromQueue(FmcBaseCmd *cmd)
+{
+    /* Unindex first - the queue links are needed to find the previous command of the same type */
+    _FMC_UnindexQueuedCmd(cmd);
+
+    FMC_RemoveNodeList(&cmd->node);
+}
+
+void FMCI_ChangeHeadCmdType(FmcBaseCmd *cmd, FMC_UINT cmdType)
+{
+    FMC_FUNC_START("FMCI_ChangeHeadCmdType");
+
+    FMC_VERIFY_FATAL_NO_RETVAR((FMC_GetHeadList(&_fmcData.cmdsQueue) == &cmd->node), 
+                                ("FMCI_ChangeHeadCmdType: Command is not at the head of the queue"));
+
+    _FMC_UnindexQueuedCmd(cmd);
+
+    cmd->cmdType = cmdType;
+
+    /* 
+        The head is the first command in the queue, so it becomes the last command of its new
+        type only if there is no other command of that type
+    */
+    if (_fmcData.numOfQueuedCmds[cmdType] == 0)
+    {
+        _fmcData.lastQueuedCmd[cmdType] = cmd;
+    }
+
+    ++_fmcData.numOfQueuedCmds[cmdType];
+
+    FMC_FUNC_END();
+}
+
+FmcBaseCmd *FMCI_FindLatestCmdInQueueByType(FMC_UINT cmdType)
+{
+    if (cmdType >= FMC_MAX_NUM_OF_CMD_TYPES)
+    {
+        return NULL;
+    }
+    
+    return _fmcData.lastQueuedCmd[cmdType];
+}
+
+void _FMC_IndexQueuedCmd(FmcBaseCmd *cmd)
+{
+    FMC_FUNC_START("_FMC_IndexQueuedCmd");
+
+    FMC_VERIFY_FATAL_NO_RETVAR((cmd->cmdType < FMC_MAX_NUM_OF_CMD_TYPES), 
+                                ("_FMC_IndexQueuedCmd: Invalid Command Type (%d)", cmd->cmdType));
+
+    /* Commands are always inserted at the tail */
+    _fmcData.lastQueuedCmd[cmd->cmdType] = cmd;
+    ++_fmcData.numOfQueuedCmds[cmd->cmdType];
+
+    FMC_FUNC_END();
+}
+
+void _FMC_UnindexQueuedCmd(FmcBaseCmd *cmd)
+{
+    FMC_ListNode    *node;
+
+    FMC_FUNC_START("_FMC_UnindexQueuedCmd");
+
+    FMC_VERIFY_FATAL_NO_RETVAR((_fmcData.numOfQueuedCmds[cmd->cmdType] > 0), 
+                                ("_FMC_UnindexQueuedCmd: No queued commands of type %d", cmd->cmdType));
+
+    --_fmcData.numOfQueuedCmds[cmd->cmdType];
+
+    if (_fmcData.lastQueuedCmd[cmd->cmdType] == cmd)
+    {
+        _fmcData.lastQueuedCmd[cmd->cmdType] = NULL;
+
+        /* 
+            Search backwards for the new last command of that type. Commands are usually removed 
+            from the head, where the removed command is the only one of its type and no search is done.
+        */
+        if (_fmcData.numOfQueuedCmds[cmd->cmdType] > 0)
+        {
+            for (node = cmd->node.PrevNode; node != &_fmcData.cmdsQueue; node = node->PrevNode)
+            {
+                if (((FmcBaseCmd*)node)->cmdType == cmd->cmdType)
+                {
+                    _fmcData.lastQueuedCmd[cmd->cmdType] = (FmcBaseCmd*)node;
+                    break;
+                }
+            }
+        }
+    }
+
+    FMC_FUNC_END();
+}
+
 void _FMC_TaskEventCallback(FmcOsEvent evtMask)
 {
     /* Lock the Mutex on entry to FM state machine */
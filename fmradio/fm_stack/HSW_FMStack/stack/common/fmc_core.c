@@ -96,6 +96,91 @@ typedef struct {
 
 static _FmcCoreData _fmcTransportData;
 
+/*
+    The write shadow holds the last value the chip acknowledged for each configuration register.
+
+    A value is recorded only when its write completes successfully, and the whole shadow is dropped
+    whenever the chip may have lost or changed its registers (power mode / transport changes,
+    init scripts, resets). Registers that the firmware changes on its own (frequency, interrupt mask)
+    or that trigger an action on every write (tune, seek, RDS data) are never shadowed.
+*/
+typedef enum {
+    _FMC_CORE_SHADOW_POLICY_NONE = 0,   /* Always sent, not shadowed */
+    _FMC_CORE_SHADOW_POLICY_CACHED,     /* Skipped when the value is unchanged */
+    _FMC_CORE_SHADOW_POLICY_MODE,       /* As CACHED, but a new value may reset the other registers */
+    _FMC_CORE_SHADOW_POLICY_RESET       /* Always sent, resets the other registers */
+} _FmcCoreShadowPolicy;
+
+#define _FMC_CORE_SHADOW_NUM_OF_OPCODES         (256)
+
+typedef struct {
+    FMC_U8          policy[_FMC_CORE_SHADOW_NUM_OF_OPCODES];
+    FMC_BOOL        valid[_FMC_CORE_SHADOW_NUM_OF_OPCODES];
+    FMC_U16         value[_FMC_CORE_SHADOW_NUM_OF_OPCODES];
+
+    /* Shadowed write that is waiting for its command complete */
+    FMC_BOOL        writePending;
+    FmcFwOpcode     pendingOpcode;
+    FMC_U16         pendingValue;
+
+    FMC_U32         hits;
+    FMC_U32         misses;
+} _FmcCoreShadowData;
+
+static _FmcCoreShadowData _fmcCoreShadow;
+
+static const FmcFwOpcode _fmcCoreShadowCachedOpcodes[] = {
+    FMC_FW_OPCODE_CMN_INTX_CONFIG_SET_GET,
+    FMC_FW_OPCODE_CMN_PULL_EN_SET_GET,
+    FMC_FW_OPCODE_RX_MOST_MODE_SET_GET,
+    FMC_FW_OPCODE_RX_MOST_BLEND_SET_GET,
+    FMC_FW_OPCODE_RX_DEMPH_MODE_SET_GET,
+    FMC_FW_OPCODE_RX_SEARCH_LVL_SET_GET,
+    FMC_FW_OPCODE_RX_BAND_SET_GET,
+    FMC_FW_OPCODE_RX_MUTE_STATUS_SET_GET,
+    FMC_FW_OPCODE_RX_RDS_PAUSE_LVL_SET_GET,
+    FMC_FW_OPCODE_RX_RDS_PAUSE_DUR_SET_GET,
+    FMC_FW_OPCODE_RX_RDS_MEM_SET_GET,
+    FMC_FW_OPCODE_RX_RDS_BLK_B_SET_GET,
+    FMC_FW_OPCODE_RX_RDS_MSK_B_SET_GET,
+    FMC_FW_OPCODE_RX_RDS_PI_MASK_SET_GET,
+    FMC_FW_OPCODE_RX_RDS_PI_SET_GET,
+    FMC_FW_OPCODE_RX_RDS_SYSTEM_SET_GET,
+    FMC_FW_OPCODE_RX_SEARCH_DIR_SET_GET,
+    FMC_FW_OPCODE_RX_VOLUME_SET_GET,
+    FMC_FW_OPCODE_RX_AUDIO_ENABLE_SET_GET,
+    FMC_FW_OPCODE_RX_HILO_SET_GET,
+    FMC_FW_OPCODE_TX_POWER_LEVEL_SET_GET,
+    FMC_FW_OPCODE_TX_PREMPH_SET_GET,
+    FMC_FW_OPCODE_TX_MONO_SET_GET,
+    FMC_FW_OPCODE_TX_PI_CODE_SET_GET,
+    FMC_FW_OPCODE_TX_RDS_ECC_SET_GET,
+    FMC_FW_OPCODE_TX_RDS_PTY_CODE_SET_GET,
+    FMC_FW_OPCODE_TX_RDS_AF_SET_GET,
+    FMC_FW_OPCODE_TX_RDS_PS_DISPLAY_MODE_SET_GET,
+    FMC_FW_OPCODE_TX_RDS_REPERTOIRE_SET_GET,
+    FMC_FW_OPCODE_TX_RDS_TA_SET_GET,
+    FMC_FW_OPCODE_TX_RDS_TP_SET_GET,
+    FMC_FW_OPCODE_TX_RDS_DI_CODES_SET_GET,
+    FMC_FW_OPCODE_TX_RDS_MUSIC_SPEECH_FLAG_SET_GET,
+    FMC_FW_OPCODE_TX_RDS_PS_SCROLL_SPEED_SET_GET,
+    FMC_FW_OPCODE_TX_MUTE_MODE_SET_GET
+};
+
+static const FmcFwOpcode _fmcCoreShadowResetOpcodes[] = {
+    FMC_FW_OPCODE_CMN_HARDWARE_REG_SET_GET,
+    FMC_FW_OPCODE_CMN_CODE_DOWNLOAD,
+    FMC_FW_OPCODE_CMN_RESET,
+    FMC_FW_OPCODE_TX_POWER_ENB_SET,
+    FMC_FW_OPCODE_TX_POWER_UP_DOWN_SET
+};
+
+FMC_STATIC void _FMC_CORE_ShadowInit(void);
+FMC_STATIC void _FMC_CORE_ShadowInvalidateAll(void);
+FMC_STATIC void _FMC_CORE_ShadowInvalidate(FmcFwOpcode fmOpcode);
+FMC_STATIC FMC_BOOL _FMC_CORE_ShadowIsRedundantWrite(FmcFwOpcode fmOpcode, FMC_U16 value);
+FMC_STATIC void _FMC_CORE_ShadowWriteCompleted(FmcStatus status);
+
 FMC_STATIC void _FMC_CORE_CcmImCallback(CcmImEvent *event);
 
 FMC_STATIC FmcStatus _FMC_CORE_SendAnyWriteCommand( FmcFwOpcode fmOpcode,
@@ -138,6 +223,8 @@ FmcStatus FMC_CORE_Init(handle_t hMcpf)
     /* [ToDo] - Protect against mutliple initializations / handle them correctly if allowed*/
     _fmcTransportData.clientCb = NULL;
 
+    _FMC_CORE_ShadowInit();
+
 #ifdef MCP_STK_ENABLE
     _fmcTransportData.hMcpf = mcpf_create(NULL, NULL);
     /*Initialize the parms pointer  */
@@ -230,6 +317,12 @@ FmcStatus FMC_CORE_TransportOff(void)
 
 	FMC_FUNC_START("FMC_CORE_TransportOff");
 
+	FMC_LOG_INFO(("FMC_CORE_TransportOff: Write shadow hits: %d, misses: %d", 
+					_fmcCoreShadow.hits, _fmcCoreShadow.misses));
+
+	/* The chip loses its configuration when FM is turned off */
+	_FMC_CORE_ShadowInvalidateAll();
+
 	FMC_LOG_INFO(("FMC_CORE_TransportOff: Calling TI_CHIP_MNGR_FMOff"));
 
 #ifdef BLUEZ_SOLUTION
@@ -310,6 +403,8 @@ void _FMC_CORE_CmdCompleteCb(   FmcStatus   status,
 {
     /* _fmcTransportData.event.type was set when the command was originally received */
     
+    _FMC_CORE_ShadowWriteCompleted(status);
+
     _fmcTransportData.event.status = status;
 
     /* the data is not copied. The client's callback must copy the data if it wishes to access it afterwards */
@@ -379,6 +474,125 @@ CcmObj* _FMC_CORE_GetCcmObjStackHandle(void)
 	return _fmcTransportData.ccmObj;
 }
 
+void FMC_CORE_GetWriteShadowStats(FMC_U32 *hits, FMC_U32 *misses)
+{
+    *hits = _fmcCoreShadow.hits;
+    *misses = _fmcCoreShadow.misses;
+}
+
+void _FMC_CORE_ShadowInit(void)
+{
+    FMC_UINT    idx;
+
+    FMC_OS_MemSet(&_fmcCoreShadow, 0, sizeof(_fmcCoreShadow));
+
+#if FMC_CONFIG_CORE_WRITE_SHADOW == FMC_CONFIG_ENABLED
+    for (idx = 0; idx < sizeof(_fmcCoreShadowCachedOpcodes) / sizeof(_fmcCoreShadowCachedOpcodes[0]); ++idx)
+    {
+        _fmcCoreShadow.policy[_fmcCoreShadowCachedOpcodes[idx]] = _FMC_CORE_SHADOW_POLICY_CACHED;
+    }
+
+    /* Changing the RX power mode (FM / RDS on-off) may reinitialize the RX registers */
+    _fmcCoreShadow.policy[FMC_FW_OPCODE_RX_POWER_SET_GET] = _FMC_CORE_SHADOW_POLICY_MODE;
+#endif
+
+    for (idx = 0; idx < sizeof(_fmcCoreShadowResetOpcodes) / sizeof(_fmcCoreShadowResetOpcodes[0]); ++idx)
+    {
+        _fmcCoreShadow.policy[_fmcCoreShadowResetOpcodes[idx]] = _FMC_CORE_SHADOW_POLICY_RESET;
+    }
+}
+
+void _FMC_CORE_ShadowInvalidateAll(void)
+{
+    FMC_OS_MemSet(_fmcCoreShadow.valid, 0, sizeof(_fmcCoreShadow.valid));
+    _fmcCoreShadow.writePending = FMC_FALSE;
+}
+
+void _FMC_CORE_ShadowInvalidate(FmcFwOpcode fmOpcode)
+{
+    if (_fmcCoreShadow.policy[fmOpcode] == _FMC_CORE_SHADOW_POLICY_RESET)
+    {
+        _FMC_CORE_ShadowInvalidateAll();
+    }
+    else
+    {
+        _fmcCoreShadow.valid[fmOpcode] = FMC_FALSE;
+    }
+}
+
+/*
+    Checks a write against the shadow. Returns FMC_TRUE if the chip already holds the value, 
+    in which case the write should not be sent. Otherwise, the write is recorded as pending and
+    will be committed to the shadow when it completes.
+*/
+FMC_BOOL _FMC_CORE_ShadowIsRedundantWrite(FmcFwOpcode fmOpcode, FMC_U16 value)
+{
+    FMC_BOOL    isRedundant = FMC_FALSE;
+
+    _fmcCoreShadow.writePending = FMC_FALSE;
+
+    switch (_fmcCoreShadow.policy[fmOpcode])
+    {
+        case _FMC_CORE_SHADOW_POLICY_CACHED:
+        case _FMC_CORE_SHADOW_POLICY_MODE:
+
+            if ((_fmcCoreShadow.valid[fmOpcode] == FMC_TRUE) && (_fmcCoreShadow.value[fmOpcode] == value))
+            {
+                ++_fmcCoreShadow.hits;
+                isRedundant = FMC_TRUE;
+            }
+            else
+            {
+                ++_fmcCoreShadow.misses;
+
+                if (_fmcCoreShadow.policy[fmOpcode] == _FMC_CORE_SHADOW_POLICY_MODE)
+                {
+                    _FMC_CORE_ShadowInvalidateAll();
+                }
+
+                _fmcCoreShadow.writePending = FMC_TRUE;
+                _fmcCoreShadow.pendingOpcode = fmOpcode;
+                _fmcCoreShadow.pendingValue = value;
+            }
+            
+            break;
+
+        case _FMC_CORE_SHADOW_POLICY_RESET:
+
+            _FMC_CORE_ShadowInvalidateAll();
+            
+            break;
+
+        default:
+
+            break;
+    };
+
+    return isRedundant;
+}
+
+/*
+    Commits the pending write to the shadow. A failed write leaves the register in an unknown
+    state, so its shadowed value is dropped.
+*/
+void _FMC_CORE_ShadowWriteCompleted(FmcStatus status)
+{
+    if (_fmcCoreShadow.writePending == FMC_TRUE)
+    {
+        _fmcCoreShadow.writePending = FMC_FALSE;
+
+        if (status == FMC_STATUS_SUCCESS)
+        {
+            _fmcCoreShadow.value[_fmcCoreShadow.pendingOpcode] = _fmcCoreShadow.pendingValue;
+            _fmcCoreShadow.valid[_fmcCoreShadow.pendingOpcode] = FMC_TRUE;
+        }
+        else
+        {
+            _fmcCoreShadow.valid[_fmcCoreShadow.pendingOpcode] = FMC_FALSE;
+        }
+    }
+}
+
 /*************************************************************************************************
                 HCI-Specific implementation of transport API  - 
                 This Implementation should be changed when working over I2C.
@@ -476,6 +690,8 @@ FmcStatus FMC_CORE_SendPowerModeCommand(FMC_BOOL powerOn)
     _fmcTransportData.parmsLen = 1;
     
     _fmcTransportData.event.type = FMC_CORE_EVENT_POWER_MODE_COMMAND_COMPLETE;
+
+    _FMC_CORE_ShadowInvalidateAll();
     
     status = _FMC_CORE_HCI_SendFmCommand(       _FMC_CORE_TRANSPORT_CLIENT_FM,
                                                     _FMC_CORE_CmdCompleteCb,
@@ -500,14 +716,28 @@ FmcStatus FMC_CORE_SendWriteCommand(FmcFwOpcode fmOpcode, FMC_U16 fmCmdParms)
     
     FMC_FUNC_START("FMC_CORE_SendWriteCommand");
     
-    /* Store the cmd parms in BE (always 2 bytes for a write command) */
-    FMC_UTILS_StoreBE16(&fmCmdParmsBe[0], fmCmdParms);
     _fmcTransportData.event.type = FMC_CORE_EVENT_WRITE_COMPLETE;
-    status = _FMC_CORE_SendAnyWriteCommand( 
-                    fmOpcode, 
-                    fmCmdParmsBe,
-                    sizeof(fmCmdParms));
-    FMC_VERIFY_ERR((status == FMC_STATUS_PENDING), status, ("FMC_CORE_SendWriteCommand"));
+
+    if (_FMC_CORE_ShadowIsRedundantWrite(fmOpcode, fmCmdParms) == FMC_TRUE)
+    {
+        /* 
+            The chip already holds this value - complete the command without sending it. The client
+            is notified from within this call, the same way it would be on a fast transport.
+        */
+        _FMC_CORE_CmdCompleteCb(FMC_STATUS_SUCCESS, NULL, 0);
+
+        status = FMC_STATUS_PENDING;
+    }
+    else
+    {
+        /* Store the cmd parms in BE (always 2 bytes for a write command) */
+        FMC_UTILS_StoreBE16(&fmCmdParmsBe[0], fmCmdParms);
+        status = _FMC_CORE_SendAnyWriteCommand( 
+                        fmOpcode, 
+                        fmCmdParmsBe,
+                        sizeof(fmCmdParms));
+        FMC_VERIFY_ERR((status == FMC_STATUS_PENDING), status, ("FMC_CORE_SendWriteCommand"));
+    }
     
 
     FMC_FUNC_END();
@@ -596,6 +826,9 @@ FmcStatus FMC_CORE_SendHciScriptCommand(    FMC_U16     hciOpcode,
     FMC_OS_MemCopy(_fmcTransportData.cmdParms, hciCmdParms, len);
     _fmcTransportData.parmsLen = len;
     _fmcTransportData.event.type = FMC_CORE_EVENT_SCRIPT_CMD_COMPLETE;
+
+    /* Init scripts write registers behind the shadow's back */
+    _FMC_CORE_ShadowInvalidateAll();
         
     status = _FMC_CORE_HCI_SendFmCommand(           _FMC_CORE_TRANSPORT_CLIENT_FM,
                                                         _FMC_CORE_CmdCompleteCb,
@@ -754,6 +987,8 @@ FmcStatus FMC_CORE_TransportOn(void)
 
     FMC_FUNC_START("FMC_CORE_TransportOn");
 
+    _FMC_CORE_ShadowInvalidateAll();
+
 #ifdef BLUEZ_SOLUTION
 	/* remove unused vars warning, since we are ignoring these status-es*/
 	(void) stStatus;
@@ -1015,6 +1250,9 @@ CcmaStatus FM_TRANSPORT_IF_SendFmVacCommand(
     _fmcTransportHciData[_FMC_CORE_TRANSPORT_CLIENT_VAC].pUserData = pUserData;
 
     _fmcTransportData.cmdParms[0] = hciCmdParms[0];
+
+    /* The VAC writes the register directly, so its shadowed value is no longer known */
+    _FMC_CORE_ShadowInvalidate(hciCmdParms[0]);
     
     /* Store the FM Parameters Len in LE */
     len = (hciCmdParmsLen -(sizeof(FmcFwOpcode) + FMC_CORE_HCI_FM_PARMS_LEN_FIELD_LEN));
@@ -164,6 +164,10 @@ typedef FMC_UINT FmRxEventType;
 
 	FM_RX_STATUS_AF_SWITCH_FAILED_LIST_EXHAUSTED: 
 		No frequency in the list complied as a valid AF the attempted AF frequency
+
+	FM_RX_STATUS_AF_SWITCH_ABORTED: 
+		The switch was given up since FM_RX_Tune() or FM_RX_Seek() was called meanwhile.
+		The receiver stays on the original tuned frequency until that command runs.
 */
 #define FM_RX_EVENT_AF_SWITCH_COMPLETE			((FmRxEventType)5)
 
@@ -234,6 +238,19 @@ typedef FMC_UINT FmRxEventType;
 
 #define FM_RX_EVENT_COMPLETE_SCAN_DONE			((FmRxEventType)12)
 
+/* 
+	This event will be sent by the signal monitor, while the application is subscribed to it 
+	(see FM_RX_SubscribeSignalMonitor()), when the averaged RSSI moved by at least the configured
+	hysteresis from the last reported RSSI, or when the reception changed between mono and stereo.
+
+	The first sample after subscribing is always reported.
+
+        "p.signalQualityData" is valid.
+        "p.signalQualityData.rssi" - contains the averaged RSSI of the tuned frequency.
+        "p.signalQualityData.isStereo" - FMC_TRUE when the station is received in stereo.
+*/
+#define FM_RX_EVENT_SIGNAL_QUALITY_CHANGED		((FmRxEventType)13)
+
 
 
 /********************************************************************************
@@ -349,6 +366,7 @@ typedef FMC_UINT FmRxStatus;
 #define FM_RX_STATUS_AF_SWITCH_FAILED_LIST_EXHAUSTED		((FmRxStatus)FMC_FIRST_FM_RX_STATUS_CODE + 14)
 #define FM_RX_STATUS_COMPLETE_SCAN_IS_NOT_IN_PROGRESS		((FmRxStatus)FMC_FIRST_FM_RX_STATUS_CODE + 15) 
 #define FM_RX_STATUS_COMPLETE_SCAN_STOPPED		((FmRxStatus)FMC_FIRST_FM_RX_STATUS_CODE + 16)  
+#define FM_RX_STATUS_AF_SWITCH_ABORTED				((FmRxStatus)FMC_FIRST_FM_RX_STATUS_CODE + 17)
 
 #define FM_RX_NO_VALUE									((FmRxStatus)FMC_FIRST_FM_RX_STATUS_CODE)
 
@@ -551,10 +569,35 @@ struct _FmRxEvent {
             FmcFreq channelsData[FM_RX_COMPLETE_SCAN_MAX_NUM];
 
 		} completeScanData;
+
+		struct {
+			/* The averaged RSSI of the tuned frequency */
+			FMC_INT rssi;
+			/* FMC_TRUE when the station is received in stereo */
+			FMC_BOOL isStereo;
+		} signalQualityData;
     } p;    
 
 } ;
 
+/*-------------------------------------------------------------------------------
+ * FmRxCachedState structure
+ *
+ *     Snapshot of the FM RX configuration that the stack keeps in host memory,
+ *     returned by FM_RX_GetCachedState().
+ */
+typedef struct _FmRxCachedState {
+	FmcBand					band;
+	FMC_UINT				volume;
+	FmcMuteMode				muteMode;
+	FmRxRfDependentMuteMode	rfDependentMuteMode;
+	FMC_INT					rssiThreshold;
+	FmcEmphasisFilter		deEmphasisFilter;
+	FmcRdsSystem			rdsSystem;
+	FmcRdsGroupTypeMask		rdsGroupMask;
+	FmRxRdsAfSwitchMode		afSwitchMode;
+} FmRxCachedState;
+
 
 /********************************************************************************
  *
@@ -1318,9 +1361,10 @@ FmRxStatus FM_RX_GetVolume(FmRxContext *fmContext);
  *		to a preset station. The receiver will be tuned to the specified frequency regardless
  *		of any signal present.
  *
- *		Calling this function stops other frequency related processes in progress (seek, switch to AF)
- *		In that case, the application will receive a single event, reporting the tune result. The application
- *		will NOT recreive any event regarding the process that is being stopped.
+ *		Calling this function stops other frequency related processes in progress (seek, complete scan,
+ *		switch to AF), and the tune starts as soon as the stopped process completes. The stopped process
+ *		reports its completion as usual, with FM_RX_STATUS_SEEK_STOPPED, FM_RX_STATUS_COMPLETE_SCAN_STOPPED 
+ *		or FM_RX_STATUS_AF_SWITCH_ABORTED respectively, followed by the event reporting the tune result.
  *
  * Default Values: 
  *		NO DEFAULT VALUE AVAILABLE
@@ -1351,6 +1395,81 @@ FmRxStatus FM_RX_GetVolume(FmRxContext *fmContext);
  */
 FmRxStatus FM_RX_Tune(FmRxContext *fmContext, FmcFreq freq);
 
+/*-------------------------------------------------------------------------------
+ * FM_RX_SetPresets()
+ *
+ * Brief:  
+ *		Sets the list of preset frequencies used by FM_RX_TuneToNextPreset().
+ *
+ * Description:
+ *		The list is copied by the stack. Setting a new list restarts preset hopping: the next
+ *		FM_RX_TuneToNextPreset() tunes to the first preset (direction up), or to the last one 
+ *		(direction down). Calling the function with numOfPresets == 0 clears the list.
+ *
+ *		The list is kept when FM RX is disabled.
+ *
+ * Type:
+ *		Synchronous
+ *
+ * Parameters:
+ *		fmContext [in] - FM RX context.
+ *
+ *		numOfPresets [in] - The number of frequencies in presets. Up to 
+ *							FM_CONFIG_RX_MAX_NUM_OF_PRESETS.
+ *
+ *		presets [in] - The preset frequencies, in kHz.
+ *
+ * Returns:
+ *		FM_RX_STATUS_SUCCESS - The list was set.
+ *
+ *		FM_RX_STATUS_INVALID_PARM - The function was called with an invalid parameter
+ *
+ *		FM_RX_STATUS_CONTEXT_NOT_ENABLED - The context is not enabled
+ */
+FmRxStatus FM_RX_SetPresets(FmRxContext *fmContext, FMC_UINT numOfPresets, const FmcFreq *presets);
+
+/*-------------------------------------------------------------------------------
+ * FM_RX_TuneToNextPreset()
+ *
+ * Brief:  
+ *		Tune the receiver to the next or previous entry of the presets list.
+ *
+ * Description:
+ *		The entry is selected relative to the last entry selected by this function, wrapping 
+ *		around the ends of the list, and tuned as if FM_RX_Tune() was called with its frequency.
+ *		Each call moves one entry, also when the previous calls did not complete yet.
+ *
+ *		When consecutive tunes wait in the queue, the stack skips the stages that restore and
+ *		re-enable the tuning interrupt between them, so scrolling the presets costs fewer chip 
+ *		round trips than a sequence of separate tunes.
+ *
+ * Generated Events:
+ *		1. Event type==FM_RX_EVENT_CMD_DONE, with command type == FM_RX_CMD_TUNE
+ *
+ * Type:
+ *		Asynchronous
+ *
+ * Parameters:
+ *		fmContext [in] - FM RX context.
+ *
+ *		direction [in] - FM_RX_SEEK_DIRECTION_UP for the next entry, FM_RX_SEEK_DIRECTION_DOWN 
+ *						for the previous one.
+ *
+ * Returns:
+ *		FM_RX_STATUS_PENDING - Operation started successfully, an event will be sent to
+ *								the application upon completion.
+ *
+ *		FM_RX_STATUS_INVALID_PARM - The function was called with an invalid parameter
+ *
+ *		FM_RX_STATUS_CONTEXT_NOT_ENABLED - The context is not enabled
+ *
+ *		FM_RX_STATUS_NO_VALUE_AVAILABLE - No presets were set (first call FM_RX_SetPresets())
+ *
+ *		FM_RX_STATUS_TOO_MANY_PENDING_OPERATIONS - Too many operations are already waiting
+ *														execution in operations queue.
+ */
+FmRxStatus FM_RX_TuneToNextPreset(FmRxContext *fmContext, FmRxSeekDirection direction);
+
 
 /*-------------------------------------------------------------------------------
  * FM_RX_IsValidChannel()
@@ -1452,8 +1571,8 @@ FmRxStatus FM_RX_GetTunedFrequency(FmRxContext *fmContext);
  *		2. The band limit was reached. The band limit will be the new tuned frequency.
  *		3. FM_RX_StopSeek() was called. The last scanned frequency will be the new
  *			tuned frequency.
- *		4. TBD: FM_RX_Tune() was called. The new tuned frequency will be the one specified
- *			in the FM_RX_Tune() call.
+ *		4. FM_RX_Tune() or FM_RX_Seek() was called. The seek completes as if FM_RX_StopSeek() 
+ *			was called, and the new command starts right after it.
  *		
  * Generated Events:
  *		1. Event type==FM_RX_EVENT_CMD_DONE, with command type == FM_RX_CMD_SEEK, and
@@ -1532,6 +1651,9 @@ FmRxStatus FM_RX_StopSeek(FmRxContext *fmContext);
  *		
  *		Perfrom a complete Scan on the Band and return a list of frequnecies that are valid acorrding to the RSSI.
  *
+ *		Calling FM_RX_Tune() or FM_RX_Seek() during the scan stops it as if FM_RX_StopCompleteScan() 
+ *		was called, and the new command starts right after it.
+ *
  * Generated Events:
  *		Event type==FM_RX_EVENT_COMPLETE_SCAN_DONE.
  *		
@@ -1907,7 +2029,14 @@ FmRxStatus FM_RX_GetRdsGroupMask(FmRxContext *fmContext);
  *		2. The RDS PI (Program Indicator) of the alternate frequency matches that of the tuned
  *			frequency.
  *
- *		TBD: How to handle seek and tune commands that are issued while AF is in progress?
+ *		After a low RSSI, no other switch is attempted for a suspension time. Each attempt that 
+ *		exhausts the list doubles the suspension, up to a maximum, until a new frequency is tuned.
+ *		During the suspension, the RSSI of the tuned frequency is sampled every signal monitor
+ *		interval (see FM_RX_SetSignalMonitorParams()). A low RSSI within one interval after the 
+ *		suspension attempts no switch while the averaged RSSI rises. The first low RSSI of a frequency is 
+ *		never suppressed. See FM_RX_SetAfSwitchParams() for the values used.
+ *
+ *		A tune or seek issued while a switch is in progress stops it (see FM_RX_Tune()).
  *
  * Caveats:
  *		AF automatic switching can operate only when RDS reception is enabled (via FM_RX_EnableRds()) 
@@ -1969,6 +2098,46 @@ FmRxStatus FM_RX_SetRdsAfSwitchMode(FmRxContext *fmContext, FmRxRdsAfSwitchMode
  */
 FmRxStatus FM_RX_GetRdsAfSwitchMode(FmRxContext *fmContext);
 
+/*-------------------------------------------------------------------------------
+ * FM_RX_SetAfSwitchParams()
+ *
+ * Brief:  
+ *		Sets the timing of AF switch attempts and the RSSI rise that suppresses them.
+ *
+ * Description:
+ *		Default values are FM_CONFIG_RX_AF_TIMER_MS, FM_CONFIG_RX_AF_MAX_TIMER_MS and 
+ *		FM_CONFIG_RX_AF_RECOVERY_RSSI_SLOPE. The values are kept when FM RX is disabled.
+ *		Setting the parameters cancels the back off of previous failed attempts.
+ *
+ * Type:
+ *		Synchronous
+ *
+ * Parameters:
+ *		fmContext [in] - FM RX context.
+ *
+ *		suspendTimeMs [in] - Time after a low RSSI before another switch may be attempted, in
+ *							milliseconds. Must not be 0.
+ *
+ *		maxSuspendTimeMs [in] - The longest suspension after failed attempts, in milliseconds.
+ *							Must be at least suspendTimeMs.
+ *
+ *		recoveryRssiSlope [in] - Rise of the averaged RSSI between two samples from which no 
+ *							switch is attempted. The RSSI is sampled for it only during the
+ *							suspension after a low RSSI. 0 never suppresses a switch, and does
+ *							not sample the RSSI for the AF switching.
+ *
+ * Returns:
+ *		FM_RX_STATUS_SUCCESS - The parameters were set.
+ *
+ *		FM_RX_STATUS_INVALID_PARM - The function was called  with an invalid parameter
+ *
+ *		FM_RX_STATUS_CONTEXT_NOT_ENABLED - The context is not enabled
+ */
+FmRxStatus FM_RX_SetAfSwitchParams(FmRxContext *fmContext, 
+										FMC_UINT suspendTimeMs, 
+										FMC_UINT maxSuspendTimeMs, 
+										FMC_UINT recoveryRssiSlope);
+
 
 /*-------------------------------------------------------------------------------
  * FM_RX_SetSeekSpacing()
@@ -2078,6 +2247,133 @@ FmRxStatus FM_RX_GetChannelSpacing(FmRxContext *fmContext);
  */
 FmRxStatus FM_RX_GetFwVersion (FmRxContext *fmContext);
 
+/*-------------------------------------------------------------------------------
+ * FM_RX_GetCachedState()
+ *
+ * Brief:  
+ *		Returns the FM RX configuration the stack holds in host memory.
+ *
+ * Description:
+ *		Fills the state structure with the band, volume, mute mode, RF-dependent mute mode, 
+ *		RSSI threshold, de-emphasis filter, RDS system, RDS group mask and AF switch mode, 
+ *		the same values returned by the matching FM_RX_GetXxx() commands.
+ *
+ *		The call does not go through the commands queue. It reflects the commands that already
+ *		completed, and not Set commands that are still waiting in the queue.
+ *
+ *		Values that require reading the chip (frequency, RSSI, Mono/Stereo mode, channel spacing,
+ *		FW version) are available only through their asynchronous Get commands.
+ *
+ * Type:
+ *		Synchronous
+ *
+ * Parameters:
+ *		fmContext [in] - FM RX context.
+ *
+ *		state [out] - The current configuration.
+ *
+ * Returns:
+ *		FM_RX_STATUS_SUCCESS - The state was copied successfully.
+ *
+ *		FM_RX_STATUS_INVALID_PARM - The function was called  with an invalid parameter
+ *
+ *		FM_RX_STATUS_CONTEXT_NOT_ENABLED - The context is not enabled
+ */
+FmRxStatus FM_RX_GetCachedState(FmRxContext *fmContext, FmRxCachedState *state);
+
+/*-------------------------------------------------------------------------------
+ * FM_RX_SubscribeSignalMonitor()
+ *
+ * Brief:  
+ *		Subscribes to signal quality events.
+ *
+ * Description:
+ *		While at least one subscription exists, the stack samples the RSSI and the stereo status
+ *		of the tuned frequency every sampling interval (see FM_RX_SetSignalMonitorParams()), averages
+ *		the RSSI, and sends FM_RX_EVENT_SIGNAL_QUALITY_CHANGED only when the signal quality changed
+ *		meaningfully. This replaces periodic calls to FM_RX_GetRssi().
+ *
+ *		Subscriptions are counted. Each call must be matched by a call to 
+ *		FM_RX_UnsubscribeSignalMonitor(). No samples are taken while a seek or a complete scan
+ *		is in progress.
+ *
+ *		All subscriptions are dropped when FM RX is disabled.
+ *
+ * Generated Events:
+ *		1. Event type==FM_RX_EVENT_SIGNAL_QUALITY_CHANGED, with command type == FM_RX_CMD_NONE
+ *
+ * Type:
+ *		Synchronous
+ *
+ * Parameters:
+ *		fmContext [in] - FM RX context.
+ *
+ * Returns:
+ *		FM_RX_STATUS_SUCCESS - The subscription was added.
+ *
+ *		FM_RX_STATUS_INVALID_PARM - The function was called  with an invalid parameter
+ *
+ *		FM_RX_STATUS_CONTEXT_NOT_ENABLED - The context is not enabled
+ */
+FmRxStatus FM_RX_SubscribeSignalMonitor(FmRxContext *fmContext);
+
+/*-------------------------------------------------------------------------------
+ * FM_RX_UnsubscribeSignalMonitor()
+ *
+ * Brief:  
+ *		Removes a subscription added by FM_RX_SubscribeSignalMonitor().
+ *
+ * Description:
+ *		Sampling stops when the last subscription is removed.
+ *
+ * Type:
+ *		Synchronous
+ *
+ * Parameters:
+ *		fmContext [in] - FM RX context.
+ *
+ * Returns:
+ *		FM_RX_STATUS_SUCCESS - The subscription was removed.
+ *
+ *		FM_RX_STATUS_INVALID_PARM - The function was called  with an invalid parameter, or there
+ *									is no subscription to remove.
+ *
+ *		FM_RX_STATUS_CONTEXT_NOT_ENABLED - The context is not enabled
+ */
+FmRxStatus FM_RX_UnsubscribeSignalMonitor(FmRxContext *fmContext);
+
+/*-------------------------------------------------------------------------------
+ * FM_RX_SetSignalMonitorParams()
+ *
+ * Brief:  
+ *		Sets the sampling interval and the RSSI hysteresis of the signal monitor.
+ *
+ * Description:
+ *		The new interval applies from the next sample. Default values are 
+ *		FM_CONFIG_RX_SIGNAL_MONITOR_INTERVAL_MS and FM_CONFIG_RX_SIGNAL_MONITOR_RSSI_HYSTERESIS.
+ *		The values are kept when FM RX is disabled.
+ *
+ * Type:
+ *		Synchronous
+ *
+ * Parameters:
+ *		fmContext [in] - FM RX context.
+ *
+ *		intervalMs [in] - Time between two samples, in milliseconds. Must be at least
+ *							FM_CONFIG_RX_SIGNAL_MONITOR_MIN_INTERVAL_MS.
+ *
+ *		rssiHysteresis [in] - Minimal change of the averaged RSSI, relative to the last reported 
+ *							RSSI, that is reported. 0 reports every change.
+ *
+ * Returns:
+ *		FM_RX_STATUS_SUCCESS - The parameters were set.
+ *
+ *		FM_RX_STATUS_INVALID_PARM - The function was called  with an invalid parameter
+ *
+ *		FM_RX_STATUS_CONTEXT_NOT_ENABLED - The context is not enabled
+ */
+FmRxStatus FM_RX_SetSignalMonitorParams(FmRxContext *fmContext, FMC_UINT intervalMs, FMC_UINT rssiHysteresis);
+
 /*-------------------------------------------------------------------------------
  * FM_RX_ChangeAudioTarget()
  *
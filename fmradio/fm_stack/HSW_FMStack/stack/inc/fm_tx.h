@@ -378,6 +378,34 @@ struct _FmTxEvent
     } p;    
 } ;
 
+/*-------------------------------------------------------------------------------
+ * FmTxCachedState structure
+ *
+ *     Snapshot of the FM TX configuration that the stack keeps in host memory,
+ *     returned by FM_TX_GetCachedState().
+ */
+typedef struct _FmTxCachedState
+{
+    FmcFreq                         tunedFreq;
+    FMC_BOOL                        transmissionOn;
+    FmTxPowerLevel                  powerLevel;
+    FmcMuteMode                     muteMode;
+    FmcEmphasisFilter               preEmphasisFilter;
+    FMC_BOOL                        rdsEnabled;
+    FmTxRdsTransmissionMode         rdsTransmissionMode;
+    FmTxRdsTransmittedGroupsMask    rdsTransmittedGroupsMask;
+    FmcRdsPiCode                    rdsPiCode;
+    FmcRdsPtyCode                   rdsPtyCode;
+    FmcAfCode                       rdsAfCode;
+    FmcRdsRepertoire                rdsRepertoire;
+    FmcRdsPsDisplayMode             rdsPsDisplayMode;
+    FmcRdsPsScrollSpeed             rdsPsScrollSpeed;
+    FmcRdsTaCode                    rdsTaCode;
+    FmcRdsTpCode                    rdsTpCode;
+    FmcRdsMusicSpeechFlag           rdsMusicSpeechFlag;
+    FmcRdsExtendedCountryCode       rdsExtendedCountryCode;
+} FmTxCachedState;
+
 /********************************************************************************
  *
  * Function declarations
@@ -2141,6 +2169,41 @@ FmTxStatus FM_TX_SetRdsECC(FmTxContext *fmContext,
  */
 FmTxStatus FM_TX_GetRdsECC(FmTxContext *fmContext);
 
+/*------------------------------------------------------------------------------
+ * FM_TX_GetCachedState()
+ *
+ * Brief:  
+ *      Returns the FM TX configuration the stack holds in host memory.
+ *
+ * Description:
+ *      Fills the state structure with the values the stack cached when they were
+ *      last set in the chip: tuned frequency, transmission state, power level,
+ *      mute mode, pre-emphasis filter and the RDS configuration codes.
+ *
+ *      The call does not go through the commands queue. It reflects the commands
+ *      that already completed, and not Set commands that are still waiting in the queue.
+ *
+ *      The PS / RT messages and the Mono/Stereo mode are available only through their 
+ *      asynchronous Get commands.
+ *
+ * Type:
+ *      Synchronous
+ *
+ * Parameters:
+ *      fmContext [in] - FM TX context.
+ *
+ *      state [out] - The current configuration.
+ *
+ * Returns:
+ *      FM_TX_STATUS_SUCCESS - The state was copied successfully.
+ *
+ *      FM_TX_STATUS_INVALID_PARM - The function was called  with an invalid
+ *          parameter
+ *
+ *      FM_TX_STATUS_CONTEXT_NOT_ENABLED - The context is not enabled
+ */
+FmTxStatus FM_TX_GetCachedState(FmTxContext *fmContext, FmTxCachedState *state);
+
 /*------------------------------------------------------------------------------
  * FM_TX_WriteRdsRawData()
  *
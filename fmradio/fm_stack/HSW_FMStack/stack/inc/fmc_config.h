@@ -86,6 +86,12 @@
 
 #define FMC_CONFIG_SCRIPT_FILES_FM_TX_INIT_NAME                                             ("fm_tx_init")
 
+/*
+*   Largest FMC or FM RX init script that is read into memory while the FM wakes up. The memory is 
+*   allocated only until the power on ends. A larger script is executed directly from the file system.
+*/
+#define FMC_CONFIG_SCRIPT_PREFETCH_MAX_SIZE                                                 (8192)
+
 /*
 *   Defines the name of the single FM mutex that is shared between RX & TX
 */
@@ -106,6 +112,13 @@
 */
 #define FMC_CONFIG_MAX_NUM_OF_PENDING_CMDS                  (20)
 
+/*
+    Defines whether the FM core keeps a shadow of the last value written to each
+    configuration register, and completes a write of an unchanged value without
+    sending it to the chip
+*/
+#define FMC_CONFIG_CORE_WRITE_SHADOW                        FMC_CONFIG_ENABLED
+
 /*
 *   Bit 0: INTx polarity: 0 = low, 1 = high
     Bit 1: When polarity high: 0 = high, 1 = Hi-Z
@@ -120,9 +133,51 @@
 /*
 *   define the time from the moment the FM stack switches to the AF before it allows another switch. This is necessary to avoid
 *   excessive changes between the primary and alternate frequencies.
+*   This is the default value - the application may change it via FM_RX_SetAfSwitchParams().
 */
 #define FM_CONFIG_RX_AF_TIMER_MS                                (30000)
 
+/*
+*   Default longest time between two AF switch attempts. Each attempt that exhausts the AF list without 
+*   switching doubles the time until the next attempt, up to this value.
+*/
+#define FM_CONFIG_RX_AF_MAX_TIMER_MS                            (240000)
+
+/*
+*   Default rise of the averaged RSSI between two signal monitor samples from which the tuned station is 
+*   considered recovering. A low RSSI does not start an AF switch while the station recovers. The RSSI 
+*   is sampled for it only during the AF suspension after a low RSSI.
+*/
+#define FM_CONFIG_RX_AF_RECOVERY_RSSI_SLOPE                     (1)
+
+/*
+*   Default interval between two samples of the signal monitor (RSSI and Stereo status), used while
+*   the application is subscribed to FM_RX_EVENT_SIGNAL_QUALITY_CHANGED events.
+*/
+#define FM_CONFIG_RX_SIGNAL_MONITOR_INTERVAL_MS                 (1000)
+
+/*
+*   The shortest sampling interval the application may set for the signal monitor
+*/
+#define FM_CONFIG_RX_SIGNAL_MONITOR_MIN_INTERVAL_MS             (100)
+
+/*
+*   Default change in the averaged RSSI, relative to the last reported RSSI, that triggers a
+*   FM_RX_EVENT_SIGNAL_QUALITY_CHANGED event
+*/
+#define FM_CONFIG_RX_SIGNAL_MONITOR_RSSI_HYSTERESIS             (3)
+
+/*
+*   Number of samples the RSSI is averaged over. Each new sample moves the average by 1/N
+*   of its distance from the average.
+*/
+#define FM_CONFIG_RX_SIGNAL_MONITOR_AVERAGING_SAMPLES           (4)
+
+/*
+*   The maximum number of frequencies in the presets list set by FM_RX_SetPresets()
+*/
+#define FM_CONFIG_RX_MAX_NUM_OF_PRESETS                         (30)
+
 /*
 *   Must wait at least 20msec before starting to send commands to the FM.
 */
@@ -235,6 +235,32 @@ FMC_BOOL FM_RX_SM_IsContextEnabled(void);
 
 FmRxCmdType FM_RX_SM_GetRunningCmd(void);
 
+/*
+    Copies the configuration values kept in the SM data. Must be called with the FM mutex held.
+*/
+void FM_RX_SM_GetCachedState(FmRxCachedState *state);
+
+/*
+    Signal monitor subscriptions and parameters. Must be called with the FM mutex held.
+*/
+void FM_RX_SM_SubscribeSignalMonitor(void);
+FMC_BOOL FM_RX_SM_UnsubscribeSignalMonitor(void);
+void FM_RX_SM_SetSignalMonitorParams(FMC_UINT intervalMs, FMC_UINT rssiHysteresis);
+
+/*
+    AF switch policy parameters. Must be called with the FM mutex held.
+*/
+void FM_RX_SM_SetAfSwitchParams(FMC_UINT suspendTimeMs, FMC_UINT maxSuspendTimeMs, FMC_UINT recoveryRssiSlope);
+
+/*
+    Presets list. FM_RX_SM_GetNextPreset() returns FMC_FALSE when the list is empty. The selected
+    entry becomes the current one only once FM_RX_SM_SetCurrentPreset() is called with its index.
+    Must be called with the FM mutex held.
+*/
+void FM_RX_SM_SetPresets(FMC_UINT numOfPresets, const FmcFreq *presets);
+FMC_BOOL FM_RX_SM_GetNextPreset(FmRxSeekDirection direction, FMC_UINT *index, FmcFreq *freq);
+void FM_RX_SM_SetCurrentPreset(FMC_UINT index);
+
 void FM_RX_SM_SetUpperEvent(FMC_U8 upperEvt);
 
 /*
@@ -31,8 +31,9 @@
 #define FM_RX_INTERNAL_HANDLE_STEREO_CHANGE 	((FmRxCmdType)FM_RX_LAST_API_CMD+4)
 #define FM_RX_INTERNAL_HANDLE_HW_MAL			((FmRxCmdType)FM_RX_LAST_API_CMD+5)	/* Internal use */
 #define FM_RX_INTERNAL_HANDLE_TIMEOUT			((FmRxCmdType)FM_RX_LAST_API_CMD+6)	/* Internal use */
+#define FM_RX_INTERNAL_SAMPLE_SIGNAL			((FmRxCmdType)FM_RX_LAST_API_CMD+7)	/* Internal use */
 
-#define FM_RX_LAST_CMD								((FmRxCmdType)FM_RX_INTERNAL_HANDLE_TIMEOUT+1)	
+#define FM_RX_LAST_CMD								((FmRxCmdType)FM_RX_INTERNAL_SAMPLE_SIGNAL+1)	
 
 /********************************************************************************
  *
@@ -163,14 +164,18 @@ typedef struct _FmRxRdsDataFormat {
 #define RDS_BIT_4_TO_BIT_7		0xf0
 
 #define RDS_STATUS_ERROR_MASK				0x18
-#define RDS_BLOCK_B_GROUP_TYPE_MASK			0xF0
-#define RDS_BLOCK_B_PTY_MASK 					0x03E0
 #define RDS_BLOCK_B_AB_BIT_MASK				0x0800
 #define RDS_BLOCK_B_PS_INDEX_MASK			0x0003
 #define RDS_BLOCK_B_RT_INDEX_MASK			0x000F
 #define RDS_BLOCK_B_AB_FLAG_MASK			0x0010
 
-#define RDS_NUM_OF_BITS_BEFOR_PTY	5
+/* Block B fields, in transmission order */
+#define RDS_BLOCK_B_FIELD_GROUP_TYPE		0
+#define RDS_BLOCK_B_FIELD_B_TYPE			1
+#define RDS_BLOCK_B_FIELD_TP				2
+#define RDS_BLOCK_B_FIELD_PTY				3
+#define RDS_BLOCK_B_FIELD_OTHER				4
+#define RDS_BLOCK_B_NUM_OF_FIELDS			5
 
 #define RDS_RT_END_CHARACTER				0x0D	/* indicates carriage return	*/
 
@@ -196,6 +201,9 @@ typedef struct _FmRxRdsDataFormat {
 #define GEN_INT_AFTER_LOW_RSSI_STAGE			4
 #define GEN_INT_AFTER_FINISH_STAGE				5
 
+/* Tune stage that enables the FR interrupt, once the frequency is set and the flag is cleared */
+#define TUNE_ENABLE_INTERRUPTS_STAGE			3
+
 #define INT_READ_MASK		0
 #define INT_READ_FLAG		1
 #define INT_HANDLE_INT		2
@@ -317,6 +317,10 @@ FmTxRdsTransmissionMode FM_TX_SM_GetRdsMode(void);
 *	This function returns the state of RDS (Enabled/Disabled)
 */
 FMC_BOOL FM_TX_SM_IsRdsEnabled(void);
+/*
+*	This function copies the configuration values kept in the FW cache. Must be called with the FM mutex held.
+*/
+void FM_TX_SM_GetCachedState(FmTxCachedState *state);
 /*
 	Returns the single context
 
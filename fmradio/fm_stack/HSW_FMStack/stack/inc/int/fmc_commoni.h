@@ -57,6 +57,9 @@ typedef struct  {
 
 #define FMC_MAX_CMD_LEN             (FMC_UINT)(FMC_BASE_CMD_LEN + FMC_MAX_CMD_PARMS_LEN)
 
+/* Upper bound of RX & TX command type values (including RX internal commands), sizes the commands queue index */
+#define FMC_MAX_NUM_OF_CMD_TYPES        (64)
+
 #define FMC_RDS_FIFO_SIZE               (FM_RDS_RAW_MAX_MSG_LEN)
 
 typedef void (*FmciFmTaskClientCallbackFunc)(FmcOsEvent osEvent);
@@ -110,10 +113,45 @@ FmcPool *FMCI_GetCmdsPool(void);
 */
 FMC_ListNode *FMCI_GetCmdsQueue(void);
 
+/*
+    Inserts a command as the last command in the shared commands queue.
+
+    Commands must be inserted and removed only through FMCI_InsertCmdToQueue() / FMCI_RemoveCmdFromQueue(),
+    since the queue keeps an index of the pending commands of each command type.
+*/
+void FMCI_InsertCmdToQueue(FmcBaseCmd *cmd);
+
+/*
+    Removes a command from the shared commands queue
+*/
+void FMCI_RemoveCmdFromQueue(FmcBaseCmd *cmd);
+
+/*
+    Changes the command type of the command at the head of the queue (the running command).
+
+    Used when a running command continues as another command type (e.g., an RX general interrupt
+    command that turns into an RDS read).
+*/
+void FMCI_ChangeHeadCmdType(FmcBaseCmd *cmd, FMC_UINT cmdType);
+
+/*
+    Returns the last command in the queue with the specified command type, or NULL if there is 
+    no such command. The search does not traverse the queue.
+*/
+FmcBaseCmd *FMCI_FindLatestCmdInQueueByType(FMC_UINT cmdType);
+
 FmcStatus FMCI_OS_ResetTimer(FMC_U32 time);
 
 FmcStatus FMCI_OS_CancelTimer(void);
 
+/*
+    A second timer, used by the RX signal monitor. It sends FMC_OS_EVENT_MONITOR_TIMER_EXPIRED
+    to the FM task, so it may run together with the timer above.
+*/
+FmcStatus FMCI_OS_ResetMonitorTimer(FMC_U32 time);
+
+FmcStatus FMCI_OS_CancelMonitorTimer(void);
+
 
 
 #endif  /* __FMC_COMMONI_H */
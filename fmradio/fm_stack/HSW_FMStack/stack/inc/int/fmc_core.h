@@ -220,6 +220,13 @@ FmcStatus FMC_CORE_SendReadCommand(FmcFwOpcode fmOpcode,FMC_U16 fmParameter);
 FmcStatus FMC_CORE_SendHciScriptCommand(	FMC_U16 	hciOpcode, 
 																FMC_U8 		*hciCmdParms, 
 																FMC_UINT 	len);
+/*
+	Gets the write shadow statistics: the number of writes that were completed
+	without being sent since the value was already in the chip (hits), and the
+	number of shadowed writes that had to be sent (misses).
+*/
+void FMC_CORE_GetWriteShadowStats(FMC_U32 *hits, FMC_U32 *misses);
+
 /*
 	Registers/Unregister for FM Interrupts
 */
@@ -31,6 +31,7 @@
 \*******************************************************************************/
 #include "mcpf_defs.h"
 #include "fmc_types.h"
+#include "fmc_config.h"
 #include "fmc_defs.h"
 #include "fmc_os.h"
 #include "fmc_log.h"
@@ -626,6 +627,80 @@ FmRxStatus FM_RX_Tune(FmRxContext *fmContext, FmcFreq freq)
 								"FM_RX_Tune");
 }
 
+/*-------------------------------------------------------------------------------
+ * FM_RX_SetPresets()
+ *
+ * Brief:  
+ *		Sets the list of preset frequencies
+ *
+ */
+FmRxStatus FM_RX_SetPresets(FmRxContext *fmContext, FMC_UINT numOfPresets, const FmcFreq *presets)
+{
+	FmRxStatus	status = FM_RX_STATUS_SUCCESS;
+	FMC_UINT	presetIndex;
+
+	_FM_RX_FUNC_START_AND_LOCK_ENABLED("FM_RX_SetPresets");
+
+	FMC_VERIFY_ERR((fmContext == FM_RX_SM_GetContext()), FMC_STATUS_INVALID_PARM, ("FM_RX_SetPresets: Invalid Context Ptr"));
+	FMC_VERIFY_ERR((numOfPresets <= FM_CONFIG_RX_MAX_NUM_OF_PRESETS), FMC_STATUS_INVALID_PARM, 
+						("FM_RX_SetPresets: Too many presets (%d)", numOfPresets));
+	FMC_VERIFY_ERR(((numOfPresets == 0) || (presets != NULL)), FMC_STATUS_INVALID_PARM, ("FM_RX_SetPresets: Null presets Ptr"));
+
+	for (presetIndex = 0; presetIndex < numOfPresets; presetIndex++)
+	{
+		FMC_VERIFY_ERR(((FMC_FIRST_FREQ_JAPAN_KHZ <= presets[presetIndex]) && (FMC_LAST_FREQ_US_EUROPE_KHZ >= presets[presetIndex])),
+							FMC_STATUS_INVALID_PARM, ("FM_RX_SetPresets: Invalid preset #%d", presetIndex));
+	}
+
+	FM_RX_SM_SetPresets(numOfPresets, presets);
+
+	_FM_RX_FUNC_END_AND_UNLOCK_ENABLED();
+
+	return status;
+}
+
+/*-------------------------------------------------------------------------------
+ * FM_RX_TuneToNextPreset()
+ *
+ * Brief:  
+ *		Tune the receiver to the next or previous entry of the presets list
+ *
+ */
+FmRxStatus FM_RX_TuneToNextPreset(FmRxContext *fmContext, FmRxSeekDirection direction)
+{
+	FmRxStatus		status;
+	FmRxTuneCmd		*tuneCmd = NULL;
+	FMC_UINT		presetIndex;
+	FmcFreq			freq;
+
+	_FM_RX_FUNC_START_AND_LOCK_ENABLED("FM_RX_TuneToNextPreset");
+
+	FMC_VERIFY_ERR((fmContext == FM_RX_SM_GetContext()), FMC_STATUS_INVALID_PARM, ("FM_RX_TuneToNextPreset: Invalid Context Ptr"));
+	FMC_VERIFY_ERR(((direction == FM_RX_SEEK_DIRECTION_UP) || (direction == FM_RX_SEEK_DIRECTION_DOWN)), 
+						FMC_STATUS_INVALID_PARM, ("FM_RX_TuneToNextPreset: Invalid direction (%d)", direction));
+	FMC_VERIFY_ERR((FM_RX_SM_GetNextPreset(direction, &presetIndex, &freq) == FMC_TRUE), FM_RX_STATUS_NO_VALUE_AVAILABLE, 
+						("FM_RX_TuneToNextPreset: No presets"));
+
+	/* Allocates the command and insert to commands queue */
+	status = FM_RX_SM_AllocateCmdAndAddToQueue(fmContext, FM_RX_CMD_TUNE, (FmcBaseCmd**)&tuneCmd);
+	FMC_VERIFY_ERR((status == FMC_STATUS_SUCCESS), status, ("FM_RX_TuneToNextPreset"));
+
+	/* Copy cmd parms for the cmd execution phase*/
+	tuneCmd->freq = (FMC_INT)freq;
+
+	/* Only a queued tune moves the current preset, so the next call continues from it */
+	FM_RX_SM_SetCurrentPreset(presetIndex);
+
+	status = FM_RX_STATUS_PENDING;
+
+	/* Trigger RX SM to execute the command in FM Task context */
+	FMCI_NotifyFmTask(FMC_OS_EVENT_FMC_STACK_TASK_PROCESS);
+
+	_FM_RX_FUNC_END_AND_UNLOCK_ENABLED();
+
+	return status;
+}
+
 /*-------------------------------------------------------------------------------
  * FM_RX_IsValidChannel()
  *
@@ -896,6 +971,33 @@ FmRxStatus FM_RX_GetRdsAfSwitchMode(FmRxContext *fmContext)
 								"FM_RX_GetRdsAfSwitchMode");
 }
 
+/*-------------------------------------------------------------------------------
+ * FM_RX_SetAfSwitchParams()
+ *
+ * Brief:  
+ *		Sets the timing of AF switch attempts and the RSSI rise that suppresses them.
+ *
+ */
+FmRxStatus FM_RX_SetAfSwitchParams(FmRxContext *fmContext, 
+										FMC_UINT suspendTimeMs, 
+										FMC_UINT maxSuspendTimeMs, 
+										FMC_UINT recoveryRssiSlope)
+{
+	FmRxStatus	status = FM_RX_STATUS_SUCCESS;
+
+	_FM_RX_FUNC_START_AND_LOCK_ENABLED("FM_RX_SetAfSwitchParams");
+
+	FMC_VERIFY_ERR((fmContext == FM_RX_SM_GetContext()), FMC_STATUS_INVALID_PARM, ("FM_RX_SetAfSwitchParams: Invalid Context Ptr"));
+	FMC_VERIFY_ERR(((suspendTimeMs > 0) && (maxSuspendTimeMs >= suspendTimeMs)), FMC_STATUS_INVALID_PARM, 
+						("FM_RX_SetAfSwitchParams: Invalid suspension times (%d, %d)", suspendTimeMs, maxSuspendTimeMs));
+
+	FM_RX_SM_SetAfSwitchParams(suspendTimeMs, maxSuspendTimeMs, recoveryRssiSlope);
+
+	_FM_RX_FUNC_END_AND_UNLOCK_ENABLED();
+
+	return status;
+}
+
 /*-------------------------------------------------------------------------------
  * FM_RX_SetChannelSpacing()
  *
@@ -944,6 +1046,97 @@ FmRxStatus FM_RX_GetFwVersion(FmRxContext *fmContext)
                                 "FM_RX_GetFwVersion");
 }
 
+/*-------------------------------------------------------------------------------
+ * FM_RX_GetCachedState()
+ *
+ * Brief:  
+ *      Returns the FM RX configuration the stack holds in host memory.
+ *
+ */
+FmRxStatus FM_RX_GetCachedState(FmRxContext *fmContext, FmRxCachedState *state)
+{
+	FmRxStatus	status = FM_RX_STATUS_SUCCESS;
+
+	_FM_RX_FUNC_START_AND_LOCK_ENABLED("FM_RX_GetCachedState");
+
+	FMC_VERIFY_ERR((fmContext == FM_RX_SM_GetContext()), FMC_STATUS_INVALID_PARM, ("FM_RX_GetCachedState: Invalid Context Ptr"));
+	FMC_VERIFY_ERR((state != NULL), FMC_STATUS_INVALID_PARM, ("FM_RX_GetCachedState: Null state Ptr"));
+
+	FM_RX_SM_GetCachedState(state);
+
+	_FM_RX_FUNC_END_AND_UNLOCK_ENABLED();
+
+	return status;
+}
+
+/*-------------------------------------------------------------------------------
+ * FM_RX_SubscribeSignalMonitor()
+ *
+ * Brief:  
+ *      Subscribes to signal quality events.
+ *
+ */
+FmRxStatus FM_RX_SubscribeSignalMonitor(FmRxContext *fmContext)
+{
+	FmRxStatus	status = FM_RX_STATUS_SUCCESS;
+
+	_FM_RX_FUNC_START_AND_LOCK_ENABLED("FM_RX_SubscribeSignalMonitor");
+
+	FMC_VERIFY_ERR((fmContext == FM_RX_SM_GetContext()), FMC_STATUS_INVALID_PARM, ("FM_RX_SubscribeSignalMonitor: Invalid Context Ptr"));
+
+	FM_RX_SM_SubscribeSignalMonitor();
+
+	_FM_RX_FUNC_END_AND_UNLOCK_ENABLED();
+
+	return status;
+}
+
+/*-------------------------------------------------------------------------------
+ * FM_RX_UnsubscribeSignalMonitor()
+ *
+ * Brief:  
+ *      Removes a subscription to signal quality events.
+ *
+ */
+FmRxStatus FM_RX_UnsubscribeSignalMonitor(FmRxContext *fmContext)
+{
+	FmRxStatus	status = FM_RX_STATUS_SUCCESS;
+
+	_FM_RX_FUNC_START_AND_LOCK_ENABLED("FM_RX_UnsubscribeSignalMonitor");
+
+	FMC_VERIFY_ERR((fmContext == FM_RX_SM_GetContext()), FMC_STATUS_INVALID_PARM, ("FM_RX_UnsubscribeSignalMonitor: Invalid Context Ptr"));
+	FMC_VERIFY_ERR((FM_RX_SM_UnsubscribeSignalMonitor() == FMC_TRUE), FMC_STATUS_INVALID_PARM, 
+						("FM_RX_UnsubscribeSignalMonitor: No subscription"));
+
+	_FM_RX_FUNC_END_AND_UNLOCK_ENABLED();
+
+	return status;
+}
+
+/*-------------------------------------------------------------------------------
+ * FM_RX_SetSignalMonitorParams()
+ *
+ * Brief:  
+ *      Sets the sampling interval and the RSSI hysteresis of the signal monitor.
+ *
+ */
+FmRxStatus FM_RX_SetSignalMonitorParams(FmRxContext *fmContext, FMC_UINT intervalMs, FMC_UINT rssiHysteresis)
+{
+	FmRxStatus	status = FM_RX_STATUS_SUCCESS;
+
+	_FM_RX_FUNC_START_AND_LOCK_ENABLED("FM_RX_SetSignalMonitorParams");
+
+	FMC_VERIFY_ERR((fmContext == FM_RX_SM_GetContext()), FMC_STATUS_INVALID_PARM, ("FM_RX_SetSignalMonitorParams: Invalid Context Ptr"));
+	FMC_VERIFY_ERR((intervalMs >= FM_CONFIG_RX_SIGNAL_MONITOR_MIN_INTERVAL_MS), FMC_STATUS_INVALID_PARM, 
+						("FM_RX_SetSignalMonitorParams: Interval too short (%d)", intervalMs));
+
+	FM_RX_SM_SetSignalMonitorParams(intervalMs, rssiHysteresis);
+
+	_FM_RX_FUNC_END_AND_UNLOCK_ENABLED();
+
+	return status;
+}
+
 
 /*-------------------------------------------------------------------------------
  * FM_RX_ChangeAudioTarget()
@@ -34,7 +34,10 @@
 #include "mcp_bts_script_processor.h"
 #include "mcp_rom_scripts_db.h"
 #include "mcp_hal_string.h"
+#include "mcp_hal_fs.h"
+#include "mcp_hal_os.h"
 #include "mcp_unicode.h"
+#include "mcpf_services.h"
 
 #include "ccm.h"
 #include "ccm_vac.h"
@@ -100,6 +103,44 @@ typedef struct {
 
 } _FmRxCompleteScanInfo;
 
+typedef struct {
+    FMC_UINT    numOfSubscribers;
+    FMC_UINT    intervalMs;
+    FMC_UINT    rssiHysteresis;
+
+    FMC_BOOL    isAverageValid;     /* FMC_FALSE until the first sample on the tuned frequency */
+    FMC_INT     rssiAverageSum;     /* The averaged RSSI, multiplied by the number of averaged samples */
+    FMC_INT     rssiSample;         /* The RSSI read by the running sample command */
+
+    FMC_BOOL    isSlopeValid;       /* FMC_FALSE until the second sample on the tuned frequency */
+    FMC_INT     rssiSlope;          /* Change of the averaged RSSI caused by the last sample */
+    McpHalOsTimeInMs slopeTimeMs;   /* Until when the slope was followed - it is stale an interval later */
+
+    FMC_BOOL    isReportForced;     /* Report the next sample even if it did not change (new subscriber) */
+    FMC_INT     reportedRssi;
+    FMC_BOOL    reportedIsStereo;
+
+} _FmRxSignalMonitorInfo;
+
+typedef struct {
+    FMC_UINT    suspendTimeMs;      /* Time after a low RSSI before another AF switch may be attempted */
+    FMC_UINT    maxSuspendTimeMs;   /* The longest suspension after failed attempts */
+    FMC_UINT    recoveryRssiSlope;  /* Averaged RSSI rise that suppresses an attempt. 0 - never suppress */
+
+    FMC_UINT    curSuspendTimeMs;   /* Doubled after each attempt that exhausted the AF list */
+    FMC_BOOL    isSuspended;        /* The suspension timer runs - the RSSI trend is followed */
+
+} _FmRxAfPolicyInfo;
+
+/* No preset was selected since the presets list was set */
+#define FM_RX_SM_NO_PRESET  ((FMC_UINT)0xFFFFFFFF)
+
+typedef struct {
+    FmcFreq     presets[FM_CONFIG_RX_MAX_NUM_OF_PRESETS];
+    FMC_UINT    numOfPresets;
+    FMC_UINT    currentPreset;
+} _FmRxPresetsInfo;
+
 typedef struct _tagFmRxSmData {
     /*Parameters/State currently set in FM RX*/
     /****************************/
@@ -133,6 +174,7 @@ typedef struct _tagFmRxSmData {
     /*ASIC ID/Version are used to define the fm init script that should be loaded*/
     FMC_U16 fmAsicId;
     FMC_U16 fmAsicVersion;
+    FMC_BOOL isAsicIdRead;  /* ASIC ID/Version were read by a previous enable */
     /****************************/
     FmRxContext         context;
     /****************************/
@@ -155,10 +197,41 @@ typedef struct _tagFmRxSmData {
 
  /*Info related to Complete Scan*/
     _FmRxCompleteScanInfo               completeScanOp;
+
+ /*Info related to the signal monitor*/
+    _FmRxSignalMonitorInfo              signalMonitor;
+
+ /*Info related to the AF switch policy*/
+    _FmRxAfPolicyInfo                   afPolicy;
+
+    _FmRxPresetsInfo                    presetsInfo;
+
+    /* The previous tune read the flag and kept the FR interrupt for the tune that follows it */
+    FMC_BOOL                            isTuneChained;
+
+    /* Number of commands completed while a long operation was running, since RX was enabled */
+    FMC_UINT                            numOfCmdsRunAhead;
+
+    /* The running command was asked to stop - by the application or by a command that supersedes it */
+    FMC_BOOL                            isCurrCmdStopping;
     
 } _FmRxSmData;
 FMC_STATIC _FmRxSmData  _fmRxSmData;
 
+/* Init scripts read while the FM wakes up, according to the ASIC ID/Version of the previous enable */
+#define FM_RX_SM_PREFETCH_FMC_INIT_SCRIPT       (0)
+#define FM_RX_SM_PREFETCH_RX_INIT_SCRIPT        (1)
+#define FM_RX_SM_NUM_OF_PREFETCHED_SCRIPTS      (2)
+
+typedef struct {
+    FMC_U16     asicId;
+    FMC_U16     asicVersion;
+    McpUint     size;
+    McpU8       *data;              /* Allocated only until the power on ends. NULL - not prefetched */
+} _FmRxPrefetchedScript;
+
+FMC_STATIC _FmRxPrefetchedScript _fmRxPrefetchedScripts[FM_RX_SM_NUM_OF_PREFETCHED_SCRIPTS];
+
 
 FMC_BOOL  fmRxSendDisableEventToApp = FMC_TRUE;
 
@@ -231,6 +304,9 @@ FMC_STATIC void _FmRxSmHandleGenInterrupts(void);
 
 FMC_STATIC void _FM_RX_SM_ResetStationParams(FMC_U32 freq);
 
+FMC_STATIC FMC_BOOL _FM_RX_SM_IsFreqInBand(FMC_U32 freq);
+FMC_STATIC FMC_BOOL _FM_RX_SM_IsNextCmdTuneInBand(void);
+
 FMC_STATIC void _FM_RX_SM_InitCmdsTable(void);
 FMC_STATIC void _FM_RX_SM_ResetRdsData(void);
 
@@ -249,6 +325,7 @@ FMC_STATIC void send_fm_event_most_mode_changed(FMC_U8 mode);
 FMC_STATIC void send_fm_event_pty_changed(FmcRdsPtyCode ptyCode);
 FMC_STATIC void send_fm_event_pi_changed(FmcRdsPiCode piCode);
 FMC_STATIC void send_fm_event_raw_rds(FMC_U16 len, FMC_U8 *data,FmcRdsGroupTypeMask gType);
+FMC_STATIC void send_fm_event_signal_quality_changed(FMC_INT rssi, FMC_BOOL isStereo);
 
 
 /* Handlers prototypes */
@@ -531,6 +608,9 @@ FMC_STATIC void HandleHwMalStartFinish(void);
 
 FMC_STATIC void HandleTimeoutStart(void);
 FMC_STATIC void HandleTimeoutFinish(void);
+FMC_STATIC void HandleSampleSignalStart(void);
+FMC_STATIC void HandleSampleSignalReadStereo(void);
+FMC_STATIC void HandleSampleSignalFinish(void);
 /*******************************************************************************************************************
  *                  
  *******************************************************************************************************************/
@@ -563,8 +643,25 @@ FMC_STATIC void HandleGetAudioRoutingModeStartEnd(void);
  *******************************************************************************************************************/
 FMC_STATIC void _FM_RX_SM_Process(void);
 FMC_STATIC void _FM_RX_SM_Timer_Process(void);
+FMC_STATIC void _FM_RX_SM_MonitorTimer_Process(void);
+FMC_STATIC void _FM_RX_SM_ArmSignalMonitor(void);
+FMC_STATIC void _FM_RX_SM_UpdateSignalMonitor(FMC_INT rssi, FMC_BOOL isStereo);
+FMC_STATIC FMC_BOOL _FM_RX_SM_IsSignalMonitorActive(void);
+FMC_STATIC FMC_BOOL _FM_RX_SM_IsSignalRecovering(void);
+FMC_STATIC void _FM_RX_SM_BackOffAfSwitch(void);
+FMC_STATIC void _FM_RX_SM_StartAfSuspension(void);
+FMC_STATIC void _FM_RX_SM_EndAfSuspension(void);
+FMC_STATIC void _FM_RX_SM_PrefetchScript(FMC_UINT scriptIndex, const char *scriptName);
+FMC_STATIC void _FM_RX_SM_GetPrefetchedScript(FMC_UINT scriptIndex, McpBtsSpScriptLocation *scriptLocation);
+FMC_STATIC void _FM_RX_SM_FreePrefetchedScript(FMC_UINT scriptIndex);
+FMC_STATIC FMC_BOOL _FM_RX_SM_AddInternalCmdIfNotPending(FmRxCmdType cmdType);
 FMC_STATIC void _FM_RX_SM_Interrupts_Process(void);
 FMC_STATIC void _FM_RX_SM_Commands_Process(void);
+FMC_STATIC void _FM_RX_SM_RunHostCmdsAhead(void);
+FMC_STATIC FMC_BOOL _FM_RX_SM_IsLongRunningCmd(FmRxCmdType cmdType);
+FMC_STATIC FMC_BOOL _FM_RX_SM_IsHostOnlyCmd(FmRxCmdType cmdType);
+FMC_STATIC void _FM_RX_SM_PreemptIfSuperseded(void);
+FMC_STATIC FMC_BOOL _FM_RX_SM_IsSupersedingCmd(FmRxCmdType cmdType);
 FMC_STATIC void _FM_RX_SM_Events_Process(void);
 /*******************************************************************************************************************
  *                  
@@ -891,6 +988,12 @@ FMC_STATIC FmRxOpCurHandler timeoutHandler[] = {HandleTimeoutStart,
                                                        HandleTimeoutFinish};
 FMC_STATIC _FmRxSmCmdInfo _fmRxSmCmdInfo_timeoutHandler = {timeoutHandler, 
                                                         sizeof(timeoutHandler) / sizeof(FmRxOpCurHandler)};
+/* Handlers for FM_RX_INTERNAL_SAMPLE_SIGNAL */
+FMC_STATIC FmRxOpCurHandler sampleSignalHandler[] = {HandleSampleSignalStart,
+                                                       HandleSampleSignalReadStereo,
+                                                       HandleSampleSignalFinish};
+FMC_STATIC _FmRxSmCmdInfo _fmRxSmCmdInfo_sampleSignalHandler = {sampleSignalHandler, 
+                                                        sizeof(sampleSignalHandler) / sizeof(FmRxOpCurHandler)};
 
 /* Handlers for Get Tuned Freq */
 FMC_STATIC FmRxOpCurHandler getTunedFreqHandler[] = {HandleGetTunedFreqStart,
@@ -1017,6 +1120,7 @@ FMC_STATIC void _FM_RX_SM_InitCmdsTable(void)
     fmOpAllHandlersArray[FM_RX_INTERNAL_HANDLE_STEREO_CHANGE] = _fmRxSmCmdInfo_stereoChangedHandler;
     fmOpAllHandlersArray[FM_RX_INTERNAL_HANDLE_HW_MAL] = _fmRxSmCmdInfo_hwMalHandler;
     fmOpAllHandlersArray[FM_RX_INTERNAL_HANDLE_TIMEOUT] = _fmRxSmCmdInfo_timeoutHandler;
+    fmOpAllHandlersArray[FM_RX_INTERNAL_SAMPLE_SIGNAL] = _fmRxSmCmdInfo_sampleSignalHandler;
     
 }
 
@@ -1037,6 +1141,29 @@ FMC_STATIC void _FM_RX_SM_InitDefualtValues(void)
     /* Initialize mute variables */
     _fmRxSmData.fmRxReadState = FM_RX_NONE;
 
+    _fmRxSmData.signalMonitor.numOfSubscribers = 0;
+    _fmRxSmData.signalMonitor.intervalMs = FM_CONFIG_RX_SIGNAL_MONITOR_INTERVAL_MS;
+    _fmRxSmData.signalMonitor.rssiHysteresis = FM_CONFIG_RX_SIGNAL_MONITOR_RSSI_HYSTERESIS;
+
+    _fmRxSmData.afPolicy.suspendTimeMs = FM_CONFIG_RX_AF_TIMER_MS;
+    _fmRxSmData.afPolicy.maxSuspendTimeMs = FM_CONFIG_RX_AF_MAX_TIMER_MS;
+    _fmRxSmData.afPolicy.recoveryRssiSlope = FM_CONFIG_RX_AF_RECOVERY_RSSI_SLOPE;
+    _fmRxSmData.afPolicy.curSuspendTimeMs = FM_CONFIG_RX_AF_TIMER_MS;
+    _fmRxSmData.afPolicy.isSuspended = FMC_FALSE;
+
+    _fmRxSmData.presetsInfo.numOfPresets = 0;
+    _fmRxSmData.presetsInfo.currentPreset = FM_RX_SM_NO_PRESET;
+
+    _fmRxSmData.isTuneChained = FMC_FALSE;
+
+    _fmRxSmData.numOfCmdsRunAhead = 0;
+
+    _fmRxSmData.isCurrCmdStopping = FMC_FALSE;
+
+    _fmRxSmData.isAsicIdRead = FMC_FALSE;
+    _fmRxPrefetchedScripts[FM_RX_SM_PREFETCH_FMC_INIT_SCRIPT].data = NULL;
+    _fmRxPrefetchedScripts[FM_RX_SM_PREFETCH_RX_INIT_SCRIPT].data = NULL;
+
     _fmRxSmData.band = FMC_CONFIG_RX_BAND;
     _fmRxSmData.tunedFreq = FMC_UNDEFINED_FREQ;
     _fmRxSmData.volume = FMC_FW_RX_FM_VOLUMN_INITIAL_VALUE/FMC_FW_RX_FM_GAIN_STEP;
@@ -1065,10 +1192,19 @@ FMC_STATIC void _FM_RX_SM_ResetStationParams(FMC_U32 freq)
 {
     /*Was intiated when Low RSSI interrupt was recieved*/
     FMCI_OS_CancelTimer();
+    _FM_RX_SM_EndAfSuspension();
     
     _fmRxSmData.tunedFreq= freq;
     _FM_RX_SM_ResetRdsData();
 
+    /* Do not average the RSSI of the new frequency with the RSSI of the previous one, nor judge
+       its first low RSSI by the trend of the previous one */
+    _fmRxSmData.signalMonitor.isAverageValid = FMC_FALSE;
+    _fmRxSmData.signalMonitor.isSlopeValid = FMC_FALSE;
+
+    /* Failed AF switches of the previous frequency do not delay switches of the new one */
+    _fmRxSmData.afPolicy.curSuspendTimeMs = _fmRxSmData.afPolicy.suspendTimeMs;
+
     /* If AF feature is on, enable low level RSSI interrupt in global parameter */
     if(FMC_TRUE == _fmRxSmData.afMode)
     {
@@ -1210,6 +1346,106 @@ void FM_RX_SM_SetUpperEvent(FMC_U8 upperEvt)
 {
     _fmRxSmData.upperEvent = upperEvt; 
 }
+void FM_RX_SM_GetCachedState(FmRxCachedState *state)
+{
+    state->band = _fmRxSmData.band;
+    state->volume = _fmRxSmData.volume;
+    state->muteMode = _fmRxSmData.muteMode;
+    state->rfDependentMuteMode = _fmRxSmData.rfDependedMute;
+    state->rssiThreshold = _fmRxSmData.rssiThreshold;
+    state->deEmphasisFilter = _fmRxSmData.deemphasisFilter;
+    state->rdsSystem = _fmRxSmData.rdsRdbsSystem;
+    state->rdsGroupMask = _fmRxSmData.rdsGroupMask;
+    state->afSwitchMode = _fmRxSmData.afMode;
+}
+void FM_RX_SM_SubscribeSignalMonitor(void)
+{
+    _fmRxSmData.signalMonitor.numOfSubscribers++;
+    _fmRxSmData.signalMonitor.isReportForced = FMC_TRUE;
+
+    /* Take the first sample now, the next ones are taken every interval */
+    _FM_RX_SM_MonitorTimer_Process();
+}
+FMC_BOOL FM_RX_SM_UnsubscribeSignalMonitor(void)
+{
+    if (_fmRxSmData.signalMonitor.numOfSubscribers == 0)
+    {
+        return FMC_FALSE;
+    }
+
+    _fmRxSmData.signalMonitor.numOfSubscribers--;
+
+    if (_FM_RX_SM_IsSignalMonitorActive() == FMC_FALSE)
+    {
+        FMCI_OS_CancelMonitorTimer();
+    }
+
+    return FMC_TRUE;
+}
+void FM_RX_SM_SetSignalMonitorParams(FMC_UINT intervalMs, FMC_UINT rssiHysteresis)
+{
+    _fmRxSmData.signalMonitor.intervalMs = intervalMs;
+    _fmRxSmData.signalMonitor.rssiHysteresis = rssiHysteresis;
+
+    _FM_RX_SM_ArmSignalMonitor();
+}
+void FM_RX_SM_SetAfSwitchParams(FMC_UINT suspendTimeMs, FMC_UINT maxSuspendTimeMs, FMC_UINT recoveryRssiSlope)
+{
+    _fmRxSmData.afPolicy.suspendTimeMs = suspendTimeMs;
+    _fmRxSmData.afPolicy.maxSuspendTimeMs = maxSuspendTimeMs;
+    _fmRxSmData.afPolicy.recoveryRssiSlope = recoveryRssiSlope;
+    _fmRxSmData.afPolicy.curSuspendTimeMs = suspendTimeMs;
+
+    /* The RSSI is sampled for the AF switching only when it may suppress a switch */
+    if (_FM_RX_SM_IsSignalMonitorActive() == FMC_TRUE)
+    {
+        _FM_RX_SM_ArmSignalMonitor();
+    }
+    else
+    {
+        FMCI_OS_CancelMonitorTimer();
+    }
+}
+void FM_RX_SM_SetPresets(FMC_UINT numOfPresets, const FmcFreq *presets)
+{
+    if (numOfPresets > 0)
+    {
+        FMC_OS_MemCopy(_fmRxSmData.presetsInfo.presets, presets, numOfPresets * sizeof(FmcFreq));
+    }
+
+    _fmRxSmData.presetsInfo.numOfPresets = numOfPresets;
+    _fmRxSmData.presetsInfo.currentPreset = FM_RX_SM_NO_PRESET;
+}
+FMC_BOOL FM_RX_SM_GetNextPreset(FmRxSeekDirection direction, FMC_UINT *index, FmcFreq *freq)
+{
+    _FmRxPresetsInfo    *presetsInfo = &_fmRxSmData.presetsInfo;
+
+    if (presetsInfo->numOfPresets == 0)
+    {
+        return FMC_FALSE;
+    }
+
+    if (presetsInfo->currentPreset == FM_RX_SM_NO_PRESET)
+    {
+        *index = ((direction == FM_RX_SEEK_DIRECTION_UP) ? 0 : (presetsInfo->numOfPresets - 1));
+    }
+    else if (direction == FM_RX_SEEK_DIRECTION_UP)
+    {
+        *index = (presetsInfo->currentPreset + 1) % presetsInfo->numOfPresets;
+    }
+    else
+    {
+        *index = ((presetsInfo->currentPreset == 0) ? (presetsInfo->numOfPresets - 1) : (presetsInfo->currentPreset - 1));
+    }
+
+    *freq = presetsInfo->presets[*index];
+
+    return FMC_TRUE;
+}
+void FM_RX_SM_SetCurrentPreset(FMC_UINT index)
+{
+    _fmRxSmData.presetsInfo.currentPreset = index;
+}
 
 
 /*
@@ -1259,6 +1495,10 @@ void Fm_Rx_Stack_EventCallback(FmcOsEvent evtMask)
     {
         _FM_RX_SM_Timer_Process();
     }
+    if (evtMask & FMC_OS_EVENT_FMC_MONITOR_TIMER_EXPIRED)
+    {
+        _FM_RX_SM_MonitorTimer_Process();
+    }
 }
 
 FMC_STATIC void _FM_RX_SM_Process(void)
@@ -1391,6 +1631,7 @@ FMC_STATIC void _FM_RX_SM_Commands_Process(void)
             
             _fmRxSmData.currCmdInfo.stageIndex = 0;
             _fmRxSmData.currCmdInfo.status = FM_RX_STATUS_SUCCESS;
+            _fmRxSmData.isCurrCmdStopping = FMC_FALSE;
             /* We copy the param in order to allow the application to send another 
                command of the same type without overriding the current performed operation */
         
@@ -1399,6 +1640,208 @@ FMC_STATIC void _FM_RX_SM_Commands_Process(void)
                 fmOpAllHandlersArray[_fmRxSmData.currCmdInfo.baseCmd->cmdType].opHandlerArray[_fmRxSmData.currCmdInfo.stageIndex]();
         }
     }
+    else
+    {
+        /* A command waiting in the queue may make the current one pointless - stop it */
+        _FM_RX_SM_PreemptIfSuperseded();
+
+        /* The current command waits for an interrupt - serve what does not need the chip meanwhile */
+        if (_fmRxSmData.currCmdInfo.smState == _FM_RX_SM_STATE_NONE)
+        {
+            _FM_RX_SM_RunHostCmdsAhead();
+        }
+    }
+}
+
+/*---------------------------------------------------------------------------
+ *            _FM_RX_SM_PreemptIfSuperseded()
+ *---------------------------------------------------------------------------
+ *
+ * Synopsis:  If a command that supersedes the running seek, complete scan or 
+ *            AF jump is waiting in the queue, ask the running one to stop at 
+ *            its next safe stage, so the new command starts right after it. 
+ *            Seek and complete scan are stopped the same way the application 
+ *            stops them, and complete with their "stopped" status. An AF jump 
+ *            has no stop command - it gives up before trying the next AF 
+ *            frequency.
+ *
+ * Return:    void
+ */
+FMC_STATIC void _FM_RX_SM_PreemptIfSuperseded(void)
+{
+    FmRxCmdType     runningCmdType = _fmRxSmData.currCmdInfo.baseCmd->cmdType;
+    FMC_ListNode    *node;
+
+    /* Already stopping, or an upper event is still waiting to be handled */
+    if ((_fmRxSmData.isCurrCmdStopping == FMC_TRUE) ||
+        (_fmRxSmData.upperEvent != FM_RX_SM_UPPER_EVENT_NONE) ||
+        (_fmRxSmData.upperEventWait == FMC_TRUE))
+    {
+        return;
+    }
+
+    /* Complete scan can only be stopped once the scan itself runs in the chip */
+    if ((runningCmdType == FM_RX_CMD_COMPLETE_SCAN) &&
+        (_fmRxSmData.currCmdInfo.smState != _FM_RX_SM_STATE_NONE))
+    {
+        return;
+    }
+
+    if ((runningCmdType != FM_RX_CMD_SEEK) &&
+        (runningCmdType != FM_RX_CMD_COMPLETE_SCAN) &&
+        (runningCmdType != FM_RX_INTERNAL_HANDLE_AF_JUMP))
+    {
+        return;
+    }
+
+    for (node = _fmRxSmData.currCmdInfo.baseCmd->node.NextNode; 
+         node != FMCI_GetCmdsQueue(); 
+         node = node->NextNode)
+    {
+        if (_FM_RX_SM_IsSupersedingCmd(((FmcBaseCmd *)node)->cmdType) == FMC_TRUE)
+        {
+            break;
+        }
+    }
+
+    if (node == FMCI_GetCmdsQueue())
+    {
+        return;
+    }
+
+    FMC_LOG_INFO(("_FM_RX_SM_PreemptIfSuperseded: Stopping cmd %d, superseded by cmd %d", 
+                    runningCmdType, ((FmcBaseCmd *)node)->cmdType));
+
+    if (runningCmdType == FM_RX_CMD_SEEK)
+    {
+        FM_RX_SM_SetUpperEvent(FM_RX_SM_UPPER_EVENT_STOP_SEEK);
+        FMCI_NotifyFmTask(FMC_OS_EVENT_FMC_STACK_TASK_PROCESS);
+    }
+    else if (runningCmdType == FM_RX_CMD_COMPLETE_SCAN)
+    {
+        FM_RX_SM_SetUpperEvent(FM_RX_SM_UPPER_EVENT_STOP_COMPLETE_SCAN);
+        FMCI_NotifyFmTask(FMC_OS_EVENT_FMC_STACK_TASK_PROCESS);
+    }
+    else
+    {
+        /* Checked by HandleAfJumpFinished() */
+        _fmRxSmData.isCurrCmdStopping = FMC_TRUE;
+    }
+}
+
+/*
+    Commands that make a running seek, complete scan or AF jump pointless, as they change the
+    tuned frequency anyway.
+*/
+FMC_STATIC FMC_BOOL _FM_RX_SM_IsSupersedingCmd(FmRxCmdType cmdType)
+{
+    switch (cmdType)
+    {
+        case FM_RX_CMD_TUNE:
+        case FM_RX_CMD_SEEK:
+            return FMC_TRUE;
+
+        default:
+            return FMC_FALSE;
+    }
+}
+
+/*---------------------------------------------------------------------------
+ *            _FM_RX_SM_RunHostCmdsAhead()
+ *---------------------------------------------------------------------------
+ *
+ * Synopsis:  While a long operation runs, complete the commands queued right 
+ *            behind it that are served from host memory, instead of holding 
+ *            them until the operation ends. Only commands that directly follow
+ *            the running one are taken, so no command overtakes another 
+ *            command that is still waiting.
+ *
+ * Return:    void
+ */
+FMC_STATIC void _FM_RX_SM_RunHostCmdsAhead(void)
+{
+    _FmRxSmCurrCmdInfo  runningCmdInfo;
+    FmRxEvent           runningCmdAppEvent;
+    FMC_ListNode        *nextNode;
+    FmRxCmdType         nextCmdType;
+
+    if (_FM_RX_SM_IsLongRunningCmd(_fmRxSmData.currCmdInfo.baseCmd->cmdType) == FMC_FALSE)
+    {
+        return;
+    }
+
+    /* The running command may keep data for its completion event in the application event */
+    runningCmdInfo = _fmRxSmData.currCmdInfo;
+    runningCmdAppEvent = _fmRxSmData.context.appEvent;
+
+    nextNode = runningCmdInfo.baseCmd->node.NextNode;
+
+    while (nextNode != FMCI_GetCmdsQueue())
+    {
+        nextCmdType = ((FmcBaseCmd *)nextNode)->cmdType;
+
+        if (_FM_RX_SM_IsHostOnlyCmd(nextCmdType) == FMC_FALSE)
+        {
+            break;
+        }
+
+        _fmRxSmData.currCmdInfo.baseCmd = (FmcBaseCmd *)nextNode;
+        _fmRxSmData.currCmdInfo.stageIndex = 0;
+        _fmRxSmData.currCmdInfo.status = FM_RX_STATUS_SUCCESS;
+        _fmRxSmData.currCmdInfo.smState = _FM_RX_SM_STATE_NONE;
+
+        /* Host-only handlers have a single stage that completes the command and frees it */
+        fmOpAllHandlersArray[nextCmdType].opHandlerArray[0]();
+
+        _fmRxSmData.numOfCmdsRunAhead++;
+
+        nextNode = runningCmdInfo.baseCmd->node.NextNode;
+    }
+
+    _fmRxSmData.currCmdInfo = runningCmdInfo;
+    _fmRxSmData.context.appEvent = runningCmdAppEvent;
+}
+
+/*
+    Operations that wait for the chip for a long time, and do not change the values the host-only 
+    commands return.
+*/
+FMC_STATIC FMC_BOOL _FM_RX_SM_IsLongRunningCmd(FmRxCmdType cmdType)
+{
+    switch (cmdType)
+    {
+        case FM_RX_CMD_TUNE:
+        case FM_RX_CMD_SEEK:
+        case FM_RX_CMD_COMPLETE_SCAN:
+        case FM_RX_INTERNAL_HANDLE_AF_JUMP:
+            return FMC_TRUE;
+
+        default:
+            return FMC_FALSE;
+    }
+}
+
+/*
+    Commands that return a value kept in host memory, without sending anything to the chip.
+*/
+FMC_STATIC FMC_BOOL _FM_RX_SM_IsHostOnlyCmd(FmRxCmdType cmdType)
+{
+    switch (cmdType)
+    {
+        case FM_RX_CMD_GET_BAND:
+        case FM_RX_CMD_GET_MUTE_MODE:
+        case FM_RX_CMD_GET_RF_DEPENDENT_MUTE_MODE:
+        case FM_RX_CMD_GET_RSSI_THRESHOLD:
+        case FM_RX_CMD_GET_DEEMPHASIS_FILTER:
+        case FM_RX_CMD_GET_VOLUME:
+        case FM_RX_CMD_GET_RDS_SYSTEM:
+        case FM_RX_CMD_GET_RDS_GROUP_MASK:
+        case FM_RX_CMD_GET_RDS_AF_SWITCH_MODE:
+            return FMC_TRUE;
+
+        default:
+            return FMC_FALSE;
+    }
 }
 
 /* Handle received interrupts: Read the flag and mask in order to figure
@@ -1438,7 +1881,8 @@ FMC_STATIC FMC_BOOL checkUpperEvent(void)
     switch(_fmRxSmData.upperEvent) 
     {
         case FM_RX_SM_UPPER_EVENT_STOP_SEEK:
-            if((_fmRxSmData.currCmdInfo.baseCmd!= NULL) && (_fmRxSmData.currCmdInfo.baseCmd->cmdType == FM_RX_CMD_SEEK))
+            if((_fmRxSmData.currCmdInfo.baseCmd!= NULL) && (_fmRxSmData.currCmdInfo.baseCmd->cmdType == FM_RX_CMD_SEEK) &&
+                (_fmRxSmData.isCurrCmdStopping == FMC_FALSE))
                 return FMC_TRUE;
             else
                 return FMC_FALSE;
@@ -1449,7 +1893,8 @@ FMC_STATIC FMC_BOOL checkUpperEvent(void)
                 return FMC_FALSE;
 
         case FM_RX_SM_UPPER_EVENT_STOP_COMPLETE_SCAN:
-            if((_fmRxSmData.currCmdInfo.baseCmd!= NULL) && (_fmRxSmData.currCmdInfo.baseCmd->cmdType == FM_RX_CMD_COMPLETE_SCAN))
+            if((_fmRxSmData.currCmdInfo.baseCmd!= NULL) && (_fmRxSmData.currCmdInfo.baseCmd->cmdType == FM_RX_CMD_COMPLETE_SCAN) &&
+                (_fmRxSmData.isCurrCmdStopping == FMC_FALSE))
                 return FMC_TRUE;
             else
                 return FMC_FALSE;
@@ -1468,25 +1913,142 @@ FMC_STATIC FMC_BOOL checkUpperEvent(void)
  */
 FMC_STATIC void _FM_RX_SM_Timer_Process(void)
 {
-    FmRxGenCmd * timeout = NULL;
     FMC_LOG_INFO(("AF suspension timeout finished"));
 
-    /* Check if the command is not already waiting in the queue */
-    if(FM_RX_SM_IsCmdPending(FM_RX_INTERNAL_HANDLE_TIMEOUT))
+    /* Add the command unless it is already waiting in the queue */
+    if (_FM_RX_SM_AddInternalCmdIfNotPending(FM_RX_INTERNAL_HANDLE_TIMEOUT) == FMC_FALSE)
     {
         FMC_LOG_INFO(("Timeout operation is already pending"));
     }
     else
     {
+        /* Notify FM stack about the operation */
+        FMCI_NotifyFmTask(FMC_OS_EVENT_FMC_STACK_TASK_PROCESS);
+    }
+}
+/*---------------------------------------------------------------------------
+ *            _FM_RX_SM_MonitorTimer_Process()
+ *---------------------------------------------------------------------------
+ *
+ * Synopsis:  Queue a signal sample, unless the monitor has no subscribers
+ *            and the AF switching does not follow the RSSI trend.
+ *            No sample is taken while the receiver is moving between
+ *            frequencies (seek / complete scan).
+ *
+ * Return:    void
+ */
+FMC_STATIC void _FM_RX_SM_MonitorTimer_Process(void)
+{
+    FmRxCmdType runningCmd;
 
-        /* Lock the stack when inserting the operation into the queue */
-        FM_RX_SM_AllocateCmdAndAddToQueue(&_fmRxSmData.context,
-                                                FM_RX_INTERNAL_HANDLE_TIMEOUT,
-                                                (FmcBaseCmd **)&timeout);
+    if (_FM_RX_SM_IsSignalMonitorActive() == FMC_FALSE)
+    {
+        return;
+    }
 
-        /* Notify FM stack about the operation */
+    runningCmd = FM_RX_SM_GetRunningCmd();
+
+    if ((runningCmd == FM_RX_CMD_SEEK) || 
+        (runningCmd == FM_RX_CMD_COMPLETE_SCAN) ||
+        (_fmRxSmData.tunedFreq == FMC_UNDEFINED_FREQ))
+    {
+        _FM_RX_SM_ArmSignalMonitor();
+    }
+    /* If a sample is already pending it re-arms the timer when it finishes */
+    else if (_FM_RX_SM_AddInternalCmdIfNotPending(FM_RX_INTERNAL_SAMPLE_SIGNAL) == FMC_TRUE)
+    {
         FMCI_NotifyFmTask(FMC_OS_EVENT_FMC_STACK_TASK_PROCESS);
     }
+    else if (FM_RX_SM_IsCmdPending(FM_RX_INTERNAL_SAMPLE_SIGNAL) == FMC_FALSE)
+    {
+        /* The queue is full - try again on the next interval */
+        _FM_RX_SM_ArmSignalMonitor();
+    }
+}
+
+FMC_STATIC void _FM_RX_SM_ArmSignalMonitor(void)
+{
+    if (_FM_RX_SM_IsSignalMonitorActive() == FMC_TRUE)
+    {
+        FMCI_OS_ResetMonitorTimer(FMC_OS_MS_TO_TICKS(_fmRxSmData.signalMonitor.intervalMs));
+    }
+}
+
+/*
+    The signal is sampled while the application is subscribed, or during the AF suspension
+    after a low RSSI, when the RSSI trend may suppress the next AF switch.
+*/
+FMC_STATIC FMC_BOOL _FM_RX_SM_IsSignalMonitorActive(void)
+{
+    if (_fmRxSmData.context.state != FM_RX_SM_CONTEXT_STATE_ENABLED)
+    {
+        return FMC_FALSE;
+    }
+
+    if (_fmRxSmData.signalMonitor.numOfSubscribers > 0)
+    {
+        return FMC_TRUE;
+    }
+
+    if ((_fmRxSmData.afMode == FM_RX_RDS_AF_SWITCH_MODE_ON) && 
+        (_fmRxSmData.afPolicy.recoveryRssiSlope > 0) &&
+        (_fmRxSmData.afPolicy.isSuspended == FMC_TRUE))
+    {
+        return FMC_TRUE;
+    }
+
+    return FMC_FALSE;
+}
+
+/*
+    Adds a sample to the RSSI average, and reports the signal quality when the average moved
+    by at least the hysteresis from the last reported value, or when the stereo status changed.
+*/
+FMC_STATIC void _FM_RX_SM_UpdateSignalMonitor(FMC_INT rssi, FMC_BOOL isStereo)
+{
+    _FmRxSignalMonitorInfo  *monitor = &_fmRxSmData.signalMonitor;
+    FMC_INT                 average;
+    FMC_INT                 prevAverage;
+    FMC_UINT                change;
+
+    if (monitor->isAverageValid == FMC_FALSE)
+    {
+        monitor->rssiAverageSum = rssi * FM_CONFIG_RX_SIGNAL_MONITOR_AVERAGING_SAMPLES;
+        monitor->isAverageValid = FMC_TRUE;
+        monitor->isSlopeValid = FMC_FALSE;
+        monitor->isReportForced = FMC_TRUE;
+    }
+    else
+    {
+        prevAverage = monitor->rssiAverageSum / FM_CONFIG_RX_SIGNAL_MONITOR_AVERAGING_SAMPLES;
+        monitor->rssiAverageSum += rssi - prevAverage;
+
+        monitor->rssiSlope = (monitor->rssiAverageSum / FM_CONFIG_RX_SIGNAL_MONITOR_AVERAGING_SAMPLES) - prevAverage;
+        monitor->isSlopeValid = FMC_TRUE;
+        monitor->slopeTimeMs = MCP_HAL_OS_GetSystemTime();
+    }
+
+    /* Sampled only for the AF switching */
+    if (monitor->numOfSubscribers == 0)
+    {
+        return;
+    }
+
+    average = monitor->rssiAverageSum / FM_CONFIG_RX_SIGNAL_MONITOR_AVERAGING_SAMPLES;
+    change = (FMC_UINT)((average > monitor->reportedRssi) ? (average - monitor->reportedRssi) : (monitor->reportedRssi - average));
+
+    if ((monitor->isReportForced == FMC_FALSE) &&
+        (isStereo == monitor->reportedIsStereo) &&
+        ((change == 0) || (change < monitor->rssiHysteresis)))
+    {
+        return;
+    }
+
+    monitor->isReportForced = FMC_FALSE;
+    monitor->reportedRssi = average;
+    monitor->reportedIsStereo = isStereo;
+
+    send_fm_event_signal_quality_changed(average, isStereo);
 }
 
 
@@ -1560,22 +2122,28 @@ FMC_STATIC void _FmRxSmHandleFmInterrupt(void)
 }
 FMC_STATIC void _FmRxSmHandleGenInterrupts(void)
 {
-    FmRxGenCmd * genInterrupts = NULL;
     /* If we already have a general interrupt in the queue - no need to add another one.
        Note: This situation can happen when there is a general interrupt in the queue, then we
        start an operation with interrupt (like seek) and then after receiving the interrupt
        and enabling again the general interrupt - we will receive an interrupt again and try
        to add it to the queue */
-    if(FM_RX_SM_IsCmdPending(FM_RX_INTERNAL_HANDLE_GEN_INT))
+    if (_FM_RX_SM_AddInternalCmdIfNotPending(FM_RX_INTERNAL_HANDLE_GEN_INT) == FMC_FALSE)
     {       
         return;
     }
 
-    /* Add the general interrupts handling to the beginning of the list to generate it before other operations */
-    FM_RX_SM_AllocateCmdAndAddToQueue(&_fmRxSmData.context,
-                                            FM_RX_INTERNAL_HANDLE_GEN_INT,
-                                            (FmcBaseCmd **)&genInterrupts);
-    FMCI_NotifyFmTask(FMC_OS_EVENT_FMC_STACK_TASK_PROCESS);
+    /* If no operation is running, start handling the interrupts right away (the flag
+       was just read, so no command is waiting for a cmd complete). This saves a pass
+       of the stack task between reading the flag and sending the next command
+       (e.g. reading the RDS data) */
+    if (_fmRxSmData.currCmdInfo.baseCmd == NULL)
+    {
+        _FM_RX_SM_Commands_Process();
+    }
+    else
+    {
+        FMCI_NotifyFmTask(FMC_OS_EVENT_FMC_STACK_TASK_PROCESS);
+    }
 }
 
 
@@ -1659,9 +2227,33 @@ FMC_STATIC void HandlePowerOnWakeupFm(void)
 
 FMC_STATIC void HandlePowerOnReadAsicId(void)
 {   
+    McpHalOsTimeInMs    prefetchStartTime;
+    McpHalOsTimeInMs    prefetchDuration;
+
+    prefetchStartTime = MCP_HAL_OS_GetSystemTime();
+
+    /* Read the init scripts of the chip found by the previous enable instead of sleeping for 
+       the whole wake up time. The reads block the FM task, like the sleep they replace. The
+       scripts are verified against the ASIC ID/Version read below before they are used */
+    if (_fmRxSmData.isAsicIdRead == FMC_TRUE)
+    {
+        _FM_RX_SM_PrefetchScript(FM_RX_SM_PREFETCH_FMC_INIT_SCRIPT, FMC_CONFIG_SCRIPT_FILES_FMC_INIT_NAME);
+
+        /* Do not delay the power on beyond the wake up time */
+        if ((MCP_HAL_OS_GetSystemTime() - prefetchStartTime) < FMC_CONFIG_WAKEUP_TIMEOUT_MS)
+        {
+            _FM_RX_SM_PrefetchScript(FM_RX_SM_PREFETCH_RX_INIT_SCRIPT, FMC_CONFIG_SCRIPT_FILES_FM_RX_INIT_NAME);
+        }
+    }
+
+    prefetchDuration = MCP_HAL_OS_GetSystemTime() - prefetchStartTime;
+
     /* Must wait 20msec before starting to send commands to the FM after command
      * FMC_FW_FM_CORE_POWER_UP was sent. */
-    FMC_OS_Sleep(FMC_CONFIG_WAKEUP_TIMEOUT_MS);
+    if (prefetchDuration < FMC_CONFIG_WAKEUP_TIMEOUT_MS)
+    {
+        FMC_OS_Sleep(FMC_CONFIG_WAKEUP_TIMEOUT_MS - prefetchDuration);
+    }
 
     /* Update to next handler */
     prepareNextStage(_FM_RX_SM_STATE_WAITING_FOR_CC, INCREMENT_STAGE);
@@ -1693,6 +2285,7 @@ FMC_STATIC void HandleFmcPowerOnStartInitScript(void)
     FMC_LOG_DEBUG(("HandleFmcPowerOnStartInitScript"));
     
     _fmRxSmData.fmAsicVersion = _fmRxSmData.context.transportEventData.read_param;
+    _fmRxSmData.isAsicIdRead = FMC_TRUE;
     
     MCP_HAL_STRING_Sprintf(fileName, "%s_%x.%d.bts", 
                            FMC_CONFIG_SCRIPT_FILES_FMC_INIT_NAME,
@@ -1709,6 +2302,9 @@ FMC_STATIC void HandleFmcPowerOnStartInitScript(void)
     scriptCbData.sendHciCmdCb = _FM_RX_SM_TiSpSendHciScriptCmd;
     scriptCbData.setTranParmsCb = NULL;
     scriptCbData.execCompleteCb = _FM_RX_SM_TiSpExecuteCompleteCb;
+
+    /* Execute from memory if the script was read while the FM woke up */
+    _FM_RX_SM_GetPrefetchedScript(FM_RX_SM_PREFETCH_FMC_INIT_SCRIPT, &scriptLocation);
     
     btsSpStatus = MCP_BTS_SP_ExecuteScript(&scriptLocation, &scriptCbData, &_fmRxSmData.context.tiSpContext);
 
@@ -1801,6 +2397,9 @@ FMC_STATIC void HandleFmRxPowerOnStartInitScript(void)
     scriptCbData.sendHciCmdCb = _FM_RX_SM_TiSpSendHciScriptCmd;
     scriptCbData.setTranParmsCb = NULL;
     scriptCbData.execCompleteCb = _FM_RX_SM_TiSpExecuteCompleteCb;
+
+    /* Execute from memory if the script was read while the FM woke up */
+    _FM_RX_SM_GetPrefetchedScript(FM_RX_SM_PREFETCH_RX_INIT_SCRIPT, &scriptLocation);
     
     btsSpStatus = MCP_BTS_SP_ExecuteScript(&scriptLocation, &scriptCbData, &_fmRxSmData.context.tiSpContext);
 
@@ -1855,6 +2454,113 @@ FMC_STATIC void HandleFmRxPowerOnStartInitScript(void)
     }
 
 }
+/*
+    Reads the init script of the ASIC ID/Version found by the previous enable into a buffer 
+    allocated for it. Any failure leaves no buffer, and the script is then executed from the 
+    file system (or ROM), as if it was not prefetched.
+*/
+FMC_STATIC void _FM_RX_SM_PrefetchScript(FMC_UINT scriptIndex, const char *scriptName)
+{
+    _FmRxPrefetchedScript       *script = &_fmRxPrefetchedScripts[scriptIndex];
+    McpHalFsStat                fsStat;
+    McpHalFsFileDesc            fileDesc;
+    McpHalFsStatus              fsStatus;
+    McpU32                      numRead;
+    char                        fileName[MCP_HAL_CONFIG_FS_MAX_FILE_NAME_LEN_CHARS *
+                                         MCP_HAL_CONFIG_MAX_BYTES_IN_UTF8_CHAR];
+    McpUtf8                     scriptFullFileName[(MCP_HAL_CONFIG_FS_MAX_PATH_LEN_CHARS * MCP_HAL_CONFIG_MAX_BYTES_IN_UTF8_CHAR) + 
+					      (MCP_HAL_CONFIG_FS_MAX_FILE_NAME_LEN_CHARS * MCP_HAL_CONFIG_MAX_BYTES_IN_UTF8_CHAR)];
+
+    _FM_RX_SM_FreePrefetchedScript(scriptIndex);
+
+    MCP_HAL_STRING_Sprintf(fileName, "%s_%x.%d.bts", 
+                           scriptName,
+                           _fmRxSmData.fmAsicId,
+                           _fmRxSmData.fmAsicVersion);
+
+    MCP_StrCpyUtf8(scriptFullFileName,
+                   (const McpUtf8 *)FMC_CONFIG_SCRIPT_FILES_FULL_PATH_LOCATION);
+    MCP_StrCatUtf8(scriptFullFileName, (const McpUtf8 *)fileName);
+
+    if (MCP_HAL_FS_Stat(scriptFullFileName, &fsStat) != MCP_HAL_FS_STATUS_SUCCESS)
+    {
+        return;
+    }
+
+    if ((fsStat.size == 0) || (fsStat.size > FMC_CONFIG_SCRIPT_PREFETCH_MAX_SIZE))
+    {
+        FMC_LOG_INFO(("%s is too large to prefetch (%d bytes)", fileName, fsStat.size));
+        return;
+    }
+
+    if (MCP_HAL_FS_Open(scriptFullFileName, (MCP_HAL_FS_O_RDONLY | MCP_HAL_FS_O_BINARY), &fileDesc) != MCP_HAL_FS_STATUS_SUCCESS)
+    {
+        return;
+    }
+
+    script->data = (McpU8 *)os_memoryAlloc(NULL, fsStat.size);
+
+    if (script->data == NULL)
+    {
+        MCP_HAL_FS_Close(fileDesc);
+        return;
+    }
+
+    script->size = (McpUint)fsStat.size;
+
+    fsStatus = MCP_HAL_FS_Read(fileDesc, script->data, fsStat.size, &numRead);
+
+    MCP_HAL_FS_Close(fileDesc);
+
+    if ((fsStatus != MCP_HAL_FS_STATUS_SUCCESS) || (numRead != fsStat.size))
+    {
+        _FM_RX_SM_FreePrefetchedScript(scriptIndex);
+        return;
+    }
+
+    script->asicId = _fmRxSmData.fmAsicId;
+    script->asicVersion = _fmRxSmData.fmAsicVersion;
+
+    FMC_LOG_INFO(("Prefetched %s (%d bytes)", fileName, fsStat.size));
+}
+
+/*
+    Updates the script location to the prefetch buffer, if it holds the script of the ASIC 
+    ID/Version just read. Otherwise the location is left unchanged.
+*/
+FMC_STATIC void _FM_RX_SM_GetPrefetchedScript(FMC_UINT scriptIndex, McpBtsSpScriptLocation *scriptLocation)
+{
+    _FmRxPrefetchedScript   *script = &_fmRxPrefetchedScripts[scriptIndex];
+
+    if (script->data == NULL)
+    {
+        return;
+    }
+
+    if ((script->asicId != _fmRxSmData.fmAsicId) || (script->asicVersion != _fmRxSmData.fmAsicVersion))
+    {
+        FMC_LOG_INFO(("Prefetched script of ASIC %x.%d does not match ASIC %x.%d", 
+                        script->asicId, script->asicVersion, _fmRxSmData.fmAsicId, _fmRxSmData.fmAsicVersion));
+
+        _FM_RX_SM_FreePrefetchedScript(scriptIndex);
+        return;
+    }
+
+    scriptLocation->locationType = MCP_BTS_SP_SCRIPT_LOCATION_MEMORY;
+    scriptLocation->locationData.memoryData.address = script->data;
+    scriptLocation->locationData.memoryData.size = script->size;
+}
+
+FMC_STATIC void _FM_RX_SM_FreePrefetchedScript(FMC_UINT scriptIndex)
+{
+    _FmRxPrefetchedScript   *script = &_fmRxPrefetchedScripts[scriptIndex];
+
+    if (script->data != NULL)
+    {
+        os_memoryFree(NULL, script->data, script->size);
+        script->data = NULL;
+    }
+}
 FMC_STATIC void HandlePowerOnRxRunScript(void)
 {
 //    FMC_LOG_DEBUG(("HandlePowerOnRxRunScript"));
@@ -1904,6 +2610,10 @@ FMC_STATIC void HandlePowerOnFinish(void)
 
 FMC_STATIC void FM_FinishPowerOn(FmRxStatus status)
 {
+    /* The init scripts are no longer executed */
+    _FM_RX_SM_FreePrefetchedScript(FM_RX_SM_PREFETCH_FMC_INIT_SCRIPT);
+    _FM_RX_SM_FreePrefetchedScript(FM_RX_SM_PREFETCH_RX_INIT_SCRIPT);
+
     _fmRxSmData.currCmdInfo.status = status;
     _FM_RX_SM_HandleCompletionOfCurrCmd(NULL,NULL,NULL,FM_RX_EVENT_CMD_DONE);
     
@@ -1916,6 +2626,12 @@ FMC_STATIC void FM_FinishPowerOn(FmRxStatus status)
 FMC_STATIC void HandlePowerOffStart(void)
 {
     _fmRxSmData.interruptInfo.gen_int_mask = 0;
+    _fmRxSmData.isTuneChained = FMC_FALSE;
+
+    /* Subscriptions do not survive disabling */
+    _fmRxSmData.signalMonitor.numOfSubscribers = 0;
+    _fmRxSmData.afPolicy.isSuspended = FMC_FALSE;
+    FMCI_OS_CancelMonitorTimer();
     
     _fmRxSmData.context.state = FM_RX_SM_CONTEXT_STATE_DISABLING;    
    
@@ -1977,6 +2693,9 @@ FMC_STATIC void HandlePowerOffFinish(void)
 {
     FMC_CORE_SetCallback(NULL);
 
+    FMC_LOG_INFO(("HandlePowerOffFinish: %d commands completed during long operations", _fmRxSmData.numOfCmdsRunAhead));
+    _fmRxSmData.numOfCmdsRunAhead = 0;
+
     _FM_RX_SM_ResetStationParams(FMC_UNDEFINED_FREQ);
     /* Send event to the applicatoin */
     _fmRxSmData.context.state = FM_RX_SM_CONTEXT_STATE_DISABLED;
@@ -2227,16 +2946,9 @@ FMC_STATIC void HandleTuneSetFreq(void)
     FMC_U16 index = 0;
     FMC_U8 status = FM_RX_STATUS_SUCCESS;
 
-    if(_fmRxSmData.band== FMC_BAND_EUROPE_US)
-    {
-        if((freq < FMC_FIRST_FREQ_US_EUROPE_KHZ) || (freq > FMC_LAST_FREQ_US_EUROPE_KHZ))
-            status = FM_RX_STATUS_INVALID_PARM;
-    }
-    /* Japan band */
-    else
+    if(_FM_RX_SM_IsFreqInBand(freq) == FMC_FALSE)
     {
-        if((freq < FMC_FIRST_FREQ_JAPAN_KHZ) || (freq > FMC_LAST_FREQ_JAPAN_KHZ))
-            status = FM_RX_STATUS_INVALID_PARM;
+        status = FM_RX_STATUS_INVALID_PARM;
     }
 
     if(status == FM_RX_STATUS_INVALID_PARM)
@@ -2249,8 +2961,19 @@ FMC_STATIC void HandleTuneSetFreq(void)
     {
         /*[ToDo Zvi] the first channel should depend on the band*/
         index = FMC_UTILS_FreqToFwChannelIndex(_fmRxSmData.band,FMC_CHANNEL_SPACING_50_KHZ,freq);
-        /* Update to next handler */
-        prepareNextStage(_FM_RX_SM_STATE_WAITING_FOR_CC, INCREMENT_STAGE);
+
+        if(_fmRxSmData.isTuneChained == FMC_TRUE)
+        {
+            /* The flag was read when the previous tune finished, so there is no need to clear it.
+               The mask must still be written: the chip masks its interrupts once it raises one, 
+               so the FR interrupt of the previous tune left FR masked */
+            prepareNextStage(_FM_RX_SM_STATE_WAITING_FOR_CC, TUNE_ENABLE_INTERRUPTS_STAGE);
+        }
+        else
+        {
+            /* Update to next handler */
+            prepareNextStage(_FM_RX_SM_STATE_WAITING_FOR_CC, INCREMENT_STAGE);
+        }
 
         /* Send Set_Frequency command */    
         FMC_CORE_SendWriteCommand(FMC_FW_OPCODE_RX_FREQ_SET_GET, index);
@@ -2280,7 +3003,7 @@ FMC_STATIC void HandleTuneEnableInterrupts(void)
     if(_fmRxSmData.interruptInfo.interruptInd)
     {
         _fmRxSmData.interruptInfo.interruptInd = FMC_FALSE;
-        prepareNextStage(_FM_RX_SM_STATE_WAITING_FOR_CC, 3);/*[ToDo Zvi]*/
+        prepareNextStage(_FM_RX_SM_STATE_WAITING_FOR_CC, TUNE_ENABLE_INTERRUPTS_STAGE);
         /* Read the flag to clear status*/
     FMC_CORE_SendReadCommand(FMC_FW_OPCODE_CMN_FLAG_GET,2);
     }
@@ -2331,14 +3054,67 @@ FMC_STATIC void HandleTuneFinishedReadFreq(void)
 
 FMC_STATIC void HandleTuneFinishedEnableDefaultInts(void)
 {   
+    _fmRxSmData.interruptInfo.opHandler_int_mask = 0;
+
+    /* Another tune follows - skip restoring the default interrupts, the next tune re-enables 
+       FR anyway. The last tune in the sequence restores the default interrupts */
+    if(_FM_RX_SM_IsNextCmdTuneInBand() == FMC_TRUE)
+    {
+        _fmRxSmData.isTuneChained = FMC_TRUE;
+
+        /* The frequency read is still in read_param */
+        prepareNextStage(_FM_RX_SM_STATE_NONE, INCREMENT_STAGE);
+        fmOpAllHandlersArray[_fmRxSmData.currCmdInfo.baseCmd->cmdType].opHandlerArray[_fmRxSmData.currCmdInfo.stageIndex]();
+        return;
+    }
+
+    _fmRxSmData.isTuneChained = FMC_FALSE;
+
     /* Update to next handler */
     prepareNextStage(_FM_RX_SM_STATE_WAITING_FOR_CC, INCREMENT_STAGE);
 
-    _fmRxSmData.interruptInfo.opHandler_int_mask = 0;
     /* Disable FR and enable the default interrupts or disable all interupts acorrding to the queue */
     FMC_CORE_SendWriteCommand(FMC_FW_OPCODE_CMN_INT_MASK_SET_GET, getMask());
 
 }
+FMC_STATIC FMC_BOOL _FM_RX_SM_IsFreqInBand(FMC_U32 freq)
+{
+    if(_fmRxSmData.band== FMC_BAND_EUROPE_US)
+    {
+        return (((freq < FMC_FIRST_FREQ_US_EUROPE_KHZ) || (freq > FMC_LAST_FREQ_US_EUROPE_KHZ)) ? FMC_FALSE : FMC_TRUE);
+    }
+    /* Japan band */
+    else
+    {
+        return (((freq < FMC_FIRST_FREQ_JAPAN_KHZ) || (freq > FMC_LAST_FREQ_JAPAN_KHZ)) ? FMC_FALSE : FMC_TRUE);
+    }
+}
+
+/*
+    Returns FMC_TRUE when the command queued right after the running one is a tune to a frequency
+    of the current band (one that will actually start tuning).
+*/
+FMC_STATIC FMC_BOOL _FM_RX_SM_IsNextCmdTuneInBand(void)
+{
+    FMC_ListNode    *nextNode = _fmRxSmData.currCmdInfo.baseCmd->node.NextNode;
+    FmRxTuneCmd     *nextCmd;
+
+    /* The running command is the last one in the queue */
+    if (nextNode == FMCI_GetCmdsQueue())
+    {
+        return FMC_FALSE;
+    }
+
+    nextCmd = (FmRxTuneCmd *)nextNode;
+
+    if (nextCmd->op.cmdType != FM_RX_CMD_TUNE)
+    {
+        return FMC_FALSE;
+    }
+
+    return _FM_RX_SM_IsFreqInBand((FMC_U32)nextCmd->freq);
+}
+
 FMC_STATIC void HandleTuneFinish(void)
 {   
     FMC_U32 freq;
@@ -2414,6 +3190,9 @@ FMC_STATIC void HandleSeekMain(void)
     /* If an upper event was received update the handler to stop seek */
     else if(_fmRxSmData.callReason == FM_RX_SM_CALL_REASON_UPPER_EVT) 
     {
+        /* A seek is stopped only once */
+        _fmRxSmData.isCurrCmdStopping = FMC_TRUE;
+
         /* The seek is already finished - just finish the operation
             Call the next seek stage with cmd complete because upper
             event always wait for the cmd complete event */
@@ -2679,6 +3458,8 @@ FMC_STATIC void HandleSetAFStart(void)
         /* Update global parameter gen_int_mask to disable low rssi interrupt */
         _fmRxSmData.interruptInfo.gen_int_mask &= ~(FMC_FW_MASK_LEV);
         _fmRxSmData.afMode = FM_RX_RDS_AF_SWITCH_MODE_OFF;
+
+        _FM_RX_SM_EndAfSuspension();
     }
 
     /* Enable the interrupts  acorrding to the queue*/
@@ -2922,6 +3703,8 @@ FMC_STATIC void HandleCompleteScanMain(void)
    /*If we got Stop Complete Scan in the middle of the operation change the handler to the correct one*/ 
       else if( _fmRxSmData.upperEvent==FM_RX_SM_UPPER_EVENT_STOP_COMPLETE_SCAN)
         {         
+            /* A complete scan is stopped only once */
+            _fmRxSmData.isCurrCmdStopping = FMC_TRUE;
             _fmRxSmData.completeScanOp.curStage = 0; 
             handlerArray = stopCompleteScanHandler;
         }        
@@ -3633,19 +4416,27 @@ FMC_STATIC void HandleGenIntRds(void)
 FMC_STATIC void HandleGenIntLowRssi(void)
 {
     FMC_BOOL go_to_next = FMC_FALSE;
+    FMC_BOOL isRecovering;
     FmcStatus status;
     
     /* If low RSSI interrupt occurred  */
     if(_fmRxSmData.interruptInfo.genIntSetBits & _fmRxSmData.interruptInfo.gen_int_mask & FMC_FW_MASK_LEV)
     {
-        status = FMCI_OS_ResetTimer(FMC_OS_MS_TO_TICKS(FM_CONFIG_RX_AF_TIMER_MS)) ;                             
+        /* The trend of the previous suspension judges this low RSSI only */
+        isRecovering = _FM_RX_SM_IsSignalRecovering();
+        _fmRxSmData.signalMonitor.isSlopeValid = FMC_FALSE;
+
+        status = FMCI_OS_ResetTimer(FMC_OS_MS_TO_TICKS(_fmRxSmData.afPolicy.curSuspendTimeMs)) ;                             
         FMC_ASSERT(status == FMC_STATUS_SUCCESS);
+
+        /* Follow the RSSI trend until the suspension ends, for the next low RSSI */
+        _FM_RX_SM_StartAfSuspension();
             
         /* Update global parameter gen_int_mask to disable low RSSI interrupt -
-         * we do not need it during FM_CONFIG_RX_AF_TIMER_MS timeout */
+         * we do not need it during the AF suspension timeout */
         _fmRxSmData.interruptInfo.gen_int_mask &= ~FMC_FW_MASK_LEV;
         
-        if(isAfJumpValid())
+        if(isAfJumpValid() && (isRecovering == FMC_FALSE))
         {
             
             send_fm_event_af_jump(FM_RX_EVENT_AF_SWITCH_START,FM_RX_STATUS_AF_IN_PROGRESS, _fmRxSmData.curStationParams.piCode, _fmRxSmData.freqBeforeJump, _fmRxSmData.freqBeforeJump); 
@@ -3670,7 +4461,7 @@ FMC_STATIC void HandleGenIntLowRssi(void)
 FMC_STATIC void HandleGenIntEnableInt(void)
 {
     /* Update operation back to general interrupts */
-    _fmRxSmData.currCmdInfo.baseCmd->cmdType = FM_RX_INTERNAL_HANDLE_GEN_INT;
+    FMCI_ChangeHeadCmdType(_fmRxSmData.currCmdInfo.baseCmd, FM_RX_INTERNAL_HANDLE_GEN_INT);
     
     prepareNextStage(_FM_RX_SM_STATE_WAITING_FOR_CC, GEN_INT_AFTER_FINISH_STAGE);
     _fmRxSmData.interruptInfo.fmMask = _fmRxSmData.interruptInfo.gen_int_mask;
@@ -3693,7 +4484,7 @@ FMC_STATIC void HandleGenIntFinish(void)
  *******************************************************************************************************************/
 FMC_STATIC void FmHandleRdsRx(void)
 {
-    _fmRxSmData.currCmdInfo.baseCmd->cmdType = FM_RX_INTERNAL_READ_RDS;
+    FMCI_ChangeHeadCmdType(_fmRxSmData.currCmdInfo.baseCmd, FM_RX_INTERNAL_READ_RDS);
 
     prepareNextStage(_FM_RX_SM_STATE_WAITING_FOR_CC, 0);
 
@@ -3704,7 +4495,7 @@ FMC_STATIC void FmHandleRdsRx(void)
  *******************************************************************************************************************/
 FMC_STATIC void FmHandleAfJump(void)
 {
-    _fmRxSmData.currCmdInfo.baseCmd->cmdType = FM_RX_INTERNAL_HANDLE_AF_JUMP;
+    FMCI_ChangeHeadCmdType(_fmRxSmData.currCmdInfo.baseCmd, FM_RX_INTERNAL_HANDLE_AF_JUMP);
     prepareNextStage(_FM_RX_SM_STATE_WAITING_FOR_CC, 0);
 
     initAfJumpParams();
@@ -3716,7 +4507,7 @@ FMC_STATIC void FmHandleAfJump(void)
  *******************************************************************************************************************/
 FMC_STATIC void FmHandleStereoChange(void)
 {
-    _fmRxSmData.currCmdInfo.baseCmd->cmdType = FM_RX_INTERNAL_HANDLE_STEREO_CHANGE;
+    FMCI_ChangeHeadCmdType(_fmRxSmData.currCmdInfo.baseCmd, FM_RX_INTERNAL_HANDLE_STEREO_CHANGE);
 
     prepareNextStage(_FM_RX_SM_STATE_WAITING_FOR_CC, 0);
 
@@ -3727,7 +4518,7 @@ FMC_STATIC void FmHandleStereoChange(void)
  *******************************************************************************************************************/
 FMC_STATIC void FmHandleMalfunction(void)
 {
-    _fmRxSmData.currCmdInfo.baseCmd->cmdType = FM_RX_INTERNAL_HANDLE_HW_MAL;
+    FMCI_ChangeHeadCmdType(_fmRxSmData.currCmdInfo.baseCmd, FM_RX_INTERNAL_HANDLE_HW_MAL);
 
     prepareNextStage(_FM_RX_SM_STATE_WAITING_FOR_CC, 0);
 
@@ -3755,6 +4546,85 @@ FMC_STATIC FMC_BOOL isAfJumpValid(void)
     return isValid;
 }
 
+/*
+    The averaged RSSI of the tuned frequency rises - it may recover without an AF switch, which
+    would mute the audio meanwhile. A slope not followed during the last sampling interval is
+    too old to tell.
+*/
+FMC_STATIC FMC_BOOL _FM_RX_SM_IsSignalRecovering(void)
+{
+    if ((_fmRxSmData.afPolicy.recoveryRssiSlope == 0) || 
+        (_fmRxSmData.signalMonitor.isSlopeValid == FMC_FALSE) ||
+        (_fmRxSmData.signalMonitor.rssiSlope < (FMC_INT)_fmRxSmData.afPolicy.recoveryRssiSlope))
+    {
+        return FMC_FALSE;
+    }
+
+    if ((MCP_HAL_OS_GetSystemTime() - _fmRxSmData.signalMonitor.slopeTimeMs) > _fmRxSmData.signalMonitor.intervalMs)
+    {
+        return FMC_FALSE;
+    }
+
+    FMC_LOG_INFO(("Low RSSI while the signal recovers (slope %d) - AF switch suppressed", 
+                    _fmRxSmData.signalMonitor.rssiSlope));
+
+    return FMC_TRUE;
+}
+
+/*
+    Doubles the suspension until the next AF switch attempt, up to the maximal suspension, and
+    restarts the suspension timer with it.
+*/
+FMC_STATIC void _FM_RX_SM_BackOffAfSwitch(void)
+{
+    FmcStatus status;
+
+    if (_fmRxSmData.afPolicy.curSuspendTimeMs > (_fmRxSmData.afPolicy.maxSuspendTimeMs / 2))
+    {
+        _fmRxSmData.afPolicy.curSuspendTimeMs = _fmRxSmData.afPolicy.maxSuspendTimeMs;
+    }
+    else
+    {
+        _fmRxSmData.afPolicy.curSuspendTimeMs *= 2;
+    }
+
+    FMC_LOG_INFO(("AF switch failed - next attempt in %d ms", _fmRxSmData.afPolicy.curSuspendTimeMs));
+
+    status = FMCI_OS_ResetTimer(FMC_OS_MS_TO_TICKS(_fmRxSmData.afPolicy.curSuspendTimeMs));
+    FMC_ASSERT(status == FMC_STATUS_SUCCESS);
+
+    _FM_RX_SM_StartAfSuspension();
+}
+
+/*
+    The RSSI is sampled for the AF switching only while the suspension timer runs. The slope
+    measured meanwhile decides whether the low RSSI that follows the suspension is acted upon.
+*/
+FMC_STATIC void _FM_RX_SM_StartAfSuspension(void)
+{
+    if (_fmRxSmData.afPolicy.isSuspended == FMC_FALSE)
+    {
+        _fmRxSmData.afPolicy.isSuspended = FMC_TRUE;
+        _FM_RX_SM_ArmSignalMonitor();
+    }
+}
+
+FMC_STATIC void _FM_RX_SM_EndAfSuspension(void)
+{
+    /* The trend was followed until now - it ages from here */
+    if (_fmRxSmData.afPolicy.isSuspended == FMC_TRUE)
+    {
+        _fmRxSmData.signalMonitor.slopeTimeMs = MCP_HAL_OS_GetSystemTime();
+    }
+
+    _fmRxSmData.afPolicy.isSuspended = FMC_FALSE;
+
+    if (_FM_RX_SM_IsSignalMonitorActive() == FMC_FALSE)
+    {
+        FMCI_OS_CancelMonitorTimer();
+    }
+}
+
 FMC_STATIC void initAfJumpParams(void)
 {
     /* Update parameters before starting the jump */
@@ -3881,11 +4751,25 @@ FMC_STATIC void HandleAfJumpFinished(void)
     {
         _fmRxSmData.curAfJumpIndex++;   /* Go to next index in the af list */ 
         
+        /* A command that changes the frequency anyway is waiting - stop searching */
+        if(_fmRxSmData.isCurrCmdStopping == FMC_TRUE)
+        {
+            send_fm_event_af_jump(FM_RX_EVENT_AF_SWITCH_COMPLETE,FM_RX_STATUS_AF_SWITCH_ABORTED, curPi, read_freq, jumped_freq);
+
+            /* Reset the int_mask */
+            _fmRxSmData.interruptInfo.opHandler_int_mask = 0;
+
+            /* Call the next stage of general interrupts handler to handle other interrupts */
+            genIntHandler[GEN_INT_AFTER_LOW_RSSI_STAGE]();
+        }
         /* If we reached the end of the list - stop searching */
-        if(_fmRxSmData.curAfJumpIndex >= _fmRxSmData.curStationParams.afListSize) 
+        else if(_fmRxSmData.curAfJumpIndex >= _fmRxSmData.curStationParams.afListSize) 
         {
             send_fm_event_af_jump(FM_RX_EVENT_AF_SWITCH_COMPLETE,FM_RX_STATUS_AF_SWITCH_FAILED_LIST_EXHAUSTED, curPi, read_freq, jumped_freq);
 
+            /* Wait longer before the next attempt - it would most probably fail too */
+            _FM_RX_SM_BackOffAfSwitch();
+
             /* Reset the int_mask */
             _fmRxSmData.interruptInfo.opHandler_int_mask = 0;
 
@@ -3969,9 +4853,28 @@ FMC_STATIC void HandleReadStatusRegisterToAvoidRdsEmptyInterrupt(void)
 }
 FMC_STATIC void HandleReadRdsAnalyze(void)
 {
+    /* Reading the flag register clears it, so general interrupts which occurred
+       while reading the RDS data are in the flag read above. Handle them in this
+       pass instead of losing them (the RDS bit is the RDS empty indication this
+       read is meant to clear, and is ignored) */
+    FMC_U16 newIntBits = (FMC_U16)(_fmRxSmData.context.transportEventData.read_param &
+                                   _fmRxSmData.interruptInfo.gen_int_mask &
+                                   ~FMC_FW_MASK_RDS);
 
-    /* Finished analyzing - call the next stage of general interrupts handler to handle other interrupts */
-    genIntHandler[GEN_INT_AFTER_RDS_STAGE]();
+    if (newIntBits & (FMC_FW_MASK_MAL | FMC_FW_MASK_STIC))
+    {
+        /* Their stages were already passed - start over, keeping a pending low RSSI */
+        _fmRxSmData.interruptInfo.genIntSetBits = (FMC_U16)((_fmRxSmData.interruptInfo.genIntSetBits & FMC_FW_MASK_LEV) | 
+                                                            newIntBits);
+        genIntHandler[GEN_INT_MAL_STAGE]();
+    }
+    else
+    {
+        _fmRxSmData.interruptInfo.genIntSetBits |= newIntBits;
+
+        /* Finished analyzing - call the next stage of general interrupts handler to handle other interrupts */
+        genIntHandler[GEN_INT_AFTER_RDS_STAGE]();
+    }
 }
 /*******************************************************************************************************************/
 FMC_STATIC void GetRDSBlock(void)
@@ -4038,7 +4941,10 @@ FMC_STATIC void GetRDSBlock(void)
 
 FMC_STATIC FmcRdsGroupTypeMask handleRdsGroup(FmRxRdsDataFormat  *rdsFormat)
 {
+    static const FMC_U8 blockBWidths[RDS_BLOCK_B_NUM_OF_FIELDS] = {4, 1, 1, 5, 5};
     FmcRdsGroupTypeMask gType = FM_RDS_GROUP_TYPE_MASK_NONE;
+    TMcpfBitStream blockB;
+    FMC_U32 blockBFields[RDS_BLOCK_B_NUM_OF_FIELDS];
 
     /*
     |    block A           |    block B                                                        |   block C               |   block D        | 
@@ -4054,8 +4960,11 @@ FMC_STATIC FmcRdsGroupTypeMask handleRdsGroup(FmRxRdsDataFormat  *rdsFormat)
         send_fm_event_pi_changed(rdsFormat->piCode);
     }
 
-    rdsFormat->groupBitInMask = rdsParseFunc_getGroupType((FMC_U8)((rdsFormat->rdsData.groupGeneral.blockB_byte1& RDS_BLOCK_B_GROUP_TYPE_MASK) >> 3));
-    rdsFormat->ptyCode = (FMC_UTILS_BEtoHost16((FMC_U8 *)&rdsFormat->rdsData.groupGeneral.blockB_byte1)&RDS_BLOCK_B_PTY_MASK)>>RDS_NUM_OF_BITS_BEFOR_PTY;
+    mcpf_bitStream_Init(&blockB, &rdsFormat->rdsData.groupGeneral.blockB_byte1, 2, 0);
+    mcpf_bitStream_GetFields(&blockB, blockBWidths, RDS_BLOCK_B_NUM_OF_FIELDS, blockBFields);
+
+    rdsFormat->groupBitInMask = rdsParseFunc_getGroupType((FMC_U8)(blockBFields[RDS_BLOCK_B_FIELD_GROUP_TYPE] << 1));
+    rdsFormat->ptyCode = (FmcRdsPtyCode)blockBFields[RDS_BLOCK_B_FIELD_PTY];
 
     if(rdsFormat->ptyCode != _fmRxSmData.rdsData.ptyCode)
     {
@@ -4488,8 +5397,10 @@ FMC_STATIC void HandleTimeoutStart(void)
     /* Update to next handler */
     prepareNextStage(_FM_RX_SM_STATE_WAITING_FOR_CC, INCREMENT_STAGE);
 
+    _FM_RX_SM_EndAfSuspension();
+
     /* Update global parameter gen_int_mask to enable low RSSI interrupt -
-     * it was disabled during FM_CONFIG_RX_AF_TIMER_MS timeout */
+     * it was disabled during the AF suspension timeout */
     _fmRxSmData.interruptInfo.gen_int_mask |= FMC_FW_MASK_LEV;
     _fmRxSmData.interruptInfo.fmMask =  _fmRxSmData.interruptInfo.gen_int_mask;
     /* Enable the interrupts */
@@ -4504,6 +5415,51 @@ FMC_STATIC void HandleTimeoutFinish(void)
     FMCI_NotifyFmTask(FMC_OS_EVENT_FMC_STACK_TASK_PROCESS);
     
 }
+/*******************************************************************************************************************
+ *                  
+ *******************************************************************************************************************/
+FMC_STATIC void HandleSampleSignalStart(void)
+{
+    /* The last subscriber left, AF switching was turned off, or RX is being disabled, since 
+       the sample was queued */
+    if (_FM_RX_SM_IsSignalMonitorActive() == FMC_FALSE)
+    {
+        _FM_RX_SM_RemoveFromQueueAndFreeCmd(&_fmRxSmData.currCmdInfo.baseCmd);
+        FMCI_NotifyFmTask(FMC_OS_EVENT_FMC_STACK_TASK_PROCESS);
+        return;
+    }
+
+    /* Update to next handler */
+    prepareNextStage(_FM_RX_SM_STATE_WAITING_FOR_CC, INCREMENT_STAGE);
+
+    FMC_CORE_SendReadCommand(FMC_FW_OPCODE_RX_RSSI_LEVEL_GET,2);
+}
+
+FMC_STATIC void HandleSampleSignalReadStereo(void)
+{
+    _fmRxSmData.signalMonitor.rssiSample = (FMC_INT)(FMC_S16)_fmRxSmData.context.transportEventData.read_param;
+
+    /* Update to next handler */
+    prepareNextStage(_FM_RX_SM_STATE_WAITING_FOR_CC, INCREMENT_STAGE);
+
+    FMC_CORE_SendReadCommand(FMC_FW_OPCODE_RX_STEREO_GET,2);
+}
+
+FMC_STATIC void HandleSampleSignalFinish(void)
+{
+    FMC_BOOL isStereo;
+
+    /* 0 = Mono; 1 = Stereo */
+    isStereo = (((FMC_U8)_fmRxSmData.context.transportEventData.read_param == 0) ? FMC_FALSE : FMC_TRUE);
+
+    _FM_RX_SM_UpdateSignalMonitor(_fmRxSmData.signalMonitor.rssiSample, isStereo);
+
+    _FM_RX_SM_RemoveFromQueueAndFreeCmd(&_fmRxSmData.currCmdInfo.baseCmd);
+
+    _FM_RX_SM_ArmSignalMonitor();
+
+    FMCI_NotifyFmTask(FMC_OS_EVENT_FMC_STACK_TASK_PROCESS);
+}
 /*******************************************************************************************************************
  *                  
  *******************************************************************************************************************/
@@ -4739,7 +5695,7 @@ FmRxStatus FM_RX_SM_AllocateCmdAndAddToQueue(   FmRxContext     *context,
     (*cmd)->cmdType = cmdType;
 
     /* Insert the cmd as the last cmd in the cmds queue */
-    FMC_InsertTailList(FMCI_GetCmdsQueue(), &((*cmd)->node));
+    FMCI_InsertCmdToQueue(*cmd);
 
     smRxNumOfCmdInQueue++;
 
@@ -4748,6 +5704,25 @@ FmRxStatus FM_RX_SM_AllocateCmdAndAddToQueue(   FmRxContext     *context,
     return status;
 }
 
+/*
+    Adds an internal command (one that carries no parameters) to the commands queue, unless a command 
+    of the same type is already pending. Returns FMC_TRUE if the command was added.
+*/
+FMC_BOOL _FM_RX_SM_AddInternalCmdIfNotPending(FmRxCmdType cmdType)
+{
+    FmRxGenCmd  *cmd = NULL;
+    FmRxStatus  status;
+
+    if (FM_RX_SM_IsCmdPending(cmdType) == FMC_TRUE)
+    {
+        return FMC_FALSE;
+    }
+
+    status = FM_RX_SM_AllocateCmdAndAddToQueue(&_fmRxSmData.context, cmdType, (FmcBaseCmd **)&cmd);
+
+    return ((status == FM_RX_STATUS_SUCCESS) ? FMC_TRUE : FMC_FALSE);
+}
+
 FmRxStatus _FM_RX_SM_RemoveFromQueueAndFreeCmd(FmcBaseCmd **cmd)
 {
     FmcStatus   status;
@@ -4755,7 +5730,7 @@ FmRxStatus _FM_RX_SM_RemoveFromQueueAndFreeCmd(FmcBaseCmd **cmd)
     FMC_FUNC_START("_FM_RX_SM_RemoveFromQueueAndFreeCmd");
 
     /* Remove the cmd element from the queue */
-    FMC_RemoveNodeList(&((*cmd)->node));
+    FMCI_RemoveCmdFromQueue(*cmd);
 
     /* Free the cmd structure space */
     status = _FM_RX_SM_FreeCmd(cmd);
@@ -4977,6 +5952,12 @@ FMC_STATIC void send_fm_event_pty_changed(FmcRdsPtyCode ptyCode)
     _fmRxSmData.context.appEvent.p.ptyChangedData.pty= ptyCode;
     _FM_RX_SM_SendAppEvent(&_fmRxSmData.context, FM_RX_STATUS_SUCCESS, FM_RX_CMD_NONE, FM_RX_EVENT_PTY_CODE_CHANGED);
 }
+FMC_STATIC void send_fm_event_signal_quality_changed(FMC_INT rssi, FMC_BOOL isStereo)
+{
+    _fmRxSmData.context.appEvent.p.signalQualityData.rssi = rssi;
+    _fmRxSmData.context.appEvent.p.signalQualityData.isStereo = isStereo;
+    _FM_RX_SM_SendAppEvent(&_fmRxSmData.context, FM_RX_STATUS_SUCCESS, FM_RX_CMD_NONE, FM_RX_EVENT_SIGNAL_QUALITY_CHANGED);
+}
 FMC_STATIC void send_fm_event_pi_changed(FmcRdsPiCode piCode)
 {
     _fmRxSmData.context.appEvent.p.piChangedData.pi = piCode;
@@ -5135,51 +6116,12 @@ FMC_STATIC void fm_recvd_intterupt(void)
 
 }
 /*
-    This is a comparison function that is used when searching the commands queue for command of a specific
-    command type.
-    
-    See FM_RX_SM_FindLatestCmdInQueueByType() for details
-*/
-FMC_BOOL _FM_RX_SM_CompareCmdTypes(const FMC_ListNode *entryToMatch, const FMC_ListNode* checkedEntry)
-{
-    const FmcBaseCmd *cmdToMatch = (FmcBaseCmd*)entryToMatch;
-    const FmcBaseCmd *checkedCmdEntry = (FmcBaseCmd*)checkedEntry;
-
-    /* Declare equality when command types are equal */
-    if (cmdToMatch->cmdType == checkedCmdEntry->cmdType)
-    {
-        return FMC_TRUE;
-    }
-    else
-    {
-        return FMC_FALSE;
-    }
-}
-
-/*
-    Traverse the commands queue from the last command to the first, and search for a command object with
-    the specified command type 
+    Returns the last command object in the commands queue with the specified command type. The commands
+    queue keeps a per-type index, so the queue is not traversed.
 */
 FmcBaseCmd *FM_RX_SM_FindLatestCmdInQueueByType(FmRxCmdType cmdType)
 {
-    FmcBaseCmd      templateEntry;
-    FMC_ListNode        *matchingEntryAsListEntry = NULL;
-
-    FMC_FUNC_START("FM_RX_SM_FindLatestCmdInQueueByType");
-
-    /* Init the template entry so that the entry with the matching cmd type will be searched for */
-    templateEntry.cmdType = cmdType;
-    
-    /* Seach the commands queue for the last entry */
-    matchingEntryAsListEntry = FMC_UTILS_FindMatchingListNode(  FMCI_GetCmdsQueue(),                /* Head */
-                                            NULL,                               /* Start from last node */
-                                            FMC_UTILS_SEARCH_LAST_TO_FIRST, /* Search for last entry */
-                                            &(templateEntry.node),
-                                            _FM_RX_SM_CompareCmdTypes);
-    
-    FMC_FUNC_END();
-    
-    return  (FmcBaseCmd*)matchingEntryAsListEntry;
+    return FMCI_FindLatestCmdInQueueByType(cmdType);
 }
 
 /*
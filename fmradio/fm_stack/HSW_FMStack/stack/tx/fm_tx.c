@@ -746,6 +746,22 @@ FmTxStatus FM_TX_GetRdsECC(FmTxContext *fmContext)
 							 "FM_TX_GetRdsECC");
 }
 
+FmTxStatus FM_TX_GetCachedState(FmTxContext *fmContext, FmTxCachedState *state)
+{
+	FmTxStatus	status = FM_TX_STATUS_SUCCESS;
+
+	_FM_TX_FUNC_START_AND_LOCK_ENABLED("FM_TX_GetCachedState");
+
+	FMC_VERIFY_ERR((fmContext == FM_TX_SM_GetContext()), FMC_STATUS_INVALID_PARM, ("FM_TX_GetCachedState: Invalid Context Ptr"));
+	FMC_VERIFY_ERR((state != NULL), FMC_STATUS_INVALID_PARM, ("FM_TX_GetCachedState: Null state Ptr"));
+
+	FM_TX_SM_GetCachedState(state);
+
+	_FM_TX_FUNC_END_AND_UNLOCK_ENABLED();
+
+	return status;
+}
+
 FmTxStatus FM_TX_WriteRdsRawData(FmTxContext *fmContext, const FMC_U8 *rdsRawData, FMC_UINT len)
 {
 	FmTxStatus				status;
@@ -1785,6 +1785,29 @@ FmTxRdsTransmissionMode FM_TX_SM_GetRdsMode(void)
 {
     return _fmTxSmData.context.fwCache.transmissionMode;
 }
+void FM_TX_SM_GetCachedState(FmTxCachedState *state)
+{
+    _FmTxSmFwCache  *fwCache = &_fmTxSmData.context.fwCache;
+
+    state->tunedFreq = fwCache->tunedFreq;
+    state->transmissionOn = fwCache->transmissionOn;
+    state->powerLevel = fwCache->powerLevel;
+    state->muteMode = fwCache->muteMode;
+    state->preEmphasisFilter = fwCache->emphasisfilter;
+    state->rdsEnabled = fwCache->rdsEnabled;
+    state->rdsTransmissionMode = fwCache->transmissionMode;
+    state->rdsTransmittedGroupsMask = fwCache->fieldsMask;
+    state->rdsPiCode = fwCache->rdsPiCode;
+    state->rdsPtyCode = fwCache->rdsPtyCode;
+    state->rdsAfCode = fwCache->afCode;
+    state->rdsRepertoire = fwCache->rdsRepertoire;
+    state->rdsPsDisplayMode = fwCache->rdsScrollMode;
+    state->rdsPsScrollSpeed = fwCache->rdsScrollSpeed;
+    state->rdsTaCode = fwCache->rdsTaCode;
+    state->rdsTpCode = fwCache->rdsTpCode;
+    state->rdsMusicSpeechFlag = fwCache->rdsRusicSpeachFlag;
+    state->rdsExtendedCountryCode = fwCache->countryCode;
+}
 FmTxContext* FM_TX_SM_GetContext(void)
 {
     return &_fmTxSmData.context;
@@ -5276,7 +5299,7 @@ FmTxStatus FM_TX_SM_AllocateCmdAndAddToQueue(   FmTxContext     *context,
     (*cmd)->cmdType = cmdType;
 
     /* Insert the cmd as the last cmd in the cmds queue */
-    FMC_InsertTailList(FMCI_GetCmdsQueue(), &((*cmd)->node));
+    FMCI_InsertCmdToQueue(*cmd);
 
     smNumOfCmdInQueue++;
 
@@ -5294,7 +5317,7 @@ FmTxStatus _FM_TX_SM_RemoveFromQueueAndFreeCmd(FmcBaseCmd **cmd)
     FMC_FUNC_START("_FM_TX_SM_RemoveFromQueueAndFreeCmd");
 
     /* Remove the cmd element from the queue */
-    FMC_RemoveNodeList(&((*cmd)->node));
+    FMCI_RemoveCmdFromQueue(*cmd);
 
     FMC_LOG_INFO(("FM TX: %s Removed Commands Queue", FMC_DEBUG_FmTxCmdStr((*cmd)->cmdType)));
 
@@ -5445,51 +5468,12 @@ FmTxStatus _FM_TX_SM_FreeCmd(FmcBaseCmd **cmd)
 }
 
 /*
-    This is a comparison function that is used when searching the commands queue for command of a specific
-    command type.
-    
-    See FM_TX_SM_FindLatestCmdInQueueByType() for details
-*/
-FMC_BOOL _FM_TX_SM_CompareCmdTypes(const FMC_ListNode *entryToMatch, const FMC_ListNode* checkedEntry)
-{
-    const FmcBaseCmd *cmdToMatch = (FmcBaseCmd*)entryToMatch;
-    const FmcBaseCmd *checkedCmdEntry = (FmcBaseCmd*)checkedEntry;
-
-    /* Declare equality when command types are equal */
-    if (cmdToMatch->cmdType == checkedCmdEntry->cmdType)
-    {
-        return FMC_TRUE;
-    }
-    else
-    {
-        return FMC_FALSE;
-    }
-}
-
-/*
-    Traverse the commands queue from the last command to the first, and search for a command object with
-    the specified command type 
+    Returns the last command object in the commands queue with the specified command type. The commands
+    queue keeps a per-type index, so the queue is not traversed.
 */
 FmcBaseCmd *FM_TX_SM_FindLatestCmdInQueueByType(FmTxCmdType cmdType)
 {
-    FmcBaseCmd      templateEntry;
-    FMC_ListNode        *matchingEntryAsListEntry = NULL;
-
-    FMC_FUNC_START("FM_TX_SM_FindLatestCmdInQueueByType");
-
-    /* Init the template entry so that the entry with the matching cmd type will be searched for */
-    templateEntry.cmdType = cmdType;
-    
-    /* Seach the commands queue for the last entry */
-    matchingEntryAsListEntry = FMC_UTILS_FindMatchingListNode(  FMCI_GetCmdsQueue(),                /* Head */
-                                            NULL,                               /* Start from last node */
-                                            FMC_UTILS_SEARCH_LAST_TO_FIRST, /* Search for last entry */
-                                            &(templateEntry.node),
-                                            _FM_TX_SM_CompareCmdTypes);
-    
-    FMC_FUNC_END();
-    
-    return  (FmcBaseCmd*)matchingEntryAsListEntry;
+    return FMCI_FindLatestCmdInQueueByType(cmdType);
 }
 
 /*
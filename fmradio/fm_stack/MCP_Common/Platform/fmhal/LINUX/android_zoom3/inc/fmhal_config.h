@@ -25,16 +25,17 @@
 /*
 *   The maximum number of FM-Specific Events
 *   
-*   1 fm process event + 1 timer event + 1 fm interrupt event + 1 fm disable event
+*   1 fm process event + 1 timer event + 1 fm interrupt event + 1 fm disable event +
+*   1 signal monitor timer event
 */
-#define FMHAL_OS_MAX_NUM_OF_EVENTS_FM                           (4)
+#define FMHAL_OS_MAX_NUM_OF_EVENTS_FM                           (5)
 
 /*
 *   The maximum number of FM-Specific timers
 *   
-*   
+*   1 fm timer + 1 fm signal monitor timer
 */
-#define FMHAL_OS_MAX_NUM_OF_TIMERS                              (1) 
+#define FMHAL_OS_MAX_NUM_OF_TIMERS                              (2) 
 
 /*
 *   FMC Server socket path
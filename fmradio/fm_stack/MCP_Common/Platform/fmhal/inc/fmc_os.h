@@ -97,6 +97,7 @@ typedef void (*FmcOsEventCallback)(FmcOsEvent evtMask);
 /* FM Stack event */
 #define FMC_OS_EVENT_FMC_STACK_TASK_PROCESS     (FMC_OS_EVENT_GENERAL)
 #define FMC_OS_EVENT_FMC_TIMER_EXPIRED          (FMC_OS_EVENT_TIMER_EXPIRED)
+#define FMC_OS_EVENT_FMC_MONITOR_TIMER_EXPIRED  (FMC_OS_EVENT_MONITOR_TIMER_EXPIRED)
 
 /*
 FM Events
@@ -110,6 +111,8 @@ FM Events
 #define FMC_OS_EVENT_TIMER_EXPIRED              (0x00000004)
 /*This event is recieved when Disable API command called*/
 #define FMC_OS_EVENT_DISABELING                 (0x00000008)
+/*This event is recieved when the FM signal monitor timer expiers */
+#define FMC_OS_EVENT_MONITOR_TIMER_EXPIRED      (0x00000010)
 
 /********************************************************************************
  *
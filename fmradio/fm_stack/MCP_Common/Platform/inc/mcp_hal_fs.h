@@ -592,6 +592,54 @@ McpHalFsStatus MCP_HAL_FS_Remove( const McpUtf8 *fullPathFileName );
  */
 McpHalFsStatus MCP_HAL_FS_IsAbsoluteName( const McpUtf8 *fileName, McpBool *isAbsolute );
 
+/*-------------------------------------------------------------------------------
+ * MCP_HAL_FS_Map()
+ *
+ * Brief:  		maps a whole file into memory, read only.
+ *
+ * Description: maps a whole file into memory, so that it can be parsed in place
+ *				instead of being read in chunks. The mapping stays valid until
+ *				MCP_HAL_FS_Unmap() is called.
+ *	
+ *	Type:
+ *		blocking
+ *
+ * 	Parameters:
+ *		fullPathFileName [in] - points to file name.
+ *
+ *		ppData [out] - the file contents, NULL for an empty file.
+ *
+ *		pSize [out] - the file size in bytes.
+ *
+ * 	Returns:
+ *		MCP_HAL_FS_STATUS_SUCCESS - Operation is successful.
+ *
+ *		other -  Operation failed.
+ */
+McpHalFsStatus MCP_HAL_FS_Map( const McpUtf8 *fullPathFileName, const McpU8 **ppData, McpU32 *pSize );
+
+/*-------------------------------------------------------------------------------
+ * MCP_HAL_FS_Unmap()
+ *
+ * Brief:  		releases a file mapped by MCP_HAL_FS_Map().
+ *
+ * Description: releases a file mapped by MCP_HAL_FS_Map().
+ *	
+ *	Type:
+ *		blocking
+ *
+ * 	Parameters:
+ *		pData [in] - the file contents returned by MCP_HAL_FS_Map().
+ *
+ *		size [in] - the file size returned by MCP_HAL_FS_Map().
+ *
+ * 	Returns:
+ *		MCP_HAL_FS_STATUS_SUCCESS - Operation is successful.
+ *
+ *		other -  Operation failed.
+ */
+McpHalFsStatus MCP_HAL_FS_Unmap( const McpU8 *pData, McpU32 size );
+
 /*-------------------------------------------------------------------------------
  * MCP_HAL_FS_ExtractDateAndTime()
  *
@@ -107,7 +107,9 @@ eHalHciStatus hal_hci_SendPacket(
  *  hciCmdParms - pointer to hci command payload
  *  hciCmdLen - length of command payload buffer
  *  CmdCompleteCallback - callback function for command complete events
- *               (same function can be registered for the 2 callbacks if needed)
+ *               (same function can be registered for the 2 callbacks if needed). If a command 
+ *               kept for a credit fails to be written, it is called with HAL_HCI_STATUS_FAILED
+ *               and the command packet type and opcode instead of an event
  *  hCmdComplete - client handle (user data) that will be used as first parameter of the callbacks 
  *
  * Return Code: HAL_HCI_STATUS_PENDING upon succesfull transfer or HAL_HCI_STATUS_FAILED otherwise
@@ -388,6 +388,15 @@ void MCP_HAL_LOG_LogBinBuf( const McpU8	logMode,
 
 #define MCP_HAL_LOG_FORMAT_MSG(msg) MCP_HAL_LOG_FormatMsg msg
 
+/*-------------------------------------------------------------------------------
+ * MCP_HAL_LOG_IS_ENABLED
+ *
+ *      Checks whether messages of the given severity are currently enabled for
+ *      the module. Allows hot paths to skip building log arguments altogether.
+ */
+#define MCP_HAL_LOG_IS_ENABLED(moduleId, severity)\
+    (0 != (MCP_HAL_LOG_Modules[moduleId].logLevelMask & MCP_HAL_LOG_GET_SEVERITY_FLAG(severity)))
+
 
 /*-------------------------------------------------------------------------------
  * MCP_HAL_LOG_FUNCTION
@@ -418,21 +427,30 @@ void MCP_HAL_LOG_LogBinBuf( const McpU8	logMode,
  *
  *      Defines trace message in info level.
  */
-#define MCP_HAL_LOG_INFO(file, line, moduleId, msg) ((void)MCP_HAL_LOG_LogMsg( file,line,moduleId,MCP_HAL_LOG_SEVERITY_INFO,MCP_HAL_LOG_FORMAT_MSG(msg)))
+#define MCP_HAL_LOG_INFO(file, line, moduleId, msg)\
+    ( MCP_HAL_LOG_IS_ENABLED(moduleId, MCP_HAL_LOG_SEVERITY_INFO)\
+    ? ((void)MCP_HAL_LOG_LogMsg( file,line,moduleId,MCP_HAL_LOG_SEVERITY_INFO,MCP_HAL_LOG_FORMAT_MSG(msg)))\
+    : (void)0 )
 
 /*-------------------------------------------------------------------------------
  * MCP_HAL_LOG_ERROR
  *
  *      Defines trace message in info level.
  */
-#define MCP_HAL_LOG_ERROR(file, line, moduleId, msg) ((void)MCP_HAL_LOG_LogMsg( file,line,moduleId,MCP_HAL_LOG_SEVERITY_ERROR,MCP_HAL_LOG_FORMAT_MSG(msg)))
+#define MCP_HAL_LOG_ERROR(file, line, moduleId, msg)\
+    ( MCP_HAL_LOG_IS_ENABLED(moduleId, MCP_HAL_LOG_SEVERITY_ERROR)\
+    ? ((void)MCP_HAL_LOG_LogMsg( file,line,moduleId,MCP_HAL_LOG_SEVERITY_ERROR,MCP_HAL_LOG_FORMAT_MSG(msg)))\
+    : (void)0 )
 
 /*-------------------------------------------------------------------------------
  * MCP_HAL_LOG_FATAL
  *
  *      Defines trace message in fatal level.
  */
-#define MCP_HAL_LOG_FATAL(file, line, moduleId, msg) ((void)MCP_HAL_LOG_LogMsg( file,line,moduleId,MCP_HAL_LOG_SEVERITY_FATAL,MCP_HAL_LOG_FORMAT_MSG(msg)))
+#define MCP_HAL_LOG_FATAL(file, line, moduleId, msg)\
+    ( MCP_HAL_LOG_IS_ENABLED(moduleId, MCP_HAL_LOG_SEVERITY_FATAL)\
+    ? ((void)MCP_HAL_LOG_LogMsg( file,line,moduleId,MCP_HAL_LOG_SEVERITY_FATAL,MCP_HAL_LOG_FORMAT_MSG(msg)))\
+    : (void)0 )
     
     
 /*-------------------------------------------------------------------------------
@@ -118,6 +118,25 @@
 */
 #define MCP_HAL_CONFIG_FS_CASE_SENSITIVE                        (MCP_TRUE)
 
+/*
+ *  Size of the read-ahead buffer of files opened read only, 0 disables
+ *  read-ahead buffering
+*/
+#define MCP_HAL_CONFIG_FS_READ_AHEAD_SIZE                       (4096)
+
+/*
+ *  The maximum number of read only files buffered simultaneously, files
+ *  opened beyond it are read directly
+*/
+#define MCP_HAL_CONFIG_FS_MAX_NUM_OF_BUFFERED_FILES             (4)
+
+/*
+ *  Number of MCP_HAL_FS_Stat() results kept, and for how long (in seconds).
+ *  The cache is invalidated by any write, rename or remove done through the HAL
+*/
+#define MCP_HAL_CONFIG_FS_STAT_CACHE_SIZE                       (8)
+#define MCP_HAL_CONFIG_FS_STAT_CACHE_TTL_SEC                    (2)
+
 /*------------------------------------------------------------------------------
  * OS
  *
@@ -43,6 +43,8 @@
 #include <dirent.h>
 #include <string.h>
 #include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
 
 #include "mcp_hal_defs.h"
 #include "mcp_hal_fs.h"
@@ -74,6 +76,24 @@
 	DIR*			searchHandle;
 } _McpHalFsDirHandle;
 
+/* Read-ahead buffer of a file opened read only */
+typedef struct _tagMcpHalFsReadBuf
+{
+	McpHalFsFileDesc	fd;			/* MCP_HAL_FS_INVALID_FILE_DESC when free */
+	McpU32				len;		/* valid bytes in data */
+	McpU32				pos;		/* next byte to return */
+	McpU8				data[MCP_HAL_CONFIG_FS_READ_AHEAD_SIZE];
+} _McpHalFsReadBuf;
+
+/* Cached MCP_HAL_FS_Stat() result */
+typedef struct _tagMcpHalFsStatEntry
+{
+	McpBool				busy;
+	time_t				timestamp;	/* monotonic seconds when the entry was stored */
+	McpU8				path[MCP_HAL_CONFIG_FS_MAX_PATH_LEN_CHARS + 1];
+	McpHalFsStat		stat;
+} _McpHalFsStatEntry;
+
 
 /********************************************************************************
  *
@@ -87,6 +107,16 @@ static _McpHalFsDirHandle	_mcpHalFs_DirStructureArray[MCP_HAL_CONFIG_FS_MAX_NUM_
 /* Full name (path+name), null terminated */
 static McpU8                _mcpHalFs_lfilename[MCP_HAL_CONFIG_FS_MAX_PATH_LEN_CHARS+ MCP_HAL_CONFIG_FS_MAX_FILE_NAME_LEN_CHARS+ 1];
 
+#if MCP_HAL_CONFIG_FS_READ_AHEAD_SIZE > 0
+static _McpHalFsReadBuf		_mcpHalFs_ReadBufArray[MCP_HAL_CONFIG_FS_MAX_NUM_OF_BUFFERED_FILES];
+#endif
+
+static _McpHalFsStatEntry	_mcpHalFs_StatCache[MCP_HAL_CONFIG_FS_STAT_CACHE_SIZE];
+static McpU32				_mcpHalFs_StatCacheNext;
+
+/* Protects the read buffers allocation and the stat cache */
+static pthread_mutex_t		_mcpHalFs_Lock = PTHREAD_MUTEX_INITIALIZER;
+
 
 /********************************************************************************
  *
@@ -98,6 +128,13 @@ static McpU32	 _McpHalFs_GetFreeScpaceInDirStructurArray(void);
 static McpHalFsStatus	_McpHalFs_ConvertLinuxErrorToFsError();
 static McpHalFsStatus	_McpHalFs_CheckIfDirHandleIsInValidAndRange(const McpHalFsDirDesc dirDesc);
 static void _McpHalFs_ExtractPermissions(mode_t file_mode, McpHalFsStat* fileStat);
+static _McpHalFsReadBuf *_McpHalFs_GetReadBuf(const McpHalFsFileDesc fd);
+static void _McpHalFs_AttachReadBuf(const McpHalFsFileDesc fd);
+static void _McpHalFs_DetachReadBuf(const McpHalFsFileDesc fd);
+static time_t _McpHalFs_GetMonotonicSec(void);
+static McpBool _McpHalFs_StatCacheLookup(const McpUtf8* fullPathName, McpHalFsStat* fileStat);
+static void _McpHalFs_StatCacheStore(const McpUtf8* fullPathName, const McpHalFsStat* fileStat);
+static void _McpHalFs_StatCacheInvalidate(void);
 
 
 /********************************************************************************
@@ -116,8 +153,19 @@ static void _McpHalFs_ExtractPermissions(mode_t file_mode, McpHalFsStat* fileSta
  */
 McpHalFsStatus MCP_HAL_FS_Init(void)
 {
+#if MCP_HAL_CONFIG_FS_READ_AHEAD_SIZE > 0
+	McpU32 index;
+
+	for (index = 0; index < MCP_HAL_CONFIG_FS_MAX_NUM_OF_BUFFERED_FILES; index++)
+	{
+		_mcpHalFs_ReadBufArray[index].fd = MCP_HAL_FS_INVALID_FILE_DESC;
+	}
+#endif
+
 	memset((void*)_mcpHalFs_DirStructureArray, 0, (MCP_HAL_CONFIG_FS_MAX_NUM_OF_OPEN_DIRS * sizeof(_McpHalFsDirHandle)));
 
+	_McpHalFs_StatCacheInvalidate();
+
 	return MCP_HAL_FS_STATUS_SUCCESS;
 }
 
@@ -279,6 +327,17 @@ McpHalFsStatus MCP_HAL_FS_Open(const McpUtf8* fullPathFileName, McpHalFsOpenFlag
 
     MCP_HAL_LOG_INFO(__FILE__, __LINE__, MCP_HAL_LOG_MODULE_TYPE_HAL_FS, ("MCP_HAL_FS_Open: opened %s", fullPathFileName));
 
+	if (flags & (MCP_HAL_FS_O_WRONLY | MCP_HAL_FS_O_RDWR | MCP_HAL_FS_O_APPEND | MCP_HAL_FS_O_CREATE | MCP_HAL_FS_O_TRUNC))
+	{
+		/* the file may be created, truncated or written */
+		_McpHalFs_StatCacheInvalidate();
+	}
+	else
+	{
+		/* read only, callers tend to read it in small pieces */
+		_McpHalFs_AttachReadBuf(filehandle);
+	}
+
 	*fd = filehandle;
 	return MCP_HAL_FS_STATUS_SUCCESS;
 }
@@ -296,6 +355,8 @@ McpHalFsStatus MCP_HAL_FS_Open(const McpUtf8* fullPathFileName, McpHalFsOpenFlag
  */
 McpHalFsStatus MCP_HAL_FS_Close( const McpHalFsFileDesc fd )
 {
+	_McpHalFs_DetachReadBuf(fd);
+
 	if(close(fd) != 0)
 		return _McpHalFs_ConvertLinuxErrorToFsError();
 
@@ -306,7 +367,8 @@ McpHalFsStatus MCP_HAL_FS_Close( const McpHalFsFileDesc fd )
  *            MCP_HAL_FS_Read
  *---------------------------------------------------------------------------
  *
- * Synopsis:  read file
+ * Synopsis:  read file. Files opened read only are served from their read-ahead
+ *			  buffer, requests of at least a buffer size bypass it.
  *
  * Return:    MCP_HAL_FS_STATUS_SUCCESS if success,
  *			  other - if failed.
@@ -315,6 +377,60 @@ McpHalFsStatus MCP_HAL_FS_Close( const McpHalFsFileDesc fd )
 McpHalFsStatus MCP_HAL_FS_Read ( const McpHalFsFileDesc fd, void* buf, McpU32 nSize, McpU32 *numRead )
 {
     int sNumRead;
+    _McpHalFsReadBuf *pReadBuf = _McpHalFs_GetReadBuf(fd);
+
+    if (NULL != pReadBuf)
+    {
+        McpU32 copied = 0;
+        McpU32 chunk;
+
+        while (copied < nSize)
+        {
+            if (pReadBuf->pos < pReadBuf->len)
+            {
+                chunk = pReadBuf->len - pReadBuf->pos;
+                if (chunk > nSize - copied)
+                {
+                    chunk = nSize - copied;
+                }
+                memcpy((McpU8*)buf + copied, &pReadBuf->data[pReadBuf->pos], chunk);
+                pReadBuf->pos += chunk;
+                copied += chunk;
+                continue;
+            }
+
+            if (nSize - copied >= sizeof(pReadBuf->data))
+            {
+                /* large request, read it directly */
+                sNumRead = read(fd, (McpU8*)buf + copied, nSize - copied);
+                if (sNumRead > 0)
+                {
+                    copied += (McpU32)sNumRead;
+                }
+            }
+            else
+            {
+                sNumRead = read(fd, pReadBuf->data, sizeof(pReadBuf->data));
+                pReadBuf->pos = 0;
+                pReadBuf->len = (sNumRead > 0) ? (McpU32)sNumRead : 0;
+                if (sNumRead > 0)
+                {
+                    continue;
+                }
+            }
+
+            if (sNumRead < 0 && copied == 0)
+            {
+                MCP_HAL_LOG_ERROR(__FILE__, __LINE__, MCP_HAL_LOG_MODULE_TYPE_HAL_FS, ("MCP_HAL_FS_Read: read failed: %s\n", strerror(errno)));
+                *numRead = 0;
+                return _McpHalFs_ConvertLinuxErrorToFsError();
+            }
+            break;
+        }
+
+        *numRead = copied;
+        return MCP_HAL_FS_STATUS_SUCCESS;
+    }
 
     sNumRead = read(fd,buf,nSize);
 
@@ -342,6 +458,8 @@ McpHalFsStatus MCP_HAL_FS_Write( const McpHalFsFileDesc fd, void* buf, McpU32 nS
 {
     int sNumWritten;
 
+    _McpHalFs_StatCacheInvalidate();
+
     sNumWritten = write(fd,buf,nSize);
 
     if (sNumWritten < 0) {
@@ -367,9 +485,14 @@ McpHalFsStatus MCP_HAL_FS_Write( const McpHalFsFileDesc fd, void* buf, McpU32 nS
 McpHalFsStatus MCP_HAL_FS_Tell( const McpHalFsFileDesc fd, McpU32 *curPosition )
 {
 	off_t offset;
+	_McpHalFsReadBuf *pReadBuf = _McpHalFs_GetReadBuf(fd);
 
 	offset = lseek(fd, 0, SEEK_CUR);
 	if (offset != (off_t)-1){
+		/* the read-ahead bytes not returned yet are not consumed */
+		if (NULL != pReadBuf)
+			offset -= (off_t)(pReadBuf->len - pReadBuf->pos);
+
 		*curPosition = offset;
 		return MCP_HAL_FS_STATUS_SUCCESS;
 	}
@@ -389,6 +512,7 @@ McpHalFsStatus MCP_HAL_FS_Tell( const McpHalFsFileDesc fd, McpU32 *curPosition )
 McpHalFsStatus MCP_HAL_FS_Seek( const McpHalFsFileDesc fd, McpS32 offset, McpHalFsSeekOrigin from )
 {
 	McpS32 origin;
+	_McpHalFsReadBuf *pReadBuf = _McpHalFs_GetReadBuf(fd);
 
 	switch(from)
 	{
@@ -407,6 +531,16 @@ McpHalFsStatus MCP_HAL_FS_Seek( const McpHalFsFileDesc fd, McpS32 offset, McpHal
 	    break;
 	}
 
+	if (NULL != pReadBuf)
+	{
+		/* drop the read-ahead, relative seeks are from the caller's position */
+		if (origin == SEEK_CUR)
+			offset -= (McpS32)(pReadBuf->len - pReadBuf->pos);
+
+		pReadBuf->len = 0;
+		pReadBuf->pos = 0;
+	}
+
 	if(lseek(fd,offset,origin) == -1 )
 		return _McpHalFs_ConvertLinuxErrorToFsError();
 
@@ -438,7 +572,7 @@ McpHalFsStatus MCP_HAL_FS_Flush( const McpHalFsFileDesc fd )
  *
  * Synopsis:  get information of a file or folder - name, size, type, 
  *            created/modified/accessed time, and Read/Write/Delete         . 
- *            access permissions.
+ *            access permissions. Recent results are served from the stat cache.
  *
  * Returns:	MCP_HAL_FS_STATUS_SUCCESS - if successful,
  *				other -  Operation failed.
@@ -448,6 +582,9 @@ McpHalFsStatus MCP_HAL_FS_Stat( const McpUtf8* fullPathName, McpHalFsStat* fileS
 	/* TODO (a0798989): support UTF-8 */
 
         struct stat buf;
+
+	if (_McpHalFs_StatCacheLookup(fullPathName, fileStat) == MCP_TRUE)
+		return MCP_HAL_FS_STATUS_SUCCESS;
 	
 	if (stat((char *)fullPathName, &buf) == 0)
 	{
@@ -475,6 +612,8 @@ McpHalFsStatus MCP_HAL_FS_Stat( const McpUtf8* fullPathName, McpHalFsStat* fileS
             /* set device id */
             fileStat->deviceId = buf.st_dev;
 
+            _McpHalFs_StatCacheStore(fullPathName, fileStat);
+
         return MCP_HAL_FS_STATUS_SUCCESS;
     }
 
@@ -496,6 +635,8 @@ McpHalFsStatus MCP_HAL_FS_Mkdir( const McpUtf8 *dirFullPathName )
 {
         /* TODO (a0798989): support UTF-8 */
 
+	_McpHalFs_StatCacheInvalidate();
+
 	/* Allow everyone to read dir, but only owner to change its contents */
 	if(mkdir((char *)dirFullPathName, 0755) == 0)
 		return MCP_HAL_FS_STATUS_SUCCESS;
@@ -516,6 +657,8 @@ McpHalFsStatus MCP_HAL_FS_Rmdir( const McpUtf8 *dirFullPathName )
 {
 	/* TODO (a0798989): support UTF-8 */
 
+	_McpHalFs_StatCacheInvalidate();
+
         if(rmdir((char *)dirFullPathName) == 0)
 		return MCP_HAL_FS_STATUS_SUCCESS;
 
@@ -648,6 +791,8 @@ McpHalFsStatus MCP_HAL_FS_Rename(const McpUtf8 *fullPathOldName, const McpUtf8 *
 {
         /* TODO (a0798989): support UTF-8 */
 
+	_McpHalFs_StatCacheInvalidate();
+
         if (rename((char *)fullPathOldName,(char *)fullPathNewName) != 0)
 	{
 		return _McpHalFs_ConvertLinuxErrorToFsError();
@@ -665,6 +810,8 @@ McpHalFsStatus MCP_HAL_FS_Remove( const McpUtf8 *fullPathFileName )
 {
 	/* TODO (a0798989): support UTF-8 */
 
+	_McpHalFs_StatCacheInvalidate();
+
         if(remove((char *)fullPathFileName) != 0)
 		return _McpHalFs_ConvertLinuxErrorToFsError();
 
@@ -691,6 +838,74 @@ McpHalFsStatus MCP_HAL_FS_IsAbsoluteName( const McpUtf8 *fileName, McpBool *isAb
 	return MCP_HAL_FS_STATUS_ERROR_NOTAFILE;
 }
 
+/*-------------------------------------------------------------------------------
+ *
+ *  MCP_HAL_FS_Map
+ *
+ *  maps a whole file into memory, read only
+ */ 
+McpHalFsStatus MCP_HAL_FS_Map( const McpUtf8 *fullPathFileName, const McpU8 **ppData, McpU32 *pSize )
+{
+	struct stat buf;
+	void *pMap;
+	int filehandle;
+
+	*ppData = NULL;
+	*pSize = 0;
+
+	filehandle = open((char *)fullPathFileName, O_RDONLY);
+	if (-1 == filehandle)
+	{
+		MCP_HAL_LOG_INFO(__FILE__, __LINE__, MCP_HAL_LOG_MODULE_TYPE_HAL_FS, ("MCP_HAL_FS_Map: failed to open %s", fullPathFileName));
+		return _McpHalFs_ConvertLinuxErrorToFsError();
+	}
+
+	if (fstat(filehandle, &buf) != 0)
+	{
+		close(filehandle);
+		return _McpHalFs_ConvertLinuxErrorToFsError();
+	}
+
+	if (buf.st_size == 0)
+	{
+		close(filehandle);
+		return MCP_HAL_FS_STATUS_SUCCESS;
+	}
+
+	pMap = mmap(NULL, (size_t)buf.st_size, PROT_READ, MAP_PRIVATE, filehandle, 0);
+
+	/* the mapping does not need the descriptor */
+	close(filehandle);
+
+	if (MAP_FAILED == pMap)
+	{
+		MCP_HAL_LOG_ERROR(__FILE__, __LINE__, MCP_HAL_LOG_MODULE_TYPE_HAL_FS, ("MCP_HAL_FS_Map: mmap failed: %s\n", strerror(errno)));
+		return _McpHalFs_ConvertLinuxErrorToFsError();
+	}
+
+	*ppData = (const McpU8 *)pMap;
+	*pSize = (McpU32)buf.st_size;
+
+	return MCP_HAL_FS_STATUS_SUCCESS;
+}
+
+/*-------------------------------------------------------------------------------
+ *
+ *  MCP_HAL_FS_Unmap
+ *
+ *  releases a file mapped by MCP_HAL_FS_Map
+ */ 
+McpHalFsStatus MCP_HAL_FS_Unmap( const McpU8 *pData, McpU32 size )
+{
+	if ((NULL == pData) || (0 == size))
+		return MCP_HAL_FS_STATUS_SUCCESS;
+
+	if (munmap((void *)pData, size) != 0)
+		return _McpHalFs_ConvertLinuxErrorToFsError();
+
+	return MCP_HAL_FS_STATUS_SUCCESS;
+}
+
 /*-------------------------------------------------------------------------------
  *
  * MCP_HAL_FS_ExtractDateAndTime()
@@ -705,9 +920,12 @@ void	MCP_HAL_FS_ExtractDateAndTime(time_t st_time, McpHalDateAndTime *dateAndTim
     
     McpU8 str[20];
     McpU8 *pStr;
+    char timeStr[32];
     
-    struct tm *pUtcTime;
+    struct tm utcTime;
 
+    /* Local parser context, so concurrent callers do not share parsing state */
+    McpLinuxLineParserContext		parserCtx;
     MCP_LINUX_LINE_PARSER_STATUS 	status;
     McpU16 idx;
 
@@ -724,26 +942,29 @@ void	MCP_HAL_FS_ExtractDateAndTime(time_t st_time, McpHalDateAndTime *dateAndTim
     MCP_HAL_MEMORY_MemSet(dateAndTimeStruct, 0, sizeof(McpHalDateAndTime));
 
     
-    /* The fields of pUtcTime hold the evaluated value of the st_time 
+    /* The fields of utcTime hold the evaluated value of the st_time 
        argument in UTC rather than in local time. */
-    pUtcTime = gmtime( &st_time );
-
-    if (NULL == pUtcTime)
+    if (NULL == gmtime_r( &st_time, &utcTime ))
     {
         /* If timer represents a date before midnight, January 1, 1970, 
            gmtime returns NULL */
         return;
     }
     
-    /* Converts a pUtcTime structure to a character string.*/
+    /* Converts the utcTime structure to a character string.*/
     /* The format in pStr is: "Tue May 08 17:23:04 2007" */
-    pStr = (McpU8*)asctime( pUtcTime );
+    pStr = (McpU8*)asctime_r( &utcTime, timeStr );
+
+    if (NULL == pStr)
+    {
+        return;
+    }
     
-    /* Now, we shall extract the dateAndTimeStruct fields from pUtcTime string */ 
+    /* Now, we shall extract the dateAndTimeStruct fields from the time string */ 
     
     /* Instructs the parser to search for 'SP' (space) and ':' (column) delimiters */
 
-    status = MCP_LINUX_LINE_PARSER_ParseLine( pStr, " :" );
+    status = MCP_LINUX_LINE_PARSER_ParseLineCtx( &parserCtx, pStr, " :" );
 	
 	if (status != MCP_LINUX_LINE_PARSER_STATUS_SUCCESS)
 	{
@@ -751,13 +972,13 @@ void	MCP_HAL_FS_ExtractDateAndTime(time_t st_time, McpHalDateAndTime *dateAndTim
 	}
     
     /* Skip the first argument */
-    if (MCP_LINUX_LINE_PARSER_STATUS_SUCCESS != MCP_LINUX_LINE_PARSER_GetNextStr(str, MCP_LINUX_LINE_PARSER_MAX_STR_LEN))
+    if (MCP_LINUX_LINE_PARSER_STATUS_SUCCESS != MCP_LINUX_LINE_PARSER_GetNextStrCtx(&parserCtx, str, (McpU8)(sizeof(str) - 1)))
 	{
 		return;
 	}
 
     /* Get month */
-    if (MCP_LINUX_LINE_PARSER_STATUS_SUCCESS != MCP_LINUX_LINE_PARSER_GetNextStr(str, MCP_LINUX_LINE_PARSER_MAX_STR_LEN))
+    if (MCP_LINUX_LINE_PARSER_STATUS_SUCCESS != MCP_LINUX_LINE_PARSER_GetNextStrCtx(&parserCtx, str, (McpU8)(sizeof(str) - 1)))
 	{
 		return;
 	}
@@ -772,31 +993,31 @@ void	MCP_HAL_FS_ExtractDateAndTime(time_t st_time, McpHalDateAndTime *dateAndTim
     }
     
     /* Get day */
-    if (MCP_LINUX_LINE_PARSER_STATUS_SUCCESS != MCP_LINUX_LINE_PARSER_GetNextU16(&day, MCP_LINUX_LINE_PARSER_MAX_STR_LEN))
+    if (MCP_LINUX_LINE_PARSER_STATUS_SUCCESS != MCP_LINUX_LINE_PARSER_GetNextU16Ctx(&parserCtx, &day, MCP_FALSE))
 	{
 		return;
 	}
 
     /* Get hour */
-    if (MCP_LINUX_LINE_PARSER_STATUS_SUCCESS != MCP_LINUX_LINE_PARSER_GetNextU16(&hour, MCP_LINUX_LINE_PARSER_MAX_STR_LEN))
+    if (MCP_LINUX_LINE_PARSER_STATUS_SUCCESS != MCP_LINUX_LINE_PARSER_GetNextU16Ctx(&parserCtx, &hour, MCP_FALSE))
 	{
 		return;
 	}
 
     /* Get minutes */
-    if (MCP_LINUX_LINE_PARSER_STATUS_SUCCESS != MCP_LINUX_LINE_PARSER_GetNextU16(&minute, MCP_LINUX_LINE_PARSER_MAX_STR_LEN))
+    if (MCP_LINUX_LINE_PARSER_STATUS_SUCCESS != MCP_LINUX_LINE_PARSER_GetNextU16Ctx(&parserCtx, &minute, MCP_FALSE))
 	{
 		return;
 	}
 
     /* Get seconds */
-    if (MCP_LINUX_LINE_PARSER_STATUS_SUCCESS != MCP_LINUX_LINE_PARSER_GetNextU16(&second, MCP_LINUX_LINE_PARSER_MAX_STR_LEN))
+    if (MCP_LINUX_LINE_PARSER_STATUS_SUCCESS != MCP_LINUX_LINE_PARSER_GetNextU16Ctx(&parserCtx, &second, MCP_FALSE))
 	{
 		return;
 	}
 
     /* Get year */
-    if (MCP_LINUX_LINE_PARSER_STATUS_SUCCESS != MCP_LINUX_LINE_PARSER_GetNextU16(&year, MCP_LINUX_LINE_PARSER_MAX_STR_LEN))
+    if (MCP_LINUX_LINE_PARSER_STATUS_SUCCESS != MCP_LINUX_LINE_PARSER_GetNextU16Ctx(&parserCtx, &year, MCP_FALSE))
 	{
 		return;
 	}
@@ -855,6 +1076,185 @@ static void _McpHalFs_ExtractPermissions(mode_t file_mode, McpHalFsStat* fileSta
 	}
 }
 
+/*---------------------------------------------------------------------------
+ *            _McpHalFs_GetReadBuf
+ *---------------------------------------------------------------------------
+ *
+ * Synopsis:  get the read-ahead buffer of a file
+ *
+ * Return:    the buffer, NULL if the file is not buffered
+ *
+ */ 
+static _McpHalFsReadBuf *_McpHalFs_GetReadBuf(const McpHalFsFileDesc fd)
+{
+#if MCP_HAL_CONFIG_FS_READ_AHEAD_SIZE > 0
+	McpU32 index;
+
+	/* a slot is only changed by opening or closing its own descriptor */
+	for (index = 0; index < MCP_HAL_CONFIG_FS_MAX_NUM_OF_BUFFERED_FILES; index++)
+	{
+		if (_mcpHalFs_ReadBufArray[index].fd == fd)
+		{
+			return &_mcpHalFs_ReadBufArray[index];
+		}
+	}
+#else
+	(void)fd;
+#endif
+	return NULL;
+}
+
+/*---------------------------------------------------------------------------
+ *            _McpHalFs_AttachReadBuf
+ *---------------------------------------------------------------------------
+ *
+ * Synopsis:  allocate a read-ahead buffer to a file, if one is free
+ *
+ * Return:    void
+ *
+ */ 
+static void _McpHalFs_AttachReadBuf(const McpHalFsFileDesc fd)
+{
+#if MCP_HAL_CONFIG_FS_READ_AHEAD_SIZE > 0
+	McpU32 index;
+
+	pthread_mutex_lock(&_mcpHalFs_Lock);
+	for (index = 0; index < MCP_HAL_CONFIG_FS_MAX_NUM_OF_BUFFERED_FILES; index++)
+	{
+		if (_mcpHalFs_ReadBufArray[index].fd == MCP_HAL_FS_INVALID_FILE_DESC)
+		{
+			_mcpHalFs_ReadBufArray[index].len = 0;
+			_mcpHalFs_ReadBufArray[index].pos = 0;
+			_mcpHalFs_ReadBufArray[index].fd = fd;
+			break;
+		}
+	}
+	pthread_mutex_unlock(&_mcpHalFs_Lock);
+#else
+	(void)fd;
+#endif
+}
+
+/*---------------------------------------------------------------------------
+ *            _McpHalFs_DetachReadBuf
+ *---------------------------------------------------------------------------
+ *
+ * Synopsis:  free the read-ahead buffer of a file
+ *
+ * Return:    void
+ *
+ */ 
+static void _McpHalFs_DetachReadBuf(const McpHalFsFileDesc fd)
+{
+	_McpHalFsReadBuf *pReadBuf = _McpHalFs_GetReadBuf(fd);
+
+	if (NULL != pReadBuf)
+	{
+		pthread_mutex_lock(&_mcpHalFs_Lock);
+		pReadBuf->fd = MCP_HAL_FS_INVALID_FILE_DESC;
+		pthread_mutex_unlock(&_mcpHalFs_Lock);
+	}
+}
+
+/*---------------------------------------------------------------------------
+ *            _McpHalFs_GetMonotonicSec
+ *---------------------------------------------------------------------------
+ *
+ * Synopsis:  get time in seconds that is not affected by system time changes
+ *
+ * Return:    time_t
+ *
+ */ 
+static time_t _McpHalFs_GetMonotonicSec(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec;
+}
+
+/*---------------------------------------------------------------------------
+ *            _McpHalFs_StatCacheLookup
+ *---------------------------------------------------------------------------
+ *
+ * Synopsis:  look for a valid cached stat result of a path
+ *
+ * Return:    MCP_TRUE if found, fileStat is filled
+ *
+ */ 
+static McpBool _McpHalFs_StatCacheLookup(const McpUtf8* fullPathName, McpHalFsStat* fileStat)
+{
+	McpBool found = MCP_FALSE;
+	time_t now = _McpHalFs_GetMonotonicSec();
+	McpU32 index;
+
+	pthread_mutex_lock(&_mcpHalFs_Lock);
+	for (index = 0; index < MCP_HAL_CONFIG_FS_STAT_CACHE_SIZE; index++)
+	{
+		_McpHalFsStatEntry *pEntry = &_mcpHalFs_StatCache[index];
+
+		if ((pEntry->busy == MCP_TRUE) &&
+			(now - pEntry->timestamp < MCP_HAL_CONFIG_FS_STAT_CACHE_TTL_SEC) &&
+			(strcmp((char *)pEntry->path, (char *)fullPathName) == 0))
+		{
+			*fileStat = pEntry->stat;
+			found = MCP_TRUE;
+			break;
+		}
+	}
+	pthread_mutex_unlock(&_mcpHalFs_Lock);
+
+	return found;
+}
+
+/*---------------------------------------------------------------------------
+ *            _McpHalFs_StatCacheStore
+ *---------------------------------------------------------------------------
+ *
+ * Synopsis:  keep a stat result, replacing the oldest stored entry
+ *
+ * Return:    void
+ *
+ */ 
+static void _McpHalFs_StatCacheStore(const McpUtf8* fullPathName, const McpHalFsStat* fileStat)
+{
+	_McpHalFsStatEntry *pEntry;
+
+	if (strlen((char *)fullPathName) > MCP_HAL_CONFIG_FS_MAX_PATH_LEN_CHARS)
+		return;
+
+	pthread_mutex_lock(&_mcpHalFs_Lock);
+	pEntry = &_mcpHalFs_StatCache[_mcpHalFs_StatCacheNext];
+	_mcpHalFs_StatCacheNext = (_mcpHalFs_StatCacheNext + 1) % MCP_HAL_CONFIG_FS_STAT_CACHE_SIZE;
+
+	strcpy((char *)pEntry->path, (char *)fullPathName);
+	pEntry->stat = *fileStat;
+	pEntry->timestamp = _McpHalFs_GetMonotonicSec();
+	pEntry->busy = MCP_TRUE;
+	pthread_mutex_unlock(&_mcpHalFs_Lock);
+}
+
+/*---------------------------------------------------------------------------
+ *            _McpHalFs_StatCacheInvalidate
+ *---------------------------------------------------------------------------
+ *
+ * Synopsis:  drop all cached stat results
+ *
+ * Return:    void
+ *
+ */ 
+static void _McpHalFs_StatCacheInvalidate(void)
+{
+	McpU32 index;
+
+	pthread_mutex_lock(&_mcpHalFs_Lock);
+	for (index = 0; index < MCP_HAL_CONFIG_FS_STAT_CACHE_SIZE; index++)
+	{
+		_mcpHalFs_StatCache[index].busy = MCP_FALSE;
+	}
+	pthread_mutex_unlock(&_mcpHalFs_Lock);
+}
+
 /*---------------------------------------------------------------------------
  *            MCP_HAL_FS_fopen
  *---------------------------------------------------------------------------
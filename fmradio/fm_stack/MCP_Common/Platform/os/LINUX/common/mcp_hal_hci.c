@@ -50,6 +50,16 @@
 
 #define HAL_HCI_HOST_NUM_COMPLETED_PACKETS   0x0C35
 
+/* Commands sent or waiting for a controller credit, over all the socket clients */
+#define HAL_HCI_MAX_CMDS_OUTSTANDING	8
+
+/* Packet type, command header and the longest command payload */
+#define HAL_HCI_MAX_CMD_PACKET_SIZE	(1 + HAL_HCI_COMMAND_HDR_SIZE + 255)
+
+/* Command Complete: num packets, opcode. Command Status: status, num packets, opcode */
+#define HAL_HCI_EVT_COMPLETED_OFFSET_TO_NUM_PKTS	3
+#define HAL_HCI_EVT_STATUS_OFFSET_TO_NUM_PKTS		4
+
 typedef sem_t*          	SEM_HANDLE;
 
 typedef struct  {
@@ -58,6 +68,17 @@ typedef struct  {
 								   evtType[0] == 0xff makes a wildcard */  	
 } hci_filter_t;
 
+typedef struct  {
+	McpBool			bInUse;			/* command was not completed yet */
+	McpBool			bSent;			/* command was written - otherwise it waits for a credit */
+	McpU16			opcode;
+	McpU32			uSendOrder;		/* to complete the oldest command of an opcode first */
+	fHciCallback	CmdCompleteCallback;
+	handle_t		hCmdComplete;
+	McpU32			uPacketLen;
+	McpU8			packet[HAL_HCI_MAX_CMD_PACKET_SIZE];
+} tHalHciCmd;
+
 typedef struct  {
 
 	handle_t 			hMcpf;
@@ -65,11 +86,19 @@ typedef struct  {
 	int				fd;
 	hci_filter_t		flt;
 	fHciCallback		RxIndCallabck;
-	fHciCallback		CmdCompleteCallback;
 	handle_t			hRxInd;
-	handle_t			hCmdComplete;
-   
-	McpU16		opcodeSent; 
+
+	/* 
+	 * commands outstanding - the controller accepts as many commands as it reports in its
+	 * last command complete / status event, and the rest are written once it reports more
+	 */
+	tHalHciCmd		cmds[HAL_HCI_MAX_CMDS_OUTSTANDING];
+	McpU32			uCmdCredits;
+	McpU32			uNextSendOrder;
+
+	/* receives the completions that match no outstanding command, as the single callback did */
+	fHciCallback	LastCmdCompleteCallback;
+	handle_t		hLastCmdComplete;
 
 	/* internal parameters */
 	pthread_mutex_t		opcodeLock;
@@ -80,6 +109,11 @@ typedef struct  {
  } tHalHci;
 
 static handle_t hal_hci_ReceiverThread(handle_t hHalHci);
+static eHalHciStatus hal_hci_WriteCmd(tHalHci *pHalHci, tHalHciCmd *pCmd);
+static McpBool hal_hci_CompleteCmd(tHalHci *pHalHci, McpU8 *buf, int len, 
+								fHciCallback *pCallback, handle_t *phCmdComplete,
+								fHciCallback *pFailedCallbacks, handle_t *phFailedCmdComplete,
+								McpU16 *pFailedOpcodes, McpU32 *puNumFailedCmds);
 static void signalSem  (handle_t hMcpf, SEM_HANDLE hSem);
 static void waitForSem (handle_t hMcpf, SEM_HANDLE hSem);
 
@@ -123,6 +157,9 @@ handle_t hal_hci_OpenSocket(handle_t hMcpf, int hci_dev, McpU32 pktTypeMask, Mcp
 	mcpf_mem_set(hMcpf ,pHalHci, 0, sizeof(tHalHci));
 
 	pHalHci->hMcpf = hMcpf;
+
+	/* the host may send a single command until the controller reports otherwise */
+	pHalHci->uCmdCredits = 1;
 	
 	/* Create Buf Avialable semaphore */
     if (sem_init(&pHalHci->tSemBufAvail,
@@ -307,6 +344,8 @@ eHalHciStatus hal_hci_SendPacket(
  *                         be comared against following command complete events)
  *  Note that command complete will always be received asynchronously (i.e. in callback), while
  *  this send will return PENDING status upon successful operation.
+ *  Several commands may be outstanding - a command the controller has no credit for is kept,
+ *  and written by the receiver thread once a command complete / status event returns a credit.
  *
  * Parameters:
  *  hHalHci - handle of HalHci
@@ -314,7 +353,9 @@ eHalHciStatus hal_hci_SendPacket(
  *  hciCmdParms - pointer to hci command payload
  *  hciCmdLen - length of command payload buffer
  *  CmdCompleteCallback - callback function for command complete events
- *               (same function can be registered for the 2 callbacks if needed)
+ *               (same function can be registered for the 2 callbacks if needed). If a command 
+ *               kept for a credit fails to be written, it is called with HAL_HCI_STATUS_FAILED
+ *               and the command packet type and opcode instead of an event
  *  hCmdComplete - client handle (user data) that will be used as first parameter of the callbacks 
  *
  * Return Code: HAL_HCI_STATUS_PENDING upon succesfull transfer or HAL_HCI_STATUS_FAILED otherwise
@@ -328,44 +369,79 @@ eHalHciStatus  hal_hci_SendCommand(
 					void			*hCmdComplete)
 {
 	McpU8 hciHeader[HAL_HCI_COMMAND_HDR_SIZE], *hciFrag[2];
-	McpU32 HciFragLen[2];
+	McpU32 HciFragLen[2], i;
 	McpU8 hciCmdLenU8 = (McpU8)hciCmdLen;
+	McpU16 opcodeLE = __cpu_to_le16(hciOpcode);
 	tHalHci *pHalHci = (tHalHci *)hHalHci;
+	tHalHciCmd *pCmd = NULL;
+	eHalHciStatus status = HAL_HCI_STATUS_PENDING;
 
        MCPF_REPORT_INFORMATION(pHalHci->hMcpf, HAL_HCI_MODULE_LOG, 
 									("Enter hal_hci_SendCommand"));
 	
 	MCPF_Assert(pHalHci); 
+	MCPF_Assert(hciCmdLen <= HAL_HCI_MAX_CMD_PACKET_SIZE - 1 - HAL_HCI_COMMAND_HDR_SIZE);
 
-	/* Only one command at a time is allowed && 
-	    HOST_NUM_COMPLETED_PACKETS command doesn't have a CMD COMPLETE */
-	MCPF_Assert((pHalHci->opcodeSent == 0) || 
-		(pHalHci->opcodeSent == HAL_HCI_HOST_NUM_COMPLETED_PACKETS)); 
-
-	pHalHci->CmdCompleteCallback = CmdCompleteCallback;
-	pHalHci->hCmdComplete = hCmdComplete;
+	MCPF_REPORT_INFORMATION(pHalHci->hMcpf, HAL_HCI_MODULE_LOG, 
+									("hal_hci_SendCommand: hci command opcode = %x", hciOpcode));
 
+	/* HOST_NUM_COMPLETED_PACKETS command doesn't have a CMD COMPLETE, and needs no credit */
+	if (HAL_HCI_HOST_NUM_COMPLETED_PACKETS == hciOpcode)
+	{
+		memcpy(hciHeader, &opcodeLE, sizeof(opcodeLE));
+		memcpy(hciHeader + sizeof(opcodeLE), &hciCmdLenU8, sizeof(hciCmdLenU8));
+		hciFrag[0] = hciHeader;
+		HciFragLen[0] = sizeof(hciHeader);
+		hciFrag[1] = hciCmdParms;
+		HciFragLen[1] = hciCmdLen;
+
+		return hal_hci_SendPacket(hHalHci, HAL_HCI_COMMAND_PKT, 2, hciFrag, HciFragLen);
+	}
 
 	pthread_mutex_lock(&pHalHci->opcodeLock);
-	pHalHci->opcodeSent = __cpu_to_le16(hciOpcode);
-	pthread_mutex_unlock(&pHalHci->opcodeLock);
-	
-	MCPF_REPORT_INFORMATION(pHalHci->hMcpf, HAL_HCI_MODULE_LOG, 
-									("hal_hci_SendCommand: hci command opcode = %x", hciOpcode));
 
+	for (i = 0; i < HAL_HCI_MAX_CMDS_OUTSTANDING; i++)
+	{
+		if (MCP_FALSE == pHalHci->cmds[i].bInUse)
+		{
+			pCmd = &pHalHci->cmds[i];
+			break;
+		}
+	}
 
-	/* build the HCI command */
-	memcpy(hciHeader, &pHalHci->opcodeSent, sizeof(pHalHci->opcodeSent));
-	memcpy(hciHeader + sizeof(pHalHci->opcodeSent), &hciCmdLenU8, sizeof(hciCmdLenU8));
-	hciFrag[0] = hciHeader;
-	HciFragLen[0] = sizeof(hciHeader);
-	hciFrag[1] = hciCmdParms;
-	HciFragLen[1] = hciCmdLen;
-	
-	
-	/* send the HCI command */
-	return hal_hci_SendPacket(hHalHci, HAL_HCI_COMMAND_PKT, 2, hciFrag, HciFragLen);
-	
+	if (NULL == pCmd)
+	{
+		pthread_mutex_unlock(&pHalHci->opcodeLock);
+		MCPF_REPORT_ERROR(pHalHci->hMcpf, HAL_HCI_MODULE_LOG, 
+								("hal_hci_SendCommand: too many commands outstanding"));
+		return HAL_HCI_STATUS_FAILED;
+	}
+
+	/* build the HCI command - kept until written, as the caller may reuse its parameters */
+	pCmd->packet[0] = HAL_HCI_COMMAND_PKT;
+	memcpy(&pCmd->packet[1], &opcodeLE, sizeof(opcodeLE));
+	pCmd->packet[1 + sizeof(opcodeLE)] = hciCmdLenU8;
+	memcpy(&pCmd->packet[1 + HAL_HCI_COMMAND_HDR_SIZE], hciCmdParms, hciCmdLen);
+	pCmd->uPacketLen = 1 + HAL_HCI_COMMAND_HDR_SIZE + hciCmdLen;
+
+	pCmd->opcode = hciOpcode;
+	pCmd->uSendOrder = pHalHci->uNextSendOrder++;
+	pCmd->CmdCompleteCallback = CmdCompleteCallback;
+	pCmd->hCmdComplete = hCmdComplete;
+	pCmd->bSent = MCP_FALSE;
+	pHalHci->LastCmdCompleteCallback = CmdCompleteCallback;
+	pHalHci->hLastCmdComplete = hCmdComplete;
+	pCmd->bInUse = MCP_TRUE;
+
+	/* no credit - the command is written when a command complete / status returns one */
+	if (0 < pHalHci->uCmdCredits)
+	{
+		status = hal_hci_WriteCmd(pHalHci, pCmd);
+	}
+
+	pthread_mutex_unlock(&pHalHci->opcodeLock);
+
+	return status;
 }
 
 /** 
@@ -537,13 +613,45 @@ static handle_t hal_hci_ReceiverThread(handle_t hHalHci)
 			MCPF_REPORT_INFORMATION(pHalHci->hMcpf, HAL_HCI_MODULE_LOG, 
 										("evtType = %x", evtType));
 
+			fHciCallback	CmdCompleteCallback;
+			handle_t		hCmdComplete;
+			fHciCallback	failedCallbacks[HAL_HCI_MAX_CMDS_OUTSTANDING];
+			handle_t		hFailedCmdComplete[HAL_HCI_MAX_CMDS_OUTSTANDING];
+			McpU16			failedOpcodes[HAL_HCI_MAX_CMDS_OUTSTANDING];
+			McpU32			uNumFailedCmds, uFailed;
+			McpU8			failedCmdHdr[3];
+			McpBool			bCreditsOnly;
+
+			bCreditsOnly = hal_hci_CompleteCmd(pHalHci, buf, len, &CmdCompleteCallback, &hCmdComplete,
+											   failedCallbacks, hFailedCmdComplete, failedOpcodes,
+											   &uNumFailedCmds);
+
+			/* 
+			 * commands held for a credit which failed to be written will not be completed - 
+			 * report the failure with the command packet type and opcode
+			 */
+			for (uFailed = 0; uFailed < uNumFailedCmds; uFailed++)
+			{
+				failedCmdHdr[0] = HAL_HCI_COMMAND_PKT;
+				failedCmdHdr[1] = (McpU8)failedOpcodes[uFailed];
+				failedCmdHdr[2] = (McpU8)(failedOpcodes[uFailed] >> 8);
+
+				failedCallbacks[uFailed](hFailedCmdComplete[uFailed], failedCmdHdr, sizeof(failedCmdHdr),
+										 HAL_HCI_STATUS_FAILED);
+			}
+
+			/* a credit update only, or no command was sent yet */
+			if ((MCP_TRUE == bCreditsOnly) || (NULL == CmdCompleteCallback))
+			{
+				continue;
+			}
+
 			MCPF_REPORT_INFORMATION(pHalHci->hMcpf, HAL_HCI_MODULE_LOG, 
 					("ReceiverThread call the CMD Complete callback" )); 
 
-			pHalHci->opcodeSent = 0;
 			/* If Cmd Cmplt CB returns PENDING --> Rx Congestion */
 			/* Wait for indication from stack that buffer is avialable */
-			while ( RES_PENDING == pHalHci->CmdCompleteCallback(pHalHci->hCmdComplete, buf, len, 
+			while ( RES_PENDING == CmdCompleteCallback(hCmdComplete, buf, len, 
 														HAL_HCI_STATUS_SUCCESS) )
 			{
 				waitForSem (pHalHci->hMcpf, &pHalHci->tSemBufAvail);
@@ -574,6 +682,130 @@ close:
 	return NULL;
 }
 
+/*
+ * hal_hci_WriteCmd - Write an outstanding command, consuming a controller credit.
+ *  Called with the opcode lock taken.
+ *
+ * Parameters:
+ *  pHalHci - HalHci object
+ *  pCmd - the command to write
+ *
+ * Return Code: HAL_HCI_STATUS_PENDING upon succesfull transfer or HAL_HCI_STATUS_FAILED otherwise
+ */
+static eHalHciStatus hal_hci_WriteCmd(tHalHci *pHalHci, tHalHciCmd *pCmd)
+{
+	if (write(pHalHci->fd, pCmd->packet, pCmd->uPacketLen) < 0)
+	{
+		MCPF_REPORT_ERROR(pHalHci->hMcpf, HAL_HCI_MODULE_LOG, 
+								("hal_hci_WriteCmd: failed to send command %x", pCmd->opcode));
+		pCmd->bInUse = MCP_FALSE;
+		return HAL_HCI_STATUS_FAILED;
+	}
+
+	pCmd->bSent = MCP_TRUE;
+	pHalHci->uCmdCredits--;
+
+	return HAL_HCI_STATUS_PENDING;
+}
+
+/*
+ * hal_hci_CompleteCmd - Handle a command complete / status event: update the controller credits,
+ *  release the oldest written command of the event opcode, and write the commands that waited
+ *  for a credit, in the order they were sent.
+ *  An event which matches no outstanding command is for the sender of the last command, as 
+ *  with a single outstanding command.
+ *
+ * Parameters:
+ *  pHalHci - HalHci object
+ *  buf, len - the received event packet
+ *  pCallback, phCmdComplete - [out] the callback the event is passed to, or NULL
+ *  pFailedCallbacks, phFailedCmdComplete, pFailedOpcodes, puNumFailedCmds - [out] the callbacks 
+ *                  and opcodes of the commands that failed to be written, to be called with 
+ *                  HAL_HCI_STATUS_FAILED
+ *
+ * Return Code: MCP_TRUE if the event only returns credits (opcode 0), MCP_FALSE otherwise
+ */
+static McpBool hal_hci_CompleteCmd(tHalHci *pHalHci, McpU8 *buf, int len, 
+								fHciCallback *pCallback, handle_t *phCmdComplete,
+								fHciCallback *pFailedCallbacks, handle_t *phFailedCmdComplete,
+								McpU16 *pFailedOpcodes, McpU32 *puNumFailedCmds)
+{
+	tHalHciCmd *pCmd, *pMatch = NULL, *pNext;
+	McpU32 uNumPktsOffset, i;
+	McpU16 opcode;
+
+	*puNumFailedCmds = 0;
+
+	pthread_mutex_lock(&pHalHci->opcodeLock);
+
+	*pCallback = pHalHci->LastCmdCompleteCallback;
+	*phCmdComplete = pHalHci->hLastCmdComplete;
+
+	uNumPktsOffset = (HAL_HCI_EVT_COMPLETED == buf[1]) ? 
+						HAL_HCI_EVT_COMPLETED_OFFSET_TO_NUM_PKTS : HAL_HCI_EVT_STATUS_OFFSET_TO_NUM_PKTS;
+	if ((McpU32)len < uNumPktsOffset + 3)
+	{
+		pthread_mutex_unlock(&pHalHci->opcodeLock);
+		MCPF_REPORT_ERROR(pHalHci->hMcpf, HAL_HCI_MODULE_LOG, 
+								("hal_hci_CompleteCmd: event too short (%d)", len));
+		return MCP_FALSE;
+	}
+	opcode = (McpU16)(buf[uNumPktsOffset + 1] | (buf[uNumPktsOffset + 2] << 8));
+
+	pHalHci->uCmdCredits = buf[uNumPktsOffset];
+
+	/* opcode 0 only returns credits */
+	for (i = 0; (0 != opcode) && (i < HAL_HCI_MAX_CMDS_OUTSTANDING); i++)
+	{
+		pCmd = &pHalHci->cmds[i];
+		if ((MCP_TRUE == pCmd->bInUse) && (MCP_TRUE == pCmd->bSent) && (opcode == pCmd->opcode) &&
+			((NULL == pMatch) || (0 > (McpS32)(pCmd->uSendOrder - pMatch->uSendOrder))))
+		{
+			pMatch = pCmd;
+		}
+	}
+
+	if (NULL != pMatch)
+	{
+		*pCallback = pMatch->CmdCompleteCallback;
+		*phCmdComplete = pMatch->hCmdComplete;
+		pMatch->bInUse = MCP_FALSE;
+	}
+
+	/* write the commands that waited for a credit, oldest first */
+	while (0 < pHalHci->uCmdCredits)
+	{
+		pNext = NULL;
+		for (i = 0; i < HAL_HCI_MAX_CMDS_OUTSTANDING; i++)
+		{
+			pCmd = &pHalHci->cmds[i];
+			if ((MCP_TRUE == pCmd->bInUse) && (MCP_FALSE == pCmd->bSent) &&
+				((NULL == pNext) || (0 > (McpS32)(pCmd->uSendOrder - pNext->uSendOrder))))
+			{
+				pNext = pCmd;
+			}
+		}
+
+		if (NULL == pNext)
+		{
+			break;
+		}
+
+		/* a failed write releases the command - its sender is told once the lock is dropped */
+		if (HAL_HCI_STATUS_FAILED == hal_hci_WriteCmd(pHalHci, pNext))
+		{
+			pFailedCallbacks[*puNumFailedCmds] = pNext->CmdCompleteCallback;
+			phFailedCmdComplete[*puNumFailedCmds] = pNext->hCmdComplete;
+			pFailedOpcodes[*puNumFailedCmds] = pNext->opcode;
+			(*puNumFailedCmds)++;
+		}
+	}
+
+	pthread_mutex_unlock(&pHalHci->opcodeLock);
+
+	return ((0 == opcode) ? MCP_TRUE : MCP_FALSE);
+}
+
 /**
  * \fn     signalSem
  * \brief  Signal semaphore
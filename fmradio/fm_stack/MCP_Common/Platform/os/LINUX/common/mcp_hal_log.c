@@ -128,6 +128,24 @@ FILE* log_output_handle = NULL;
  * to ease having a consistent self identifying logs */
 static pthread_key_t thread_name;
 
+/* this key holds the per-thread buffer MCP_HAL_LOG_FormatMsg() formats into,
+ * so that threads logging concurrently do not overwrite each other's message */
+static pthread_key_t thread_fmt_buf;
+static pthread_once_t thread_keys_once = PTHREAD_ONCE_INIT;
+static McpU8 gThreadKeysCreated = 0;
+
+/* the per-thread buffers are also linked in a list, so MCP_HAL_LOG_Deinit() can release
+ * the buffers of threads that are still alive - deleting the key does not call its destructor */
+typedef struct _McpHalLogFmtBuf
+{
+    struct _McpHalLogFmtBuf *pNext;
+    struct _McpHalLogFmtBuf *pPrev;
+    char buf[MCP_HAL_MAX_FORMATTED_MSG_LEN + 1];
+} McpHalLogFmtBuf;
+
+static McpHalLogFmtBuf *gFmtBufs = NULL;
+static pthread_mutex_t gFmtBufsLock = PTHREAD_MUTEX_INITIALIZER;
+
 #ifdef ANDROID
 void MCP_HAL_LOG_EnableLogToAndroid(const char *app_name)
 {
@@ -221,9 +239,92 @@ static unsigned int MCP_HAL_LOG_GetThreadId(void)
     return syscall(SYS_gettid);
 }
 
+static void MCP_HAL_LOG_FreeFormatBuf(void *pData)
+{
+    McpHalLogFmtBuf *pFmtBuf = (McpHalLogFmtBuf *)pData;
+
+    pthread_mutex_lock(&gFmtBufsLock);
+    if (NULL != pFmtBuf->pPrev)
+        pFmtBuf->pPrev->pNext = pFmtBuf->pNext;
+    else
+        gFmtBufs = pFmtBuf->pNext;
+    if (NULL != pFmtBuf->pNext)
+        pFmtBuf->pNext->pPrev = pFmtBuf->pPrev;
+    pthread_mutex_unlock(&gFmtBufsLock);
+
+    free(pFmtBuf);
+}
+
+static void MCP_HAL_LOG_CreateThreadKeys(void)
+{
+    int rc;
+
+    rc = pthread_key_create(&thread_id, NULL);
+    if (0 != rc)
+    {
+        fprintf(stderr, "MCP_HAL_LOG_CreateThreadKeys | pthread_key_create() (id) failed: %s", strerror(rc));
+        return;
+    }
+
+    rc = pthread_key_create(&thread_name, NULL);
+    if (0 != rc)
+    {
+        fprintf(stderr, "MCP_HAL_LOG_CreateThreadKeys | pthread_key_create() (name) failed: %s", strerror(rc));
+        return;
+    }
+
+    /* the buffer is released by the key destructor when its thread exits */
+    rc = pthread_key_create(&thread_fmt_buf, MCP_HAL_LOG_FreeFormatBuf);
+    if (0 != rc)
+    {
+        fprintf(stderr, "MCP_HAL_LOG_CreateThreadKeys | pthread_key_create() (buffer) failed: %s", strerror(rc));
+        return;
+    }
+
+    gThreadKeysCreated = 1;
+}
+
+static char *MCP_HAL_LOG_GetFormatBuf(void)
+{
+    McpHalLogFmtBuf *pFmtBuf;
+
+    pthread_once(&thread_keys_once, MCP_HAL_LOG_CreateThreadKeys);
+    if (0 == gThreadKeysCreated)
+    {
+        return _mcpLog_FormattedMsg;
+    }
+
+    pFmtBuf = pthread_getspecific(thread_fmt_buf);
+    if (NULL == pFmtBuf)
+    {
+        pFmtBuf = malloc(sizeof(McpHalLogFmtBuf));
+        if ((NULL == pFmtBuf) || (0 != pthread_setspecific(thread_fmt_buf, pFmtBuf)))
+        {
+            free(pFmtBuf);
+            /* fall back to the shared buffer rather than losing the message */
+            return _mcpLog_FormattedMsg;
+        }
+
+        pthread_mutex_lock(&gFmtBufsLock);
+        pFmtBuf->pPrev = NULL;
+        pFmtBuf->pNext = gFmtBufs;
+        if (NULL != gFmtBufs)
+            gFmtBufs->pPrev = pFmtBuf;
+        gFmtBufs = pFmtBuf;
+        pthread_mutex_unlock(&gFmtBufsLock);
+    }
+
+    return pFmtBuf->buf;
+}
+
 static void MCP_HAL_LOG_SetThreadIdName(unsigned int id, const char *name)
 {
     int rc;
+
+    pthread_once(&thread_keys_once, MCP_HAL_LOG_CreateThreadKeys);
+    if (0 == gThreadKeysCreated)
+        return;
+
     rc = pthread_setspecific(thread_id, (void *)id);
     if (0 != rc)
         fprintf(stderr, "MCP_HAL_LOG_SetThreadIdName | pthread_setspecific() (id) failed: %s", strerror(rc));
@@ -235,6 +336,10 @@ static void MCP_HAL_LOG_SetThreadIdName(unsigned int id, const char *name)
 
 static char *MCP_HAL_LOG_GetThreadName(void)
 {
+    if (0 == gThreadKeysCreated)
+    {
+        return NULL;
+    }
     return pthread_getspecific(thread_name);
 }
 
@@ -246,10 +351,11 @@ void MCP_HAL_LOG_SetThreadName(const char* name)
 /*-------------------------------------------------------------------------------
  * MCP_HAL_LOG_FormatMsg()
  *
- *      sprintf-like string formatting. the formatted string is allocated by the function.
+ *      sprintf-like string formatting. the formatted string is placed in a buffer
+ *      owned by the calling thread, and stays valid until its next call.
  *
  * Type:
- *      Synchronous, non-reentrant 
+ *      Synchronous, reentrant across threads
  *
  * Parameters:
  *
@@ -264,16 +370,17 @@ void MCP_HAL_LOG_SetThreadName(const char* name)
 char *MCP_HAL_LOG_FormatMsg(const char *format, ...)
 {
     va_list     args;
+    char        *pFormattedMsg = MCP_HAL_LOG_GetFormatBuf();
 
-    _mcpLog_FormattedMsg[MCP_HAL_MAX_FORMATTED_MSG_LEN] = '\0';
+    pFormattedMsg[MCP_HAL_MAX_FORMATTED_MSG_LEN] = '\0';
 
     va_start(args, format);
 
-    vsnprintf(_mcpLog_FormattedMsg, MCP_HAL_MAX_FORMATTED_MSG_LEN, format, args);
+    vsnprintf(pFormattedMsg, MCP_HAL_MAX_FORMATTED_MSG_LEN, format, args);
 
     va_end(args);
 
-    return _mcpLog_FormattedMsg;
+    return pFormattedMsg;
 }
 
 void MCP_HAL_InitUdpSockets(void)
@@ -386,10 +493,17 @@ void MCP_HAL_LOG_Init(void)
 
 void MCP_HAL_LOG_Deinit(void)
 {
+    McpHalLogFmtBuf *pFmtBuf;
     int rc;
 
     MCP_HAL_DeInitUdpSockets();
 
+    if (0 == gThreadKeysCreated)
+        return;
+
+    /* the keys are not re-created, later messages use the shared buffer */
+    gThreadKeysCreated = 0;
+
     rc = pthread_key_delete(thread_id);
     if (0 != rc)
         fprintf(stderr, "MCP_HAL_LogDeinit | pthread_key_delete() failed: %s", strerror(rc));
@@ -397,6 +511,20 @@ void MCP_HAL_LOG_Deinit(void)
     rc = pthread_key_delete(thread_name);
     if (0 != rc)
         fprintf(stderr, "MCP_HAL_LogDeinit | pthread_key_delete() failed: %s", strerror(rc));
+
+    rc = pthread_key_delete(thread_fmt_buf);
+    if (0 != rc)
+        fprintf(stderr, "MCP_HAL_LogDeinit | pthread_key_delete() failed: %s", strerror(rc));
+
+    /* the key destructor is no longer called - release the buffers of the live threads */
+    pthread_mutex_lock(&gFmtBufsLock);
+    while (NULL != gFmtBufs)
+    {
+        pFmtBuf = gFmtBufs;
+        gFmtBufs = pFmtBuf->pNext;
+        free(pFmtBuf);
+    }
+    pthread_mutex_unlock(&gFmtBufsLock);
 }
 
 const char *MCP_HAL_LOG_SeverityCodeToName(McpHalLogSeverity Severity)
@@ -19,14 +19,21 @@
 /** \file   mcp_hal_socket.c 
  *  \brief  Linux OS Adaptation Layer for Socket Interface implementation
  * 
+ *  All client connections are served by a single epoll driven loop, running
+ *  in the thread calling mcp_hal_socket_Accept().
+ *
  *  \see    mcp_hal_socket.h
  */
 #include <stdio.h>
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/epoll.h>
 #include <netinet/in.h>
 #include <string.h>
 #include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
 #include <pthread.h>
 #include <errno.h>
 #include "mcpf_services.h"
@@ -37,34 +44,58 @@
 #include "mcpf_mem.h"
 #include "mcpf_report.h"
 
+/************************************************************************/
+/* Internal Definitions			                                        */
+/************************************************************************/
+#define HAL_SOCKET_RX_BUF_SIZE			(9000)
+#define HAL_SOCKET_MAX_EVENTS			(SOCKET_CLIENT_NUM + 2)
+#define HAL_SOCKET_SEND_TIMEOUT_MS		(2000)
+
 /************************************************************************/
 /* Internal Structures			                                        */
 /************************************************************************/
+typedef struct  
+{
+	McpU32		clientSockId;
+	handle_t	hHalSock;
+	handle_t	hCaller;
+	McpU8		uNumOfBytesToRead;
+	McpS8		*pRxBuf;			/* receive buffer taken from the rx pool */
+	McpU32		uBytesToRead;		/* size of the message being received */
+	McpU32		uBytesRead;			/* bytes of it received so far */
+} client_handle_t;
+
 typedef struct {
 	handle_t				hMcpf;
 	handle_t				hHostSocket;
 	handle_t				hClientsPool;
+	handle_t				hRxBufPool;
 	tHalSockOnAcceptCb		onAcceptCb;
 	tHalSockOnRecvCb		onRecvCb;
 	tHalSockOnCloseCb		onCloseCb;
 	McpU32					sockId;
 
-} hal_socket_t;
+	int						epollFd;
+	int						aWakePipe[2];
+	client_handle_t			*pClients[SOCKET_CLIENT_NUM];
+	McpU32					uNumOfClients;
 
-typedef struct  
-{
-	McpU32		clientSockId;
-	handle_t	hHalSock;
-	handle_t	hCaller;
-	McpU8		uNumOfBytesToRead;
-} client_handle_t;
+	pthread_mutex_t			tLoopLock;
+	pthread_cond_t			tLoopDone;
+	McpBool					bLoopRunning;
+	volatile McpBool		bStop;
+
+} hal_socket_t;
 
 
 /************************************************************************/
 /* Internal Functions Definitions                                       */
 /************************************************************************/
-void serverSocket_ThreadFunc();
-void clientSocket_ThreadFunc();
+static void serverSocket_AcceptClients(hal_socket_t *pHalSock);
+static EMcpfRes clientSocket_Read(hal_socket_t *pHalSock, client_handle_t *pClientHandle);
+static void clientSocket_Close(hal_socket_t *pHalSock, client_handle_t *pClientHandle);
+static EMcpfRes socket_SetNonBlocking(int fd);
+static void socket_Free(hal_socket_t *pHalSock);
 
 
 /************************************************************************/
@@ -80,12 +111,8 @@ handle_t mcp_hal_socket_CreateServerSocket(handle_t hMcpf, handle_t hHostSocket,
 										   tHalSockOnRecvCb onRecvCb, tHalSockOnCloseCb onCloseCb) 
 {
 	struct sockaddr_in  lSockAddr;
-	//WSADATA wsaData;
-	//unsigned long q_Handle;
-	//HANDLE hThread;
-	McpU32 hThread;
+	struct epoll_event	tEvent;
 	hal_socket_t *pHalSocket;
-	pthread_t     thread1;
 
 	pHalSocket = mcpf_mem_alloc(hMcpf, sizeof(hal_socket_t));
 	if(pHalSocket == NULL)
@@ -94,29 +121,36 @@ handle_t mcp_hal_socket_CreateServerSocket(handle_t hMcpf, handle_t hHostSocket,
 			("mcp_hal_socket_CreateServerSocket: Create Hal Socket Failed!"));
 		return NULL;
 	}
+	memset(pHalSocket, 0, sizeof(hal_socket_t));
+
+	pHalSocket->hMcpf = hMcpf;
+	pHalSocket->hHostSocket = hHostSocket;
+	pHalSocket->onAcceptCb = onAcceptCb;
+	pHalSocket->onRecvCb = onRecvCb;
+	pHalSocket->onCloseCb = onCloseCb;
+	pHalSocket->sockId = (McpU32)-1;
+	pHalSocket->epollFd = -1;
+	pHalSocket->aWakePipe[0] = -1;
+	pHalSocket->aWakePipe[1] = -1;
+	pthread_mutex_init(&pHalSocket->tLoopLock, NULL);
+	pthread_cond_init(&pHalSocket->tLoopDone, NULL);
 
 	pHalSocket->hClientsPool = mcpf_memory_pool_create(hMcpf, sizeof(client_handle_t), SOCKET_CLIENT_NUM);
-	if(pHalSocket->hClientsPool == NULL)
+	pHalSocket->hRxBufPool = mcpf_memory_pool_create(hMcpf, HAL_SOCKET_RX_BUF_SIZE, SOCKET_CLIENT_NUM);
+	if((pHalSocket->hClientsPool == NULL) || (pHalSocket->hRxBufPool == NULL))
 	{
 		MCPF_REPORT_ERROR(hMcpf, HAL_SOCKET_MODULE_LOG,
 			("mcp_hal_socket_CreateServerSocket: Create Pool Failed!"));
-		mcpf_mem_free(hMcpf, pHalSocket);
+		socket_Free(pHalSocket);
 		return NULL;
 	}
 
-	pHalSocket->hMcpf = hMcpf;
-	pHalSocket->hHostSocket = hHostSocket;
-	pHalSocket->onAcceptCb = onAcceptCb;
-	pHalSocket->onRecvCb = onRecvCb;
-	pHalSocket->onCloseCb = onCloseCb;
-
 	pHalSocket->sockId = socket(AF_INET,SOCK_STREAM,IPPROTO_TCP);
-	if(pHalSocket->sockId < 0)
+	if((int)pHalSocket->sockId < 0)
 	{
 		MCPF_REPORT_ERROR(hMcpf, HAL_SOCKET_MODULE_LOG,
 			("mcp_hal_socket_CreateServerSocket: socket() Failed!"));
-		mcpf_memory_pool_destroy(hMcpf, pHalSocket->hClientsPool);
-		mcpf_mem_free(hMcpf, pHalSocket);
+		socket_Free(pHalSocket);
 		return NULL;
 	}
 
@@ -133,24 +167,51 @@ handle_t mcp_hal_socket_CreateServerSocket(handle_t hMcpf, handle_t hHostSocket,
     {
 		MCPF_REPORT_ERROR(hMcpf, HAL_SOCKET_MODULE_LOG,
 			("mcp_hal_socket_CreateServerSocket: bind() Failed!"));
-		close(pHalSocket->sockId);
-		mcpf_memory_pool_destroy(hMcpf, pHalSocket->hClientsPool);
-		mcpf_mem_free(hMcpf, pHalSocket);
+		socket_Free(pHalSocket);
         return NULL;
     }
 
     /* Listen - instructs the socket to listen for incoming
        connections from clients. The second arg is the backlog. */
-    if(listen(pHalSocket->sockId,10) != 0)
+    if((listen(pHalSocket->sockId,10) != 0) ||
+	   (socket_SetNonBlocking(pHalSocket->sockId) != RES_OK))
     {
 		MCPF_REPORT_ERROR(hMcpf, HAL_SOCKET_MODULE_LOG,
 			("mcp_hal_socket_CreateServerSocket: listen() Failed!"));
-		close(pHalSocket->sockId);
-		mcpf_memory_pool_destroy(hMcpf, pHalSocket->hClientsPool);
-		mcpf_mem_free(hMcpf, pHalSocket);
+		socket_Free(pHalSocket);
         return NULL;
     }
-	//hThread = pthread_create( &thread1, NULL, serverSocket_ThreadFunc, pHalSocket);
+
+	/* The event loop waits on the listening socket, on the clients and on a
+	   wake-up pipe used by mcp_hal_socket_DestroyServerSocket() */
+	pHalSocket->epollFd = epoll_create(HAL_SOCKET_MAX_EVENTS);
+	if((pHalSocket->epollFd < 0) || (pipe(pHalSocket->aWakePipe) != 0))
+	{
+		MCPF_REPORT_ERROR(hMcpf, HAL_SOCKET_MODULE_LOG,
+			("mcp_hal_socket_CreateServerSocket: epoll setup Failed! %s", strerror(errno)));
+		socket_Free(pHalSocket);
+		return NULL;
+	}
+
+	tEvent.events = EPOLLIN;
+	tEvent.data.ptr = pHalSocket;
+	if(epoll_ctl(pHalSocket->epollFd, EPOLL_CTL_ADD, pHalSocket->sockId, &tEvent) != 0)
+	{
+		MCPF_REPORT_ERROR(hMcpf, HAL_SOCKET_MODULE_LOG,
+			("mcp_hal_socket_CreateServerSocket: epoll_ctl() Failed! %s", strerror(errno)));
+		socket_Free(pHalSocket);
+		return NULL;
+	}
+
+	tEvent.events = EPOLLIN;
+	tEvent.data.ptr = NULL;
+	if(epoll_ctl(pHalSocket->epollFd, EPOLL_CTL_ADD, pHalSocket->aWakePipe[0], &tEvent) != 0)
+	{
+		MCPF_REPORT_ERROR(hMcpf, HAL_SOCKET_MODULE_LOG,
+			("mcp_hal_socket_CreateServerSocket: epoll_ctl() Failed! %s", strerror(errno)));
+		socket_Free(pHalSocket);
+		return NULL;
+	}
 
 	return (handle_t)pHalSocket;
 }
@@ -159,96 +220,201 @@ handle_t mcp_hal_socket_CreateServerSocket(handle_t hMcpf, handle_t hHostSocket,
  * \fn     mcp_hal_socket_Accept
  * \brief  Socket Accept at the Server side
  * 
+ * Runs the event loop accepting new clients and receiving data from the 
+ * connected ones, until mcp_hal_socket_DestroyServerSocket() is called.
  */
 void mcp_hal_socket_Accept(handle_t hHalSocket) 
 {
-	hal_socket_t	*pHalSock = (hal_socket_t *)hHalSocket;
-	McpU32			hThread;
-	pthread_t		thread1;
+	hal_socket_t		*pHalSock = (hal_socket_t *)hHalSocket;
+	struct epoll_event	aEvents[HAL_SOCKET_MAX_EVENTS];
+	client_handle_t		*pClientHandle;
+	int					iNumOfEvents;
+	int					i;
+
+	MCPF_REPORT_INFORMATION(pHalSock->hMcpf, HAL_SOCKET_MODULE_LOG,
+				("mcp_hal_socket_Accept: Entering..."));
+
+	pthread_mutex_lock(&pHalSock->tLoopLock);
+	pHalSock->bLoopRunning = MCP_TRUE;
+	pthread_mutex_unlock(&pHalSock->tLoopLock);
 
 	/* This function is blocking, and is running in the application main thread */
-	serverSocket_ThreadFunc(pHalSock);
+	while(!pHalSock->bStop)
+	{
+		iNumOfEvents = epoll_wait(pHalSock->epollFd, aEvents, HAL_SOCKET_MAX_EVENTS, -1);
+		if(iNumOfEvents < 0)
+		{
+			if(errno == EINTR)
+			{
+				continue;
+			}
+			MCPF_REPORT_ERROR(pHalSock->hMcpf, HAL_SOCKET_MODULE_LOG,
+				("mcp_hal_socket_Accept: epoll_wait() Failed! %s", strerror(errno)));
+			break;
+		}
+
+		for(i = 0; (i < iNumOfEvents) && !pHalSock->bStop; i++)
+		{
+			if(aEvents[i].data.ptr == NULL)
+			{
+				/* Woken up by mcp_hal_socket_DestroyServerSocket() */
+				break;
+			}
+			else if(aEvents[i].data.ptr == pHalSock)
+			{
+				serverSocket_AcceptClients(pHalSock);
+			}
+			else
+			{
+				pClientHandle = (client_handle_t *)aEvents[i].data.ptr;
+				if(clientSocket_Read(pHalSock, pClientHandle) != RES_OK)
+				{
+					clientSocket_Close(pHalSock, pClientHandle);
+				}
+			}
+		}
+	}
+
+	pthread_mutex_lock(&pHalSock->tLoopLock);
+	pHalSock->bLoopRunning = MCP_FALSE;
+	pthread_cond_signal(&pHalSock->tLoopDone);
+	pthread_mutex_unlock(&pHalSock->tLoopLock);
 }
 
 /** 
  * \fn     mcp_hal_socket_DestroyServerSocket
  * \brief  Socket Initializing and Binding at the Server side
  * 
+ * Stops the event loop, waits for it to exit and closes all the clients.
  */
 void mcp_hal_socket_DestroyServerSocket(handle_t hHalSocket) 
 {
 	hal_socket_t	*pHalSock = (hal_socket_t *)hHalSocket;
+	McpU8			uWake = 0;
 
-		/* TODO: Need to destroy Thread */
+	pHalSock->bStop = MCP_TRUE;
+	if(write(pHalSock->aWakePipe[1], &uWake, sizeof(uWake)) != sizeof(uWake))
+	{
+		MCPF_REPORT_ERROR(pHalSock->hMcpf, HAL_SOCKET_MODULE_LOG,
+			("mcp_hal_socket_DestroyServerSocket: Failed to wake the event loop! %s", strerror(errno)));
+	}
 
-	close(pHalSock->sockId);
+	pthread_mutex_lock(&pHalSock->tLoopLock);
+	while(pHalSock->bLoopRunning)
+	{
+		pthread_cond_wait(&pHalSock->tLoopDone, &pHalSock->tLoopLock);
+	}
+	pthread_mutex_unlock(&pHalSock->tLoopLock);
+
+	while(pHalSock->uNumOfClients > 0)
+	{
+		clientSocket_Close(pHalSock, pHalSock->pClients[pHalSock->uNumOfClients - 1]);
+	}
+
+	socket_Free(pHalSock);
 }
 
 /** 
  * \fn     mcp_hal_socket_Send 
  * \brief  Send data back to the client
  * 
+ * Client sockets are non-blocking. When the client does not drain its socket
+ * the caller is held back for up to HAL_SOCKET_SEND_TIMEOUT_MS before the
+ * send is failed, instead of queueing without limit.
  */
 EMcpfRes mcp_hal_socket_Send(handle_t hHalSocket, McpU32 clientSockId, McpS8 *buf, McpU16 bufLen)
 {
 	hal_socket_t *pHalSocket = (hal_socket_t *)hHalSocket;
-	McpU32	clientSock = (McpU32)clientSockId;
+	int		clientSock = (int)clientSockId;
 	McpU32	bytesSent = 0;
+	ssize_t	sent;
+	struct pollfd	tPollFd;
 
-	do
+	while(bytesSent < bufLen)
 	{
-		bytesSent += send(clientSock, &buf[bytesSent], bufLen-bytesSent, 0);
-	} while ( (bytesSent > 0) && (bytesSent < bufLen) );
+		sent = send(clientSock, &buf[bytesSent], bufLen-bytesSent, MSG_NOSIGNAL);
+		if(sent > 0)
+		{
+			bytesSent += (McpU32)sent;
+			continue;
+		}
+
+		if((sent < 0) && (errno == EINTR))
+		{
+			continue;
+		}
+
+		if((sent < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK)))
+		{
+			tPollFd.fd = clientSock;
+			tPollFd.events = POLLOUT;
+			tPollFd.revents = 0;
+			if(poll(&tPollFd, 1, HAL_SOCKET_SEND_TIMEOUT_MS) > 0)
+			{
+				continue;
+			}
+			MCPF_REPORT_ERROR(pHalSocket->hMcpf, HAL_SOCKET_MODULE_LOG,
+				("mcp_hal_socket_Send: client %d does not drain its socket, %d of %d bytes sent",
+				 clientSock, bytesSent, bufLen));
+			return RES_ERROR;
+		}
 
-	if(bytesSent == 0)
-	{
 		MCPF_REPORT_ERROR(pHalSocket->hMcpf, HAL_SOCKET_MODULE_LOG,
-			("mcp_hal_socket_Send: Send Failed!"));
+			("mcp_hal_socket_Send: Send Failed! %s", strerror(errno)));
 		return RES_ERROR;
 	}
-	else
-	{
-		MCPF_REPORT_INFORMATION(pHalSocket->hMcpf, HAL_SOCKET_MODULE_LOG,
-			("mcp_hal_socket_Send: Send was succesful! bytesSent = %d", bytesSent));
+
+	MCPF_REPORT_INFORMATION(pHalSocket->hMcpf, HAL_SOCKET_MODULE_LOG,
+		("mcp_hal_socket_Send: Send was succesful! bytesSent = %d", bytesSent));
 	return RES_OK;
 }
-}
 
 
 /************************************************************************/
 /* Internal Functions Implementation                                    */
 /************************************************************************/
 /** 
- * \fn     serverSocket_ThreadFuncThreadFunc 
- * \brief  Server Socket Thread Function, where the 
- *		   Incoming connections From Socket is handled
+ * \fn     serverSocket_AcceptClients 
+ * \brief  Accepts all the pending incoming connections
  * 
+ * Connections beyond SOCKET_CLIENT_NUM are closed right away.
  **/
-void serverSocket_ThreadFunc(void* hSocket)
+static void serverSocket_AcceptClients(hal_socket_t *pHalSock)
 {
-	hal_socket_t	*pHalSock = (hal_socket_t *)hSocket;
 	struct sockaddr_in 	from;
-	int				fromlen = sizeof(from);
-	McpU32			clientThread;
-	unsigned long	client_Handle;
-	client_handle_t	*hClientHandle;
-	McpU32			clienSockId;
-	McpBool			bInLoop = MCP_TRUE;
-	pthread_t       thread2;
+	socklen_t			fromlen;
+	client_handle_t		*hClientHandle;
+	struct epoll_event	tEvent;
+	int					clienSockId;
 
-	MCPF_REPORT_INFORMATION(pHalSock->hMcpf, HAL_SOCKET_MODULE_LOG,
-				("serverSocket_ThreadFunc: Entering..."));
-	
-	while(bInLoop)
+	for(;;)
 	{
+		fromlen = sizeof(from);
 		clienSockId = accept(pHalSock->sockId,(struct sockaddr *)&from,&fromlen);
+		if(clienSockId < 0)
+		{
+			if((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR))
+			{
+				MCPF_REPORT_ERROR(pHalSock->hMcpf, HAL_SOCKET_MODULE_LOG,
+					("serverSocket_AcceptClients: accept() Failed! %s", strerror(errno)));
+			}
+			return;
+		}
+
 		MCPF_REPORT_INFORMATION(pHalSock->hMcpf, HAL_SOCKET_MODULE_LOG,
-			("serverSocket_ThreadFunc: accept() for sockId %d, socket descriptor is %d", pHalSock->sockId, clienSockId ));
+			("serverSocket_AcceptClients: accept() for sockId %d, socket descriptor is %d", pHalSock->sockId, clienSockId ));
 
-		if(clienSockId < 0)
+		if(pHalSock->uNumOfClients >= SOCKET_CLIENT_NUM)
 		{
-			MCPF_REPORT_INFORMATION(pHalSock->hMcpf, HAL_SOCKET_MODULE_LOG,
-				("serverSocket_ThreadFunc: accept() returned INVALID_SOCKET! clienSockId is %d", clienSockId ));
+			MCPF_REPORT_ERROR(pHalSock->hMcpf, HAL_SOCKET_MODULE_LOG,
+				("serverSocket_AcceptClients: Too many clients, closing socket %d", clienSockId));
+			close(clienSockId);
+			continue;
+		}
+
+		if(socket_SetNonBlocking(clienSockId) != RES_OK)
+		{
+			close(clienSockId);
 			continue;
 		}
 
@@ -256,12 +422,24 @@ void serverSocket_ThreadFunc(void* hSocket)
 		if(hClientHandle == NULL)
 		{
 			MCPF_REPORT_ERROR(pHalSock->hMcpf, HAL_SOCKET_MODULE_LOG,
-				("serverSocket_ThreadFunc: Failed to allocate client structure!"));
-			break;
+				("serverSocket_AcceptClients: Failed to allocate client structure!"));
+			close(clienSockId);
+			continue;
+		}
+
+		hClientHandle->pRxBuf = (McpS8 *)mcpf_mem_alloc_from_pool(pHalSock->hMcpf, pHalSock->hRxBufPool);
+		if(hClientHandle->pRxBuf == NULL)
+		{
+			MCPF_REPORT_ERROR(pHalSock->hMcpf, HAL_SOCKET_MODULE_LOG,
+				("serverSocket_AcceptClients: Failed to allocate receive buffer!"));
+			mcpf_mem_free_from_pool(pHalSock->hMcpf, hClientHandle);
+			close(clienSockId);
+			continue;
 		}
 
-		hClientHandle->hHalSock = hSocket;
-		hClientHandle->clientSockId = clienSockId;
+		hClientHandle->hHalSock = pHalSock;
+		hClientHandle->clientSockId = (McpU32)clienSockId;
+		hClientHandle->uNumOfBytesToRead = 0;
 
 		hClientHandle->hCaller = pHalSock->onAcceptCb(pHalSock->hHostSocket, hClientHandle->clientSockId,
 														&hClientHandle->uNumOfBytesToRead);
@@ -269,93 +447,162 @@ void serverSocket_ThreadFunc(void* hSocket)
 		if(hClientHandle->hCaller == NULL)
 		{
 			MCPF_REPORT_ERROR(pHalSock->hMcpf, HAL_SOCKET_MODULE_LOG,
-				("serverSocket_ThreadFunc: OnAcceptCb() Failed!"));
+				("serverSocket_AcceptClients: OnAcceptCb() Failed!"));
+			mcpf_mem_free_from_pool(pHalSock->hMcpf, (McpU8 *)hClientHandle->pRxBuf);
 			mcpf_mem_free_from_pool(pHalSock->hMcpf, hClientHandle);
-			break;
+			close(clienSockId);
+			continue;
+		}
+
+		hClientHandle->uBytesToRead = hClientHandle->uNumOfBytesToRead;
+		if(hClientHandle->uBytesToRead == 0)
+		{
+			hClientHandle->uBytesToRead = HAL_SOCKET_RX_BUF_SIZE;
+		}
+		hClientHandle->uBytesRead = 0;
+
+		pHalSock->pClients[pHalSock->uNumOfClients++] = hClientHandle;
+
+		tEvent.events = EPOLLIN;
+		tEvent.data.ptr = hClientHandle;
+		if(epoll_ctl(pHalSock->epollFd, EPOLL_CTL_ADD, clienSockId, &tEvent) != 0)
+		{
+			MCPF_REPORT_ERROR(pHalSock->hMcpf, HAL_SOCKET_MODULE_LOG,
+				("serverSocket_AcceptClients: epoll_ctl() Failed! %s", strerror(errno)));
+			clientSocket_Close(pHalSock, hClientHandle);
 		}
-		clientThread = pthread_create( &thread2, NULL, clientSocket_ThreadFunc, hClientHandle);
 	}
 }
 
 /** 
- * \fn     clientSocket_ThreadFunc 
- * \brief  Call Back Function Where the Multiple Clients are handled
- * 
+ * \fn     clientSocket_Read 
+ * \brief  Receives available data of a client
  * 
+ * Reads once per readiness event, so a busy client cannot starve the others.
+ * A message is passed to the receive callback once it was received in full;
+ * the callback returns the size of the following message, or 0 when the 
+ * next one is a header again.
  */
-void clientSocket_ThreadFunc(void* hClientHandle)
+static EMcpfRes clientSocket_Read(hal_socket_t *pHalSock, client_handle_t *pClientHandle)
 {
-	client_handle_t	*pClientHandle = (client_handle_t *)hClientHandle;
-	hal_socket_t	*pHalSock = (hal_socket_t *)pClientHandle->hHalSock;
-	McpS8		IncData[9000];
-	McpS32		recvLen = 0;
+	ssize_t		recvLen;
 	McpU32		uMoreBytesToRead;
-	McpBool			bInLoop = MCP_TRUE;
 
-	while(bInLoop)
+	recvLen = recv(pClientHandle->clientSockId, &pClientHandle->pRxBuf[pClientHandle->uBytesRead],
+				   pClientHandle->uBytesToRead - pClientHandle->uBytesRead, 0);
+	if(recvLen < 0)
 	{
-		recvLen = 0;
-		do
+		if((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR))
 		{
-			recvLen += recv(pClientHandle->clientSockId, &IncData[recvLen],
-				pClientHandle->uNumOfBytesToRead-recvLen, 0);
+			return RES_OK;
+		}
+		MCPF_REPORT_ERROR(pHalSock->hMcpf, HAL_SOCKET_MODULE_LOG,
+			("clientSocket_Read: Error on recv(), Error code returned is %s", strerror(errno)));
+		return RES_ERROR;
+	}
+	else if(recvLen == 0)
+	{
+		MCPF_REPORT_INFORMATION(pHalSock->hMcpf, HAL_SOCKET_MODULE_LOG,
+			("clientSocket_Read: socket %d was closed by peer", pClientHandle->clientSockId));
+		return RES_ERROR;
+	}
 
-			MCPF_REPORT_INFORMATION(pHalSock->hMcpf, HAL_SOCKET_MODULE_LOG,
-				("serverSocket_ThreadFunc: recv() is passed the clienSockId of %d", pClientHandle->clientSockId));
+	pClientHandle->uBytesRead += (McpU32)recvLen;
+	if(pClientHandle->uBytesRead < pClientHandle->uBytesToRead)
+	{
+		return RES_OK;
+	}
 
-		} while ( (recvLen > 0) && (recvLen < pClientHandle->uNumOfBytesToRead) );
+	uMoreBytesToRead = pHalSock->onRecvCb(pClientHandle->hCaller, pClientHandle->pRxBuf,
+										  (McpS16)pClientHandle->uBytesRead);
 
-		if(recvLen < 0)
-		{
-			MCPF_REPORT_ERROR(pHalSock->hMcpf, HAL_SOCKET_MODULE_LOG,
-				("clientSocket_ThreadFunc: Error on recv() 1"));
-			break;
-		}
-		else if(recvLen == 0)
+	pClientHandle->uBytesRead = 0;
+	if(uMoreBytesToRead != 0)
+	{
+		pClientHandle->uBytesToRead = (uMoreBytesToRead < HAL_SOCKET_RX_BUF_SIZE) ? 
+									   uMoreBytesToRead : HAL_SOCKET_RX_BUF_SIZE;
+	}
+	else
+	{
+		pClientHandle->uBytesToRead = (pClientHandle->uNumOfBytesToRead != 0) ? 
+									   pClientHandle->uNumOfBytesToRead : HAL_SOCKET_RX_BUF_SIZE;
+	}
+
+	return RES_OK;
+}
+
+/** 
+ * \fn     clientSocket_Close 
+ * \brief  Closes a client connection and releases its resources
+ * 
+ */
+static void clientSocket_Close(hal_socket_t *pHalSock, client_handle_t *pClientHandle)
+{
+	McpU32	i;
+
+	for(i = 0; i < pHalSock->uNumOfClients; i++)
+	{
+		if(pHalSock->pClients[i] == pClientHandle)
 		{
-			MCPF_REPORT_ERROR(pHalSock->hMcpf, HAL_SOCKET_MODULE_LOG,
-				("clientSocket_ThreadFunc: sokcet was closed by peer 1"));
+			pHalSock->pClients[i] = pHalSock->pClients[--pHalSock->uNumOfClients];
 			break;
 		}
-		else
-		{
-			uMoreBytesToRead = pHalSock->onRecvCb(pClientHandle->hCaller, IncData, (McpS16)recvLen);
-
+	}
 
-			memset((void*)&IncData, 0, 9000);
+	epoll_ctl(pHalSock->epollFd, EPOLL_CTL_DEL, pClientHandle->clientSockId, NULL);
+	close(pClientHandle->clientSockId);
 
-			if(uMoreBytesToRead != 0)
-			{
-				recvLen = 0;
-				do
-				{
-					recvLen += recv(pClientHandle->clientSockId, &IncData[recvLen],
-						uMoreBytesToRead-recvLen, 0);
+	pHalSock->onCloseCb(pClientHandle->hCaller);
 
-				} while ( (recvLen > 0) && ((McpU32)recvLen < uMoreBytesToRead) );
+	mcpf_mem_free_from_pool(pHalSock->hMcpf, (McpU8 *)pClientHandle->pRxBuf);
+	mcpf_mem_free_from_pool(pHalSock->hMcpf, pClientHandle);
+}
 
-				if(recvLen < 0)
-				{
-					MCPF_REPORT_ERROR(pHalSock->hMcpf, HAL_SOCKET_MODULE_LOG,
-						("clientSocket_ThreadFunc: Error on recv() 2, Error code returned is %s",strerror(errno) ));
-					break;
-				}
-				else if(recvLen == 0)
-				{
-					MCPF_REPORT_ERROR(pHalSock->hMcpf, HAL_SOCKET_MODULE_LOG,
-						("clientSocket_ThreadFunc: sokcet was closed by peer 2"));
-					break;
-				}
-				else
-				{
-					uMoreBytesToRead = pHalSock->onRecvCb(pClientHandle->hCaller, IncData, (McpS16)recvLen);
+/** 
+ * \fn     socket_SetNonBlocking 
+ * \brief  Sets a socket to non-blocking mode
+ * 
+ */
+static EMcpfRes socket_SetNonBlocking(int fd)
+{
+	int	iFlags = fcntl(fd, F_GETFL, 0);
 
-					memset((void*)&IncData, 0, 9000);
-				}
-			}
-		}
+	if((iFlags < 0) || (fcntl(fd, F_SETFL, iFlags | O_NONBLOCK) < 0))
+	{
+		return RES_ERROR;
 	}
+	return RES_OK;
+}
 
-	pHalSock->onCloseCb(pClientHandle->hCaller);
-	mcpf_mem_free_from_pool(pHalSock->hMcpf, hClientHandle);
+/** 
+ * \fn     socket_Free 
+ * \brief  Releases the server socket resources
+ * 
+ */
+static void socket_Free(hal_socket_t *pHalSock)
+{
+	if((int)pHalSock->sockId >= 0)
+	{
+		close(pHalSock->sockId);
+	}
+	if(pHalSock->epollFd >= 0)
+	{
+		close(pHalSock->epollFd);
+	}
+	if(pHalSock->aWakePipe[0] >= 0)
+	{
+		close(pHalSock->aWakePipe[0]);
+		close(pHalSock->aWakePipe[1]);
+	}
+	if(pHalSock->hRxBufPool != NULL)
+	{
+		mcpf_memory_pool_destroy(pHalSock->hMcpf, pHalSock->hRxBufPool);
+	}
+	if(pHalSock->hClientsPool != NULL)
+	{
+		mcpf_memory_pool_destroy(pHalSock->hMcpf, pHalSock->hClientsPool);
+	}
+	pthread_cond_destroy(&pHalSock->tLoopDone);
+	pthread_mutex_destroy(&pHalSock->tLoopLock);
+	mcpf_mem_free(pHalSock->hMcpf, pHalSock);
 }
@@ -31,6 +31,7 @@
 #include <pthread.h>
 #include <unistd.h>
 #include <sys/ioctl.h>
+#include <sys/uio.h>
 
 #include "mcpf_mem.h"
 #include "mcpf_report.h"
@@ -54,6 +55,11 @@
 #define HALST_IOCTL_VS_EVENT				1
 #define HALST_IOCTL_WAIT_4_CMD_CMPLT		2
 
+#define HALST_RX_RING_SIZE					4096	/* Rx ring buffer size, must be a power of 2 */
+
+/* Number of received bytes buffered in the Rx ring and not consumed yet */
+#define HALST_RX_RING_USED(_pHalSt)		((_pHalSt)->uRxRingTail - (_pHalSt)->uRxRingHead)
+
 /************************************************************************
  * Types
  ************************************************************************/
@@ -92,8 +98,12 @@ typedef struct
 
     McpBool               		terminationFlag;
     McpS32                		iRxReadNum;	/* number of bytes requested to read */
-    McpS32                		iRxAvailNum;	/* number of available bytes to read from ST device */
     McpS32                		iRxRepNum;	    	/* number of bytes to report for previous read call */
+    McpBool				bRxRestart;	/* read restart is requested, report buffered data with no read pending */
+
+    McpU8                 		aRxRing[HALST_RX_RING_SIZE];	/* bytes read from ST device, not consumed yet */
+    McpU32                		uRxRingHead;	/* free running index of the next byte to consume */
+    McpU32                		uRxRingTail;	/* free running index of the next byte to fill */
 
     McpU8                 		*pInData;       	/* Current data pointer for receiver */
 
@@ -118,6 +128,8 @@ static EMcpfRes stPortConfig (THalStObj  *pHalSt);
 static void * stThreadFun (void * pParam);
 static EMcpfRes stPortDestroy (THalStObj    *pHalSt);
 static EMcpfRes stPortRxReset (THalStObj *pHalSt, McpU8 *pBuf, McpU16 len);
+static EMcpfRes stRxRingFill (THalStObj *pHalSt);
+static McpU16 stRxRingGet (THalStObj *pHalSt, McpU8 *pBuf, McpU16 uLen);
 static McpU32 stSpeedToOSbaudrate (handle_t hMcpf, ThalStSpeed  speed);
 
 static void signalSem  (handle_t hMcpf, SEM_HANDLE hSem);
@@ -234,6 +246,9 @@ EMcpfRes HAL_ST_Init ( 	handle_t                    			hHalSt,
     /* Data will be read into this buffer */
     pHalSt->pInData = pBuf;
     pHalSt->iRxReadNum  = len;
+    pHalSt->bRxRestart = MCP_FALSE;
+    pHalSt->uRxRingHead = 0;
+    pHalSt->uRxRingTail = 0;
     pHalSt->bIsBlockOnWrite = bIsBlockOnWrite;
 
     if(pConf)
@@ -336,6 +351,10 @@ EMcpfRes HAL_ST_Deinit (handle_t  hHalSt)
  * \fn     HAL_ST_Read
  * \brief  Read data from OS ST device
  *
+ * Data already received by the ST thread is returned from the Rx ring buffer
+ * without a system call. If the ring is empty, the read is left pending and
+ * completed by the ST thread with HalStEvent_ReadReadylInd.
+ *
  */
 EMcpfRes HAL_ST_Read (	const handle_t    	hHalSt,
                           				McpU8         		*pBuf,
@@ -343,42 +362,26 @@ EMcpfRes HAL_ST_Read (	const handle_t    	hHalSt,
                           				McpU16        		*uReadLen)
 {
     	THalStObj	*pHalSt  = (THalStObj *) hHalSt;
-	McpS32		iReadNum;
     	McpS32		iBytesRead = 0;
 	EMcpfRes  eRes = RES_ERROR;
-	int     	  iRetCode;
 
-    MCPF_REPORT_DEBUG_RX(pHalSt->hMcpf, HAL_ST_MODULE_LOG, ("%s: begin pBuf=%p len=%u avail=%d\n", 
-										   __FUNCTION__, pBuf, uLen, pHalSt->iRxAvailNum));
+    MCPF_REPORT_DEBUG_RX(pHalSt->hMcpf, HAL_ST_MODULE_LOG, ("%s: begin pBuf=%p len=%u avail=%u\n", 
+										   __FUNCTION__, pBuf, uLen, HALST_RX_RING_USED(pHalSt)));
 
 	if (!pHalSt->terminationFlag)
     {
-			
-		iReadNum = MIN(uLen, pHalSt->iRxAvailNum);
-		if (iReadNum > 0)
+		if (HALST_RX_RING_USED(pHalSt) > 0)
 		{
-			/* Read received bytes from ST device */
-			iBytesRead = read (pHalSt->hOsPort, pBuf, iReadNum);
-
-			if (iBytesRead >= 0)
-			{
-				pHalSt->iRxAvailNum -= iBytesRead;
-				eRes = RES_COMPLETE;
-			}
-			else
-			{
-				MCPF_REPORT_ERROR (pHalSt->hMcpf, HAL_ST_MODULE_LOG,
-								   ("%s: ReadFile failed, err=%u\n", __FUNCTION__, errno));
-
-				*uReadLen = 0;
-				return RES_ERROR;
-			}
+			/* Copy buffered bytes, received by ST thread bulk read */
+			iBytesRead = stRxRingGet (pHalSt, pBuf, uLen);
+			eRes = RES_COMPLETE;
 		}
 		else
 		{
-			McpU8   uMngEvt =  (McpU8) HalStEvent_AwakeRxThread; 
-			
-			/* Nothing is available to read for now, prepare for the incoming data */
+			/* 
+			 * Nothing is available to read for now, prepare for the incoming data.
+			 * The ST thread selects on osPort whenever the Rx ring is not full.
+			 */
 			eRes = RES_PENDING;
 			pHalSt->iRxReadNum = uLen;	/* byte number requested to read  	   */
 			pHalSt->pInData 	 = pBuf;    /* buffer to use for the incoming data */
@@ -386,14 +389,6 @@ EMcpfRes HAL_ST_Read (	const handle_t    	hHalSt,
 			MCPF_REPORT_DEBUG_RX(pHalSt->hMcpf, HAL_ST_MODULE_LOG, 
 								 ("%s: prepare pBuf=%p len=%d readNum=%d retLen=%d\n", 
 								  __FUNCTION__, pBuf, uLen, pHalSt->iRxReadNum, iBytesRead));
-
-			/* Signal ST thread to d oselect also on osPort */
-	    		if(write(pHalSt->pipeFd[1], (const void*) &uMngEvt, 1) == -1)
-	    		{
-				MCPF_REPORT_ERROR (pHalSt->hMcpf, HAL_ST_MODULE_LOG,
-								  ("%s: Pipe write failed, err=%u\n", __FUNCTION__, errno));
-				return RES_ERROR;
-	    		}
 		}
 	}
 	else
@@ -421,8 +416,8 @@ EMcpfRes HAL_ST_ReadResult (const handle_t  hHalSt, McpU16 *pLen)
 
     *pLen = (McpU16) pHalSt->iRxRepNum;
 
-	MCPF_REPORT_DEBUG_RX(pHalSt->hMcpf, HAL_ST_MODULE_LOG, ("%s: availNum=%d readNum=%d retLen=%d\n",
-                         __FUNCTION__, pHalSt->iRxAvailNum, pHalSt->iRxReadNum, pHalSt->iRxRepNum));
+	MCPF_REPORT_DEBUG_RX(pHalSt->hMcpf, HAL_ST_MODULE_LOG, ("%s: availNum=%u readNum=%d retLen=%d\n",
+                         __FUNCTION__, HALST_RX_RING_USED(pHalSt), pHalSt->iRxReadNum, pHalSt->iRxRepNum));
 
     return RES_OK;
 }
@@ -513,10 +508,20 @@ EMcpfRes HAL_ST_Port_Reset (handle_t  *hHalSt, McpU8 *pBuf, McpU16 len, const Mc
  */
 EMcpfRes HAL_ST_RestartRead (const handle_t  hHalSt)
 {
-    handle_t  lHalSt = hHalSt; /* reduce compiler warnings*/
-    
-    MCP_UNUSED_PARAMETER(lHalSt);
-    /* Nothing to do, the read is not stopped */
+    THalStObj  *pHalSt = (THalStObj *) hHalSt;
+    McpU8       uMngEvt = (McpU8) HalStEvent_AwakeRxThread;
+
+    /* 
+     * The read is not stopped, but data may already be buffered in the Rx ring - 
+     * awake ST thread to report it
+     */
+    pHalSt->bRxRestart = MCP_TRUE;
+    if (write(pHalSt->pipeFd[1], (const void*) &uMngEvt, 1) == -1)
+    {
+        MCPF_REPORT_ERROR (pHalSt->hMcpf, HAL_ST_MODULE_LOG,
+                           ("%s: Pipe write failed, err=%u\n", __FUNCTION__, errno));
+        return RES_ERROR;
+    }
     return RES_OK;
 }
 
@@ -833,7 +838,6 @@ static void *stThreadFun (void * pParam)
     THalStObj  *pHalSt = (THalStObj *) pParam;
     fd_set  	  readFds;
     int     	  iRetCode;
-    EHalStEvent event;
 
     /* Identify ! */
     MCP_HAL_LOG_SetThreadName("ST");
@@ -850,9 +854,12 @@ static void *stThreadFun (void * pParam)
     {
         // MCPF_REPORT_DEBUG_CONTROL(pHalSt->hMcpf, HAL_ST_MODULE_LOG, ("stThreadFun: Reading data synchronously...\n"));
 
-        /* initialize file descr. bit sets */
+        /* initialize file descr. bit sets, stop reading ST device while the Rx ring is full */
         FD_ZERO (&readFds);
-		FD_SET (pHalSt->hOsPort,   &readFds);
+		if (HALST_RX_RING_USED(pHalSt) < HALST_RX_RING_SIZE)
+		{
+			FD_SET (pHalSt->hOsPort,   &readFds);
+		}
 
         FD_SET (pHalSt->pipeFd[0], &readFds);
 
@@ -867,42 +874,11 @@ static void *stThreadFun (void * pParam)
 			/* Determine which file descriptor is ready for read */
 			if (FD_ISSET(pHalSt->hOsPort, &readFds))
 			{
-				McpS32	iReadNum, iBytesRead;
-
-                iRetCode = ioctl (pHalSt->hOsPort, FIONREAD, &pHalSt->iRxAvailNum);
-
-                MCPF_REPORT_DEBUG_CONTROL(pHalSt->hMcpf, HAL_ST_MODULE_LOG, ("%s: ReadReady event,  res=%d avail=%d\n", __FUNCTION__, iRetCode, pHalSt->iRxAvailNum));
-
-				/* read requested number of bytes */
-				iReadNum = MIN(pHalSt->iRxReadNum, pHalSt->iRxAvailNum);
-
-				if (iReadNum > 0)
-				{
-					/* Read received bytes from ST device */
-					iBytesRead = read (pHalSt->hOsPort, pHalSt->pInData, iReadNum);
-
-					if (iBytesRead >= 0)
-					{
-						event = HalStEvent_ReadReadylInd;
-						pHalSt->iRxAvailNum -= iBytesRead;
-                        			pHalSt->iRxRepNum = iBytesRead;
-						pHalSt->iRxReadNum = 0;
-					}
-					else
-					{
-						MCPF_REPORT_ERROR (pHalSt->hMcpf, HAL_ST_MODULE_LOG,
-										   ("%s: Read failed, err=%u\n", __FUNCTION__, errno));
-						event = HalStEvent_Error;
-					}
-				}
-				else
+				/* Read all the available bytes into the Rx ring in a single call */
+				if (stRxRingFill (pHalSt) != RES_OK)
 				{
-					MCPF_REPORT_ERROR (pHalSt->hMcpf, HAL_ST_MODULE_LOG,
-									   ("%s: uexpected num zero\n", __FUNCTION__));
-					event = HalStEvent_Error;
+					pHalSt->fEventHandlerCb (pHalSt->hHandleCb, HalStEvent_Error);
 				}
-
-				pHalSt->fEventHandlerCb (pHalSt->hHandleCb, event);
 			}
 
 			if (FD_ISSET(pHalSt->pipeFd[0], &readFds))
@@ -937,6 +913,28 @@ static void *stThreadFun (void * pParam)
 					MCPF_REPORT_ERROR(pHalSt->hMcpf, HAL_ST_MODULE_LOG, ("%s: pipe read error\n", __FUNCTION__));
 				}
 			}
+
+			/* 
+			 * Complete the pending read from the Rx ring. The receiver keeps reading all the 
+			 * other buffered packets from the ring in the same event, without system calls.
+			 * On read restart, just indicate the receiver to read the buffered data.
+			 */
+			if ((HALST_RX_RING_USED(pHalSt) > 0) && 
+				((pHalSt->iRxReadNum > 0) || pHalSt->bRxRestart))
+			{
+				pHalSt->iRxRepNum = 0;
+				if (!pHalSt->bRxRestart)
+				{
+					pHalSt->iRxRepNum = stRxRingGet (pHalSt, pHalSt->pInData, (McpU16) pHalSt->iRxReadNum);
+				}
+				pHalSt->iRxReadNum = 0;
+				pHalSt->bRxRestart = MCP_FALSE;
+
+				MCPF_REPORT_DEBUG_CONTROL(pHalSt->hMcpf, HAL_ST_MODULE_LOG, ("%s: ReadReady event, len=%d avail=%u\n", 
+										  __FUNCTION__, pHalSt->iRxRepNum, HALST_RX_RING_USED(pHalSt)));
+
+				pHalSt->fEventHandlerCb (pHalSt->hHandleCb, HalStEvent_ReadReadylInd);
+			}
         }
 		else if (iRetCode == 0)
 		{
@@ -1057,6 +1055,9 @@ static EMcpfRes stPortRxReset (THalStObj *pHalSt, McpU8 *pBuf, McpU16 len)
     
     MCP_UNUSED_PARAMETER(len);
 
+	/* Discard the bytes already buffered in the Rx ring */
+	pHalSt->uRxRingHead = pHalSt->uRxRingTail;
+
 	/* 
 	 * Read and discard all available bytes from ST port input buffer.
 	 * ReadFile returns 0 when fails (no more data to read or error)
@@ -1078,6 +1079,81 @@ static EMcpfRes stPortRxReset (THalStObj *pHalSt, McpU8 *pBuf, McpU16 len)
 }
 
 
+/**
+ * \fn     stRxRingFill
+ * \brief  Bulk read into Rx ring
+ *
+ * Reads whatever the ST device has available, up to the free space of the Rx ring,
+ * with a single system call
+ *
+ * \note   Called from ST thread when ST device is ready for read
+ * \param   pHalSt  - pointer to HAL ST object
+ * \return  Returns the status of operation: OK or Error
+ * \sa      stRxRingGet
+ */
+static EMcpfRes stRxRingFill (THalStObj *pHalSt)
+{
+    struct iovec    aIov[2];
+    McpU32          uOffset = pHalSt->uRxRingTail & (HALST_RX_RING_SIZE - 1);
+    McpU32          uFree   = HALST_RX_RING_SIZE - HALST_RX_RING_USED(pHalSt);
+    McpS32          iBytesRead;
+
+    /* The free space may wrap around the ring end */
+    aIov[0].iov_base = &pHalSt->aRxRing[uOffset];
+    aIov[0].iov_len  = MIN(uFree, HALST_RX_RING_SIZE - uOffset);
+    aIov[1].iov_base = pHalSt->aRxRing;
+    aIov[1].iov_len  = uFree - aIov[0].iov_len;
+
+    iBytesRead = readv (pHalSt->hOsPort, aIov, (aIov[1].iov_len > 0) ? 2 : 1);
+    if (iBytesRead < 0)
+    {
+        MCPF_REPORT_ERROR (pHalSt->hMcpf, HAL_ST_MODULE_LOG,
+                           ("%s: Read failed, err=%u\n", __FUNCTION__, errno));
+        return RES_ERROR;
+    }
+
+    pHalSt->uRxRingTail += (McpU32) iBytesRead;
+
+#ifdef TRAN_DBG
+    pHalSt->dbgCount.Rx++;
+#endif
+
+    MCPF_REPORT_DEBUG_RX(pHalSt->hMcpf, HAL_ST_MODULE_LOG, ("%s: read=%d avail=%u\n", 
+                         __FUNCTION__, iBytesRead, HALST_RX_RING_USED(pHalSt)));
+    return RES_OK;
+}
+
+
+/**
+ * \fn     stRxRingGet
+ * \brief  Get data from Rx ring
+ *
+ * Copies up to the requested number of buffered bytes to the receiver buffer
+ *
+ * \note
+ * \param   pHalSt  - pointer to HAL ST object
+ * \param   pBuf    - receiver buffer
+ * \param   uLen    - requested number of bytes
+ * \return  Number of bytes copied
+ * \sa      stRxRingFill
+ */
+static McpU16 stRxRingGet (THalStObj *pHalSt, McpU8 *pBuf, McpU16 uLen)
+{
+    McpU32  uOffset = pHalSt->uRxRingHead & (HALST_RX_RING_SIZE - 1);
+    McpU32  uNum    = MIN((McpU32) uLen, HALST_RX_RING_USED(pHalSt));
+    McpU32  uFirst  = MIN(uNum, HALST_RX_RING_SIZE - uOffset);
+
+    mcpf_mem_copy (pHalSt->hMcpf, pBuf, &pHalSt->aRxRing[uOffset], uFirst);
+    if (uNum > uFirst)
+    {
+        mcpf_mem_copy (pHalSt->hMcpf, pBuf + uFirst, pHalSt->aRxRing, uNum - uFirst);
+    }
+    pHalSt->uRxRingHead += uNum;
+
+    return (McpU16) uNum;
+}
+
+
 /**
  * \fn     stSpeedToOSbaudrate
  * \brief  Convert ST speed to baudrate
@@ -59,59 +59,48 @@ typedef enum
 	_MCP_LINUX_LINE_PARSER_STATE_END_QUOTED_TOKEN
 } _lineParserParsingState;
 
-static McpU32 	_lineParserNextArgIndex = 0;
-static McpU32 	_lineParserNumOfArgs = 0;
-char 	*_lineParserArgs[MCP_LINUX_LINE_PARSER_MAX_NUM_OF_ARGUMENTS];
-char	_lineParserLine[MCP_LINUX_LINE_PARSER_MAX_LINE_LEN + 1];
-static McpBool	parsingFailed = MCP_FALSE;
+/* Context of the non reentrant API */
+static McpLinuxLineParserContext _lineParserContext;
 
-_lineParserCharType GetCharType(char c, const char* delimiters)
-{
-	if (c == (char)34)
-	{
-		return _MCP_LINUX_LINE_PARSER_CHAR_TYPE_QUOTE;
-	}
-	else if (strchr(delimiters, c) != NULL)
-	{
-		return _MCP_LINUX_LINE_PARSER_CHAR_TYPE_DELIM;
-	}
-	else if (c == '\0')
-	{
-		return _MCP_LINUX_LINE_PARSER_CHAR_TYPE_END;
-	}
-	else
-	{
-		return _MCP_LINUX_LINE_PARSER_CHAR_TYPE_NORMAL;
-	}
-}
+static void _lineParserBuildCharTypes(McpLinuxLineParserContext *ctx, const char* delimiters);
+static McpBool _lineParserAddArg(McpLinuxLineParserContext *ctx, char *pos);
+static McpBool _lineParserStrToU32(const char *str, McpBool hex, McpU32 *value);
 
-MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_ParseLine(McpU8 *line, const char* delimiters)
+MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_ParseLineCtx(McpLinuxLineParserContext *ctx, McpU8 *line, const char* delimiters)
 {
 	char *pos = NULL;
 	char *lineEnd;
+	size_t lineLen;
 	_lineParserParsingState state;
 	_lineParserCharType	charType;
 
-	_lineParserNextArgIndex = 0;
-	_lineParserNumOfArgs = 0;
-	parsingFailed = MCP_TRUE;
+	ctx->nextArgIndex = 0;
+	ctx->numOfArgs = 0;
+	ctx->parsingFailed = MCP_TRUE;
 
-	MCP_HAL_STRING_StrCpy(_lineParserLine, (char*)line);
+	lineLen = MCP_HAL_STRING_StrLen((char*)line);
+	if (lineLen > MCP_LINUX_LINE_PARSER_MAX_LINE_LEN)
+	{
+		return MCP_LINUX_LINE_PARSER_STATUS_ARGUMENT_TOO_LONG;
+	}
 
-	if (MCP_HAL_STRING_StrLen(_lineParserLine)== 0)
+	if (lineLen == 0)
 	{
-		parsingFailed = MCP_FALSE;
+		ctx->parsingFailed = MCP_FALSE;
 		return MCP_LINUX_LINE_PARSER_STATUS_SUCCESS;
 	}
 
-	pos = _lineParserLine;
-	lineEnd = _lineParserLine + MCP_HAL_STRING_StrLen(_lineParserLine);
+	memcpy(ctx->line, line, lineLen + 1);
+	_lineParserBuildCharTypes(ctx, delimiters);
+
+	pos = ctx->line;
+	lineEnd = ctx->line + lineLen;
 
 	state = _MCP_LINUX_LINE_PARSER_STATE_IN_DELIMITER;
 
 	while (pos <= lineEnd)
 	{
-		charType = GetCharType(*pos, delimiters);
+		charType = (_lineParserCharType)ctx->charTypes[(McpU8)*pos];
 
 		switch (state)
 		{
@@ -130,8 +119,10 @@ MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_ParseLine(McpU8 *line, const
 				break;
 
 			case _MCP_LINUX_LINE_PARSER_CHAR_TYPE_NORMAL:
-				_lineParserArgs[_lineParserNumOfArgs] = pos;
-				++_lineParserNumOfArgs;
+				if (_lineParserAddArg(ctx, pos) == MCP_FALSE)
+				{
+					return MCP_LINUX_LINE_PARSER_STATUS_FAILED;
+				}
 				state = _MCP_LINUX_LINE_PARSER_STATE_IN_TOKEN;
 				break;
 
@@ -147,16 +138,20 @@ MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_ParseLine(McpU8 *line, const
 			switch (charType)
 			{
 			case _MCP_LINUX_LINE_PARSER_CHAR_TYPE_QUOTE:
-				_lineParserArgs[_lineParserNumOfArgs] = pos;
-				++_lineParserNumOfArgs;
+				if (_lineParserAddArg(ctx, pos) == MCP_FALSE)
+				{
+					return MCP_LINUX_LINE_PARSER_STATUS_FAILED;
+				}
 				state = _MCP_LINUX_LINE_PARSER_STATE_END_QUOTED_TOKEN;
 
 				break;
 
 			case _MCP_LINUX_LINE_PARSER_CHAR_TYPE_DELIM:
 			case _MCP_LINUX_LINE_PARSER_CHAR_TYPE_NORMAL:
-				_lineParserArgs[_lineParserNumOfArgs] = pos;
-				++_lineParserNumOfArgs;
+				if (_lineParserAddArg(ctx, pos) == MCP_FALSE)
+				{
+					return MCP_LINUX_LINE_PARSER_STATUS_FAILED;
+				}
 				state = _MCP_LINUX_LINE_PARSER_STATE_IN_QUOTED_TOKEN;
 
 				break;
@@ -243,19 +238,19 @@ MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_ParseLine(McpU8 *line, const
 		++pos;
 	}
 
-	parsingFailed = MCP_FALSE;
+	ctx->parsingFailed = MCP_FALSE;
 
 	return MCP_LINUX_LINE_PARSER_STATUS_SUCCESS;
 }
 
-McpU32 MCP_LINUX_LINE_PARSER_GetNumOfArgs(void)
+McpU32 MCP_LINUX_LINE_PARSER_GetNumOfArgsCtx(McpLinuxLineParserContext *ctx)
 {
-	return _lineParserNumOfArgs;
+	return ctx->numOfArgs;
 }
 
-McpBool MCP_LINUX_LINE_PARSER_AreThereMoreArgs(void)
+McpBool MCP_LINUX_LINE_PARSER_AreThereMoreArgsCtx(McpLinuxLineParserContext *ctx)
 {
-	if ((parsingFailed == MCP_TRUE) || (_lineParserNextArgIndex >= _lineParserNumOfArgs))
+	if ((ctx->parsingFailed == MCP_TRUE) || (ctx->nextArgIndex >= ctx->numOfArgs))
 	{
 		return MCP_FALSE;
 	}
@@ -287,10 +282,10 @@ void MCP_LINUX_LINE_PARSER_ToUpper(McpU8 *str)
 	}
 }
 
-MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_GetNextChar(McpU8 *c)
+MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_GetNextCharCtx(McpLinuxLineParserContext *ctx, McpU8 *c)
 {
 	char tempStr[200];
-	MCP_LINUX_LINE_PARSER_STATUS status = MCP_LINUX_LINE_PARSER_GetNextStr((McpU8*)tempStr, 200);
+	MCP_LINUX_LINE_PARSER_STATUS status = MCP_LINUX_LINE_PARSER_GetNextStrCtx(ctx, (McpU8*)tempStr, 200);
 
 	if (status != MCP_LINUX_LINE_PARSER_STATUS_SUCCESS)
 	{
@@ -311,36 +306,39 @@ MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_GetNextChar(McpU8 *c)
 	}
 }
 
-MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_GetNextStr(McpU8 *str, McpU8 len)
+MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_GetNextStrCtx(McpLinuxLineParserContext *ctx, McpU8 *str, McpU8 len)
 {
-	if (parsingFailed == MCP_TRUE)
+	size_t argLen;
+
+	if (ctx->parsingFailed == MCP_TRUE)
 	{
 		return MCP_LINUX_LINE_PARSER_STATUS_FAILED;
 	}
 
-	if (MCP_LINUX_LINE_PARSER_AreThereMoreArgs() == MCP_FALSE)
+	if (MCP_LINUX_LINE_PARSER_AreThereMoreArgsCtx(ctx) == MCP_FALSE)
 	{
 		return MCP_LINUX_LINE_PARSER_STATUS_NO_MORE_ARGUMENTS;
 	}
-			
-	if (MCP_HAL_STRING_StrLen(_lineParserArgs[_lineParserNextArgIndex]) > len)
+
+	argLen = MCP_HAL_STRING_StrLen(ctx->args[ctx->nextArgIndex]);
+	if (argLen > len)
 	{
-		parsingFailed = MCP_TRUE;
+		ctx->parsingFailed = MCP_TRUE;
 		return MCP_LINUX_LINE_PARSER_STATUS_ARGUMENT_TOO_LONG;
 	}
 
-	MCP_HAL_STRING_StrCpy((char*)str, _lineParserArgs[_lineParserNextArgIndex]);
+	memcpy(str, ctx->args[ctx->nextArgIndex], argLen + 1);
 
-	++_lineParserNextArgIndex;
+	++ctx->nextArgIndex;
 
 	return MCP_LINUX_LINE_PARSER_STATUS_SUCCESS;
 }
 
-MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_GetNextU8(McpU8 *value, McpBool hex)
+MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_GetNextU8Ctx(McpLinuxLineParserContext *ctx, McpU8 *value, McpBool hex)
 {
 	McpU32	tempValue = 0;
 	
-	MCP_LINUX_LINE_PARSER_STATUS status = MCP_LINUX_LINE_PARSER_GetNextU32(&tempValue, hex);
+	MCP_LINUX_LINE_PARSER_STATUS status = MCP_LINUX_LINE_PARSER_GetNextU32Ctx(ctx, &tempValue, hex);
 
 	if (status != MCP_LINUX_LINE_PARSER_STATUS_SUCCESS)
 	{
@@ -349,7 +347,7 @@ MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_GetNextU8(McpU8 *value, McpBo
 
 	if (tempValue > 0xFF)
 	{
-		parsingFailed = MCP_TRUE;
+		ctx->parsingFailed = MCP_TRUE;
 		return MCP_LINUX_LINE_PARSER_STATUS_FAILED;
 	}
 
@@ -358,11 +356,11 @@ MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_GetNextU8(McpU8 *value, McpBo
 	return MCP_LINUX_LINE_PARSER_STATUS_SUCCESS;
 }
 
-MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_GetNextU16(McpU16 *value, McpBool hex)
+MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_GetNextU16Ctx(McpLinuxLineParserContext *ctx, McpU16 *value, McpBool hex)
 {
 	McpU32	tempValue = 0;
 	
-	MCP_LINUX_LINE_PARSER_STATUS status = MCP_LINUX_LINE_PARSER_GetNextU32(&tempValue, hex);
+	MCP_LINUX_LINE_PARSER_STATUS status = MCP_LINUX_LINE_PARSER_GetNextU32Ctx(ctx, &tempValue, hex);
 
 	if (status != MCP_LINUX_LINE_PARSER_STATUS_SUCCESS)
 	{
@@ -371,7 +369,7 @@ MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_GetNextU16(McpU16 *value, Mcp
 
 	if (tempValue > 0xFFFF)
 	{
-		parsingFailed = MCP_TRUE;
+		ctx->parsingFailed = MCP_TRUE;
 		return MCP_LINUX_LINE_PARSER_STATUS_FAILED;
 	}
 
@@ -380,59 +378,46 @@ MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_GetNextU16(McpU16 *value, Mcp
 	return MCP_LINUX_LINE_PARSER_STATUS_SUCCESS;
 }
 
-MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_GetNextU32(McpU32 *value, McpBool hex)
+MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_GetNextU32Ctx(McpLinuxLineParserContext *ctx, McpU32 *value, McpBool hex)
 {
-	int 		num;
-	McpS32		signedValue = 0;
+	const char	*arg;
+	McpU32		tempValue;
 
-	if (parsingFailed ==MCP_TRUE)
+	if (ctx->parsingFailed ==MCP_TRUE)
 	{
 		return MCP_LINUX_LINE_PARSER_STATUS_FAILED;
 	}
 
-	if (MCP_LINUX_LINE_PARSER_AreThereMoreArgs() == MCP_FALSE)
+	if (MCP_LINUX_LINE_PARSER_AreThereMoreArgsCtx(ctx) == MCP_FALSE)
 	{
 		return MCP_LINUX_LINE_PARSER_STATUS_NO_MORE_ARGUMENTS;
 	}
 
-	if (hex == MCP_TRUE)
+	arg = ctx->args[ctx->nextArgIndex];
+	if (arg[0] == '-')
 	{
-        num = sscanf(_lineParserArgs[_lineParserNextArgIndex], "%x", 
-                     (unsigned int*)&signedValue);
+		++arg;
 	}
-	else
-	{
-        num = sscanf(_lineParserArgs[_lineParserNextArgIndex], "%d", 
-                     (int *)&signedValue);
-	}
-	
 
-	if ((num == 0) || (num == EOF))
+	/* negative values are not accepted */
+	if ((_lineParserStrToU32(arg, (hex == MCP_TRUE) ? MCP_TRUE : MCP_FALSE, &tempValue) == MCP_FALSE) ||
+		(tempValue > ((arg != ctx->args[ctx->nextArgIndex]) ? 0 : 0x7FFFFFFF)))
 	{	
-		parsingFailed = MCP_TRUE;
+		ctx->parsingFailed = MCP_TRUE;
 		return MCP_LINUX_LINE_PARSER_STATUS_FAILED;
 	}
-	else
-	{
-		if (signedValue < 0)
-		{
-			parsingFailed = MCP_TRUE;
-			return MCP_LINUX_LINE_PARSER_STATUS_FAILED;
 
-		}
-
-		*value = (McpU32)signedValue;
-		++_lineParserNextArgIndex;
-				
-		return MCP_LINUX_LINE_PARSER_STATUS_SUCCESS;
-	}
+	*value = tempValue;
+	++ctx->nextArgIndex;
+			
+	return MCP_LINUX_LINE_PARSER_STATUS_SUCCESS;
 }
 
-MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_GetNextS8(McpS8 *value)
+MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_GetNextS8Ctx(McpLinuxLineParserContext *ctx, McpS8 *value)
 {
 	McpS32	tempValue = 0;
 	
-	MCP_LINUX_LINE_PARSER_STATUS status = MCP_LINUX_LINE_PARSER_GetNextS32(&tempValue);
+	MCP_LINUX_LINE_PARSER_STATUS status = MCP_LINUX_LINE_PARSER_GetNextS32Ctx(ctx, &tempValue);
 
 	if (status != MCP_LINUX_LINE_PARSER_STATUS_SUCCESS)
 	{
@@ -441,7 +426,7 @@ MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_GetNextS8(McpS8 *value)
 
 	if ((McpU32)tempValue > 0xFF)
 	{
-		parsingFailed = MCP_TRUE;
+		ctx->parsingFailed = MCP_TRUE;
 		return MCP_LINUX_LINE_PARSER_STATUS_FAILED;
 	}
 
@@ -450,11 +435,11 @@ MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_GetNextS8(McpS8 *value)
 	return MCP_LINUX_LINE_PARSER_STATUS_SUCCESS;
 }
 
-MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_GetNextS16(McpS16 *value)
+MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_GetNextS16Ctx(McpLinuxLineParserContext *ctx, McpS16 *value)
 {
 	McpS32	tempValue = 0;
 	
-	MCP_LINUX_LINE_PARSER_STATUS status = MCP_LINUX_LINE_PARSER_GetNextS32(&tempValue);
+	MCP_LINUX_LINE_PARSER_STATUS status = MCP_LINUX_LINE_PARSER_GetNextS32Ctx(ctx, &tempValue);
 
 	if (status != MCP_LINUX_LINE_PARSER_STATUS_SUCCESS)
 	{
@@ -463,7 +448,7 @@ MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_GetNextS16(McpS16 *value)
 
 	if ((McpU32)tempValue > 0xFFFF)
 	{
-		parsingFailed = MCP_TRUE;
+		ctx->parsingFailed = MCP_TRUE;
 		return MCP_LINUX_LINE_PARSER_STATUS_FAILED;
 	}
 
@@ -472,48 +457,46 @@ MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_GetNextS16(McpS16 *value)
 	return MCP_LINUX_LINE_PARSER_STATUS_SUCCESS;
 }
 
-MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_GetNextS32(McpS32 *value)
+MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_GetNextS32Ctx(McpLinuxLineParserContext *ctx, McpS32 *value)
 {
-	int 		num;
+	const char	*arg;
+	McpU32		magnitude;
+	McpBool		negative = MCP_FALSE;
 
-	if (parsingFailed ==MCP_TRUE)
+	if (ctx->parsingFailed ==MCP_TRUE)
 	{
 		return MCP_LINUX_LINE_PARSER_STATUS_FAILED;
 	}
 
-	if (MCP_LINUX_LINE_PARSER_AreThereMoreArgs() == MCP_FALSE)
+	if (MCP_LINUX_LINE_PARSER_AreThereMoreArgsCtx(ctx) == MCP_FALSE)
 	{
 		return MCP_LINUX_LINE_PARSER_STATUS_NO_MORE_ARGUMENTS;
 	}
 	
-	if (_lineParserArgs[_lineParserNextArgIndex][0] != '-')
-	{
-        num = sscanf(_lineParserArgs[_lineParserNextArgIndex], "%d",
-                     (int *)value);
-	}
-	else
+	arg = ctx->args[ctx->nextArgIndex];
+	if (arg[0] == '-')
 	{
-        num = sscanf(_lineParserArgs[_lineParserNextArgIndex+1], "%d",
-                     (int *)value);
+		negative = MCP_TRUE;
+		++arg;
 	}
 
-	if ((num == 0) || (num == EOF))
+	if ((_lineParserStrToU32(arg, MCP_FALSE, &magnitude) == MCP_FALSE) ||
+		(magnitude > ((negative == MCP_TRUE) ? 0x80000000 : 0x7FFFFFFF)))
 	{	
-		parsingFailed = MCP_TRUE;
+		ctx->parsingFailed = MCP_TRUE;
 		return MCP_LINUX_LINE_PARSER_STATUS_FAILED;
 	}
-	else
-	{
-		++_lineParserNextArgIndex;
-				
-		return MCP_LINUX_LINE_PARSER_STATUS_SUCCESS;
-	}
+
+	*value = (negative == MCP_TRUE) ? (McpS32)(0 - magnitude) : (McpS32)magnitude;
+	++ctx->nextArgIndex;
+			
+	return MCP_LINUX_LINE_PARSER_STATUS_SUCCESS;
 }
 
-MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_GetNextBool(McpBool *value)
+MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_GetNextBoolCtx(McpLinuxLineParserContext *ctx, McpBool *value)
 {
 	char tempStr[200];
-	MCP_LINUX_LINE_PARSER_STATUS status = MCP_LINUX_LINE_PARSER_GetNextStr((McpU8*)tempStr, 200);
+	MCP_LINUX_LINE_PARSER_STATUS status = MCP_LINUX_LINE_PARSER_GetNextStrCtx(ctx, (McpU8*)tempStr, 200);
 
 	if (status != MCP_LINUX_LINE_PARSER_STATUS_SUCCESS)
 	{
@@ -535,9 +518,165 @@ MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_GetNextBool(McpBool *value)
 		}
 		else
 		{
-			parsingFailed = MCP_TRUE;
+			ctx->parsingFailed = MCP_TRUE;
 			return MCP_LINUX_LINE_PARSER_STATUS_FAILED;
 		}
 	}
 }
 
+/*
+ * Non reentrant API, parsing with the shared context
+ */
+MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_ParseLine(McpU8 *line, const char* delimiters)
+{
+	return MCP_LINUX_LINE_PARSER_ParseLineCtx(&_lineParserContext, line, delimiters);
+}
+
+McpU32 MCP_LINUX_LINE_PARSER_GetNumOfArgs(void)
+{
+	return MCP_LINUX_LINE_PARSER_GetNumOfArgsCtx(&_lineParserContext);
+}
+
+McpBool MCP_LINUX_LINE_PARSER_AreThereMoreArgs(void)
+{
+	return MCP_LINUX_LINE_PARSER_AreThereMoreArgsCtx(&_lineParserContext);
+}
+
+MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_GetNextChar(McpU8 *c)
+{
+	return MCP_LINUX_LINE_PARSER_GetNextCharCtx(&_lineParserContext, c);
+}
+
+MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_GetNextStr(McpU8 *str, McpU8 len)
+{
+	return MCP_LINUX_LINE_PARSER_GetNextStrCtx(&_lineParserContext, str, len);
+}
+
+MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_GetNextU8(McpU8 *value, McpBool hex)
+{
+	return MCP_LINUX_LINE_PARSER_GetNextU8Ctx(&_lineParserContext, value, hex);
+}
+
+MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_GetNextU16(McpU16 *value, McpBool hex)
+{
+	return MCP_LINUX_LINE_PARSER_GetNextU16Ctx(&_lineParserContext, value, hex);
+}
+
+MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_GetNextU32(McpU32 *value, McpBool hex)
+{
+	return MCP_LINUX_LINE_PARSER_GetNextU32Ctx(&_lineParserContext, value, hex);
+}
+
+MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_GetNextS8(McpS8 *value)
+{
+	return MCP_LINUX_LINE_PARSER_GetNextS8Ctx(&_lineParserContext, value);
+}
+
+MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_GetNextS16(McpS16 *value)
+{
+	return MCP_LINUX_LINE_PARSER_GetNextS16Ctx(&_lineParserContext, value);
+}
+
+MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_GetNextS32(McpS32 *value)
+{
+	return MCP_LINUX_LINE_PARSER_GetNextS32Ctx(&_lineParserContext, value);
+}
+
+MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_GetNextBool(McpBool *value)
+{
+	return MCP_LINUX_LINE_PARSER_GetNextBoolCtx(&_lineParserContext, value);
+}
+
+/*
+ * Classify all characters once per line, so the parsing loop does a single
+ * table lookup per character instead of scanning the delimiters.
+ */
+static void _lineParserBuildCharTypes(McpLinuxLineParserContext *ctx, const char* delimiters)
+{
+	const McpU8 *delim;
+
+	memset(ctx->charTypes, _MCP_LINUX_LINE_PARSER_CHAR_TYPE_NORMAL, sizeof(ctx->charTypes));
+
+	for (delim = (const McpU8 *)delimiters; *delim != '\0'; ++delim)
+	{
+		ctx->charTypes[*delim] = _MCP_LINUX_LINE_PARSER_CHAR_TYPE_DELIM;
+	}
+
+	/* the quote wins over a delimiter, the terminator is always the end */
+	ctx->charTypes[34] = _MCP_LINUX_LINE_PARSER_CHAR_TYPE_QUOTE;
+	ctx->charTypes[0] = _MCP_LINUX_LINE_PARSER_CHAR_TYPE_END;
+}
+
+static McpBool _lineParserAddArg(McpLinuxLineParserContext *ctx, char *pos)
+{
+	if (ctx->numOfArgs >= MCP_LINUX_LINE_PARSER_MAX_NUM_OF_ARGUMENTS)
+	{
+		return MCP_FALSE;
+	}
+
+	ctx->args[ctx->numOfArgs] = pos;
+	++ctx->numOfArgs;
+
+	return MCP_TRUE;
+}
+
+/*
+ * Single pass conversion of a decimal or hexadecimal (optional "0x" prefix)
+ * number. Like sscanf, leading white space is skipped and conversion stops at
+ * the first character which is not a digit; at least one digit is required.
+ * Values not fitting in 32 bits fail.
+ */
+static McpBool _lineParserStrToU32(const char *str, McpBool hex, McpU32 *value)
+{
+	McpU32	result = 0;
+	McpU32	digit;
+	McpU32	base = (hex == MCP_TRUE) ? 16 : 10;
+	McpBool	anyDigit = MCP_FALSE;
+
+	while ((*str == ' ') || (*str == '\t') || (*str == '\n') || (*str == '\r'))
+	{
+		++str;
+	}
+
+	if (*str == '+')
+	{
+		++str;
+	}
+
+	if ((hex == MCP_TRUE) && (str[0] == '0') && ((str[1] == 'x') || (str[1] == 'X')) && isxdigit((McpU8)str[2]))
+	{
+		str += 2;
+	}
+
+	for (;; ++str)
+	{
+		if ((*str >= '0') && (*str <= '9'))
+		{
+			digit = (McpU32)(*str - '0');
+		}
+		else if ((hex == MCP_TRUE) && (*str >= 'a') && (*str <= 'f'))
+		{
+			digit = (McpU32)(*str - 'a' + 10);
+		}
+		else if ((hex == MCP_TRUE) && (*str >= 'A') && (*str <= 'F'))
+		{
+			digit = (McpU32)(*str - 'A' + 10);
+		}
+		else
+		{
+			break;
+		}
+
+		if (result > (0xFFFFFFFF - digit) / base)
+		{
+			return MCP_FALSE;
+		}
+
+		result = result * base + digit;
+		anyDigit = MCP_TRUE;
+	}
+
+	*value = result;
+
+	return anyDigit;
+}
@@ -43,6 +43,35 @@ typedef enum
 	MCP_LINUX_LINE_PARSER_STATUS_NO_MORE_ARGUMENTS
 } MCP_LINUX_LINE_PARSER_STATUS;
 
+/*
+ * Parsing context, holding a parsed line and the position of the next argument.
+ * Each thread parses with its own context; the functions without the Ctx suffix
+ * use a single shared context and are not reentrant.
+ */
+typedef struct
+{
+	McpU32	nextArgIndex;
+	McpU32	numOfArgs;
+	McpBool	parsingFailed;
+	char	*args[MCP_LINUX_LINE_PARSER_MAX_NUM_OF_ARGUMENTS];
+	char	line[MCP_LINUX_LINE_PARSER_MAX_LINE_LEN + 1];
+	McpU8	charTypes[256];		/* character classification for the current delimiters */
+} McpLinuxLineParserContext;
+
+MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_ParseLineCtx(McpLinuxLineParserContext *ctx, McpU8 *line, const char* delimiters);
+McpU32 MCP_LINUX_LINE_PARSER_GetNumOfArgsCtx(McpLinuxLineParserContext *ctx);
+McpBool MCP_LINUX_LINE_PARSER_AreThereMoreArgsCtx(McpLinuxLineParserContext *ctx);
+
+MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_GetNextCharCtx(McpLinuxLineParserContext *ctx, McpU8 *c);
+MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_GetNextStrCtx(McpLinuxLineParserContext *ctx, McpU8 *str, McpU8 len);
+MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_GetNextU8Ctx(McpLinuxLineParserContext *ctx, McpU8 *value, McpBool hex);
+MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_GetNextU16Ctx(McpLinuxLineParserContext *ctx, McpU16 *value, McpBool hex);
+MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_GetNextU32Ctx(McpLinuxLineParserContext *ctx, McpU32 *value, McpBool hex);
+MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_GetNextS8Ctx(McpLinuxLineParserContext *ctx, McpS8 *value);
+MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_GetNextS16Ctx(McpLinuxLineParserContext *ctx, McpS16 *value);
+MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_GetNextS32Ctx(McpLinuxLineParserContext *ctx, McpS32 *value);
+MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_GetNextBoolCtx(McpLinuxLineParserContext *ctx, McpBool *value);
+
 MCP_LINUX_LINE_PARSER_STATUS MCP_LINUX_LINE_PARSER_ParseLine(McpU8 *line, const char* delimiters);
 McpU32 MCP_LINUX_LINE_PARSER_GetNumOfArgs(void);
 McpBool MCP_LINUX_LINE_PARSER_AreThereMoreArgs(void);
@@ -57,6 +57,13 @@ typedef struct
     handle_t hCaller;
 } MCPTimer_t;
 
+/* Signaling object */
+typedef struct
+{
+    sem_t           tSem;
+    volatile int    iPending;   /* set while a posted wakeup is not consumed by the waiter */
+} TPlaSigObj;
+
 
 /************************************************************************/
 /*                          Global Variables                            */
@@ -423,7 +430,8 @@ McpU32      os_get_current_time_inMilliSec (handle_t hPla)
  *
  * This function creates a signaling object.
  *
- * \note
+ * \note   The signaling object coalesces wakeups: setting it while a wakeup is
+ *         already pending does not post the semaphore again.
  * \param   hPla - PLA handler.
  * \return  Handler to object
  * \sa      os_sigobj_create
@@ -431,20 +439,22 @@ McpU32      os_get_current_time_inMilliSec (handle_t hPla)
 void * os_sigobj_create (handle_t hPla)
 {
     int result;
-    sem_t *sem;
+    TPlaSigObj *pSigObj;
 
     MCPF_UNUSED_PARAMETER(hPla);
-    sem = (sem_t *)malloc(sizeof(sem_t));
+    pSigObj = (TPlaSigObj *)malloc(sizeof(TPlaSigObj));
 
-    if(sem != NULL)
+    if(pSigObj != NULL)
     {
-        result  = sem_init(sem, 0, 0);
+        pSigObj->iPending = 0;
+        result  = sem_init(&pSigObj->tSem, 0, 0);
         if(result != 0)
         {
             perror(" !!!! signal creation FAILED...");
+            free(pSigObj);
             return NULL;
         }
-        return (void *)sem;
+        return (void *)pSigObj;
     }
 
     return NULL;
@@ -457,7 +467,8 @@ void * os_sigobj_create (handle_t hPla)
  *
  * This function waits on the signaling object.
  *
- * \note
+ * \note   The pending wakeup is consumed before return, a set done afterwards
+ *         wakes the waiter again.
  * \param   hPla - PLA handler.
  * \param   *evt - signaling object handler.
  * \return  Result of operation: OK or ERROR
@@ -465,17 +476,22 @@ void * os_sigobj_create (handle_t hPla)
  */
 EMcpfRes    os_sigobj_wait (handle_t hPla, void *evt)
 {
-    sem_t* sem;
+    TPlaSigObj *pSigObj;
     int result;
 
     MCPF_UNUSED_PARAMETER(hPla);
-    sem = (sem_t*)(evt);
+    pSigObj = (TPlaSigObj *)(evt);
 
-    result = sem_wait(sem);
+    result = sem_wait(&pSigObj->tSem);
     if (result != 0)
     {
         return RES_ERROR;
     }
+
+    /* Consume the wakeup, the caller processes all the work signaled so far */
+    __sync_lock_release(&pSigObj->iPending);
+    __sync_synchronize();
+
     return RES_COMPLETE;
 }
 
@@ -486,7 +502,7 @@ EMcpfRes    os_sigobj_wait (handle_t hPla, void *evt)
  *
  * This function sets the signaling object.
  *
- * \note
+ * \note   The semaphore is posted only if no wakeup is pending already.
  * \param   hPla - PLA handler.
  * \param   *evt - signaling object handler.
  * \return  Result of operation: OK or ERROR
@@ -494,15 +510,21 @@ EMcpfRes    os_sigobj_wait (handle_t hPla, void *evt)
  */
 EMcpfRes    os_sigobj_set (handle_t hPla, void *evt)
 {
-    sem_t* sem;
+    TPlaSigObj *pSigObj;
     int result;
 
     MCPF_UNUSED_PARAMETER(hPla);
 
-    sem = (sem_t*)(evt);
+    pSigObj = (TPlaSigObj *)(evt);
+
+    /* Coalesce with the wakeup already pending */
+    if (__sync_lock_test_and_set(&pSigObj->iPending, 1))
+    {
+        return RES_COMPLETE;
+    }
 
     /* Try to release the semphore */
-    result = sem_post(sem);
+    result = sem_post(&pSigObj->tSem);
     if (result != 0)
     {
         return RES_ERROR;
@@ -525,13 +547,14 @@ EMcpfRes    os_sigobj_set (handle_t hPla, void *evt)
  */
 EMcpfRes    os_sigobj_destroy (handle_t hPla, void *evt)
 {
-    sem_t* sem;
+    TPlaSigObj *pSigObj;
     int result;
 
     MCPF_UNUSED_PARAMETER(hPla);
 
-    sem = (sem_t*)(evt);
-    result = sem_destroy(sem);
+    pSigObj = (TPlaSigObj *)(evt);
+    result = sem_destroy(&pSigObj->tSem);
+    free(pSigObj);
     if (result != 0)
         return RES_ERROR;
 
@@ -83,6 +83,9 @@ struct _Cal_Config_ID
 
     /*Operation Data Struct*/
     Cal_Resource_Config resourcedata;
+
+    /* per operation transactions, used by CAL_ConfigOperation */
+    Cal_Operation_Txn   tOperationTxn[ CAL_OPERATION_MAX_NUM ];
 	
 	McpConfigParser 			*pConfigParser;		  /* configuration file storage and parser */
 } ;
@@ -171,6 +174,20 @@ MCP_STATIC const char *IFStatusToString(CcmaStatus status);
 MCP_STATIC void Cal_Prep_PCMIF_Config(McpHciSeqCmdToken *pToken, void *pUserData);
 MCP_STATIC McpU8 Set_params_PCMIF(Cal_Resource_Data  *presourcedata,McpU8 *pBuffer);
 MCP_STATIC void CAL_Init_id_data(Cal_Config_ID *pConfigid, handle_t ccmaObj);
+MCP_STATIC McpBool CAL_IsFmCoreResource(ECAL_Resource eResource);
+MCP_STATIC ECAL_RetValue CAL_PrepareResourceConfig(Cal_Config_ID *pConfigid,
+                                                   ECAL_Operation eOperation,
+                                                   ECAL_Resource eResource,
+                                                   TCAL_DigitalConfig *ptConfig,
+                                                   TCAL_ResourceProperties *ptProperties,
+                                                   TCAL_CB fCB,
+                                                   void *pUserData,
+                                                   McpU32 *puCommandCount,
+                                                   McpBool *pbCallCbOnlyAfterLastCmd);
+MCP_STATIC void Cal_Txn_Prep_Cmd(McpHciSeqCmdToken *pToken, void *pUserData);
+MCP_STATIC void Cal_Txn_CB_Complete(CcmaClientEvent *pEvent);
+MCP_STATIC void Cal_Txn_Rollback(Cal_Operation_Txn *pTxn);
+MCP_STATIC void Cal_Txn_Rollback_CB(void *pUserData, ECAL_RetValue eRetValue);
 
 /********************************************************************************
  *
@@ -206,6 +223,8 @@ void CAL_Create(McpHalChipId chipId,
 void CAL_Destroy(Cal_Config_ID **ppConfigid)
 {       
     ECAL_Resource resourceIndex;
+    ECAL_Operation operationIndex;
+    ECAL_TxnSequence sequenceIndex;
 
     MCP_FUNC_START ("CAL_Destroy");
 
@@ -216,6 +235,16 @@ void CAL_Destroy(Cal_Config_ID **ppConfigid)
         if(((*ppConfigid)->resourcedata.tResourceConfig[resourceIndex].hciseq.handle) != NULL)
         MCP_HciSeq_DestroySequence (&((*ppConfigid)->resourcedata.tResourceConfig[resourceIndex].hciseq));
     }
+
+    /* destroy operations transaction sequences */
+    for (operationIndex = 0; operationIndex < CAL_OPERATION_MAX_NUM; operationIndex++)
+    {
+        for (sequenceIndex = 0; sequenceIndex < CAL_TXN_SEQ_MAX_NUM; sequenceIndex++)
+        {
+            if(((*ppConfigid)->tOperationTxn[operationIndex].hciseq[sequenceIndex].handle) != NULL)
+            MCP_HciSeq_DestroySequence (&((*ppConfigid)->tOperationTxn[operationIndex].hciseq[sequenceIndex]));
+        }
+    }
     /* Nullify the CAL object */
     *ppConfigid = NULL;
 
@@ -233,6 +262,7 @@ void CAL_Destroy(Cal_Config_ID **ppConfigid)
 MCP_STATIC void CAL_Init_id_data (Cal_Config_ID *pConfigid, handle_t ccmaObj)
 {       
     ECAL_Resource resourceindex;
+    ECAL_Operation operationindex;
 
     /*Init  resourcedata struct */
     for (resourceindex=0;resourceindex<CAL_RESOURCE_MAX_NUM;resourceindex++)
@@ -243,10 +273,7 @@ MCP_STATIC void CAL_Init_id_data (Cal_Config_ID *pConfigid, handle_t ccmaObj)
         pConfigid->resourcedata.tResourceConfig[resourceindex].pUserData=NULL;
 
         /*Register every HCI seq per resource as client */
-        if ((resourceindex == CAL_RESOURCE_FMIF)||
-            (resourceindex == CAL_RESOURCE_FM_ANALOG)||
-            (resourceindex == CAL_RESOURCE_CORTEX)||
-            (resourceindex == CAL_RESOURCE_FM_CORE))
+        if (MCP_TRUE == CAL_IsFmCoreResource(resourceindex))
         {
             MCP_HciSeq_CreateSequence(&(pConfigid->resourcedata.tResourceConfig[ resourceindex ].hciseq), 
                                       ccmaObj,
@@ -259,6 +286,43 @@ MCP_STATIC void CAL_Init_id_data (Cal_Config_ID *pConfigid, handle_t ccmaObj)
                                       MCP_HAL_CORE_ID_BT);           
         }
     }
+
+    /* Init operations transactions, each with a sequence per transport */
+    for (operationindex=0;operationindex<CAL_OPERATION_MAX_NUM;operationindex++)
+    {
+        pConfigid->tOperationTxn[operationindex].pConfigid=pConfigid;
+        pConfigid->tOperationTxn[operationindex].CB=NULL;
+        pConfigid->tOperationTxn[operationindex].pUserData=NULL;
+        pConfigid->tOperationTxn[operationindex].eOperation=operationindex;
+        pConfigid->tOperationTxn[operationindex].uPendingCommands=0;
+
+        MCP_HciSeq_CreateSequence(&(pConfigid->tOperationTxn[ operationindex ].hciseq[ CAL_TXN_SEQ_BT ]), 
+                                  ccmaObj,
+                                  MCP_HAL_CORE_ID_BT);           
+        MCP_HciSeq_CreateSequence(&(pConfigid->tOperationTxn[ operationindex ].hciseq[ CAL_TXN_SEQ_FM ]), 
+                                  ccmaObj,
+                                  MCP_HAL_CORE_ID_FM);           
+    }
+}
+
+/*---------------------------------------------------------------------------
+ *            CAL_IsFmCoreResource()
+ *---------------------------------------------------------------------------
+ *
+ * Synopsis:  Checks whether a resource is configured over the FM transport
+ *
+ */
+MCP_STATIC McpBool CAL_IsFmCoreResource(ECAL_Resource eResource)
+{
+    if ((eResource == CAL_RESOURCE_FMIF)||
+        (eResource == CAL_RESOURCE_FM_ANALOG)||
+        (eResource == CAL_RESOURCE_CORTEX)||
+        (eResource == CAL_RESOURCE_FM_CORE))
+    {
+        return MCP_TRUE;
+    }
+
+    return MCP_FALSE;
 }
 
 
@@ -458,13 +522,59 @@ ECAL_RetValue CAL_ConfigResource(Cal_Config_ID *pConfigid,
                                  TCAL_CB fCB,
                                  void *pUserData)
 {
-    ECAL_RetValue status=CAL_STATUS_PENDING;
+    ECAL_RetValue status;
     CcmaStatus HciSeqstatus = CCMA_STATUS_FAILED;   
     McpU32 uCommandcount = 0;
     McpBool callCbOnlyAfterLastCmd = MCP_FALSE;
 
     MCP_FUNC_START("CAL_ConfigResource");
 
+    status = CAL_PrepareResourceConfig (pConfigid, eOperation, eResource, ptConfig, ptProperties,
+                                        fCB, pUserData, &uCommandcount, &callCbOnlyAfterLastCmd);
+
+    /*Verify that we got a command to send*/
+    if (uCommandcount>0)
+    {
+        HciSeqstatus = MCP_HciSeq_RunSequence (&(pConfigid->resourcedata.tResourceConfig[eResource].hciseq),uCommandcount, 
+                                               &(pConfigid->resourcedata.tResourceConfig[eResource].hciseqCmd[0]),callCbOnlyAfterLastCmd);
+        if (CCMA_STATUS_PENDING != HciSeqstatus)
+        {
+            MCP_LOG_ERROR (("MCP_HciSeq_RunSequence failed with status %s", IFStatusToString(HciSeqstatus)));;
+            status = CAL_STATUS_FAILURE;
+        }
+    }
+
+    MCP_FUNC_END();
+
+    return status;
+
+}
+
+/*---------------------------------------------------------------------------
+ *            CAL_PrepareResourceConfig()
+ *---------------------------------------------------------------------------
+ *
+ * Synopsis:  Fills the resource command sequence according to the operation,
+ *            without sending it. Returns CAL_STATUS_PENDING when commands were
+ *            prepared, CAL_STATUS_SUCCESS when no configuration is needed.
+ *
+ */
+MCP_STATIC ECAL_RetValue CAL_PrepareResourceConfig(Cal_Config_ID *pConfigid,
+                                                   ECAL_Operation eOperation,
+                                                   ECAL_Resource eResource,
+                                                   TCAL_DigitalConfig *ptConfig,
+                                                   TCAL_ResourceProperties *ptProperties,
+                                                   TCAL_CB fCB,
+                                                   void *pUserData,
+                                                   McpU32 *puCommandCount,
+                                                   McpBool *pbCallCbOnlyAfterLastCmd)
+{
+    ECAL_RetValue status=CAL_STATUS_PENDING;
+    McpU32 uCommandcount = 0;
+    McpBool callCbOnlyAfterLastCmd = MCP_FALSE;
+
+    MCP_FUNC_START("CAL_PrepareResourceConfig");
+
     /*Update the Resource data struct per resource*/
     pConfigid->resourcedata.tResourceConfig[eResource].CB=fCB;
     pConfigid->resourcedata.tResourceConfig[eResource].pUserData=(void*)pUserData;
@@ -755,22 +865,269 @@ ECAL_RetValue CAL_ConfigResource(Cal_Config_ID *pConfigid,
     MCP_LOG_INFO(("CAL_ConfigResource -Resource %s  with Operation %s,Number of Commands %d"
                   ,ResourceToString(eResource),OperationToString(eOperation),uCommandcount)); 
 
-    /*Verify that we got a command to send*/
-    if (uCommandcount>0)
+    *puCommandCount = uCommandcount;
+    *pbCallCbOnlyAfterLastCmd = callCbOnlyAfterLastCmd;
+
+    MCP_FUNC_END();
+
+    return status;
+
+}
+
+/*FM-VAC*/
+
+ECAL_RetValue CAL_ConfigOperation(Cal_Config_ID *pConfigid,
+                                  ECAL_Operation eOperation,
+                                  TCAL_ResourceList *ptResources,
+                                  TCAL_DigitalConfig *ptConfig,
+                                  TCAL_ResourceProperties *ptProperties[],
+                                  TCAL_CB fCB,
+                                  void *pUserData)
+{
+    Cal_Operation_Txn   *pTxn = &(pConfigid->tOperationTxn[ eOperation ]);
+    Cal_Resource_Data   *pResourceData;
+    Cal_Txn_Cmd         *pCmd;
+    ECAL_RetValue       status;
+    CcmaStatus          HciSeqstatus;
+    ECAL_Resource       eResource;
+    ECAL_TxnSequence    eSequence;
+    McpU32              uResIndex, uCmdIndex, uCommandcount;
+    McpBool             callCbOnlyAfterLastCmd;
+
+    MCP_FUNC_START("CAL_ConfigOperation");
+
+    status = CAL_STATUS_PENDING;
+
+    /* initialize the transaction */
+    pTxn->CB = fCB;
+    pTxn->pUserData = pUserData;
+    pTxn->uPendingCommands = 0;
+    pTxn->uSentResourcesMask = 0;
+    MCP_HAL_MEMORY_MemCopy (&(pTxn->tResources), ptResources, sizeof (TCAL_ResourceList));
+    for (eSequence = 0; eSequence < CAL_TXN_SEQ_MAX_NUM; eSequence++)
     {
-        HciSeqstatus = MCP_HciSeq_RunSequence (&(pConfigid->resourcedata.tResourceConfig[eResource].hciseq),uCommandcount, 
-                                               &(pConfigid->resourcedata.tResourceConfig[eResource].hciseqCmd[0]),callCbOnlyAfterLastCmd);
-        if (CCMA_STATUS_PENDING != HciSeqstatus)
+        pTxn->uCommandCount[ eSequence ] = 0;
+    }
+
+    /* 
+     * plan the transaction - collect the commands of all resources, in resource order, into
+     * a single sequence per transport. Nothing is sent before all resources are planned.
+     */
+    for (uResIndex = 0; uResIndex < ptResources->uNumOfResources; uResIndex++)
+    {
+        eResource = ptResources->eResources[ uResIndex ];
+        uCommandcount = 0;
+
+        if (CAL_STATUS_FAILURE == CAL_PrepareResourceConfig (pConfigid, eOperation, eResource, ptConfig, 
+                                                             ptProperties[ uResIndex ], fCB, pUserData,
+                                                             &uCommandcount, &callCbOnlyAfterLastCmd))
         {
-            MCP_LOG_ERROR (("MCP_HciSeq_RunSequence failed with status %s", IFStatusToString(HciSeqstatus)));;
+            MCP_LOG_ERROR (("CAL_ConfigOperation: planning resource %s for operation %s failed",
+                            ResourceToString(eResource), OperationToString(eOperation)));
+            status = CAL_STATUS_FAILURE;
+            break;
+        }
+
+        eSequence = ((MCP_TRUE == CAL_IsFmCoreResource(eResource)) ? CAL_TXN_SEQ_FM : CAL_TXN_SEQ_BT);
+        if (HCI_SEQ_MAX_CMDS_PER_SEQUENCE < (pTxn->uCommandCount[ eSequence ] + uCommandcount))
+        {
+            MCP_LOG_ERROR (("CAL_ConfigOperation: operation %s requires more than %d commands per transport",
+                            OperationToString(eOperation), HCI_SEQ_MAX_CMDS_PER_SEQUENCE));
             status = CAL_STATUS_FAILURE;
+            break;
+        }
+
+        pResourceData = &(pConfigid->resourcedata.tResourceConfig[ eResource ]);
+        for (uCmdIndex = 0; uCmdIndex < uCommandcount; uCmdIndex++)
+        {
+            pCmd = &(pTxn->tCmds[ eSequence ][ pTxn->uCommandCount[ eSequence ] ]);
+            pCmd->fPrepCB = pResourceData->hciseqCmd[ uCmdIndex ].fCommandPrepCB;
+            pCmd->pPrepUserData = pResourceData->hciseqCmd[ uCmdIndex ].pUserData;
+            pCmd->pTxn = pTxn;
+            pCmd->eResource = eResource;
+            pCmd->bIgnoreStatus = MCP_FALSE;
+
+            pTxn->hciseqCmd[ eSequence ][ pTxn->uCommandCount[ eSequence ] ].fCommandPrepCB = Cal_Txn_Prep_Cmd;
+            pTxn->hciseqCmd[ eSequence ][ pTxn->uCommandCount[ eSequence ] ].pUserData = (void *)pCmd;
+
+            /* 
+             * the commands of a resource depend on each other (e.g. AVPR enable before BT over FM,
+             * FMIF I2S configuration before the PCM / I2S mode) - only the first may overlap others
+             */
+            pTxn->hciseqCmd[ eSequence ][ pTxn->uCommandCount[ eSequence ] ].bWaitForPrevious = 
+                ((0 < uCmdIndex) ? MCP_TRUE : MCP_FALSE);
+            pTxn->uCommandCount[ eSequence ]++;
+        }
+    }
+
+    if (CAL_STATUS_PENDING == status)
+    {
+        /* completions may arrive in any order across transports and within the in-flight window */
+        pTxn->uPendingCommands = pTxn->uCommandCount[ CAL_TXN_SEQ_BT ] + pTxn->uCommandCount[ CAL_TXN_SEQ_FM ];
+
+        MCP_LOG_INFO(("CAL_ConfigOperation: operation %s, %d BT commands, %d FM commands",
+                      OperationToString(eOperation), pTxn->uCommandCount[ CAL_TXN_SEQ_BT ],
+                      pTxn->uCommandCount[ CAL_TXN_SEQ_FM ]));
+
+        /* all resources were configured synchronously */
+        if (0 == pTxn->uPendingCommands)
+        {
+            status = CAL_STATUS_SUCCESS;
+        }
+    }
+
+    /* 
+     * start all sequences - the commands of different resources are independent, so each
+     * transport keeps several of them outstanding at once
+     */
+    for (eSequence = 0; (CAL_STATUS_PENDING == status) && (eSequence < CAL_TXN_SEQ_MAX_NUM); eSequence++)
+    {
+        if (0 < pTxn->uCommandCount[ eSequence ])
+        {
+            HciSeqstatus = MCP_HciSeq_RunPipelinedSequence (&(pTxn->hciseq[ eSequence ]), 
+                                                            pTxn->uCommandCount[ eSequence ],
+                                                            &(pTxn->hciseqCmd[ eSequence ][ 0 ]), MCP_FALSE,
+                                                            HCI_SEQ_MAX_CMDS_IN_FLIGHT);
+            if (CCMA_STATUS_PENDING != HciSeqstatus)
+            {
+                MCP_LOG_ERROR (("MCP_HciSeq_RunPipelinedSequence failed with status %s", IFStatusToString(HciSeqstatus)));
+
+                /* undo whatever was already sent */
+                Cal_Txn_Rollback (pTxn);
+                status = CAL_STATUS_FAILURE;
+            }
         }
     }
 
     MCP_FUNC_END();
 
     return status;
+}
+
+/*---------------------------------------------------------------------------
+ *            Cal_Txn_Prep_Cmd()
+ *---------------------------------------------------------------------------
+ *
+ * Synopsis:  Prepares a transaction command using the resource prepare function,
+ *            and redirects its completion to the transaction
+ *
+ */
+MCP_STATIC void Cal_Txn_Prep_Cmd(McpHciSeqCmdToken *pToken, void *pUserData)
+{
+    Cal_Txn_Cmd     *pCmd = (Cal_Txn_Cmd*)pUserData;
+
+    pCmd->fPrepCB (pToken, pCmd->pPrepUserData);
+
+    /* as in CAL_ConfigResource, a failure of a command the resource does not wait for is not fatal */
+    pCmd->bIgnoreStatus = ((CAL_Config_Complete_Null_CB == pToken->callback) ? MCP_TRUE : MCP_FALSE);
+
+    /* the command is about to be sent - the resource needs to be undone on failure */
+    pCmd->pTxn->uSentResourcesMask |= (1 << pCmd->eResource);
+
+    pToken->callback = Cal_Txn_CB_Complete;
+    pToken->pUserData = (void*)pCmd;
+}
+
+/*---------------------------------------------------------------------------
+ *            Cal_Txn_CB_Complete()
+ *---------------------------------------------------------------------------
+ *
+ * Synopsis:  command complete callback for all transaction commands. Calls the
+ *            client callback once - when all transports completed, or on the 
+ *            first failure.
+ *
+ */
+MCP_STATIC void Cal_Txn_CB_Complete(CcmaClientEvent *pEvent)
+{
+    Cal_Txn_Cmd         *pCmd = (Cal_Txn_Cmd*)(pEvent->pUserData);
+    Cal_Operation_Txn   *pTxn = pCmd->pTxn;
+
+    MCP_FUNC_START("Cal_Txn_CB_Complete");
+
+    if ((pEvent->status != CCMA_STATUS_SUCCESS) && (MCP_FALSE == pCmd->bIgnoreStatus))
+    {
+        MCP_LOG_ERROR (("Cal_Txn_CB_Complete: resource %s command failed with status %d, rolling back operation %s",
+                        ResourceToString(pCmd->eResource), pEvent->status, OperationToString(pTxn->eOperation)));
+
+        Cal_Txn_Rollback (pTxn);
+        pTxn->CB (pTxn->pUserData, CAL_STATUS_FAILURE);
+    }
+    else
+    {
+        if (pEvent->status != CCMA_STATUS_SUCCESS)
+        {
+            MCP_LOG_INFO (("Cal_Txn_CB_Complete: resource %s command ignored status %d",
+                           ResourceToString(pCmd->eResource), pEvent->status));
+        }
+
+        pTxn->uPendingCommands--;
+
+        /* commit - all commands on all transports completed */
+        if (0 == pTxn->uPendingCommands)
+        {
+            pTxn->CB (pTxn->pUserData, CAL_STATUS_SUCCESS);
+        }
+    }
+
+    MCP_FUNC_END();
+}
+
+/*---------------------------------------------------------------------------
+ *            Cal_Txn_Rollback()
+ *---------------------------------------------------------------------------
+ *
+ * Synopsis:  Cancels all transaction sequences and undoes the configuration of
+ *            resources that already received commands, in reverse order
+ *
+ */
+MCP_STATIC void Cal_Txn_Rollback(Cal_Operation_Txn *pTxn)
+{
+    TCAL_ResourceProperties tProperties;
+    ECAL_TxnSequence        eSequence;
+    ECAL_Resource           eResource;
+    McpU32                  uResIndex;
+
+    MCP_FUNC_START("Cal_Txn_Rollback");
+
+    for (eSequence = 0; eSequence < CAL_TXN_SEQ_MAX_NUM; eSequence++)
+    {
+        MCP_HciSeq_CancelSequence (&(pTxn->hciseq[ eSequence ]));
+    }
+    pTxn->uPendingCommands = 0;
+
+    for (uResIndex = pTxn->tResources.uNumOfResources; uResIndex > 0; uResIndex--)
+    {
+        eResource = pTxn->tResources.eResources[ uResIndex - 1 ];
+
+        if (0 != (pTxn->uSentResourcesMask & (1 << eResource)))
+        {
+            MCP_HAL_MEMORY_MemCopy (&tProperties, 
+                                    &(pTxn->pConfigid->resourcedata.tResourceConfig[ eResource ].tProperties),
+                                    sizeof (TCAL_ResourceProperties));
+
+            CAL_StopResourceConfiguration (pTxn->pConfigid, pTxn->eOperation, eResource, &tProperties,
+                                           Cal_Txn_Rollback_CB, (void*)pTxn);
+        }
+    }
+    pTxn->uSentResourcesMask = 0;
+
+    MCP_FUNC_END();
+}
+
+/*---------------------------------------------------------------------------
+ *            Cal_Txn_Rollback_CB()
+ *---------------------------------------------------------------------------
+ *
+ * Synopsis:  completion of a rollback command. The transaction failure was
+ *            already reported, so only log the result.
+ *
+ */
+MCP_STATIC void Cal_Txn_Rollback_CB(void *pUserData, ECAL_RetValue eRetValue)
+{
+    Cal_Operation_Txn   *pTxn = (Cal_Operation_Txn*)pUserData;
 
+    MCP_LOG_INFO (("Cal_Txn_Rollback_CB: operation %s rollback command completed with status %d",
+                   OperationToString(pTxn->eOperation), eRetValue));
 }
 
 
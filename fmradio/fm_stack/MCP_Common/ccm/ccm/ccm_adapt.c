@@ -595,10 +595,10 @@ static void clientCmdComplete(handle_t hHandle, THciaCmdComplEvent *pEvent)
 {
     TClientNode *pClient = (TClientNode *)hHandle;
     CcmaClientEvent tBtEvent;
-
 #ifdef MCP_STK_ENABLE
+    McpU8 failedCmdParms[4];
+
     MCPF_UNUSED_PARAMETER(len);
-    MCPF_UNUSED_PARAMETER(status);
 #endif
 
     MCP_FUNC_START("CCMA: clientCmdComplete");
@@ -607,10 +607,29 @@ static void clientCmdComplete(handle_t hHandle, THciaCmdComplEvent *pEvent)
     tBtEvent.pUserData = pClient->hClientUserData;
     
 #ifdef MCP_STK_ENABLE
-    tBtEvent.status = CCMA_STATUS_SUCCESS;
-    tBtEvent.data.hciEventData.eventType = pkt[CCMA_HCI_EVENT_PACKET_OFFSET_TO_TYPE];
-    tBtEvent.data.hciEventData.parmLen = pkt[CCMA_HCI_EVENT_PACKET_OFFSET_TO_PARAMS_LEN];
-    tBtEvent.data.hciEventData.parms = &pkt[CCMA_HCI_EVENT_PACKET_OFFSET_TO_PARAMS];
+    if (HAL_HCI_STATUS_SUCCESS == status)
+    {
+        tBtEvent.status = CCMA_STATUS_SUCCESS;
+        tBtEvent.data.hciEventData.eventType = pkt[CCMA_HCI_EVENT_PACKET_OFFSET_TO_TYPE];
+        tBtEvent.data.hciEventData.parmLen = pkt[CCMA_HCI_EVENT_PACKET_OFFSET_TO_PARAMS_LEN];
+        tBtEvent.data.hciEventData.parms = &pkt[CCMA_HCI_EVENT_PACKET_OFFSET_TO_PARAMS];
+    }
+    else
+    {
+        /* 
+         * the command was not written - pkt holds its packet type and opcode. Report it as a 
+         * failed command status, so it is matched to the command by its opcode
+         */
+        failedCmdParms[0] = 0x1F;       /* status - unspecified error */
+        failedCmdParms[1] = 0;          /* num HCI command packets */
+        failedCmdParms[2] = pkt[1];
+        failedCmdParms[3] = pkt[2];
+
+        tBtEvent.status = CCMA_STATUS_FAILED;
+        tBtEvent.data.hciEventData.eventType = CCMA_HCI_EVENT_COMMAND_STATUS;
+        tBtEvent.data.hciEventData.parmLen = sizeof(failedCmdParms);
+        tBtEvent.data.hciEventData.parms = failedCmdParms;
+    }
 #else
     tBtEvent.status = ccmStatus(pEvent->eResult);
     tBtEvent.data.hciEventData.eventType = pEvent->uEvtOpcode;
@@ -42,11 +42,15 @@
 
 MCP_HAL_LOG_SET_MODULE(MCP_HAL_LOG_MODULE_TYPE_CCM_VAC);
 
+/* operation bit within an operation mask */
+#define CCM_VAC_AE_OP_MASK(_eOperation)     ((McpU32)1 << (_eOperation))
+
 typedef struct _TCCM_VAC_AEResource
 {
     McpBool                         bAvailable;             /* whether the resource is available in the system */
     McpU32                          uNumberOfOwners;        /* number of current resource owners */
     ECAL_Operation                  eCurrentOwners[ 2 ];    /* current resource owner(s) (if any) */
+    McpU32                          uOwnersMask;            /* current resource owner(s), as operation mask */
     TCAL_ResourceProperties         tProperties;            /* resource properties */
 } TCCM_VAC_AEResource;
 
@@ -54,13 +58,15 @@ struct _TCCM_VAC_AllocationEngine
 {
     TCCM_VAC_AEResource             tResources[ CAL_RESOURCE_MAX_NUM ]; /* all system resources */
     TCAL_OpPairConfig               tConfig;                            /* allowed pairs config */
+    McpU32                          uAllowedPairsMask[ CAL_RESOURCE_MAX_NUM ][ CAL_OPERATION_MAX_NUM ];
+                                                                        /* per resource and operation - mask of 
+                                                                           operations allowed to share the resource
+                                                                           with it (compiled from tConfig) */
     McpConfigParser                 *pConfigParser;                     /* configuration parser object (holding VAC ini file) */
 };
 
 /* internal prototypes */
-McpBool _CCM_VAC_AEIsPairAllowed (TCCM_VAC_AllocationEngine *ptAllocEngine, 
-                                  ECAL_Resource eResource,
-                                  TCAL_OperationPair *ptPair);
+void _CCM_VAC_AEBuildAllowedPairsMask (TCCM_VAC_AllocationEngine *ptAllocEngine);
 
 /* the actual allocation engine objects */
 TCCM_VAC_AllocationEngine    tAEObjects[ MCP_HAL_MAX_NUM_OF_CHIPS ];
@@ -70,7 +76,7 @@ ECCM_VAC_Status _CCM_VAC_AllocationEngine_Create (McpHalChipId chipId,
                                                   McpConfigParser *pConfigParser,
                                                   TCCM_VAC_AllocationEngine **ptAllocEngine)
 {
-    McpU32      uIndex;
+    McpU32      uIndex, uOpIndex;
 
     MCP_FUNC_START ("_CCM_VAC_AllocationEngine_Create");
 
@@ -83,8 +89,14 @@ ECCM_VAC_Status _CCM_VAC_AllocationEngine_Create (McpHalChipId chipId,
     for (uIndex = 0; uIndex < CAL_RESOURCE_MAX_NUM; uIndex++)
     {
         (*ptAllocEngine)->tResources[ uIndex ].uNumberOfOwners = 0;
+        (*ptAllocEngine)->tResources[ uIndex ].uOwnersMask = 0;
         (*ptAllocEngine)->tResources[ uIndex ].bAvailable = MCP_FALSE;
         (*ptAllocEngine)->tResources[ uIndex ].tProperties.uPropertiesNumber = 0;
+
+        for (uOpIndex = 0; uOpIndex < CAL_OPERATION_MAX_NUM; uOpIndex++)
+        {
+            (*ptAllocEngine)->uAllowedPairsMask[ uIndex ][ uOpIndex ] = 0;
+        }
     }
 
     MCP_FUNC_END ();
@@ -156,6 +168,9 @@ ECCM_VAC_Status _CCM_VAC_AllocationEngine_Configure (TCCM_VAC_AllocationEngine *
         ptAllocEngine->tResources[ uIndex ].bAvailable = ptAvailResources->bResourceSupport[ uIndex ];
     }
 
+    /* 3. compile the allowed operation pairs (set by CAL in advance) into per-resource masks */
+    _CCM_VAC_AEBuildAllowedPairsMask (ptAllocEngine);
+
     MCP_FUNC_END ();
 
     return CCM_VAC_STATUS_SUCCESS;
@@ -175,13 +190,15 @@ McpBool _CCM_VAC_AllocationEngine_TryAllocate (TCCM_VAC_AllocationEngine *ptAllo
                                                ECAL_Resource eResource, 
                                                ECAL_Operation *peOperation)
 {
-    McpBool     status = MCP_FALSE;
+    TCCM_VAC_AEResource     *ptResource;
+    McpU32                  uOperationMask;
+    McpBool                 status = MCP_FALSE;
 
     MCP_FUNC_START ("_CCM_VAC_AllocationEngine_TryAllocate");
 
-    MCP_LOG_INFO (("_CCM_VAC_AllocationEngine_TryAllocate: operation %s requesting resource %s",
-                   _CCM_VAC_DebugOperationStr(*peOperation),
-                   _CCM_VAC_DebugResourceStr (eResource)));
+    CCM_VAC_LOG_INFO (("_CCM_VAC_AllocationEngine_TryAllocate: operation %s requesting resource %s",
+                       _CCM_VAC_DebugOperationStr(*peOperation),
+                       _CCM_VAC_DebugResourceStr (eResource)));
 
     /* verify object pointer and resource availability */
     MCP_VERIFY_FATAL ((NULL != ptAllocEngine), MCP_FALSE, 
@@ -192,84 +209,43 @@ McpBool _CCM_VAC_AllocationEngine_TryAllocate (TCCM_VAC_AllocationEngine *ptAllo
                      "which is unavailable, for operation %s", _CCM_VAC_DebugResourceStr (eResource),
                      _CCM_VAC_DebugOperationStr (*peOperation)));
 
-    /* if the resource is currently not allocated at all */
-    if (0 == ptAllocEngine->tResources[ eResource ].uNumberOfOwners)
-    {
-        MCP_LOG_INFO (("_CCM_VAC_AllocationEngine_TryAllocate: no current owner, resource is allocated"));
+    ptResource = &(ptAllocEngine->tResources[ eResource ]);
+    uOperationMask = CCM_VAC_AE_OP_MASK (*peOperation);
 
-        /* allocate the resource to the requesting operation */
-        ptAllocEngine->tResources[ eResource ].eCurrentOwners[ 0 ] = *peOperation;
-        ptAllocEngine->tResources[ eResource ].uNumberOfOwners++;
+    /* first check if this is a re-allocation (e.g. for resource change) */
+    if (0 != (ptResource->uOwnersMask & uOperationMask))
+    {
+        CCM_VAC_LOG_INFO (("_CCM_VAC_AllocationEngine_TryAllocate: operation %s already owning the "
+                           "resource, allocation succeeds", _CCM_VAC_DebugOperationStr(*peOperation)));
         status = MCP_TRUE;
     }
-    /* one operation is already holding the resource */
-    else if (1 == ptAllocEngine->tResources[ eResource ].uNumberOfOwners)
+    /* 
+     * the resource is currently not allocated at all, or is held by a single operation which 
+     * may share it with the requesting operation
+     */
+    else if ((0 == ptResource->uNumberOfOwners) ||
+             ((1 == ptResource->uNumberOfOwners) &&
+              (0 != (ptAllocEngine->uAllowedPairsMask[ eResource ][ *peOperation ] & ptResource->uOwnersMask))))
     {
-        TCAL_OperationPair      tNewPair;
+        CCM_VAC_LOG_INFO (("_CCM_VAC_AllocationEngine_TryAllocate: resource %s is allocated to operation %s "
+                           "(number of owners: %d)", _CCM_VAC_DebugResourceStr (eResource),
+                           _CCM_VAC_DebugOperationStr(*peOperation), ptResource->uNumberOfOwners + 1));
 
-        /* first check if this is a re-allocation (e.g. for resource change) */
-        if (*peOperation == ptAllocEngine->tResources[ eResource ].eCurrentOwners[ 0 ])
-        {
-            MCP_LOG_INFO (("_CCM_VAC_AllocationEngine_TryAllocate: operation %s already owning the "
-                           "resource, allocation succeeds", 
-                           _CCM_VAC_DebugOperationStr(ptAllocEngine->tResources[ eResource ].eCurrentOwners[ 0 ])));
-            status = MCP_TRUE;
-        }
-        /* now check if both operations may share the resource */
-        else
-        {
-            /* fill in the new operation pair */
-            tNewPair.eOperations[ 0 ] = ptAllocEngine->tResources[ eResource ].eCurrentOwners[ 0 ];
-            tNewPair.eOperations[ 1 ] = *peOperation;
-    
-            /* if the new pair is allowed */
-            if (MCP_TRUE == _CCM_VAC_AEIsPairAllowed (ptAllocEngine, eResource, &tNewPair))
-            {
-                MCP_LOG_INFO (("_CCM_VAC_AllocationEngine_TryAllocate: operation %s already owning the "
-                                   "resource, operation pair is allowed, allocation succeeded", 
-                                   _CCM_VAC_DebugOperationStr(ptAllocEngine->tResources[ eResource ].eCurrentOwners[ 0 ])));
-    
-                /* fill in the new operation mutually owning the resource */
-                ptAllocEngine->tResources[ eResource ].eCurrentOwners[ 1 ] = *peOperation;
-                ptAllocEngine->tResources[ eResource ].uNumberOfOwners++;
-                status = MCP_TRUE;
-            }
-            else
-            {
-                MCP_LOG_INFO (("_CCM_VAC_AllocationEngine_TryAllocate: operation %s already owns the "
-                               "resource, allocation failed", 
-                               _CCM_VAC_DebugOperationStr(ptAllocEngine->tResources[ eResource ].eCurrentOwners[ 0 ])));
-
-                /* indicate current owner */
-                *peOperation = ptAllocEngine->tResources[ eResource ].eCurrentOwners[ 0 ];
-                status = MCP_FALSE;
-            }
-        }
+        /* allocate the resource to the requesting operation */
+        ptResource->eCurrentOwners[ ptResource->uNumberOfOwners ] = *peOperation;
+        ptResource->uNumberOfOwners++;
+        ptResource->uOwnersMask |= uOperationMask;
+        status = MCP_TRUE;
     }
-    /* two operations are currently mutually owning the resource */
     else
     {
-        /* first check if this is a re-allocation */
-        if ((*peOperation == ptAllocEngine->tResources[ eResource ].eCurrentOwners[ 0 ]) || 
-            (*peOperation == ptAllocEngine->tResources[ eResource ].eCurrentOwners[ 1 ]))
-        {
-            MCP_LOG_INFO (("_CCM_VAC_AllocationEngine_TryAllocate: operations %s and %s already owning the "
-                           "resource, allocation succeeded", 
-                           _CCM_VAC_DebugOperationStr(ptAllocEngine->tResources[ eResource ].eCurrentOwners[ 0 ]),
-                           _CCM_VAC_DebugOperationStr(ptAllocEngine->tResources[ eResource ].eCurrentOwners[ 1 ])));
-            status = MCP_TRUE;
-        }
-        else
-        {
-            MCP_LOG_INFO (("_CCM_VAC_AllocationEngine_TryAllocate: operations %s and %s already owning the "
+        CCM_VAC_LOG_INFO (("_CCM_VAC_AllocationEngine_TryAllocate: operation %s already owns the "
                            "resource, allocation failed", 
-                           _CCM_VAC_DebugOperationStr(ptAllocEngine->tResources[ eResource ].eCurrentOwners[ 0 ]),
-                           _CCM_VAC_DebugOperationStr(ptAllocEngine->tResources[ eResource ].eCurrentOwners[ 1 ])));
-    
-            /* the current owner is indicated as the first operation */
-            *peOperation = ptAllocEngine->tResources[ eResource ].eCurrentOwners[ 0 ];
-            status = MCP_FALSE;
-        }
+                           _CCM_VAC_DebugOperationStr(ptResource->eCurrentOwners[ 0 ])));
+
+        /* the current owner is indicated as the first operation */
+        *peOperation = ptResource->eCurrentOwners[ 0 ];
+        status = MCP_FALSE;
     }
 
     MCP_FUNC_END ();
@@ -281,11 +257,14 @@ void _CCM_VAC_AllocationEngine_Release (TCCM_VAC_AllocationEngine *ptAllocEngine
                                         ECAL_Resource eResource,
                                         ECAL_Operation eOperation)
 {
+    TCCM_VAC_AEResource     *ptResource;
+    McpU32                  uOperationMask;
+
     MCP_FUNC_START ("_CCM_VAC_AllocationEngine_Release");
 
-    MCP_LOG_INFO (("_CCM_VAC_AllocationEngine_Release: operation %s releasing resource %s",
-                   _CCM_VAC_DebugOperationStr(eOperation),
-                   _CCM_VAC_DebugResourceStr (eResource)));
+    CCM_VAC_LOG_INFO (("_CCM_VAC_AllocationEngine_Release: operation %s releasing resource %s",
+                       _CCM_VAC_DebugOperationStr(eOperation),
+                       _CCM_VAC_DebugResourceStr (eResource)));
 
     /* verify object pointer, resource availability, and resource allocation */
     MCP_VERIFY_FATAL_NO_RETVAR ((NULL != ptAllocEngine),
@@ -298,48 +277,28 @@ void _CCM_VAC_AllocationEngine_Release (TCCM_VAC_AllocationEngine *ptAllocEngine
     MCP_VERIFY_ERR_NO_RETVAR ((0 < ptAllocEngine->tResources[ eResource ].uNumberOfOwners),
                               ("_CCM_VAC_AllocationEngine_Release: resource %s is not allocated!",
                                _CCM_VAC_DebugResourceStr (eResource)));
-    
-    /* if the resource is allocated by only one operation */
-    if (1 == ptAllocEngine->tResources[ eResource ].uNumberOfOwners)
+
+    ptResource = &(ptAllocEngine->tResources[ eResource ]);
+    uOperationMask = CCM_VAC_AE_OP_MASK (eOperation);
+
+    /* verify resource owner is the requesting operation */
+    MCP_VERIFY_ERR_NO_RETVAR ((0 != (ptResource->uOwnersMask & uOperationMask)),
+                              ("_CCM_VAC_AllocationEngine_Release: operation %s requesting to release "
+                               "resource %s, which is allocated to operation %s!",
+                               _CCM_VAC_DebugOperationStr(eOperation),
+                               _CCM_VAC_DebugResourceStr (eResource),
+                               _CCM_VAC_DebugOperationStr(ptResource->eCurrentOwners[ 0 ])));
+
+    /* if the requesting operation is in first place, move the operation in second place (if any) to first place */
+    if (ptResource->eCurrentOwners[ 0 ] == eOperation)
     {
-        /* verify resource owner is the requesting operation */
-        MCP_VERIFY_ERR_NO_RETVAR ((ptAllocEngine->tResources[ eResource ].eCurrentOwners[ 0 ] == eOperation),
-                                  ("_CCM_VAC_AllocationEngine_Release: operation %s requesting to release "
-                                   "resource %s, which is allocated to operation %s!",
-                                   _CCM_VAC_DebugOperationStr(eOperation),
-                                   _CCM_VAC_DebugResourceStr (eResource),
-                                   _CCM_VAC_DebugOperationStr(ptAllocEngine->tResources[ eResource ].eCurrentOwners[ 0 ])));
-
-        /* release the resource */
-        ptAllocEngine->tResources[ eResource ].uNumberOfOwners--;
-    }
-    /* the resource is mutually allocated by two operations */
-    else
-    {
-        /* the requesting operation is in first place */
-        if (ptAllocEngine->tResources[ eResource ].eCurrentOwners[ 0 ] == eOperation)
-        {
-            /* move the operation in second place to first place */
-            ptAllocEngine->tResources[ eResource ].eCurrentOwners[ 0 ] = 
-                ptAllocEngine->tResources[ eResource ].eCurrentOwners[ 1 ];
-            /* reduce number of owners */
-            ptAllocEngine->tResources[ eResource ].uNumberOfOwners--;
-        }
-        /* the requesting operation is in second place */
-        else if (ptAllocEngine->tResources[ eResource ].eCurrentOwners[ 1 ] == eOperation)
-        {
-            /* simply reduce number of owners */
-            ptAllocEngine->tResources[ eResource ].uNumberOfOwners--;
-        }
-        else
-        {
-            MCP_ERR_NO_RETVAR (("_CCM_VAC_AllocationEngine_Release: resource %s ia allocated to "
-                                "operations %s and %s!",
-                                _CCM_VAC_DebugOperationStr(ptAllocEngine->tResources[ eResource ].eCurrentOwners[ 0 ]),
-                                _CCM_VAC_DebugOperationStr(ptAllocEngine->tResources[ eResource ].eCurrentOwners[ 1 ])));
-        }
+        ptResource->eCurrentOwners[ 0 ] = ptResource->eCurrentOwners[ 1 ];
     }
 
+    /* release the resource */
+    ptResource->uOwnersMask &= ~uOperationMask;
+    ptResource->uNumberOfOwners--;
+
     MCP_FUNC_END ();
 }
 
@@ -371,36 +330,34 @@ TCAL_OpPairConfig *_CCM_VAC_AllocationEngine_GetConfigData (TCCM_VAC_AllocationE
     return &(ptAllocEngine->tConfig);
 }
 
-McpBool _CCM_VAC_AEIsPairAllowed (TCCM_VAC_AllocationEngine *ptAllocEngine, 
-                                  ECAL_Resource eResource,
-                                  TCAL_OperationPair *ptPair)
+void _CCM_VAC_AEBuildAllowedPairsMask (TCCM_VAC_AllocationEngine *ptAllocEngine)
 {
-    McpU32                      uIndex;
+    McpU32                      uResIndex, uOpIndex, uPairIndex;
     TCAL_OperationPair          *ptCurrentPair;
 
-    MCP_FUNC_START ("_TCCM_VAC_AEIsPairAllowed");
+    MCP_FUNC_START ("_CCM_VAC_AEBuildAllowedPairsMask");
 
-    /* check all allowed pairs, until a match is found or list is exhusted */
-    for (uIndex = 0; 
-         uIndex < ptAllocEngine->tConfig.tAllowedPairs[ eResource ].uNumOfAllowedPairs; 
-         uIndex++)
+    for (uResIndex = 0; uResIndex < CAL_RESOURCE_MAX_NUM; uResIndex++)
     {
-        /* get current pair pointer */
-        ptCurrentPair = &(ptAllocEngine->tConfig.tAllowedPairs[ eResource ].tOpPairs[ uIndex ]);
-
-        /* compare given pair to current pair (resource order is of no significance) */
-        if (((ptCurrentPair->eOperations[ 0 ] == ptPair->eOperations[ 0 ]) && 
-             (ptCurrentPair->eOperations[ 1 ] == ptPair->eOperations[ 1 ])) ||
-            ((ptCurrentPair->eOperations[ 0 ] == ptPair->eOperations[ 1 ]) && 
-             (ptCurrentPair->eOperations[ 1 ] == ptPair->eOperations[ 0 ])))
+        /* start with no allowed pairs */
+        for (uOpIndex = 0; uOpIndex < CAL_OPERATION_MAX_NUM; uOpIndex++)
         {
-            /* pairs match - pair is allowed for this resource */
-            return MCP_TRUE;
+            ptAllocEngine->uAllowedPairsMask[ uResIndex ][ uOpIndex ] = 0;
         }
-    }
 
-    /* no match was found - pair is not allowed for this resource */
-    return MCP_FALSE;
+        /* mark every allowed pair for this resource (pair order is of no significance) */
+        for (uPairIndex = 0;
+             uPairIndex < ptAllocEngine->tConfig.tAllowedPairs[ uResIndex ].uNumOfAllowedPairs;
+             uPairIndex++)
+        {
+            ptCurrentPair = &(ptAllocEngine->tConfig.tAllowedPairs[ uResIndex ].tOpPairs[ uPairIndex ]);
+
+            ptAllocEngine->uAllowedPairsMask[ uResIndex ][ ptCurrentPair->eOperations[ 0 ] ] |=
+                CCM_VAC_AE_OP_MASK (ptCurrentPair->eOperations[ 1 ]);
+            ptAllocEngine->uAllowedPairsMask[ uResIndex ][ ptCurrentPair->eOperations[ 1 ] ] |=
+                CCM_VAC_AE_OP_MASK (ptCurrentPair->eOperations[ 0 ]);
+        }
+    }
 
     MCP_FUNC_END ();
 }
@@ -102,6 +102,12 @@ TCCM_VAC_ConfigurationEngine    tCEObjects[ MCP_HAL_MAX_NUM_OF_CHIPS ];
 ECCM_VAC_Status _CCM_VAC_ConfigurationEngine_ConfigResources (TCCM_VAC_ConfigurationEngine *ptConfigEngine,
                                                               ECAL_Operation eOperation);
 
+ECCM_VAC_Status _CCM_VAC_ConfigurationEngine_ConfigOperation (TCCM_VAC_ConfigurationEngine *ptConfigEngine,
+                                                              ECAL_Operation eOperation);
+
+void _CCM_VAC_ConfigurationEngine_CalOperationCb (void *pUserData, 
+                                                  ECAL_RetValue eRetValue);
+
 ECCM_VAC_Status _CCM_VAC_ConfigurationEngine_StopResources (TCCM_VAC_ConfigurationEngine *ptConfigEngine,
                                                             ECAL_Operation eOperation);
 
@@ -331,7 +337,6 @@ ECCM_VAC_Status _CCM_VAC_ConfigurationEngine_StartOperation (TCCM_VAC_Configurat
                                                              TCCM_VAC_UnavailResourceList *ptUnavailResources)
 {
     McpHalOsStatus          eOsStatus;
-    TCAL_ResourceList       *pResourceList;
     ECCM_VAC_Status         eConfigStatus;
     ECCM_VAC_Status         eAllocationStatus, status = CCM_VAC_STATUS_FAILURE_UNSPECIFIED; 
 
@@ -357,9 +362,6 @@ ECCM_VAC_Status _CCM_VAC_ConfigurationEngine_StartOperation (TCCM_VAC_Configurat
                     ("_CCM_VAC_ConfigurationEngine_StartOperation: unsupported operation %s",
                      _CCM_VAC_DebugOperationStr(eOperation)));
 
-    pResourceList = &(ptConfigEngine->tOperations[ eOperation ].tCurrentRequiredResources);
-	
-
 	/* lock the semaphore (while accessing the mapping and allocation engines) */
     eOsStatus = MCP_HAL_OS_LockSemaphore (ptConfigEngine->tSemaphore, MCP_HAL_OS_TIME_INFINITE);
     MCP_VERIFY_FATAL ((MCP_HAL_OS_STATUS_SUCCESS == eOsStatus), CCM_VAC_STATUS_FAILURE_UNSPECIFIED,
@@ -456,8 +458,8 @@ ECCM_VAC_Status _CCM_VAC_ConfigurationEngine_StartOperation (TCCM_VAC_Configurat
     MCP_HAL_MEMORY_MemCopy (&(ptConfigEngine->tOperations[ eOperation ].tDigitalConfig), ptConfig,
                             sizeof(TCAL_DigitalConfig));
 
-    /* start configuration process */
-    eConfigStatus = _CCM_VAC_ConfigurationEngine_ConfigResources (ptConfigEngine, eOperation);
+    /* configure all resources as a single transaction */
+    eConfigStatus = _CCM_VAC_ConfigurationEngine_ConfigOperation (ptConfigEngine, eOperation);
 
     /* lock the semaphore again (while updating the operation state) */
     eOsStatus = MCP_HAL_OS_LockSemaphore (ptConfigEngine->tSemaphore, MCP_HAL_OS_TIME_INFINITE);
@@ -478,12 +480,15 @@ ECCM_VAC_Status _CCM_VAC_ConfigurationEngine_StartOperation (TCCM_VAC_Configurat
     {
         status = CCM_VAC_STATUS_PENDING;
     }
-    else /* an error occurred in the configuration process */
+    else /* an error occurred in the configuration process - the CAL left nothing configured */
     {
-        MCP_LOG_INFO (("_CCM_VAC_ConfigurationEngine_StartOperation: operation %s configuration stage failed, "
-                       "resource %s returned error %d!", 
-                       _CCM_VAC_DebugResourceStr (pResourceList->eResources[ ptConfigEngine->tOperations[ eOperation ].uResourceBeingConfigured ]),
+        MCP_LOG_INFO (("_CCM_VAC_ConfigurationEngine_StartOperation: operation %s configuration stage failed "
+                       "with error %d, rolling back allocation", 
                        _CCM_VAC_DebugOperationStr(eOperation), eConfigStatus));
+
+        /* release the resources allocated for the operation */
+        _CCM_VAC_ConfigurationEngine_DeallocateOperationResources (ptConfigEngine, eOperation);
+
         ptConfigEngine->tOperations[ eOperation ].eOperationState = CCM_VAC_OPERATION_STATE_IDLE;
         status = CCM_VAC_STATUS_FAILURE_UNSPECIFIED;
     }
@@ -1092,6 +1097,85 @@ void _CCM_VAC_ConfigurationEngine_CalCb (void *pUserData,
     MCP_FUNC_END ();
 }
 
+void _CCM_VAC_ConfigurationEngine_CalOperationCb (void *pUserData, 
+                                                  ECAL_RetValue eRetValue)
+{
+    TCCM_VAC_ConfigurationEngine    *ptConfigEngine = 
+        ((TCCM_VAC_CECALUserData *)pUserData)->ptConfigEngine;
+    ECAL_Operation                  eOperation = 
+        ((TCCM_VAC_CECALUserData *)pUserData)->eOperation;
+    ECCM_VAC_Status                 eStatus;
+    McpHalOsStatus                  eOsStatus;
+    McpU32                          uIndex;
+
+    MCP_FUNC_START ("_CCM_VAC_ConfigurationEngine_CalOperationCb");
+
+    MCP_LOG_INFO (("_CCM_VAC_ConfigurationEngine_CalOperationCb: called for operation %s, with status %d",
+                   _CCM_VAC_DebugOperationStr(eOperation), eRetValue));
+
+    /* verify object pointer */
+    MCP_VERIFY_FATAL_NO_RETVAR ((NULL != ptConfigEngine),
+                                ("_CCM_VAC_ConfigurationEngine_CalOperationCb: NULL object!"));
+
+    /* verify operation is valid */	
+    MCP_VERIFY_FATAL_NO_RETVAR ((eOperation < CAL_OPERATION_MAX_NUM),
+                                ("_CCM_VAC_ConfigurationEngine_CalOperationCb: invalid operation %s",
+                                 _CCM_VAC_DebugOperationStr(eOperation)));
+
+    /* lock the semaphore (while accessing the allocation engine and operation state) */
+    eOsStatus = MCP_HAL_OS_LockSemaphore (ptConfigEngine->tSemaphore, MCP_HAL_OS_TIME_INFINITE);
+    MCP_VERIFY_FATAL_NO_RETVAR ((MCP_HAL_OS_STATUS_SUCCESS == eOsStatus),
+                                ("_CCM_VAC_ConfigurationEngine_CalOperationCb: semaphore returned error %d",
+                                 eOsStatus));
+
+    /* if configuration process was stopped, simply do nothing */
+    if (CCM_VAC_OPERATION_STATE_STARTING != ptConfigEngine->tOperations[ eOperation ].eOperationState)
+    {
+        eOsStatus = MCP_HAL_OS_UnlockSemaphore (ptConfigEngine->tSemaphore);
+        MCP_VERIFY_FATAL_NO_RETVAR ((MCP_HAL_OS_STATUS_SUCCESS == eOsStatus),
+                                    ("_CCM_VAC_ConfigurationEngine_CalOperationCb: unlock semaphore status: %d",
+                                     eOsStatus));
+
+        MCP_LOG_ERROR (("_CCM_VAC_ConfigurationEngine_CalOperationCb: operation %s is not undergoing configuration",
+                        _CCM_VAC_DebugOperationStr(eOperation)));
+        return;
+    }
+
+    if (CAL_STATUS_SUCCESS == eRetValue)
+    {
+        /* commit - all resources are configured */
+        ptConfigEngine->tOperations[ eOperation ].uResourceBeingConfigured = 
+            ptConfigEngine->tOperations[ eOperation ].tCurrentRequiredResources.uNumOfResources;
+        ptConfigEngine->tOperations[ eOperation ].eOperationState = CCM_VAC_OPERATION_STATE_RUNNING;
+        eStatus = CCM_VAC_STATUS_SUCCESS;
+    }
+    else
+    {
+        MCP_LOG_ERROR (("_CCM_VAC_ConfigurationEngine_CalOperationCb: configuration of operation %s failed,"
+                        " rolling back allocation", _CCM_VAC_DebugOperationStr(eOperation)));
+
+        /* the CAL already undid the configuration - release the resources as well */
+        _CCM_VAC_ConfigurationEngine_DeallocateOperationResources (ptConfigEngine, eOperation);
+        ptConfigEngine->tOperations[ eOperation ].eOperationState = CCM_VAC_OPERATION_STATE_IDLE;
+        eStatus = CCM_VAC_STATUS_FAILURE_UNSPECIFIED;
+    }
+
+    /* unlock the semaphore */
+    eOsStatus = MCP_HAL_OS_UnlockSemaphore (ptConfigEngine->tSemaphore);
+    MCP_VERIFY_FATAL_NO_RETVAR ((MCP_HAL_OS_STATUS_SUCCESS == eOsStatus),
+                                ("_CCM_VAC_ConfigurationEngine_CalOperationCb: unlock semaphore status: %d",
+                                 eOsStatus));
+
+    /* send completion event */
+    for (uIndex = 0; uIndex < ptConfigEngine->tOperations[ eOperation ].uNumberOfCBs; uIndex++)
+    {
+        ptConfigEngine->tOperations[ eOperation ].fCB[ uIndex ] 
+            (eOperation, ptConfigEngine->tOperations[ eOperation ].eEventToClient, eStatus);
+    }
+
+    MCP_FUNC_END ();
+}
+
 void _CCM_VAC_ConfigurationEngine_CalStopCb (void *pUserData, 
                                              ECAL_RetValue eRetValue)
 {
@@ -1295,6 +1379,57 @@ ECCM_VAC_Status _CCM_VAC_ConfigurationEngine_ConfigResources (TCCM_VAC_Configura
     }
 }
 
+ECCM_VAC_Status _CCM_VAC_ConfigurationEngine_ConfigOperation (TCCM_VAC_ConfigurationEngine *ptConfigEngine,
+                                                              ECAL_Operation eOperation)
+{
+    TCAL_ResourceList       *pResourceList = 
+        &(ptConfigEngine->tOperations[ eOperation ].tCurrentRequiredResources);
+    TCAL_ResourceProperties *ptProperties[ CAL_VAC_MAX_NUM_OF_RESOURCES_PER_OP ];
+    ECAL_RetValue           eConfigStatus;
+    McpU32                  uIndex;
+
+    /*
+     * it is assumed the VAC semaphore is NOT locked when calling this function (see 
+     * _CCM_VAC_ConfigurationEngine_ConfigResources)
+     */
+
+    MCP_FUNC_START ("_CCM_VAC_ConfigurationEngine_ConfigOperation");
+
+    MCP_LOG_INFO (("_CCM_VAC_ConfigurationEngine_ConfigOperation: starting configuration for operation %s",
+                   _CCM_VAC_DebugOperationStr(eOperation)));
+
+    /* collect the properties of all resources */
+    for (uIndex = 0; uIndex < pResourceList->uNumOfResources; uIndex++)
+    {
+        ptProperties[ uIndex ] = 
+            _CCM_VAC_AllocationEngine_GetResourceProperties (ptConfigEngine->ptAllocationEngine, 
+                                                             pResourceList->eResources[ uIndex ]);
+    }
+
+    /* and configure them all in a single CAL transaction */
+    eConfigStatus = CAL_ConfigOperation (ptConfigEngine->pCAL, eOperation, pResourceList,
+                                         &(ptConfigEngine->tOperations[ eOperation ].tDigitalConfig),
+                                         ptProperties,
+                                         _CCM_VAC_ConfigurationEngine_CalOperationCb, 
+                                         (void *)&(ptConfigEngine->tOperations[ eOperation ].tCALUserData));
+
+    MCP_FUNC_END ();
+
+    if (CAL_STATUS_SUCCESS == eConfigStatus)
+    {
+        ptConfigEngine->tOperations[ eOperation ].uResourceBeingConfigured = pResourceList->uNumOfResources;
+        return CCM_VAC_STATUS_SUCCESS;
+    }
+    else if (CAL_STATUS_PENDING == eConfigStatus)
+    {
+        return CCM_VAC_STATUS_PENDING;
+    }
+    else
+    {
+        return CCM_VAC_STATUS_FAILURE_UNSPECIFIED;
+    }
+}
+
 ECCM_VAC_Status _CCM_VAC_ConfigurationEngine_StopResources (TCCM_VAC_ConfigurationEngine *ptConfigEngine,
                                                             ECAL_Operation eOperation)
 {
@@ -1362,8 +1497,8 @@ ECCM_VAC_Status _CCM_VAC_ConfigurationEngine_AllocateOperationResources (TCCM_VA
 
     MCP_FUNC_START ("_CCM_VAC_ConfigurationEngine_AllocateOperationResources");
 
-    MCP_LOG_INFO (("_CCM_VAC_ConfigurationEngine_AllocateOperationResources: allocating resources"
-                   " for operation %s", _CCM_VAC_DebugOperationStr(eOperation)));
+    CCM_VAC_LOG_INFO (("_CCM_VAC_ConfigurationEngine_AllocateOperationResources: allocating resources"
+                       " for operation %s", _CCM_VAC_DebugOperationStr(eOperation)));
 
     /* initialize the unavailable resource list to an empty list */
     ptUnavailResources->uNumOfUnavailResources = 0;
@@ -1398,9 +1533,9 @@ ECCM_VAC_Status _CCM_VAC_ConfigurationEngine_AllocateOperationResources (TCCM_VA
     /* if not all resources were allocated successfuly */
     if (0 < ptUnavailResources->uNumOfUnavailResources)
     {
-        MCP_LOG_INFO (("_CCM_VAC_ConfigurationEngine_AllocateOperationResources: resources for "
-                       "operation %s could not be allocated",
-                       _CCM_VAC_DebugOperationStr(eOperation)));
+        CCM_VAC_LOG_INFO (("_CCM_VAC_ConfigurationEngine_AllocateOperationResources: resources for "
+                           "operation %s could not be allocated",
+                           _CCM_VAC_DebugOperationStr(eOperation)));
 
         /* release all resources that were allocated */
         for (uIndex = 0; 
@@ -52,8 +52,11 @@ struct _TCCM_VAC_MappingEngine
 /* the actual mapping engine objects */
 TCCM_VAC_MappingEngine    tMEObjects[ MCP_HAL_MAX_NUM_OF_CHIPS ];
 
+/* resource bit within a resource mask */
+#define CCM_VAC_ME_RES_MASK(_eResource)     ((McpU32)1 << (_eResource))
+
 /* forward declarations */
-McpBool _CCM_VAC_MEIsResourceOnList (ECAL_Resource eResource, TCAL_ResourceList *ptList);
+McpU32 _CCM_VAC_MEResourceListToMask (TCAL_ResourceList *ptList);
 
 ECCM_VAC_Status _CCM_VAC_MappingEngine_Create (McpHalChipId chipId,
                                                McpConfigParser *pConfigParser,
@@ -262,8 +265,8 @@ void _CCM_VAC_MappingEngine_OperationToResourceList (TCCM_VAC_MappingEngine *ptM
 
     MCP_FUNC_START ("_CCM_VAC_MappingEngine_OperationToResourceList");
 
-    MCP_LOG_INFO (("_CCM_VAC_MappingEngine_OperationToResourceList: requesting resource list for operation %s",
-                   _CCM_VAC_DebugOperationStr(eOperation)));
+    CCM_VAC_LOG_INFO (("_CCM_VAC_MappingEngine_OperationToResourceList: requesting resource list for operation %s",
+                       _CCM_VAC_DebugOperationStr(eOperation)));
 
     /* verify object pointer and list pointer */
     MCP_VERIFY_FATAL_NO_RETVAR ((NULL != ptMappEngine), 
@@ -320,8 +323,8 @@ void _CCM_VAC_MappingEngine_GetOptionalResourcesList (TCCM_VAC_MappingEngine *pt
 
     MCP_FUNC_START ("_CCM_VAC_MappingEngine_GetOptionalResourcesList");
 
-    MCP_LOG_INFO (("_CCM_VAC_MappingEngine_GetOptionalResourcesList: requesting optional resources list for "
-                   "operation %s", _CCM_VAC_DebugOperationStr(eOperation)));
+    CCM_VAC_LOG_INFO (("_CCM_VAC_MappingEngine_GetOptionalResourcesList: requesting optional resources list for "
+                       "operation %s", _CCM_VAC_DebugOperationStr(eOperation)));
 
     /* verify object pointer and list pointer */
     MCP_VERIFY_FATAL_NO_RETVAR ((NULL != ptMappEngine), 
@@ -354,12 +357,13 @@ void _CCM_VAC_MappingEngine_SetOptionalResourcesList (TCCM_VAC_MappingEngine *pt
                                                       ECAL_Operation eOperation,
                                                       TCAL_ResourceList *ptResourceList)
 {
-    McpU32                      uIndex;
+    McpU32                      uIndex, uNewResourcesMask;
+    TCAL_OptionalResource       *ptOptResource;
 
     MCP_FUNC_START ("_CCM_VAC_MappingEngine_SetOptionalResourcesList");
 
-    MCP_LOG_INFO (("_CCM_VAC_MappingEngine_SetOptionalResourcesList: requesting to change optional resources list for "
-                   "operation %s", _CCM_VAC_DebugOperationStr(eOperation)));
+    CCM_VAC_LOG_INFO (("_CCM_VAC_MappingEngine_SetOptionalResourcesList: requesting to change optional resources list for "
+                       "operation %s", _CCM_VAC_DebugOperationStr(eOperation)));
 
     /* verify object pointer and list pointer */
     MCP_VERIFY_FATAL_NO_RETVAR ((NULL != ptMappEngine), 
@@ -367,34 +371,25 @@ void _CCM_VAC_MappingEngine_SetOptionalResourcesList (TCCM_VAC_MappingEngine *pt
     MCP_VERIFY_FATAL_NO_RETVAR ((NULL != ptResourceList), 
                                 ("_CCM_VAC_MappingEngine_SetOptionalResourcesList: NULL resource list!"));
 
+    /* convert the new list once, so each optional resource is checked with a single bit test */
+    uNewResourcesMask = _CCM_VAC_MEResourceListToMask (ptResourceList);
+
     /* loop over all optional resources */
     for (uIndex = 0;
          uIndex < ptMappEngine->tConfig.tOpToResMap[ eOperation ].tOptionalResources.uNumOfResourceLists;
          uIndex++)
     {
-        /* if this optional resource is include in the new list */
-        if (MCP_TRUE ==
-            _CCM_VAC_MEIsResourceOnList (ptMappEngine->tConfig.tOpToResMap[ eOperation ].tOptionalResources.tOptionalResourceLists[ uIndex ].eOptionalResource,
-            ptResourceList))
-        {
-            /* mark the optional resource as used */
-            ptMappEngine->tConfig.tOpToResMap[ eOperation ].tOptionalResources.tOptionalResourceLists[ uIndex ].bIsUsed =
-                MCP_TRUE;
-            MCP_LOG_INFO (("_CCM_VAC_MappingEngine_SetOptionalResourcesList: optional resource %s is "
-                           "set to used for operation %s",
-                           _CCM_VAC_DebugResourceStr(ptMappEngine->tConfig.tOpToResMap[ eOperation ].tOptionalResources.tOptionalResourceLists[ uIndex ].eOptionalResource),
-                           _CCM_VAC_DebugOperationStr(eOperation)));
-        }
-        else
-        {
-            /* mark the optional resource as unused */
-            ptMappEngine->tConfig.tOpToResMap[ eOperation ].tOptionalResources.tOptionalResourceLists[ uIndex ].bIsUsed = 
-                MCP_FALSE;
-            MCP_LOG_INFO (("_CCM_VAC_MappingEngine_SetOptionalResourcesList: optional resource %s is "
-                           "set to unused for operation %s",
-                           _CCM_VAC_DebugResourceStr(ptMappEngine->tConfig.tOpToResMap[ eOperation ].tOptionalResources.tOptionalResourceLists[ uIndex ].eOptionalResource),
+        ptOptResource = &(ptMappEngine->tConfig.tOpToResMap[ eOperation ].tOptionalResources.tOptionalResourceLists[ uIndex ]);
+
+        /* mark the optional resource as used if it is included in the new list, unused otherwise */
+        ptOptResource->bIsUsed = 
+            (0 != (uNewResourcesMask & CCM_VAC_ME_RES_MASK (ptOptResource->eOptionalResource))) ? MCP_TRUE : MCP_FALSE;
+
+        CCM_VAC_LOG_INFO (("_CCM_VAC_MappingEngine_SetOptionalResourcesList: optional resource %s is "
+                           "set to %s for operation %s",
+                           _CCM_VAC_DebugResourceStr(ptOptResource->eOptionalResource),
+                           ((MCP_TRUE == ptOptResource->bIsUsed) ? "used" : "unused"),
                            _CCM_VAC_DebugOperationStr(eOperation)));
-        }
     }
 
     MCP_FUNC_END ();
@@ -405,26 +400,20 @@ TCAL_MappingConfiguration *_CCM_VAC_MappingEngine_GetConfigData (TCCM_VAC_Mappin
     return &(ptMappEngine->tConfig);
 }
 
-McpBool _CCM_VAC_MEIsResourceOnList (ECAL_Resource eResource, TCAL_ResourceList *ptList)
+McpU32 _CCM_VAC_MEResourceListToMask (TCAL_ResourceList *ptList)
 {
-    McpU32      uIndex;
+    McpU32      uIndex, uMask = 0;
 
-    MCP_FUNC_START ("_CCM_VAC_MEIsResourceOnList");
+    MCP_FUNC_START ("_CCM_VAC_MEResourceListToMask");
 
-    /* loop on all resources in the list */
+    /* set the bit of every resource on the list */
     for (uIndex = 0; uIndex < ptList->uNumOfResources; uIndex++)
     {
-        /* if the current resource is the requested one */
-        if (eResource == ptList->eResources[ uIndex ])
-        {
-            /* resource is on the list */
-            return MCP_TRUE;
-        }
+        uMask |= CCM_VAC_ME_RES_MASK (ptList->eResources[ uIndex ]);
     }
 
     MCP_FUNC_END ();
 
-    /* list was exhausted and resource was not found - resource is not on the list */
-    return MCP_FALSE;
+    return uMask;
 }
 
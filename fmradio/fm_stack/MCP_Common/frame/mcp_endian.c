@@ -27,12 +27,23 @@
 \*******************************************************************************/
 #include "mcp_endian.h"
 #include "mcp_hal_log.h"
+#include "mcpf_services.h"
+
+/* 64 bits window the bit fields are extracted from / inserted into */
+typedef unsigned long long TBitWindow;
+
+#define BIT_WINDOW_BITS		(64)
 
 /****************************************************************************
  *
  * Local Prototypes
  *
  ***************************************************************************/
+static TBitWindow endian_LoadWindow(const McpU8 *pBuf, McpU32 uNumOfBytes);
+static McpU32 endian_WindowBytes(const TMcpfBitStream *pStream, McpU32 uByte);
+static McpU32 endian_ExtractBits(TBitWindow uWin, McpU32 uStartBit, McpU32 uBitLength);
+static void endian_InsertBits(McpU8 *pBuf, McpU32 uNumOfBytes, McpU32 uStartBit, 
+							  McpU32 uInputVal, McpU32 uBitLength);
 
 /****************************************************************************
  *
@@ -96,55 +107,32 @@ void MCP_ENDIAN_HostToBE32(McpU32 hostValue32, McpU8 *beBuff32)
 McpU32 mcpf_getBits(McpU8* pBuf, McpU32 *pBitOffset, McpU32 uBitLength)
 {
     McpU32  uOfs        = *pBitOffset;
-    McpU32  uFirstByte  = uOfs / 8;
-    McpU32  uLastByte   = (uOfs + uBitLength) / 8;
-    McpU32  uFirstBits  = uOfs % 8;
-    McpU32  uLsbBits    = (uOfs + uBitLength) % 8;
+    McpU32  uFirstByte;
+    McpU32  uFirstBits;
     McpU32  uVal		= 0;
-	McpU32	uIndx		= uFirstByte;
-	McpU32	uMask;
 
-    while (uIndx < uLastByte) 
-    {
-        uVal <<= 8;
-        uVal |= pBuf[uIndx++];
-    }
+    *pBitOffset = uOfs + uBitLength;
 
-    if (uLsbBits) 
+    /* the 32-bit result holds the field's least significant bits only, skip the rest */
+    if (uBitLength > 32)
     {
-		McpU8  uLsbVal = pBuf[uIndx];  /* copy the lsb byte */
-
-        if ((uFirstBits + uBitLength) <= 8 ) 
-        {
-            /* the required bit field resides in one byte */
-
-            uVal = uLsbVal >> (8 - uFirstBits - uBitLength);
-        }
-        else 
-        {
-            /* LSB bits are to be copied from the the next byte */
-
-            uLsbVal >>= (8 - uLsbBits);
-            uVal <<= uLsbBits;
-            uVal |= uLsbVal;
-        }
+        uOfs += uBitLength - 32;
+        uBitLength = 32;
     }
+    uFirstByte = uOfs >> 3;
+    uFirstBits = uOfs & 7;
 
-	if (uBitLength < 32)
-	{
-		uMask = (1 << uBitLength) - 1;
-	}
-	else
-	{
-		uMask = 0xFFFFFFFF;
-	}
-    uVal &= uMask;  /* clear not existing most significant bits */ 
+    if (uBitLength > 0)
+    {
+        /* the caller does not pass the buffer length, load only the bytes the field spans */
+        TBitWindow  uWin = endian_LoadWindow (&pBuf[uFirstByte], (uFirstBits + uBitLength + 7) >> 3);
 
-    *pBitOffset = uOfs + uBitLength;
+        uVal = endian_ExtractBits (uWin, uFirstBits, uBitLength);
+    }
 
 #ifdef RRLP_DEBUG
-	MCP_HAL_LOG_DEBUG( "mcpf", 0, "mcpf_getBits", ("first=%u last=%u ofs0=%u ofs1=%u len=%u val=%u\n",
-													uFirstByte, uLastByte, uOfs, *pBitOffset-1, uBitLength, uVal)); 
+	MCP_HAL_LOG_DEBUG( "mcpf", 0, "mcpf_getBits", ("first=%u ofs0=%u ofs1=%u len=%u val=%u\n",
+													uFirstByte, uOfs, *pBitOffset-1, uBitLength, uVal)); 
 #endif
     return uVal;
 }
@@ -165,61 +153,241 @@ McpS32 mcpf_getSignedBits(McpU8* pBuf, McpU32 *pBitOffset, McpU32 uBitLength)
  * Put bits field into output buffer
  * 
  */ 
-
-#define GETBITS_U32( uInVal, uStartBitOfs, uBitLength ) \
-			((McpU8)(((uInVal) >> (uStartBitOfs)) & ((1 << (uBitLength)) - 1)))
-
 void mcpf_putBits(McpU8* pBuf, McpU32 *pBitOffset, McpU32 uInputVal, McpU32 uInputBitLength)
 {
 	McpU32  uBitOfs 	= *pBitOffset;
-	McpU32 	uIndx		= uBitOfs / 8;                      /* starting byte of buffer to add bits      */
-	McpU32 	uMsbBits 	= 8 - uBitOfs % 8; 					/* most significant bits to add 			*/
-	McpU32	uLastByte   = (uBitOfs + uInputBitLength) / 8;  /* the last byte of buffer to add bit field */
-	McpU32 	uLsbBits 	= (uBitOfs + uInputBitLength) % 8; 	/* least significant bits 					*/
-	McpU32	uInputFromBitPos = uInputBitLength;
-
-	/* Are MSB bits to be added to the start byte of buffer? */
-	if (uMsbBits < 8)
-	{
-		/* Clear bits in byte to be filled */
-		pBuf[uIndx] &= (McpU8) (0xFF << uMsbBits);
+	McpU32	uPadBits;
+
+	*pBitOffset += uInputBitLength;
 
-		if (uInputBitLength <= uMsbBits)
+	/* the 32-bit input is zero extended to a field longer than 32 bits */
+	while (uInputBitLength > 32)
+	{
+		uPadBits = uInputBitLength - 32;
+		if (uPadBits > 32)
 		{
-			/* Bit field length (to add) suites to complete area size or less */
-			pBuf[uIndx++] |= (uInputVal << (uMsbBits - uInputBitLength));
+			uPadBits = 32;
+		}
+		endian_InsertBits (&pBuf[uBitOfs >> 3], ((uBitOfs & 7) + uPadBits + 7) >> 3,
+						   uBitOfs & 7, 0, uPadBits);
+		uBitOfs += uPadBits;
+		uInputBitLength -= uPadBits;
+	}
+
+	if (uInputBitLength > 0)
+	{
+		endian_InsertBits (&pBuf[uBitOfs >> 3], 
+						   ((uBitOfs & 7) + uInputBitLength + 7) >> 3,
+						   uBitOfs & 7, 
+						   uInputVal, 
+						   uInputBitLength);
+	}
+}
+
+/** 
+ * \fn     mcpf_bitStream_Init
+ * \brief  Initialize bit stream
+ * 
+ * Attach bit stream to buffer of known length at the starting bit offset
+ * 
+ */ 
+void mcpf_bitStream_Init(TMcpfBitStream *pStream, McpU8 *pBuf, McpU32 uBufLen, McpU32 uBitOffset)
+{
+	pStream->pBuf		= pBuf;
+	pStream->uBufLen	= uBufLen;
+	pStream->uBitOffset	= uBitOffset;
+}
+
+/** 
+ * \fn     mcpf_bitStream_GetBits
+ * \brief  Get bits field from stream
+ * 
+ * Get bits field at the current stream position and advance the position
+ * 
+ */ 
+McpU32 mcpf_bitStream_GetBits(TMcpfBitStream *pStream, McpU32 uBitLength)
+{
+	McpU32		uOfs = pStream->uBitOffset;
+	McpU32		uByte = uOfs >> 3;
+	TBitWindow	uWin;
+
+	if (uBitLength == 0)
+	{
+		return 0;
+	}
+	if (uBitLength > 32)
+	{
+		uBitLength = 32;
+	}
+
+	uWin = endian_LoadWindow (&pStream->pBuf[uByte], endian_WindowBytes (pStream, uByte));
+	pStream->uBitOffset = uOfs + uBitLength;
+
+	return endian_ExtractBits (uWin, uOfs & 7, uBitLength);
+}
+
+/** 
+ * \fn     mcpf_bitStream_GetSignedBits
+ * \brief  Get signed bits field from stream
+ * 
+ * Get bits field from stream and sign extend it
+ * 
+ */ 
+McpS32 mcpf_bitStream_GetSignedBits(TMcpfBitStream *pStream, McpU32 uBitLength)
+{
+	McpU32 u32 = mcpf_bitStream_GetBits(pStream, uBitLength);
+
+	if ((uBitLength > 0) && (uBitLength < 32) && (u32 & (1 << (uBitLength - 1))))
+	{
+		u32 |= (0xFFFFFFFF << uBitLength);
+	}
+	return (McpS32)u32;
+}
 
-			*pBitOffset += uInputBitLength;
-			return; /* Done */
+/** 
+ * \fn     mcpf_bitStream_GetFields
+ * \brief  Get consecutive bits fields from stream
+ * 
+ * Get the run of bits fields described by the widths array into the values array
+ * 
+ */ 
+void mcpf_bitStream_GetFields(TMcpfBitStream *pStream, const McpU8 *pWidths, 
+							  McpU32 uNumOfFields, McpU32 *pValues)
+{
+	TBitWindow	uWin = 0;
+	McpU32		uWinStart = 0;			/* bit offset of the window's first bit */
+	McpBool		bWinLoaded = MCP_FALSE;
+	McpU32		uOfs = pStream->uBitOffset;
+	McpU32		uBitLength;
+	McpU32		uIndx;
+
+	for (uIndx = 0; uIndx < uNumOfFields; uIndx++)
+	{
+		uBitLength = (pWidths[uIndx] > 32) ? 32 : pWidths[uIndx];
+		if (uBitLength == 0)
+		{
+			pValues[uIndx] = 0;
+			continue;
 		}
-		else
+
+		/* Reload the window only when the field runs past its end */
+		if (!bWinLoaded || (uOfs - uWinStart + uBitLength > BIT_WINDOW_BITS))
 		{
-			/* Bit field length (to add) is greater than remained area size, 
-			 * take required bit field from input value to complete the first byte
-			 */
-			McpU8   bitsVal;
-
-			uInputFromBitPos -= uMsbBits;
-			bitsVal = GETBITS_U32 (uInputVal, uInputFromBitPos, uMsbBits);
-			pBuf[uIndx++] |= bitsVal;
+			McpU32	uByte = uOfs >> 3;
+
+			uWin = endian_LoadWindow (&pStream->pBuf[uByte], endian_WindowBytes (pStream, uByte));
+			uWinStart = uByte << 3;
+			bWinLoaded = MCP_TRUE;
 		}
+
+		pValues[uIndx] = endian_ExtractBits (uWin, uOfs - uWinStart, uBitLength);
+		uOfs += uBitLength;
 	}
 
-	/* Copy to buffer in byte units */
-	while (uIndx < uLastByte)
+	pStream->uBitOffset = uOfs;
+}
+
+/** 
+ * \fn     mcpf_bitStream_PutBits
+ * \brief  Put bits field into stream
+ * 
+ * Put bits field at the current stream position and advance the position
+ * 
+ */ 
+void mcpf_bitStream_PutBits(TMcpfBitStream *pStream, McpU32 uInputVal, McpU32 uInputBitLength)
+{
+	McpU32	uOfs = pStream->uBitOffset;
+	McpU32	uByte = uOfs >> 3;
+	McpU32	uNumOfBytes;
+
+	if (uInputBitLength == 0)
+	{
+		return;
+	}
+	if (uInputBitLength > 32)
 	{
-		uInputFromBitPos -= 8;
-		pBuf[uIndx++] = GETBITS_U32 (uInputVal, uInputFromBitPos, 8);
+		uInputBitLength = 32;
 	}
 
-	/* Add LSB bits to the last byte */
-	if (uLsbBits)
+	/* store only the bytes the field spans, and never beyond the buffer */
+	uNumOfBytes = ((uOfs & 7) + uInputBitLength + 7) >> 3;
+	if (uByte >= pStream->uBufLen)
 	{
-		McpU8   bitsVal;
+		uNumOfBytes = 0;
+	}
+	else if (uNumOfBytes > pStream->uBufLen - uByte)
+	{
+		uNumOfBytes = pStream->uBufLen - uByte;
+	}
 
-		bitsVal = GETBITS_U32 (uInputVal, 0, uLsbBits);
-		pBuf[uIndx++] = (McpU8) (bitsVal << (8 - uLsbBits));
+	if (uNumOfBytes > 0)
+	{
+		endian_InsertBits (&pStream->pBuf[uByte], uNumOfBytes, uOfs & 7, uInputVal, uInputBitLength);
 	}
+	pStream->uBitOffset = uOfs + uInputBitLength;
+}
 
-	*pBitOffset += uInputBitLength;
+
+/****************************************************************************
+ *
+ * Local Functions
+ *
+ ***************************************************************************/
+
+/* Load up to 8 bytes, big endian, into the most significant end of a window.
+ * Missing bytes read as zero. */
+static TBitWindow endian_LoadWindow(const McpU8 *pBuf, McpU32 uNumOfBytes)
+{
+	TBitWindow	uWin = 0;
+	McpU32		uIndx;
+
+	if (uNumOfBytes == 8)
+	{
+		/* full word, compilers turn this into a single load and byte swap */
+		return ((TBitWindow)pBuf[0] << 56) | ((TBitWindow)pBuf[1] << 48) |
+			   ((TBitWindow)pBuf[2] << 40) | ((TBitWindow)pBuf[3] << 32) |
+			   ((TBitWindow)pBuf[4] << 24) | ((TBitWindow)pBuf[5] << 16) |
+			   ((TBitWindow)pBuf[6] << 8)  |  (TBitWindow)pBuf[7];
+	}
+
+	for (uIndx = 0; uIndx < uNumOfBytes; uIndx++)
+	{
+		uWin |= (TBitWindow)pBuf[uIndx] << (56 - 8 * uIndx);
+	}
+	return uWin;
+}
+
+/* Number of bytes a stream may load at byte offset uByte: a full word when available */
+static McpU32 endian_WindowBytes(const TMcpfBitStream *pStream, McpU32 uByte)
+{
+	if (uByte >= pStream->uBufLen)
+	{
+		return 0;
+	}
+	return (pStream->uBufLen - uByte >= 8) ? 8 : (pStream->uBufLen - uByte);
+}
+
+/* Extract uBitLength (1..32) bits starting uStartBit bits into the window */
+static McpU32 endian_ExtractBits(TBitWindow uWin, McpU32 uStartBit, McpU32 uBitLength)
+{
+	return (McpU32)((uWin << uStartBit) >> (BIT_WINDOW_BITS - uBitLength));
+}
+
+/* Insert uBitLength (1..32) bits of uInputVal uStartBit bits into the uNumOfBytes
+ * bytes at pBuf. The bits following the field in its last byte are cleared. */
+static void endian_InsertBits(McpU8 *pBuf, McpU32 uNumOfBytes, McpU32 uStartBit, 
+							  McpU32 uInputVal, McpU32 uBitLength)
+{
+	TBitWindow	uWin 	= endian_LoadWindow (pBuf, uNumOfBytes);
+	McpU32		uSpan 	= ((uStartBit + uBitLength + 7) >> 3) << 3;
+	TBitWindow	uClear	= (~(TBitWindow)0 >> uStartBit) & ~(~(TBitWindow)0 >> uSpan);
+	TBitWindow	uField	= (TBitWindow)(uInputVal & (0xFFFFFFFF >> (32 - uBitLength)));
+	McpU32		uIndx;
+
+	uWin = (uWin & ~uClear) | (uField << (BIT_WINDOW_BITS - uStartBit - uBitLength));
+
+	for (uIndx = 0; uIndx < uNumOfBytes; uIndx++)
+	{
+		pBuf[uIndx] = (McpU8) (uWin >> (56 - 8 * uIndx));
+	}
 }
@@ -21,6 +21,8 @@
 #include "mcp_hci_sequencer.h"
 #include "mcp_hal_memory.h"
 #include "mcp_hal_log.h"
+#include "mcp_hal_os.h"
+#include "mcp_endian.h"
 #include "mcpf_defs.h"
 #include "ccm_adapt.h"
 
@@ -33,6 +35,13 @@ MCP_HAL_LOG_SET_MODULE(MCP_HAL_LOG_MODULE_TYPE_FRAME);
 /* Internal prototypes */
 void _MCP_HciSeq_callback (CcmaClientEvent *pEvent);
 CcmaStatus _MCP_HciSeq_SendCommand(MCP_HciSeq_Context *pContext);
+MCP_STATIC void _MCP_HciSeq_PipelinedCallback (MCP_HciSeq_Context *pContext, CcmaClientEvent *pEvent);
+MCP_STATIC void _MCP_HciSeq_Continue (MCP_HciSeq_Context *pContext, CcmaClientEvent *pEvent);
+MCP_STATIC CcmaStatus _MCP_HciSeq_FillWindow (MCP_HciSeq_Context *pContext, McpHciSeqCmdToken **ppFailedCommand);
+MCP_STATIC McpHciSeqInFlightCmd *_MCP_HciSeq_MatchInFlight (MCP_HciSeq_Context *pContext, CcmaClientEvent *pEvent);
+MCP_STATIC McpU32 _MCP_HciSeq_WindowSize (MCP_HciSeq_Context *pContext, McpU32 uWindowSize);
+MCP_STATIC McpBool _MCP_HciSeq_IsPreviousSequencePending (MCP_HciSeq_Context *pContext);
+MCP_STATIC void _MCP_HciSeq_SequenceCompleted (MCP_HciSeq_Context *pContext);
 
 /*---------------------------------------------------------------------------
  *            MCP_HciSeq_CreateSequence()
@@ -54,6 +63,12 @@ void MCP_HciSeq_CreateSequence (MCP_HciSeq_Context *pContext,
     pContext->uCommandCount = 0;
     pContext->uCurrentCommandIdx = 0;
     pContext->bPendingCommand = MCP_FALSE;
+    pContext->uWindowSize = 1;
+    pContext->uInFlightCount = 0;
+    pContext->uNextSendOrder = 0;
+    pContext->uCompletedCount = 0;
+    MCP_HAL_MEMORY_MemSet (pContext->inFlightCommands, 0, sizeof (pContext->inFlightCommands));
+    MCP_HAL_MEMORY_MemSet (&(pContext->stats), 0, sizeof (McpHciSeqStatistics));
     /* register a CCMA client */
     pContext->coreId = coreId;
     if(pContext->coreId == MCP_HAL_CORE_ID_BT)
@@ -121,9 +136,11 @@ CcmaStatus MCP_HciSeq_RunSequence (MCP_HciSeq_Context *pContext,
     pContext->uCommandCount = uCommandCount;
     pContext->uCurrentCommandIdx = 0;
     pContext->uSequenceId++;
+    pContext->uWindowSize = 1;
+    pContext->uSequenceStartTime = MCP_HAL_OS_GetSystemTime();
 
-    /* if a command is pending */
-    if (MCP_TRUE == pContext->bPendingCommand)
+    /* if a command (or pipelined commands of a previous sequence) is pending */
+    if ((MCP_TRUE == pContext->bPendingCommand) || (0 < pContext->uInFlightCount))
     {
         return CCMA_STATUS_PENDING;
     }
@@ -139,6 +156,71 @@ CcmaStatus MCP_HciSeq_RunSequence (MCP_HciSeq_Context *pContext,
     }
 }
 
+/*---------------------------------------------------------------------------
+ *            MCP_HciSeq_RunPipelinedSequence()
+ *---------------------------------------------------------------------------
+ *
+ * Synopsis:  Starts execution of an HCI sequence of independent commands,
+ *            keeping up to a window of commands outstanding
+ *
+ */
+CcmaStatus MCP_HciSeq_RunPipelinedSequence (MCP_HciSeq_Context *pContext,
+                                            const McpU32 uCommandCount,
+                                            const McpHciSeqCmd *pCommands,
+                                            McpBool bCallCbOnlyAfterLastCmd,
+                                            McpU32 uWindowSize)
+{
+    McpHciSeqCmdToken   *pFailedCommand;
+
+    uWindowSize = _MCP_HciSeq_WindowSize (pContext, uWindowSize);
+
+    /* nothing to pipeline - run the sequence one command at a time */
+    if (1 == uWindowSize)
+    {
+        return MCP_HciSeq_RunSequence (pContext, uCommandCount, pCommands, bCallCbOnlyAfterLastCmd);
+    }
+
+    /* sanity cehck */
+    if (HCI_SEQ_MAX_CMDS_PER_SEQUENCE < uCommandCount)
+    {
+        return CCMA_STATUS_FAILED;
+    }
+    pContext->bCallCBOnlyForLastCmd = bCallCbOnlyAfterLastCmd;
+
+    /* copy commands */
+    MCP_HAL_MEMORY_MemCopy ((McpU8 *)pContext->commandsSequence,
+                            (McpU8 *)pCommands,
+                            uCommandCount*sizeof(McpHciSeqCmd));
+
+    /* initialize new sequence - the command index is the next command to send */
+    pContext->uCommandCount = uCommandCount;
+    pContext->uCurrentCommandIdx = 0;
+    pContext->uCompletedCount = 0;
+    pContext->uSequenceId++;
+    pContext->uWindowSize = uWindowSize;
+    pContext->uSequenceStartTime = MCP_HAL_OS_GetSystemTime();
+
+    /* commands of a previous sequence are pending - the window is filled once they all complete */
+    if ((MCP_TRUE == pContext->bPendingCommand) || (0 < pContext->uInFlightCount))
+    {
+        return CCMA_STATUS_PENDING;
+    }
+
+    return _MCP_HciSeq_FillWindow (pContext, &pFailedCommand);
+}
+
+/*---------------------------------------------------------------------------
+ *            MCP_HciSeq_GetStatistics()
+ *---------------------------------------------------------------------------
+ *
+ * Synopsis:  Retrieves the context aggregated sequences timing
+ *
+ */
+void MCP_HciSeq_GetStatistics (MCP_HciSeq_Context *pContext, McpHciSeqStatistics *pStats)
+{
+    MCP_HAL_MEMORY_MemCopy ((McpU8 *)pStats, (McpU8 *)&(pContext->stats), sizeof (McpHciSeqStatistics));
+}
+
 /*---------------------------------------------------------------------------
  *            MCP_HciSeq_CancelSequence()
  *---------------------------------------------------------------------------
@@ -157,6 +239,7 @@ void MCP_HciSeq_CancelSequence (MCP_HciSeq_Context *pContext)
         /* nullify command count and current command index */
         pContext->uCommandCount = 0;
         pContext->uCurrentCommandIdx = 0;
+        pContext->uCompletedCount = 0;
     }
 }
 
@@ -171,9 +254,15 @@ void MCP_HciSeq_CancelSequence (MCP_HciSeq_Context *pContext)
 void _MCP_HciSeq_callback (CcmaClientEvent *pEvent)
 {
     MCP_HciSeq_Context   *pContext = (MCP_HciSeq_Context*)pEvent->pUserData;
-    CcmaStatus          tStatus = CCMA_STATUS_INTERNAL_ERROR;
     McpU32              uSequenceId;
 
+    /* a completion with no single command pending belongs to a pipelined command */
+    if (MCP_FALSE == pContext->bPendingCommand)
+    {
+        _MCP_HciSeq_PipelinedCallback (pContext, pEvent);
+        return;
+    }
+
     /* Clear flag of pending command */
     pContext->bPendingCommand = MCP_FALSE;
     
@@ -182,6 +271,12 @@ void _MCP_HciSeq_callback (CcmaClientEvent *pEvent)
     {
         /* cancel was not requested - advance to next command */
         pContext->uCurrentCommandIdx++;
+        pContext->stats.uCommandsCompleted++;
+
+        if (pContext->uCurrentCommandIdx == pContext->uCommandCount)
+        {
+            _MCP_HciSeq_SequenceCompleted (pContext);
+        }
         
         /* if original CB exists */
         if (NULL != pContext->command.callback) 
@@ -217,7 +312,83 @@ void _MCP_HciSeq_callback (CcmaClientEvent *pEvent)
     }
 
     /* now check if more commands are available for processing */
-    if (pContext->uCurrentCommandIdx < pContext->uCommandCount)
+    _MCP_HciSeq_Continue (pContext, pEvent);
+}
+
+/*---------------------------------------------------------------------------
+ *            _MCP_HciSeq_PipelinedCallback()
+ *---------------------------------------------------------------------------
+ *
+ * Synopsis:  Completes an outstanding pipelined command, and refills the window
+ *
+ */
+MCP_STATIC void _MCP_HciSeq_PipelinedCallback (MCP_HciSeq_Context *pContext, CcmaClientEvent *pEvent)
+{
+    McpHciSeqInFlightCmd    *pInFlight;
+    McpBool                 bLastCommand;
+
+    MCP_FUNC_START ("_MCP_HciSeq_PipelinedCallback");
+
+    pInFlight = _MCP_HciSeq_MatchInFlight (pContext, pEvent);
+    MCP_VERIFY_ERR_NO_RETVAR ((NULL != pInFlight),
+                              ("_MCP_HciSeq_PipelinedCallback: completion with no command outstanding"));
+
+    pInFlight->bInUse = MCP_FALSE;
+    pContext->uInFlightCount--;
+
+    /* CB is not called if previous sequence was canceled or a new sequence was run! */
+    if (pInFlight->uSequenceId == pContext->uSequenceId)
+    {
+        pContext->uCompletedCount++;
+        pContext->stats.uCommandsCompleted++;
+        bLastCommand = (pContext->uCompletedCount == pContext->uCommandCount) ? MCP_TRUE : MCP_FALSE;
+
+        /* if the sequence is finished, reset counters */
+        if (MCP_TRUE == bLastCommand)
+        {
+            _MCP_HciSeq_SequenceCompleted (pContext);
+            pContext->uCommandCount = 0;
+            pContext->uCurrentCommandIdx = 0;
+            pContext->uCompletedCount = 0;
+        }
+
+        if ((NULL != pInFlight->command.callback) &&
+            ((!pContext->bCallCBOnlyForLastCmd) || (MCP_TRUE == bLastCommand)))
+        {
+            /* set the user data in the completion event structure, and call original CB */
+            pEvent->pUserData = pInFlight->command.pUserData;
+            pInFlight->command.callback (pEvent);
+        }
+    }
+
+    /*
+     * continue the current sequence - also when it was replaced in the callback above, since a
+     * new sequence waits for the outstanding commands of the previous one to complete
+     */
+    _MCP_HciSeq_Continue (pContext, pEvent);
+
+    MCP_FUNC_END ();
+}
+
+/*---------------------------------------------------------------------------
+ *            _MCP_HciSeq_Continue()
+ *---------------------------------------------------------------------------
+ *
+ * Synopsis:  Sends the next command(s) of the current sequence, if any
+ *
+ */
+MCP_STATIC void _MCP_HciSeq_Continue (MCP_HciSeq_Context *pContext, CcmaClientEvent *pEvent)
+{
+    McpHciSeqCmdToken   *pFailedCommand = NULL;
+    CcmaStatus          tStatus = CCMA_STATUS_PENDING;
+
+    if (1 < pContext->uWindowSize)
+    {
+        tStatus = _MCP_HciSeq_FillWindow (pContext, &pFailedCommand);
+    }
+    else if ((0 == pContext->uInFlightCount) &&
+             (MCP_FALSE == pContext->bPendingCommand) &&
+             (pContext->uCurrentCommandIdx < pContext->uCommandCount))
     {
         /* prepare next command (by calling the CB) */
         pContext->commandsSequence[ pContext->uCurrentCommandIdx ].fCommandPrepCB( 
@@ -225,15 +396,209 @@ void _MCP_HciSeq_callback (CcmaClientEvent *pEvent)
 
         /* execute first command */
         tStatus = _MCP_HciSeq_SendCommand(pContext);
+        pFailedCommand = &(pContext->command);
+    }
 
-        if (CCMA_STATUS_PENDING != tStatus)
-            {
-                /* an error has occurred - set the user data in the completion event structure */
-                pEvent->pUserData = pContext->command.pUserData;
+    if ((CCMA_STATUS_PENDING != tStatus) && (NULL != pFailedCommand->callback))
+    {
+        /* an error has occurred - set the user data and status in the completion event structure */
+        pEvent->pUserData = pFailedCommand->pUserData;
+        pEvent->status = tStatus;
 
-                /* and call the CB */
-                pContext->command.callback (pEvent);
-            }
+        /* and call the CB */
+        pFailedCommand->callback (pEvent);
+    }
+}
+
+/*---------------------------------------------------------------------------
+ *            _MCP_HciSeq_FillWindow()
+ *---------------------------------------------------------------------------
+ *
+ * Synopsis:  Prepares and sends pipelined commands until the window is full
+ *
+ */
+MCP_STATIC CcmaStatus _MCP_HciSeq_FillWindow (MCP_HciSeq_Context *pContext, McpHciSeqCmdToken **ppFailedCommand)
+{
+    McpHciSeqInFlightCmd    *pInFlight;
+    CcmaStatus              status = CCMA_STATUS_PENDING;
+    McpU32                  uIndex;
+
+    if (MCP_TRUE == _MCP_HciSeq_IsPreviousSequencePending (pContext))
+    {
+        return status;
+    }
+
+    while ((pContext->uInFlightCount < pContext->uWindowSize) &&
+           (pContext->uCurrentCommandIdx < pContext->uCommandCount))
+    {
+        /* a dependent command waits until the window drains */
+        if ((MCP_TRUE == pContext->commandsSequence[ pContext->uCurrentCommandIdx ].bWaitForPrevious) &&
+            (0 < pContext->uInFlightCount))
+        {
+            break;
+        }
+
+        /* find a free command slot - one must exist, as the window is not full */
+        for (uIndex = 0; MCP_TRUE == pContext->inFlightCommands[ uIndex ].bInUse; uIndex++);
+        pInFlight = &(pContext->inFlightCommands[ uIndex ]);
+
+        /* prepare next command (by calling the CB) */
+        pContext->commandsSequence[ pContext->uCurrentCommandIdx ].fCommandPrepCB(
+            &(pInFlight->command), pContext->commandsSequence[ pContext->uCurrentCommandIdx ].pUserData );
+
+        pInFlight->uSequenceId = pContext->uSequenceId;
+        pInFlight->uSendOrder = pContext->uNextSendOrder++;
+        pInFlight->bInUse = MCP_TRUE;
+        pContext->uCurrentCommandIdx++;
+        pContext->uInFlightCount++;
+
+        if (pContext->uInFlightCount > pContext->stats.uMaxCmdsInFlight)
+        {
+            pContext->stats.uMaxCmdsInFlight = pContext->uInFlightCount;
+        }
+
+        /* pipelined sequences are only run over the BT transport */
+        status = CCMA_SendHciCommand(pContext->handle,
+                                     pInFlight->command.eHciOpcode,
+                                     pInFlight->command.pHciCmdParms,
+                                     pInFlight->command.uhciCmdParmsLen,
+                                     pInFlight->command.uCompletionEvent,
+                                     (void *)pContext);
+        if (CCMA_STATUS_PENDING != status)
+        {
+            pInFlight->bInUse = MCP_FALSE;
+            pContext->uInFlightCount--;
+            *ppFailedCommand = &(pInFlight->command);
+            break;
+        }
+    }
+
+    return status;
+}
+
+/*---------------------------------------------------------------------------
+ *            _MCP_HciSeq_MatchInFlight()
+ *---------------------------------------------------------------------------
+ *
+ * Synopsis:  Finds the outstanding command a completion event belongs to - the
+ *            oldest one with the event opcode, or the oldest one if the event
+ *            carries no opcode
+ *
+ */
+MCP_STATIC McpHciSeqInFlightCmd *_MCP_HciSeq_MatchInFlight (MCP_HciSeq_Context *pContext, CcmaClientEvent *pEvent)
+{
+    CcmaHciEventData        *pEventData = &(pEvent->data.hciEventData);
+    McpHciSeqInFlightCmd    *pOldest = NULL, *pMatch = NULL, *pInFlight;
+    McpU16                  uOpcode = 0;
+    McpBool                 bHasOpcode = MCP_FALSE;
+    McpU32                  uIndex;
+
+    /* Command Complete: num packets, opcode. Command Status: status, num packets, opcode */
+    if ((CCMA_HCI_EVENT_COMMAND_COMPLETE == pEventData->eventType) && (3 <= pEventData->parmLen))
+    {
+        uOpcode = MCP_ENDIAN_LEtoHost16 (&(pEventData->parms[ 1 ]));
+        bHasOpcode = MCP_TRUE;
+    }
+    else if ((CCMA_HCI_EVENT_COMMAND_STATUS == pEventData->eventType) && (4 <= pEventData->parmLen))
+    {
+        uOpcode = MCP_ENDIAN_LEtoHost16 (&(pEventData->parms[ 2 ]));
+        bHasOpcode = MCP_TRUE;
+    }
+
+    for (uIndex = 0; uIndex < HCI_SEQ_MAX_CMDS_IN_FLIGHT; uIndex++)
+    {
+        pInFlight = &(pContext->inFlightCommands[ uIndex ]);
+
+        if (MCP_FALSE == pInFlight->bInUse)
+        {
+            continue;
+        }
+
+        /* send order may wrap around - compare the difference */
+        if ((NULL == pOldest) || (0 > (McpS32)(pInFlight->uSendOrder - pOldest->uSendOrder)))
+        {
+            pOldest = pInFlight;
+        }
+
+        if ((MCP_TRUE == bHasOpcode) && ((McpU16)pInFlight->command.eHciOpcode == uOpcode) &&
+            ((NULL == pMatch) || (0 > (McpS32)(pInFlight->uSendOrder - pMatch->uSendOrder))))
+        {
+            pMatch = pInFlight;
+        }
+    }
+
+    return ((NULL != pMatch) ? pMatch : pOldest);
+}
+
+/*---------------------------------------------------------------------------
+ *            _MCP_HciSeq_WindowSize()
+ *---------------------------------------------------------------------------
+ *
+ * Synopsis:  Limits the requested window to what the context transport allows
+ *
+ */
+MCP_STATIC McpU32 _MCP_HciSeq_WindowSize (MCP_HciSeq_Context *pContext, McpU32 uWindowSize)
+{
+    /* the FM transport holds a single VAC command completion */
+    if (MCP_HAL_CORE_ID_BT != pContext->coreId)
+    {
+        return 1;
+    }
+
+    /* the BT transport (HCIA, or the shared transport HCI HAL) holds back commands it has no credit for */
+    if (HCI_SEQ_MAX_CMDS_IN_FLIGHT < uWindowSize)
+    {
+        return HCI_SEQ_MAX_CMDS_IN_FLIGHT;
+    }
+
+    return ((0 == uWindowSize) ? 1 : uWindowSize);
+}
+
+/*---------------------------------------------------------------------------
+ *            _MCP_HciSeq_IsPreviousSequencePending()
+ *---------------------------------------------------------------------------
+ *
+ * Synopsis:  Checks whether commands sent for a previous sequence did not complete yet
+ *
+ */
+MCP_STATIC McpBool _MCP_HciSeq_IsPreviousSequencePending (MCP_HciSeq_Context *pContext)
+{
+    McpU32  uIndex;
+
+    if (MCP_TRUE == pContext->bPendingCommand)
+    {
+        return MCP_TRUE;
+    }
+
+    for (uIndex = 0; uIndex < HCI_SEQ_MAX_CMDS_IN_FLIGHT; uIndex++)
+    {
+        if ((MCP_TRUE == pContext->inFlightCommands[ uIndex ].bInUse) &&
+            (pContext->inFlightCommands[ uIndex ].uSequenceId != pContext->uSequenceId))
+        {
+            return MCP_TRUE;
+        }
+    }
+
+    return MCP_FALSE;
+}
+
+/*---------------------------------------------------------------------------
+ *            _MCP_HciSeq_SequenceCompleted()
+ *---------------------------------------------------------------------------
+ *
+ * Synopsis:  Accumulates the timing of a sequence that ran to completion
+ *
+ */
+MCP_STATIC void _MCP_HciSeq_SequenceCompleted (MCP_HciSeq_Context *pContext)
+{
+    McpHalOsTimeInMs    uDuration = MCP_HAL_OS_GetSystemTime() - pContext->uSequenceStartTime;
+
+    pContext->stats.uSequencesCompleted++;
+    pContext->stats.uLastSequenceTime = uDuration;
+    pContext->stats.uTotalSequenceTime += uDuration;
+    if (uDuration > pContext->stats.uMaxSequenceTime)
+    {
+        pContext->stats.uMaxSequenceTime = uDuration;
     }
 }
 
@@ -269,6 +634,11 @@ CcmaStatus _MCP_HciSeq_SendCommand(MCP_HciSeq_Context *pContext)
 #endif      
     }
 
+    /* a command that was not sent will not complete */
+    if (CCMA_STATUS_PENDING != status)
+    {
+        pContext->bPendingCommand = MCP_FALSE;
+    }
+
     return (status);
 }
-
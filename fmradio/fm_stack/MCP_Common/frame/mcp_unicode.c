@@ -108,6 +108,27 @@ typedef enum _McpUniConversionFlags
 	lenientConversion
 } McpUniConversionFlags;
 
+/* Native machine word, processed at once by the ASCII fast paths */
+typedef unsigned long McpUniWord;
+
+/* 
+ * MCP_StrLenUtf8 finds the terminator with aligned word loads, which may read
+ * the bytes following it within the same word. An aligned word never crosses
+ * a page, but address sanitizers flag the read, and the load aliases the
+ * string's bytes.
+ */
+#ifdef __GNUC__
+typedef McpUniWord __attribute__((__may_alias__)) McpUniAliasWord;
+#else
+typedef McpUniWord McpUniAliasWord;
+#endif
+
+#if defined(__clang__) || (defined(__GNUC__) && ((__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 8))))
+#define MCP_UNI_NO_SANITIZE_ADDRESS             __attribute__((__no_sanitize_address__))
+#else
+#define MCP_UNI_NO_SANITIZE_ADDRESS
+#endif
+
 /******************************************************************************* 
  *
  * Macros
@@ -150,6 +171,21 @@ typedef enum _McpUniConversionFlags
 #define MCP_UNI_SUR_LOW_START           ((McpU32) 0xDC00)
 #define MCP_UNI_SUR_LOW_END             ((McpU32) 0xDFFF)
 
+/* 
+ * Word-at-a-time (SWAR) constants used by the ASCII fast paths. They are
+ * derived from the word size, so the same code handles 32 and 64 bit hosts:
+ *   MCP_UNI_WORD_ONES_8      - 0x01 in every byte
+ *   MCP_UNI_WORD_HIGHS_8     - 0x80 in every byte (non ASCII bits)
+ *   MCP_UNI_WORD_NON_ASCII_16 - bits which are set in a UTF-16 unit > 0x7F,
+ *       for each unit of the word, in host byte order and byte swapped.
+ */
+#define MCP_UNI_WORD_SIZE                       (sizeof(McpUniWord))
+#define MCP_UNI_WORD_ONES_8                     ((McpUniWord)(~(McpUniWord)0 / 0xFF))
+#define MCP_UNI_WORD_HIGHS_8                    (MCP_UNI_WORD_ONES_8 * 0x80)
+#define MCP_UNI_WORD_ONES_16                    ((McpUniWord)(~(McpUniWord)0 / 0xFFFF))
+#define MCP_UNI_WORD_NON_ASCII_16               (MCP_UNI_WORD_ONES_16 * 0xFF80)
+#define MCP_UNI_WORD_NON_ASCII_16_SWAPPED       (MCP_UNI_WORD_ONES_16 * 0x80FF)
+
 /********************************************************************************
  *
  * Data Structures
@@ -190,6 +226,21 @@ static McpBool McpUniIsLegalUTF8Sequence(const McpUtf8 *source,
 static McpBool McpUniIsLegalUTF8(const McpUtf8 *source,
                                  McpU8 length);
 
+static McpBool McpUniConvertAsciiToUTF16(const McpUtf8 **sourceStart,
+                                         const McpUtf8 *sourceEnd,
+                                         McpUtf16 **targetStart,
+                                         McpUtf16 *targetEnd,
+                                         McpUniEndianity endianity);
+
+static McpBool McpUniConvertAsciiFromUTF16(const McpUtf16 **sourceStart,
+                                           const McpUtf16 *sourceEnd,
+                                           McpUtf8 **targetStart,
+                                           McpUtf8 *targetEnd,
+                                           McpUniEndianity endianity,
+                                           McpUniWord nonAsciiMask);
+
+static McpUniWord McpUniNonAsciiMaskUTF16(McpUniEndianity endianity);
+
 /********************************************************************************
  *
  * Internal functions definitions
@@ -206,6 +257,7 @@ static McpUniConversionResult McpUniConvertUTF16toUTF8(const McpUtf16 **sourceSt
   McpUniConversionResult result = conversionOK;
   const McpUtf16 *source = *sourceStart;
   McpUtf8 *target = *targetStart;
+  const McpUniWord nonAsciiMask = McpUniNonAsciiMaskUTF16(endianity);
 
   while (source < sourceEnd)
   {
@@ -217,6 +269,17 @@ static McpUniConversionResult McpUniConvertUTF16toUTF8(const McpUtf16 **sourceSt
     const McpUtf16* oldSource = source; /* In case we have to back up because of
                                            target overflow. */
 
+    /* Runs of ASCII characters are copied a word at a time */
+    if (MCP_TRUE == McpUniConvertAsciiFromUTF16(&source,
+                                                sourceEnd,
+                                                &target,
+                                                targetEnd,
+                                                endianity,
+                                                nonAsciiMask))
+    {
+      continue;
+    }
+
     /* Read next UTF-16 word, according the defined endianity. */
     MCP_UNI_READ_UTF16(endianity, source, &ch16)
     ch = (McpU32) ch16; /* Use 32 bit value for calculations. */
@@ -412,7 +475,20 @@ static McpUniConversionResult McpUniConvertUTF8toUTF16(const McpUtf8 **sourceSta
   while (source < sourceEnd)
   {
     McpU32 ch = 0;
-    unsigned short extraBytesToRead = mcpUni_trailingBytesForUTF8[*source];
+    unsigned short extraBytesToRead;
+
+    /* Runs of ASCII characters are converted a word at a time */
+    if ((*source < 0x80) &&
+        (MCP_TRUE == McpUniConvertAsciiToUTF16(&source,
+                                               sourceEnd,
+                                               &target,
+                                               targetEnd,
+                                               endianity)))
+    {
+      continue;
+    }
+
+    extraBytesToRead = mcpUni_trailingBytesForUTF8[*source];
 
     if (source + extraBytesToRead >= sourceEnd)
     {
@@ -513,6 +589,145 @@ static McpUniConversionResult McpUniConvertUTF8toUTF16(const McpUtf8 **sourceSta
   return result;
 }
 
+/* -------------------------------------------------------------------------- */
+
+/*
+ * ASCII fast path of the UTF-8 to UTF-16 conversion. Converts as many whole
+ * words of 7-bit characters as are available in the source and fit in the
+ * target, testing all bytes of a word with a single mask.
+ * Returns MCP_TRUE if anything was converted; otherwise the caller converts
+ * the next character the regular way.
+ */
+static McpBool McpUniConvertAsciiToUTF16(const McpUtf8 **sourceStart,
+                                         const McpUtf8 *sourceEnd,
+                                         McpUtf16 **targetStart,
+                                         McpUtf16 *targetEnd,
+                                         McpUniEndianity endianity)
+{
+  const McpUtf8 *source = *sourceStart;
+  McpUtf16 *target = *targetStart;
+  McpUniWord word;
+  McpU32 i;
+
+  while (((McpU32)(sourceEnd - source) >= MCP_UNI_WORD_SIZE) &&
+         ((McpU32)(targetEnd - target) >= MCP_UNI_WORD_SIZE))
+  {
+    memcpy(&word, source, MCP_UNI_WORD_SIZE);
+
+    if (0 != (word & MCP_UNI_WORD_HIGHS_8))
+    {
+      break;
+    }
+
+    if (endianity == mcpNativeEndian)
+    {
+      for (i = 0; i < MCP_UNI_WORD_SIZE; i++)
+      {
+        target[i] = (McpUtf16)source[i];
+      }
+      target += MCP_UNI_WORD_SIZE;
+    }
+    else
+    {
+      for (i = 0; i < MCP_UNI_WORD_SIZE; i++)
+      {
+        MCP_UNI_WRITE_UTF16(endianity, target, (McpU16)source[i])
+        target++;
+      }
+    }
+
+    source += MCP_UNI_WORD_SIZE;
+  }
+
+  if (source == *sourceStart)
+  {
+    return MCP_FALSE;
+  }
+
+  *sourceStart = source;
+  *targetStart = target;
+
+  return MCP_TRUE;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/*
+ * ASCII fast path of the UTF-16 to UTF-8 conversion, the counterpart of
+ * McpUniConvertAsciiToUTF16. 'nonAsciiMask' is the mask returned by
+ * McpUniNonAsciiMaskUTF16 for the source endianity.
+ */
+static McpBool McpUniConvertAsciiFromUTF16(const McpUtf16 **sourceStart,
+                                           const McpUtf16 *sourceEnd,
+                                           McpUtf8 **targetStart,
+                                           McpUtf8 *targetEnd,
+                                           McpUniEndianity endianity,
+                                           McpUniWord nonAsciiMask)
+{
+  const McpU32 unitsPerWord = MCP_UNI_WORD_SIZE / sizeof(McpUtf16);
+  const McpUtf16 *source = *sourceStart;
+  McpUtf8 *target = *targetStart;
+  McpUniWord word;
+  McpU16 ch16;
+  McpU32 i;
+
+  while (((McpU32)(sourceEnd - source) >= unitsPerWord) &&
+         ((McpU32)(targetEnd - target) >= unitsPerWord))
+  {
+    memcpy(&word, source, MCP_UNI_WORD_SIZE);
+
+    if (0 != (word & nonAsciiMask))
+    {
+      break;
+    }
+
+    for (i = 0; i < unitsPerWord; i++)
+    {
+      MCP_UNI_READ_UTF16(endianity, source, &ch16)
+      *target++ = (McpUtf8)ch16;
+      source++;
+    }
+  }
+
+  if (source == *sourceStart)
+  {
+    return MCP_FALSE;
+  }
+
+  *sourceStart = source;
+  *targetStart = target;
+
+  return MCP_TRUE;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/*
+ * Returns the mask of the bits set in a word of UTF-16 units read from memory,
+ * when any of the units, stored in the given endianity, is not ASCII.
+ */
+static McpUniWord McpUniNonAsciiMaskUTF16(McpUniEndianity endianity)
+{
+  const McpU16 probe = 1;
+  McpUniEndianity hostEndianity;
+
+  if (endianity == mcpNativeEndian)
+  {
+    return MCP_UNI_WORD_NON_ASCII_16;
+  }
+
+  hostEndianity = (1 == *(const McpU8 *)&probe) ? mcpLittleEndian : mcpBigEndian;
+
+  if (endianity == hostEndianity)
+  {
+    return MCP_UNI_WORD_NON_ASCII_16;
+  }
+  else
+  {
+    return MCP_UNI_WORD_NON_ASCII_16_SWAPPED;
+  }
+}
+
 
 /*******************************************************************************
  *
@@ -595,14 +810,57 @@ McpU16 MCP_Utf8ToUtf16Endian(McpUtf16 *tgtText,
   return (McpU16) (2*(targetStart - tgtText));
 }
 
-McpU16 MCP_StrLenUtf8(const McpUtf8 *str)
+MCP_UNI_NO_SANITIZE_ADDRESS McpU16 MCP_StrLenUtf8(const McpUtf8 *str)
 {
-  McpUtf8 *source = (McpUtf8 *)str;
+  const McpUtf8 *source = str;
   McpU16 len = 0;
-    
-  while (*source)
+  McpUniWord word;
+  McpU8 extraBytesToRead;
+  McpU8 i;
+
+  while (1)
   {
-    McpU8 extraBytesToRead = mcpUni_trailingBytesForUTF8[*source];
+    /* 
+     * Count ASCII runs a word at a time from aligned addresses only, so the
+     * load never crosses into the next page. The test below is non zero
+     * when the word holds the terminator or a non ASCII byte, these are
+     * then handled one byte at a time.
+     */
+    while (0 == ((McpUniWord)source & (MCP_UNI_WORD_SIZE - 1)))
+    {
+      word = *(const McpUniAliasWord *)source;
+
+      if (0 != ((word | (word - MCP_UNI_WORD_ONES_8)) & MCP_UNI_WORD_HIGHS_8))
+      {
+        break;
+      }
+
+      source += MCP_UNI_WORD_SIZE;
+      len = (McpU16)(len + MCP_UNI_WORD_SIZE);
+    }
+
+    if (0 == *source)
+    {
+      break;
+    }
+
+    if (*source < 0x80)
+    {
+      source++;
+      len = (McpU16)(len + 1);
+      continue;
+    }
+
+    extraBytesToRead = mcpUni_trailingBytesForUTF8[*source];
+
+    /* A sequence cut by the terminator is illegal */
+    for (i = 1; i <= extraBytesToRead; i++)
+    {
+      if (0 == source[i])
+      {
+        return (0);
+      }
+    }
 
     /* Do this check whether lenient or strict */
     if (MCP_FALSE == McpUniIsLegalUTF8(source, (McpU8)(extraBytesToRead + 1)))
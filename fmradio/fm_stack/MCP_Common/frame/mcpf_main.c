@@ -35,6 +35,9 @@
 /*							Internal Function							*/
 /************************************************************************/
 EMcpfRes		mcpf_TaskProc (handle_t	hMcpf, EmcpTaskId	eTaskId);
+static McpU32	mcpf_HandleQueue (handle_t hMcpf, TMcpfTask *pTask, handle_t hQue, McpU32 uQindx, 
+								  McpU32 uMaxMsgs, McpBool *pbMsgsLeft);
+static void		mcpf_ReportTaskStat (handle_t hMcpf, EmcpTaskId eTaskId);
 
 
 /** MCPF APIs - Initialization **/
@@ -184,13 +187,23 @@ EMcpfRes		mcpf_CreateTask (handle_t 		hMcpf,
 	pMcpf->tTask[eTaskId]->fQueueCb		 = mcpf_mem_alloc(hMcpf, (McpU16)(sizeof(mcpf_msg_handler_cb) * (uNum_of_queues + 1)));
     pMcpf->tTask[eTaskId]->hQueCbHandler = mcpf_mem_alloc(hMcpf, (McpU16)(sizeof(handle_t) * (uNum_of_queues + 1)));
 	pMcpf->tTask[eTaskId]->bQueueFlag	 = mcpf_mem_alloc(hMcpf, (McpU16)(sizeof(McpBool) * (uNum_of_queues + 1)));
-	/*  Set all 'bQueueFlag' fields to be disabled.	*/
+	pMcpf->tTask[eTaskId]->hUrgentQueue	 = mcpf_mem_alloc(hMcpf, (McpU16)(sizeof(handle_t) * (uNum_of_queues + 1)));
+	pMcpf->tTask[eTaskId]->uQueueWeight	 = mcpf_mem_alloc(hMcpf, (McpU16)(sizeof(McpU32) * (uNum_of_queues + 1)));
+	pMcpf->tTask[eTaskId]->tQueueStat	 = mcpf_mem_alloc(hMcpf, (McpU16)(sizeof(TMcpfQueueStat) * (uNum_of_queues + 1)));
+	mcpf_mem_zero(hMcpf, pMcpf->tTask[eTaskId]->tQueueStat, sizeof(TMcpfQueueStat) * (uNum_of_queues + 1));
+	/*  Set all 'bQueueFlag' fields to be disabled, queues without urgent lane and weight.	*/
 	for(i = 0; i <= uNum_of_queues; i++)
+	{
 		pMcpf->tTask[eTaskId]->bQueueFlag[i] = MCP_FALSE;
+		pMcpf->tTask[eTaskId]->hUrgentQueue[i] = NULL;
+		pMcpf->tTask[eTaskId]->uQueueWeight[i] = QUE_MAX_LIMIT;
+	}
 
-	/* Create Timer's Queue */
+	/* Create Timer's Queue, timer expirations are sent to its urgent lane */
 	pMcpf->tTask[eTaskId]->hQueue[0] = mcpf_que_Create(hMcpf, QUE_MAX_LIMIT, 
 														MCPF_FIELD_OFFSET(TmcpfMsg, tMsgQNode));
+	pMcpf->tTask[eTaskId]->hUrgentQueue[0] = mcpf_que_Create(hMcpf, QUE_MAX_LIMIT, 
+															MCPF_FIELD_OFFSET(TmcpfMsg, tMsgQNode));
 	pMcpf->tTask[eTaskId]->fQueueCb[0] = mcpf_handleTimer;
 	pMcpf->tTask[eTaskId]->hQueCbHandler[0] = hMcpf;
 	pMcpf->tTask[eTaskId]->bQueueFlag[0] = MCP_TRUE;
@@ -209,6 +222,8 @@ EMcpfRes		mcpf_CreateTask (handle_t 		hMcpf,
 	/* Set Destroy Flag to FALSE */
 	pMcpf->tTask[eTaskId]->bDestroyTask = MCP_FALSE;
 
+	mcpf_mem_zero(hMcpf, &pMcpf->tTask[eTaskId]->tStat, sizeof(TMcpfTaskStat));
+
 	/* Set task's Send Cb function */
 	pMcpf->tClientsTable[eTaskId].fCb = (tClientSendCb)mcpf_EnqueueMsg;
 	pMcpf->tClientsTable[eTaskId].hCb = hMcpf;
@@ -282,12 +297,17 @@ EMcpfRes		mcpf_RegisterTaskQ (handle_t hMcpf, EmcpTaskId eTaskId, McpU8 uQueueId
 		return RES_ERROR;
 	}
 
-	/* Register Queue */
+	/* Register Queue and its urgent lane */
 	pMcpf->tTask[eTaskId]->hQueue[uQueueId] = mcpf_que_Create(hMcpf, QUE_MAX_LIMIT, 
 																MCPF_FIELD_OFFSET(TmcpfMsg, tMsgQNode));
+	pMcpf->tTask[eTaskId]->hUrgentQueue[uQueueId] = mcpf_que_Create(hMcpf, QUE_MAX_LIMIT, 
+																	MCPF_FIELD_OFFSET(TmcpfMsg, tMsgQNode));
 	pMcpf->tTask[eTaskId]->fQueueCb[uQueueId] = fCb;
 	pMcpf->tTask[eTaskId]->hQueCbHandler[uQueueId] = hCb;
 
+	/* A flood on this queue must not hold back the other queues of the task */
+	mcpf_SetTaskQWeight (hMcpf, eTaskId, uQueueId, MCPF_TASK_QUEUE_WEIGHT);
+
 	return RES_COMPLETE;
 }
 
@@ -317,6 +337,11 @@ EMcpfRes		mcpf_UnregisterTaskQ (handle_t hMcpf, EmcpTaskId	eTaskId, McpU8 uQueue
 
 	/* Unregister Queue */
 	mcpf_que_Destroy(pMcpf->tTask[eTaskId]->hQueue[uQueueId]);
+	if (pMcpf->tTask[eTaskId]->hUrgentQueue[uQueueId])
+	{
+		mcpf_que_Destroy(pMcpf->tTask[eTaskId]->hUrgentQueue[uQueueId]);
+		pMcpf->tTask[eTaskId]->hUrgentQueue[uQueueId] = NULL;
+	}
 
 	return RES_COMPLETE;
 }
@@ -342,6 +367,100 @@ EMcpfRes		mcpf_SetTaskPriority (handle_t hMcpf, EmcpTaskId eTask_id, McpInt sPri
 	return os_SetTaskPriority(pTask->hOsTaskHandle, sPriority);
 }
 
+/** 
+ * \fn     mcpf_GetTaskStat
+ * \brief  Get the task's statistics
+ * 
+ * This function copies the statistics counters of the given task.
+ * 
+ * \note
+ * \param	hMcpf     - MCPF handler.
+ * \param	eTask_id - Task ID.
+ * \param	pStat - pointer to the statistics structure to fill.
+ * \return 	Result of operation: OK or ERROR
+ * \sa     	mcpf_GetTaskStat
+ */ 
+EMcpfRes		mcpf_GetTaskStat (handle_t hMcpf, EmcpTaskId eTask_id, TMcpfTaskStat *pStat)
+{
+	Tmcpf		*pMcpf = (Tmcpf *)hMcpf;
+	TMcpfTask   	*pTask = pMcpf->tTask[eTask_id];
+
+	if (!pTask)
+	{
+		return RES_ERROR;
+	}
+
+	mcpf_critSec_Enter (hMcpf, pTask->hCritSecObj, MCPF_INFINIT);
+	mcpf_mem_copy (hMcpf, pStat, &pTask->tStat, sizeof(TMcpfTaskStat));
+	mcpf_critSec_Exit (hMcpf, pTask->hCritSecObj);
+
+	return RES_OK;
+}
+
+/** 
+ * \fn     mcpf_SetTaskQWeight
+ * \brief  Set the task queue's weight
+ * 
+ * This function sets the maximum number of messages handled from the queue 
+ * in one pass of the task loop.
+ * 
+ * \note   Messages left in the queue are handled by the next pass, after the 
+ *         other queues of the task. Urgent lane messages are not limited.
+ * \param	hMcpf - MCPF handler. 
+ * \param	eTaskId - Task ID.
+ * \param	uQueueId - Queue Index.
+ * \param	uWeight - Maximum number of messages per pass, 0 for no limit.
+ * \return 	Result of operation: OK or ERROR
+ * \sa     	mcpf_GetTaskQStat
+ */ 
+EMcpfRes		mcpf_SetTaskQWeight (handle_t hMcpf, EmcpTaskId eTaskId, McpU8 uQueueId, McpU32 uWeight)
+{
+	Tmcpf		*pMcpf = (Tmcpf *)hMcpf;
+	TMcpfTask   	*pTask = pMcpf->tTask[eTaskId];
+
+	/* Check if 'uQueueId' is valid */
+	if( (pTask == NULL) || (uQueueId >= pTask->uNumOfQueues) )
+	{
+		MCPF_REPORT_ERROR(hMcpf, MCPF_MODULE_LOG, ("mcpf_SetTaskQWeight: Queue ID is invalid!"));
+		return RES_ERROR;
+	}
+
+	pTask->uQueueWeight[uQueueId] = uWeight ? uWeight : QUE_MAX_LIMIT;
+
+	return RES_COMPLETE;
+}
+
+/** 
+ * \fn     mcpf_GetTaskQStat
+ * \brief  Get the task queue's statistics
+ * 
+ * This function copies the statistics counters of the given task queue.
+ * 
+ * \note
+ * \param	hMcpf - MCPF handler. 
+ * \param	eTaskId - Task ID.
+ * \param	uQueueId - Queue Index.
+ * \param	pStat - pointer to the statistics structure to fill.
+ * \return 	Result of operation: OK or ERROR
+ * \sa     	mcpf_SetTaskQWeight
+ */ 
+EMcpfRes		mcpf_GetTaskQStat (handle_t hMcpf, EmcpTaskId eTaskId, McpU8 uQueueId, TMcpfQueueStat *pStat)
+{
+	Tmcpf		*pMcpf = (Tmcpf *)hMcpf;
+	TMcpfTask   	*pTask = pMcpf->tTask[eTaskId];
+
+	if( (pTask == NULL) || (uQueueId >= pTask->uNumOfQueues) )
+	{
+		return RES_ERROR;
+	}
+
+	mcpf_critSec_Enter (hMcpf, pTask->hCritSecObj, MCPF_INFINIT);
+	mcpf_mem_copy (hMcpf, pStat, &pTask->tQueueStat[uQueueId], sizeof(TMcpfQueueStat));
+	mcpf_critSec_Exit (hMcpf, pTask->hCritSecObj);
+
+	return RES_OK;
+}
+
 /** Internal Functions **/
 
 /** 
@@ -351,7 +470,10 @@ EMcpfRes		mcpf_SetTaskPriority (handle_t hMcpf, EmcpTaskId eTask_id, McpInt sPri
  * Wait on task signaling object and having received it process event bitmask and 
  * task queues
  * 
- * \note
+ * \note   Urgent lanes of all the queues are handled first, then each queue up to its 
+ *         weight. Messages of a queue are moved to a local list by one lock acquisition 
+ *         per pass and handled without the lock. Messages arriving meanwhile or left 
+ *         because of the weight are handled by the next pass.
  * \param	hMcpf     - handle to OS Framework
  * \param	eTaskId   - task ID
  * \return 	Result of operation: OK or ERROR
@@ -364,7 +486,10 @@ EMcpfRes	mcpf_TaskProc (handle_t	hMcpf, EmcpTaskId	eTaskId)
 	McpU32		uEvent = 0;
 	EMcpfRes  	res;
 	McpU32		uQindx;
-	TmcpfMsg	*pMsg;
+	McpU32		uMsgNum;
+	McpU32		uPassMsgs;
+	McpBool		bMsgsLeft;
+	McpBool		bPassMsgsLeft;
 
 	CL_TRACE_TASK_DEF();
 
@@ -390,6 +515,7 @@ EMcpfRes	mcpf_TaskProc (handle_t	hMcpf, EmcpTaskId	eTaskId)
 			}
 
 			/* Check event bitmap and invoke task event handler if event bitmap is set */
+			uEvent = 0;
 			mcpf_critSec_Enter (hMcpf, pTask->hCritSecObj, MCPF_INFINIT);
 			if (pTask->uEvntBitmap && pTask->fEvntCb)
 			{
@@ -403,38 +529,70 @@ EMcpfRes	mcpf_TaskProc (handle_t	hMcpf, EmcpTaskId	eTaskId)
 				pTask->fEvntCb (pTask->hEvtCbHandler, uEvent);
 			}
 
-			/* Check event queues and invoke task queue event handler if there is a message */
+			/* Handle urgent lane messages of all the queues first */
+			uPassMsgs = 0;
 			for (uQindx = 0; uQindx < pTask->uNumOfQueues; uQindx++)
 			{
-				do
+				if (pTask->hUrgentQueue[ uQindx ])
 				{
+					uMsgNum = mcpf_HandleQueue (hMcpf, pTask, pTask->hUrgentQueue[ uQindx ], uQindx, 
+												QUE_MAX_LIMIT, &bMsgsLeft);
+					uPassMsgs += uMsgNum;
+
 					mcpf_critSec_Enter (hMcpf, pTask->hCritSecObj, MCPF_INFINIT);
-					if (pTask->bQueueFlag[ uQindx ])
-					{
-						pMsg = (TmcpfMsg *) que_Dequeue (pTask->hQueue[ uQindx ]);
-					}
-					else
-					{
-						mcpf_critSec_Exit (hMcpf, pTask->hCritSecObj);
-						break;
-					}
+					pTask->tQueueStat[ uQindx ].uUrgentMsgs += uMsgNum;
 					mcpf_critSec_Exit (hMcpf, pTask->hCritSecObj);
+				}
+			}
 
-					if (pMsg)
-					{
-#ifdef DEBUG
-						MCPF_REPORT_INFORMATION(hMcpf, MCPF_MODULE_LOG, 
-									("DEQUEUED MSG FOR TASK #%d, FROM QUEUE #%d", eTaskId, uQindx));
-#endif
-						
-						pTask->fQueueCb[ uQindx ] (pTask->hQueCbHandler[ uQindx ], pMsg);
-					}
-					else
+			/* Check event queues and invoke task queue event handler up to the queue weight */
+			bPassMsgsLeft = MCP_FALSE;
+			for (uQindx = 0; uQindx < pTask->uNumOfQueues; uQindx++)
+			{
+				uMsgNum = mcpf_HandleQueue (hMcpf, pTask, pTask->hQueue[ uQindx ], uQindx, 
+											pTask->uQueueWeight[ uQindx ], &bMsgsLeft);
+				uPassMsgs += uMsgNum;
+
+				mcpf_critSec_Enter (hMcpf, pTask->hCritSecObj, MCPF_INFINIT);
+				pTask->tQueueStat[ uQindx ].uMsgs += uMsgNum;
+
+				/* Count the passes the queue was deferred because of its weight */
+				if (bMsgsLeft)
+				{
+					bPassMsgsLeft = MCP_TRUE;
+					pTask->tQueueStat[ uQindx ].uDeferredPasses++;
+					pTask->tQueueStat[ uQindx ].uCurrDeferredPasses++;
+					if (pTask->tQueueStat[ uQindx ].uCurrDeferredPasses > pTask->tQueueStat[ uQindx ].uMaxDeferredPasses)
 					{
-						break;
+						pTask->tQueueStat[ uQindx ].uMaxDeferredPasses = pTask->tQueueStat[ uQindx ].uCurrDeferredPasses;
 					}
-				} while (pMsg);
+				}
+				else
+				{
+					pTask->tQueueStat[ uQindx ].uCurrDeferredPasses = 0;
+				}
+				mcpf_critSec_Exit (hMcpf, pTask->hCritSecObj);
+			}
+
+			/* Schedule the next pass for the messages left because of the queue weight */
+			if (bPassMsgsLeft)
+			{
+				os_sigobj_set (pMcpf->hPla, pTask->hSignalObj);
 			}
+
+			/* Update the task statistics */
+			mcpf_critSec_Enter (hMcpf, pTask->hCritSecObj, MCPF_INFINIT);
+			pTask->tStat.uWakeups++;
+			pTask->tStat.uMsgs += uPassMsgs;
+			if (!uPassMsgs && !uEvent)
+			{
+				pTask->tStat.uEmptyWakeups++;
+			}
+			if (uPassMsgs > pTask->tStat.uMaxMsgsPerWakeup)
+			{
+				pTask->tStat.uMaxMsgsPerWakeup = uPassMsgs;
+			}
+			mcpf_critSec_Exit (hMcpf, pTask->hCritSecObj);
 		}
 		else
 		{
@@ -448,6 +606,8 @@ EMcpfRes	mcpf_TaskProc (handle_t	hMcpf, EmcpTaskId	eTaskId)
 	/* Unregister task's Send Cb function */
 	pMcpf->tClientsTable[eTaskId].fCb = NULL;
 	pMcpf->tClientsTable[eTaskId].hCb = NULL;
+
+	mcpf_ReportTaskStat (hMcpf, eTaskId);
 	
 	/*  Free Critical section & signaling object */
 	mcpf_critSec_DestroyObj(hMcpf, &pTask->hCritSecObj);
@@ -455,8 +615,12 @@ EMcpfRes	mcpf_TaskProc (handle_t	hMcpf, EmcpTaskId	eTaskId)
 						
 	/* Destroy Timer's Queue */
 	mcpf_que_Destroy(pTask->hQueue[0]);
+	mcpf_que_Destroy(pTask->hUrgentQueue[0]);
 					
 	/* Free Queues */
+	mcpf_mem_free(hMcpf, pTask->tQueueStat);
+	mcpf_mem_free(hMcpf, pTask->uQueueWeight);
+	mcpf_mem_free(hMcpf, pTask->hUrgentQueue);
 	mcpf_mem_free(hMcpf, pTask->bQueueFlag);
 	mcpf_mem_free(hMcpf, pTask->fQueueCb);
 	mcpf_mem_free(hMcpf, pTask->hQueue);
@@ -471,3 +635,105 @@ EMcpfRes	mcpf_TaskProc (handle_t	hMcpf, EmcpTaskId	eTaskId)
 	return RES_OK;
 }
 
+/** 
+ * \fn     mcpf_HandleQueue 
+ * \brief  Handle task queue messages
+ * 
+ * Moves up to uMaxMsgs messages of the queue to a local list by one lock acquisition 
+ * and invokes the task queue handler for each message without the lock
+ * 
+ * \note   If the handler disables the queue, the rest of messages is returned to the queue
+ * \param	hMcpf      - handle to OS Framework
+ * \param	pTask      - pointer to task object
+ * \param	hQue       - queue or urgent lane queue to handle
+ * \param	uQindx     - queue index
+ * \param	uMaxMsgs   - maximum number of messages to handle
+ * \param	pbMsgsLeft - returns whether messages are left in the enabled queue
+ * \return 	Number of handled messages
+ * \sa     	mcpf_TaskProc
+ */
+static McpU32	mcpf_HandleQueue (handle_t hMcpf, TMcpfTask *pTask, handle_t hQue, McpU32 uQindx, 
+								  McpU32 uMaxMsgs, McpBool *pbMsgsLeft)
+{
+	MCP_DL_LIST_Node tMsgList;
+	TmcpfMsg	*pMsg;
+	McpU32		uMsgNum = 0;
+	McpU32		uHandled = 0;
+
+	*pbMsgsLeft = MCP_FALSE;
+
+	/* Take the queued messages by one lock acquisition */
+	mcpf_critSec_Enter (hMcpf, pTask->hCritSecObj, MCPF_INFINIT);
+	if (pTask->bQueueFlag[ uQindx ])
+	{
+		uMsgNum = que_DequeueBatch (hQue, &tMsgList, uMaxMsgs);
+		*pbMsgsLeft = (que_Size (hQue) != 0);
+	}
+	mcpf_critSec_Exit (hMcpf, pTask->hCritSecObj);
+
+	while (uMsgNum)
+	{
+		pMsg = (TmcpfMsg *) ((McpU8 *) MCP_DL_LIST_RemoveHead (&tMsgList) - 
+							 MCPF_FIELD_OFFSET(TmcpfMsg, tMsgQNode));
+		uMsgNum--;
+		uHandled++;
+#ifdef DEBUG
+		MCPF_REPORT_INFORMATION(hMcpf, MCPF_MODULE_LOG, 
+					("DEQUEUED MSG FOR TASK, FROM QUEUE #%d", uQindx));
+#endif
+		
+		pTask->fQueueCb[ uQindx ] (pTask->hQueCbHandler[ uQindx ], pMsg);
+
+		if (!pTask->bQueueFlag[ uQindx ])
+		{
+			/* The queue was disabled by the handler, return the rest of messages */
+			mcpf_critSec_Enter (hMcpf, pTask->hCritSecObj, MCPF_INFINIT);
+			que_RequeueAll (hQue, &tMsgList, uMsgNum);
+			mcpf_critSec_Exit (hMcpf, pTask->hCritSecObj);
+			uMsgNum = 0;
+			*pbMsgsLeft = MCP_FALSE;
+		}
+	}
+
+	return uHandled;
+}
+
+/** 
+ * \fn     mcpf_ReportTaskStat 
+ * \brief  Report task statistics
+ * 
+ * Reports the task statistics and the statistics of each of its queues
+ * 
+ * \note   Called by the task before its resources are freed
+ * \param	hMcpf     - handle to OS Framework
+ * \param	eTaskId   - task ID
+ * \return 	void
+ * \sa     	mcpf_GetTaskStat, mcpf_GetTaskQStat
+ */
+static void		mcpf_ReportTaskStat (handle_t hMcpf, EmcpTaskId eTaskId)
+{
+	Tmcpf			*pMcpf = (Tmcpf *)hMcpf;
+	TMcpfTaskStat	tTaskStat;
+	TMcpfQueueStat	tQueueStat;
+	McpU8			uQindx;
+
+	if (mcpf_GetTaskStat (hMcpf, eTaskId, &tTaskStat) != RES_OK)
+	{
+		return;
+	}
+
+	MCPF_REPORT_INFORMATION(hMcpf, MCPF_MODULE_LOG, 
+		("Task %s: wakeups %u, empty %u, msgs %u, max msgs per wakeup %u", pMcpf->tTask[eTaskId]->cName,
+		 tTaskStat.uWakeups, tTaskStat.uEmptyWakeups, tTaskStat.uMsgs, tTaskStat.uMaxMsgsPerWakeup));
+
+	for (uQindx = 0; uQindx < pMcpf->tTask[eTaskId]->uNumOfQueues; uQindx++)
+	{
+		if (mcpf_GetTaskQStat (hMcpf, eTaskId, uQindx, &tQueueStat) == RES_OK)
+		{
+			MCPF_REPORT_INFORMATION(hMcpf, MCPF_MODULE_LOG, 
+				("Task %s queue %u: msgs %u, urgent %u, deferred passes %u, max consecutive %u", 
+				 pMcpf->tTask[eTaskId]->cName, uQindx, tQueueStat.uMsgs, tQueueStat.uUrgentMsgs,
+				 tQueueStat.uDeferredPasses, tQueueStat.uMaxDeferredPasses));
+		}
+	}
+}
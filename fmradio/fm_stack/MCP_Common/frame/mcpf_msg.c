@@ -43,6 +43,13 @@
 /************************************************************************
  * Internal functions prototypes
  ************************************************************************/
+static TmcpfMsg *mcpf_AllocMsg (handle_t		hMcpf,
+								EmcpTaskId	eSrcTaskId,
+								McpU8			uSrcQId,
+								McpU16		uOpcode,
+								McpU32		uLen,
+								McpU32		uUserDefined,
+								void 			*pData);
 
 
 /************************************************************************
@@ -69,17 +76,10 @@ EMcpfRes	mcpf_SendMsg (handle_t		hMcpf,
 	Tmcpf		*pMcpf = (Tmcpf	*) hMcpf;
 	TmcpfMsg	*pMsg;
 
-	pMsg = (TmcpfMsg *)mcpf_mem_alloc_from_pool (hMcpf, pMcpf->hMsgPool);
+	pMsg = mcpf_AllocMsg (hMcpf, eSrcTaskId, uSrcQId, uOpcode, uLen, uUserDefined, pData);
 
 	if (pMsg != NULL)
 	{
-		pMsg->eSrcTaskId = eSrcTaskId;
-		pMsg->uSrcQId = uSrcQId;
-		pMsg->uOpcode = uOpcode;
-		pMsg->uLen 	  = uLen;
-		pMsg->uUserDefined = uUserDefined;
-		pMsg->pData   = pData;
-
 		if (pMcpf->tClientsTable[eDestTaskId].fCb) 
 		{
 			pMcpf->tClientsTable[eDestTaskId].fCb (pMcpf->tClientsTable[eDestTaskId].hCb, 
@@ -103,6 +103,58 @@ EMcpfRes	mcpf_SendMsg (handle_t		hMcpf,
 	return (RES_OK);
 }
 
+/** 
+ * \fn     mcpf_SendUrgentMsg
+ * \brief  Send urgent MCPF message
+ * 
+ * Send the message to the urgent lane of the destination queue, handled before 
+ * all the task queues. Sent as normal message if the queue has no urgent lane.
+ * 
+ */ 
+EMcpfRes	mcpf_SendUrgentMsg (handle_t		hMcpf,
+								EmcpTaskId	eDestTaskId,
+								McpU8			uDestQId,
+								EmcpTaskId	eSrcTaskId,
+								McpU8			uSrcQId,
+								McpU16		uOpcode,
+								McpU32		uLen,
+								McpU32		uUserDefined,
+								void 			*pData)
+{
+	Tmcpf		*pMcpf = (Tmcpf	*) hMcpf;
+	TMcpfTask   *pTask;
+	TmcpfMsg	*pMsg;
+	EMcpfRes   res;
+
+	/* External clients and queues without urgent lane get normal message */
+	pTask = (eDestTaskId < TASK_MAX_ID) ? pMcpf->tTask[ eDestTaskId ] : NULL;
+	if ((pTask == NULL) || (uDestQId >= pTask->uNumOfQueues) || (pTask->hUrgentQueue[ uDestQId ] == NULL))
+	{
+		return mcpf_SendMsg (hMcpf, eDestTaskId, uDestQId, eSrcTaskId, uSrcQId, 
+							 uOpcode, uLen, uUserDefined, pData);
+	}
+
+	pMsg = mcpf_AllocMsg (hMcpf, eSrcTaskId, uSrcQId, uOpcode, uLen, uUserDefined, pData);
+	if (pMsg == NULL)
+	{
+		return (RES_MEM_ERROR);
+	}
+
+	mcpf_critSec_Enter (hMcpf, pTask->hCritSecObj, MCPF_INFINIT);
+
+	res = que_Enqueue (pTask->hUrgentQueue[ uDestQId ], (handle_t) pMsg);
+
+	mcpf_critSec_Exit (hMcpf, pTask->hCritSecObj);
+
+	if (res != RES_OK)
+	{
+		mcpf_mem_free_from_pool (hMcpf, pMsg);
+		return RES_ERROR;
+	}
+
+	return os_sigobj_set (pMcpf->hPla, pTask->hSignalObj);
+}
+
 
 /** 
  * \fn     mcpf_MsgqEnable
@@ -285,3 +337,46 @@ EMcpfRes mcpf_EnqueueMsg (handle_t		hMcpf,
 /************************************************************************
  * Module Private Functions
  ************************************************************************/
+
+/** 
+ * \fn     mcpf_AllocMsg 
+ * \brief  Allocate MCPF message
+ * 
+ * Allocate MCPF message from the message pool and populate it's fields
+ * 
+ * \note
+ * \param	hMcpf     - handle to OS Framework
+ * \param   eSrcTaskId- source task ID
+ * \param   eSrcQId   - source queue ID to return response if any
+ * \param   uOpcode   - message opcode
+ * \param   uLen      - number of bytes in data buffer pointed by pData
+ * \param   uUserDefined - user defined parameter
+ * \param	pData		 - message data buffer
+ * \return 	Pointer to the message or NULL if allocation failed
+ * \sa     	mcpf_SendMsg, mcpf_SendUrgentMsg
+ */
+static TmcpfMsg *mcpf_AllocMsg (handle_t		hMcpf,
+								EmcpTaskId	eSrcTaskId,
+								McpU8			uSrcQId,
+								McpU16		uOpcode,
+								McpU32		uLen,
+								McpU32		uUserDefined,
+								void 			*pData)
+{
+	Tmcpf		*pMcpf = (Tmcpf	*) hMcpf;
+	TmcpfMsg	*pMsg;
+
+	pMsg = (TmcpfMsg *)mcpf_mem_alloc_from_pool (hMcpf, pMcpf->hMsgPool);
+
+	if (pMsg != NULL)
+	{
+		pMsg->eSrcTaskId = eSrcTaskId;
+		pMsg->uSrcQId = uSrcQId;
+		pMsg->uOpcode = uOpcode;
+		pMsg->uLen 	  = uLen;
+		pMsg->uUserDefined = uUserDefined;
+		pMsg->pData   = pData;
+	}
+
+	return pMsg;
+}
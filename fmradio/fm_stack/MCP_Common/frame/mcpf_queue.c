@@ -265,6 +265,83 @@ EMcpfRes que_Requeue (handle_t hQue, handle_t hItem)
 }
 
 
+/** 
+ * \fn     que_DequeueBatch
+ * \brief  Dequeue batch of items 
+ * 
+ * Move up to uMaxCount items from the queue's head to the given list head, 
+ * keeping the queue order
+ * 
+ * \note   The list nodes are the NodeHeader fields of the items
+ * \param  hQue      - The queue object
+ * \param  pList     - Head of the list to receive the items
+ * \param  uMaxCount - Maximum number of items to dequeue, QUE_MAX_LIMIT for all
+ * \return McpU32 - number of dequeued items
+ * \sa     que_RequeueAll
+ */ 
+McpU32 que_DequeueBatch (handle_t hQue, MCP_DL_LIST_Node *pList, McpU32 uMaxCount)
+{
+    TQueue *pQue = (TQueue *)hQue;
+    McpU32  uCount = pQue->uCount;
+    McpU32  i;
+
+    if (uCount && (uCount <= uMaxCount))
+    {
+        /* Take the whole queue */
+        MCP_DL_LIST_MoveList (pList, &pQue->tHead);
+        pQue->uCount = 0;
+        return uCount;
+    }
+
+    MCP_DL_LIST_InitializeHead (pList);
+
+    for (i = 0; i < uMaxCount && pQue->uCount; i++)
+    {
+        MCP_DL_LIST_InsertTail (pList, MCP_DL_LIST_RemoveHead (&pQue->tHead));
+        pQue->uCount--;
+    }
+
+    return i;
+}
+
+
+/** 
+ * \fn     que_RequeueAll
+ * \brief  Requeue list of items 
+ * 
+ * Insert all the list items at the queue's head, keeping the list order
+ * 
+ * \note   Used to return items taken by que_DequeueBatch, the queue limit is not checked
+ * \param  hQue   - The queue object
+ * \param  pList  - Head of the list of items, empty on return
+ * \param  uCount - Number of items in the list
+ * \return void
+ * \sa     que_DequeueBatch
+ */ 
+void que_RequeueAll (handle_t hQue, MCP_DL_LIST_Node *pList, McpU32 uCount)
+{
+    TQueue           *pQue = (TQueue *)hQue;
+    MCP_DL_LIST_Node *pFirst, *pLast;
+
+    if (MCP_DL_LIST_IsEmpty (pList))
+    {
+        return;
+    }
+
+    pFirst = pList->next;
+    pLast  = pList->prev;
+
+    /* Link the list between the queue head and the current first item */
+    pLast->next = pQue->tHead.next;
+    pQue->tHead.next->prev = pLast;
+    pQue->tHead.next = pFirst;
+    pFirst->prev = &pQue->tHead;
+
+    MCP_DL_LIST_InitializeHead (pList);
+    pQue->uCount += uCount;
+}
+
+
 /** 
  * \fn     que_Size
  * \brief  Return queue size 
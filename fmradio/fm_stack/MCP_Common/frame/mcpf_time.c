@@ -244,7 +244,7 @@ EMcpfRes	 	mcpf_timer_stop (handle_t hMcpf, handle_t hTimer)
 	for(i = 0; i < counter; i++)
 	{
 		pMcpfTimer = pExpiredTimersQ[i];
-		mcpf_SendMsg(hMcpf, 
+		mcpf_SendUrgentMsg(hMcpf, 
 					pMcpfTimer->eSource,	/* Destination task is the task that started the timer */
 					0,						/* Timer's Queue Id is alway 0 */
 					pMcpfTimer->eSource,	/* Source task is the task that started the timer */
@@ -420,7 +420,7 @@ static void 	mcpf_timer_callback(handle_t hMcpf, McpUint uTimerId)
 	for(i = 0; i < counter; i++)
 	{
 		pMcpfTimer = pExpiredTimersQ[i];
-		mcpf_SendMsg(hMcpf, 
+		mcpf_SendUrgentMsg(hMcpf, 
 					pMcpfTimer->eSource,	/* Destination task is the task that started the timer */
 					0,						/* Timer's Queue Id is alway 0 */
 					pMcpfTimer->eSource,	/* Source task is the task that started the timer */
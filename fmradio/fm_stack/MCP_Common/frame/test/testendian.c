@@ -0,0 +1,220 @@
+/*
+ * TI's FM Stack
+ *
+ * Copyright 2001-2010 Texas Instruments, Inc. - http://www.ti.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "mcpf_services.h"
+
+#define TEST_BUF_LEN        256
+#define TEST_NUM_OF_FIELDS  64
+#define TEST_LOOPS          200000
+
+McpU8   buf[TEST_BUF_LEN];
+McpU8   refBuf[TEST_BUF_LEN];
+McpU8   widths[TEST_NUM_OF_FIELDS];
+
+/* Bit at a time reference for the packed field readers and writers,
+ * the writer clears the rest of the field's last byte as mcpf_putBits does
+ */
+McpU32 RefGetBits(const McpU8 *pBuf, McpU32 uBitOffset, McpU32 uBitLength)
+{
+    McpU32  uVal = 0;
+    McpU32  uIndx;
+
+    for (uIndx = 0; uIndx < uBitLength; uIndx++, uBitOffset++)
+    {
+        uVal = (uVal << 1) | ((pBuf[uBitOffset >> 3] >> (7 - (uBitOffset & 7))) & 1);
+    }
+    return uVal;
+}
+
+void RefPutBits(McpU8 *pBuf, McpU32 uBitOffset, McpU32 uVal, McpU32 uBitLength)
+{
+    McpU32  uIndx;
+    McpU32  uBit;
+
+    for (uIndx = 0; uIndx < uBitLength; uIndx++, uBitOffset++)
+    {
+        uBit = (uBitLength - 1 - uIndx < 32) ? (uVal >> (uBitLength - 1 - uIndx)) & 1 : 0;
+        pBuf[uBitOffset >> 3] &= (McpU8) ~(0x80 >> (uBitOffset & 7));
+        pBuf[uBitOffset >> 3] |= (McpU8) (uBit << (7 - (uBitOffset & 7)));
+    }
+    if ((uBitLength > 0) && (uBitOffset & 7))
+    {
+        pBuf[uBitOffset >> 3] &= (McpU8) (0xFF << (8 - (uBitOffset & 7)));
+    }
+}
+
+void FillRandom(McpU8 *pBuf, McpU32 uLen)
+{
+    McpU32  uIndx;
+
+    for (uIndx = 0; uIndx < uLen; uIndx++)
+    {
+        pBuf[uIndx] = (McpU8) rand();
+    }
+}
+
+void TestGetBits(void)
+{
+    McpU32  uOfs;
+    McpU32  uLen;
+    McpU32  uBitOffset;
+    McpU32  uExpected;
+
+    FillRandom(buf, TEST_BUF_LEN);
+
+    for (uOfs = 0; uOfs < 64; uOfs++)
+    {
+        for (uLen = 0; uLen <= 40; uLen++)
+        {
+            /* a field longer than 32 bits returns its 32 least significant bits */
+            uExpected = (uLen > 32) ? RefGetBits(buf, uOfs + uLen - 32, 32) : RefGetBits(buf, uOfs, uLen);
+
+            uBitOffset = uOfs;
+            assert(mcpf_getBits(buf, &uBitOffset, uLen) == uExpected);
+            assert(uBitOffset == uOfs + uLen);
+        }
+    }
+}
+
+void TestPutBits(void)
+{
+    McpU32  uOfs;
+    McpU32  uLen;
+    McpU32  uVal;
+    McpU32  uBitOffset;
+
+    for (uOfs = 0; uOfs < 64; uOfs++)
+    {
+        for (uLen = 0; uLen <= 80; uLen++)
+        {
+            FillRandom(buf, TEST_BUF_LEN);
+            memcpy(refBuf, buf, TEST_BUF_LEN);
+            uVal = ((McpU32) rand() << 16) ^ (McpU32) rand();
+
+            uBitOffset = uOfs;
+            mcpf_putBits(buf, &uBitOffset, uVal, uLen);
+            RefPutBits(refBuf, uOfs, uVal, uLen);
+
+            assert(uBitOffset == uOfs + uLen);
+            assert(memcmp(buf, refBuf, TEST_BUF_LEN) == 0);
+        }
+    }
+}
+
+void TestBitStream(void)
+{
+    TMcpfBitStream  stream;
+    McpU32          values[TEST_NUM_OF_FIELDS];
+    McpU32          uOfs = 3;
+    McpU32          uIndx;
+
+    FillRandom(buf, TEST_BUF_LEN);
+    for (uIndx = 0; uIndx < TEST_NUM_OF_FIELDS; uIndx++)
+    {
+        widths[uIndx] = (McpU8) (rand() % 33);
+    }
+
+    mcpf_bitStream_Init(&stream, buf, TEST_BUF_LEN, uOfs);
+    mcpf_bitStream_GetFields(&stream, widths, TEST_NUM_OF_FIELDS, values);
+
+    for (uIndx = 0; uIndx < TEST_NUM_OF_FIELDS; uIndx++)
+    {
+        assert(values[uIndx] == RefGetBits(buf, uOfs, widths[uIndx]));
+        uOfs += widths[uIndx];
+    }
+    assert(stream.uBitOffset == uOfs);
+
+    /* the stream never reads beyond its buffer, missing bits read as zero */
+    mcpf_bitStream_Init(&stream, buf, 2, 12);
+    assert(mcpf_bitStream_GetBits(&stream, 8) == (RefGetBits(buf, 12, 4) << 4));
+
+    /* RDS block B: group type, B0, TP, PTY and the group specific bits */
+    {
+        static const McpU8 rdsWidths[] = {4, 1, 1, 5, 5};
+        McpU8   blockB[2] = {0x2D, 0x47};
+
+        mcpf_bitStream_Init(&stream, blockB, 2, 0);
+        mcpf_bitStream_GetFields(&stream, rdsWidths, 5, values);
+        assert(values[0] == 2 && values[1] == 1 && values[2] == 1);
+        assert(values[3] == 0x0A && values[4] == 0x07);
+    }
+}
+
+/* Throughput of the field by field reader against the bulk stream reader */
+void BenchGetBits(void)
+{
+    TMcpfBitStream  stream;
+    McpU32          values[TEST_NUM_OF_FIELDS];
+    McpU32          uBitOffset;
+    McpU32          uSum = 0;
+    McpU32          uLoop;
+    McpU32          uIndx;
+    clock_t         start;
+    double          refSec, getBitsSec, streamSec;
+
+    start = clock();
+    for (uLoop = 0; uLoop < TEST_LOOPS; uLoop++)
+    {
+        uBitOffset = 0;
+        for (uIndx = 0; uIndx < TEST_NUM_OF_FIELDS; uIndx++)
+        {
+            uSum += RefGetBits(buf, uBitOffset, widths[uIndx]);
+            uBitOffset += widths[uIndx];
+        }
+    }
+    refSec = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    start = clock();
+    for (uLoop = 0; uLoop < TEST_LOOPS; uLoop++)
+    {
+        uBitOffset = 0;
+        for (uIndx = 0; uIndx < TEST_NUM_OF_FIELDS; uIndx++)
+        {
+            uSum += mcpf_getBits(buf, &uBitOffset, widths[uIndx]);
+        }
+    }
+    getBitsSec = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    start = clock();
+    for (uLoop = 0; uLoop < TEST_LOOPS; uLoop++)
+    {
+        mcpf_bitStream_Init(&stream, buf, TEST_BUF_LEN, 0);
+        mcpf_bitStream_GetFields(&stream, widths, TEST_NUM_OF_FIELDS, values);
+        uSum += values[TEST_NUM_OF_FIELDS - 1];
+    }
+    streamSec = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    printf("%u fields: bitwise %.3fs, mcpf_getBits %.3fs, mcpf_bitStream_GetFields %.3fs (%x)\n",
+           TEST_LOOPS * TEST_NUM_OF_FIELDS, refSec, getBitsSec, streamSec, uSum);
+}
+
+void main()
+{
+    srand(1);
+
+    TestGetBits();
+    TestPutBits();
+    TestBitStream();
+    BenchGetBits();
+}
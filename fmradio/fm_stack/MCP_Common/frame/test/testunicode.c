@@ -0,0 +1,358 @@
+/*
+ * TI's FM Stack
+ *
+ * Copyright 2001-2010 Texas Instruments, Inc. - http://www.ti.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "mcp_unicode.h"
+
+#define TEST_MAX_CHARS      200
+#define TEST_MAX_BYTES      (TEST_MAX_CHARS * 4 + 1)
+#define TEST_MAX_UNITS      (TEST_MAX_CHARS * 2 + 1)
+#define TEST_ITERATIONS     20000
+#define TEST_LOOPS          200000
+
+McpU32      codePoints[TEST_MAX_CHARS];
+McpUtf8     utf8[TEST_MAX_BYTES];
+McpU16      units[TEST_MAX_UNITS];
+McpUtf16    utf16[TEST_MAX_UNITS + 1];
+McpUtf8     utf8Out[TEST_MAX_BYTES + 1];
+
+/* Code point at a time references for the converters and the length count */
+McpU32 RefEncodeUtf8(const McpU32 *pCodePoints, McpU32 uNumOfChars, McpUtf8 *pOut)
+{
+    McpU32  uLen = 0;
+    McpU32  uIndx;
+    McpU32  c;
+
+    for (uIndx = 0; uIndx < uNumOfChars; uIndx++)
+    {
+        c = pCodePoints[uIndx];
+        if (c < 0x80)
+        {
+            pOut[uLen++] = (McpUtf8) c;
+        }
+        else if (c < 0x800)
+        {
+            pOut[uLen++] = (McpUtf8) (0xC0 | (c >> 6));
+            pOut[uLen++] = (McpUtf8) (0x80 | (c & 0x3F));
+        }
+        else if (c < 0x10000)
+        {
+            pOut[uLen++] = (McpUtf8) (0xE0 | (c >> 12));
+            pOut[uLen++] = (McpUtf8) (0x80 | ((c >> 6) & 0x3F));
+            pOut[uLen++] = (McpUtf8) (0x80 | (c & 0x3F));
+        }
+        else
+        {
+            pOut[uLen++] = (McpUtf8) (0xF0 | (c >> 18));
+            pOut[uLen++] = (McpUtf8) (0x80 | ((c >> 12) & 0x3F));
+            pOut[uLen++] = (McpUtf8) (0x80 | ((c >> 6) & 0x3F));
+            pOut[uLen++] = (McpUtf8) (0x80 | (c & 0x3F));
+        }
+    }
+    pOut[uLen] = 0;
+    return uLen;
+}
+
+McpU32 RefEncodeUtf16(const McpU32 *pCodePoints, McpU32 uNumOfChars, McpU16 *pOut)
+{
+    McpU32  uLen = 0;
+    McpU32  uIndx;
+    McpU32  c;
+
+    for (uIndx = 0; uIndx < uNumOfChars; uIndx++)
+    {
+        c = pCodePoints[uIndx];
+        if (c < 0x10000)
+        {
+            pOut[uLen++] = (McpU16) c;
+        }
+        else
+        {
+            c -= 0x10000;
+            pOut[uLen++] = (McpU16) (0xD800 | (c >> 10));
+            pOut[uLen++] = (McpU16) (0xDC00 | (c & 0x3FF));
+        }
+    }
+    pOut[uLen] = 0;
+    return uLen;
+}
+
+/* Number of characters of a 0-terminated UTF-8 string, 0 when it is not well formed */
+McpU16 RefStrLenUtf8(const McpUtf8 *s)
+{
+    McpU16  uLen = 0;
+    McpU8   lo, hi;
+    McpU32  uExtra, uIndx;
+
+    while (*s)
+    {
+        McpU8 c = *s;
+
+        lo = 0x80;
+        hi = 0xBF;
+        if (c < 0x80)           uExtra = 0;
+        else if (c < 0xC2)      return 0;
+        else if (c < 0xE0)      uExtra = 1;
+        else if (c < 0xF0)      uExtra = 2;
+        else if (c < 0xF5)      uExtra = 3;
+        else                    return 0;
+
+        /* as McpUniIsLegalUTF8, the byte after ED and F4 is bounded from above only */
+        if (c == 0xE0)          lo = 0xA0;
+        else if (c == 0xED)     { lo = 0x01; hi = 0x9F; }
+        else if (c == 0xF0)     lo = 0x90;
+        else if (c == 0xF4)     { lo = 0x01; hi = 0x8F; }
+
+        for (uIndx = 1; uIndx <= uExtra; uIndx++)
+        {
+            if ((s[uIndx] < lo) || (s[uIndx] > hi))
+            {
+                return 0;
+            }
+            lo = 0x80;
+            hi = 0xBF;
+        }
+        s += uExtra + 1;
+        uLen++;
+    }
+    return uLen;
+}
+
+/* Mostly ASCII text, as RDS PS/RT and file names, with some 2, 3 and 4 byte characters */
+McpU32 RandomCodePoint(void)
+{
+    McpU32  c;
+
+    switch (rand() % 8)
+    {
+    case 0:
+        return 0x80 + rand() % (0x800 - 0x80);
+    case 1:
+        do
+        {
+            c = 0x800 + rand() % (0x10000 - 0x800);
+        } while ((c >= 0xD800) && (c <= 0xDFFF));
+        return c;
+    case 2:
+        return 0x10000 + rand() % (0x110000 - 0x10000);
+    default:
+        return 1 + rand() % 0x7F;
+    }
+}
+
+McpU32 RandomText(void)
+{
+    McpU32  uNumOfChars = rand() % TEST_MAX_CHARS;
+    McpU32  uIndx;
+
+    for (uIndx = 0; uIndx < uNumOfChars; uIndx++)
+    {
+        codePoints[uIndx] = RandomCodePoint();
+    }
+    return uNumOfChars;
+}
+
+/* Copy to an exactly sized buffer at an arbitrary alignment, so reads past the end are caught */
+McpU8 *CopyAt(McpU8 **ppAlloc, const void *pSrc, McpU32 uSize, McpU32 uOfs)
+{
+    *ppAlloc = (McpU8 *) malloc(uOfs + uSize);
+    assert(*ppAlloc != NULL);
+    memcpy(*ppAlloc + uOfs, pSrc, uSize);
+    return *ppAlloc + uOfs;
+}
+
+void ExpectUtf16(const McpUtf16 *pOut, const McpU16 *pUnits, McpU32 uNumOfUnits, McpUniEndianity endianity)
+{
+    const McpU8 *pBytes = (const McpU8 *) pOut;
+    McpU32      uIndx;
+
+    for (uIndx = 0; uIndx < uNumOfUnits; uIndx++)
+    {
+        if (endianity == mcpBigEndian)
+        {
+            assert(pBytes[2 * uIndx] == (McpU8) (pUnits[uIndx] >> 8));
+            assert(pBytes[2 * uIndx + 1] == (McpU8) pUnits[uIndx]);
+        }
+        else if (endianity == mcpLittleEndian)
+        {
+            assert(pBytes[2 * uIndx] == (McpU8) pUnits[uIndx]);
+            assert(pBytes[2 * uIndx + 1] == (McpU8) (pUnits[uIndx] >> 8));
+        }
+        else
+        {
+            assert(pOut[uIndx] == pUnits[uIndx]);
+        }
+    }
+}
+
+/* Well formed text converts both ways and counts the same as the references */
+void TestValidText(void)
+{
+    static const McpUniEndianity endianities[] = {mcpBigEndian, mcpLittleEndian, mcpNativeEndian};
+    McpU32  uIter;
+    McpU32  uNumOfChars, uNumOfBytes, uNumOfUnits;
+    McpU32  uOfs;
+    McpUniEndianity endianity;
+    McpU8   *pAlloc;
+    McpUtf8 *pUtf8;
+    McpUtf16 *pUtf16;
+
+    for (uIter = 0; uIter < TEST_ITERATIONS; uIter++)
+    {
+        uNumOfChars = RandomText();
+        uNumOfBytes = RefEncodeUtf8(codePoints, uNumOfChars, utf8);
+        uNumOfUnits = RefEncodeUtf16(codePoints, uNumOfChars, units);
+        uOfs = rand() % 16;
+        endianity = endianities[uIter % 3];
+
+        pUtf8 = CopyAt(&pAlloc, utf8, uNumOfBytes + 1, uOfs);
+        assert(MCP_StrLenUtf8(pUtf8) == uNumOfChars);
+
+        memset(utf16, 0xA5, sizeof(utf16));
+        assert(MCP_Utf8ToUtf16Endian(utf16, TEST_MAX_UNITS, pUtf8, endianity) == 2 * (uNumOfUnits + 1));
+        ExpectUtf16(utf16, units, uNumOfUnits + 1, endianity);
+        free(pAlloc);
+
+        /* UTF-16 source at an odd unit offset, converted back without its terminator */
+        pUtf16 = (McpUtf16 *) CopyAt(&pAlloc, utf16, 2 * (uNumOfUnits + 1), 2 * (uOfs & 7));
+        memset(utf8Out, 0xA5, sizeof(utf8Out));
+        assert(MCP_Utf16ToUtf8Endian(utf8Out, TEST_MAX_BYTES, pUtf16, (McpU16) uNumOfUnits, endianity) == uNumOfBytes);
+        assert(memcmp(utf8Out, utf8, uNumOfBytes) == 0);
+        free(pAlloc);
+    }
+}
+
+/* Random bytes are counted as the reference counts them, including the malformed ones */
+void TestRandomBytes(void)
+{
+    static const McpU8 interesting[] = {0x00, 0x7F, 0x80, 0xBF, 0xC0, 0xC2, 0xDF, 0xE0, 0xED,
+                                        0xEF, 0xF0, 0xF4, 0xF5, 0xFF, 0xA0, 0x9F, 0x8F, 0x90};
+    McpU32  uIter;
+    McpU32  uLen, uIndx, uOfs;
+    McpU8   *pAlloc;
+    McpUtf8 *pUtf8;
+    McpU16  uRefLen;
+
+    for (uIter = 0; uIter < TEST_ITERATIONS * 10; uIter++)
+    {
+        uLen = rand() % 64;
+        for (uIndx = 0; uIndx < uLen; uIndx++)
+        {
+            switch (rand() % 4)
+            {
+            case 0:
+                utf8[uIndx] = interesting[rand() % sizeof(interesting)];
+                break;
+            case 1:
+                utf8[uIndx] = (McpU8) rand();
+                break;
+            default:
+                utf8[uIndx] = (McpU8) (1 + rand() % 0x7F);
+                break;
+            }
+        }
+        utf8[uLen] = 0;
+        uOfs = rand() % 16;
+
+        pUtf8 = CopyAt(&pAlloc, utf8, uLen + 1, uOfs);
+        uRefLen = RefStrLenUtf8(pUtf8);
+        assert(MCP_StrLenUtf8(pUtf8) == uRefLen);
+
+        if ((uRefLen > 0) || (*pUtf8 == 0))
+        {
+            assert(MCP_Utf8ToUtf16Endian(utf16, TEST_MAX_UNITS, pUtf8, mcpNativeEndian) != 1);
+        }
+        else
+        {
+            assert(MCP_Utf8ToUtf16Endian(utf16, TEST_MAX_UNITS, pUtf8, mcpNativeEndian) == 1);
+        }
+        free(pAlloc);
+    }
+}
+
+/* Throughput of the length count and of both conversions, against the references */
+void Bench(const char *name, McpU32 uNumOfChars)
+{
+    McpU32  uNumOfBytes = RefEncodeUtf8(codePoints, uNumOfChars, utf8);
+    McpU32  uNumOfUnits = RefEncodeUtf16(codePoints, uNumOfChars, units);
+    McpU32  uSum = 0;
+    McpU32  uLoop;
+    clock_t start;
+    double  refSec, lenSec, toUtf16Sec, toUtf8Sec;
+
+    MCP_Utf8ToUtf16Endian(utf16, TEST_MAX_UNITS, utf8, mcpNativeEndian);
+
+    start = clock();
+    for (uLoop = 0; uLoop < TEST_LOOPS; uLoop++)
+    {
+        uSum += RefStrLenUtf8(utf8);
+    }
+    refSec = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    start = clock();
+    for (uLoop = 0; uLoop < TEST_LOOPS; uLoop++)
+    {
+        uSum += MCP_StrLenUtf8(utf8);
+    }
+    lenSec = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    start = clock();
+    for (uLoop = 0; uLoop < TEST_LOOPS; uLoop++)
+    {
+        uSum += MCP_Utf8ToUtf16Endian(utf16, TEST_MAX_UNITS, utf8, mcpNativeEndian);
+    }
+    toUtf16Sec = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    start = clock();
+    for (uLoop = 0; uLoop < TEST_LOOPS; uLoop++)
+    {
+        uSum += MCP_Utf16ToUtf8Endian(utf8Out, TEST_MAX_BYTES, utf16, (McpU16) uNumOfUnits, mcpNativeEndian);
+    }
+    toUtf8Sec = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    printf("%s (%u bytes): ref strlen %.3fs, MCP_StrLenUtf8 %.3fs, to UTF-16 %.3fs, to UTF-8 %.3fs (%x)\n",
+           name, uNumOfBytes, refSec, lenSec, toUtf16Sec, toUtf8Sec, uSum);
+}
+
+void main()
+{
+    McpU32  uIndx;
+
+    srand(1);
+
+    TestValidText();
+    TestRandomBytes();
+
+    /* RDS radio text is 64 characters */
+    for (uIndx = 0; uIndx < 64; uIndx++)
+    {
+        codePoints[uIndx] = 'A' + uIndx % 26;
+    }
+    Bench("ASCII radio text", 64);
+
+    for (uIndx = 0; uIndx < 64; uIndx++)
+    {
+        codePoints[uIndx] = RandomCodePoint();
+    }
+    Bench("mixed radio text", 64);
+}
@@ -39,6 +39,9 @@
 
 #define MAX_XFER_BUFS            4
 
+#define BUSDRV_BATCH_MAX_TXNS    4      /* Maximum number of transactions sent together by busDrv_TransactBatch */
+#define BUSDRV_BATCH_BUF_SIZE    256    /* Maximum total length of transactions sent together */
+
 #define TXN_STATUS_OK            0
 #define TXN_STATUS_ERROR         1
 #define TXN_STATUS_RECOVERY      2
@@ -258,6 +261,8 @@ EMcpfRes 	busDrv_ConnectBus (handle_t        			hBusDrv,
 
 EMcpfRes 	busDrv_DisconnectBus (handle_t hBusDrv);
 ETxnStatus 	busDrv_Transact   (handle_t hBusDrv, TTxnStruct *pTxn);
+ETxnStatus 	busDrv_TransactBatch (handle_t hBusDrv, TTxnStruct *aTxn[], const McpU32 uNumTxns);
+McpU32		busDrv_GetTxnLen  (TTxnStruct *pTxn);
 void 	   	busDrv_BufAvailable (handle_t hBusDrv);
 void	   	busDrv_GetStat (const handle_t hBusDrv, TBusDrvStat  * pStat, EBusDrvRxState * pState);
 void		busDrv_SetSpeed (const handle_t hBusDrv, const McpU16 baudrate);
@@ -88,6 +88,8 @@ handle_t	txnQ_GetBusDrvHandle (const handle_t hTxnQ);
 
 McpBool 	txnQ_IsQueueEmpty (const handle_t hTxnQ, const McpU32 uFuncId);
 
+void        txnQ_EnableBatching (handle_t hTxnQ, const McpBool bEnable);
+
 EMcpfRes    txnQ_ResetBus (handle_t hTxnQ, const McpU16 baudrate);
 
 #ifdef TRAN_DBG
@@ -108,6 +108,59 @@ typedef struct _Cal_Resource_Config
 
 } Cal_Resource_Config;
 
+/*-------------------------------------------------------------------------------
+ * ECAL_TxnSequence
+ *
+ * the transports an operation transaction sends its commands on. Resources
+ * residing on the FM core are configured over the FM transport, all others
+ * over the BT (HCI) transport.
+ */
+typedef enum _ECAL_TxnSequence
+{
+    CAL_TXN_SEQ_BT = 0,
+    CAL_TXN_SEQ_FM,
+    CAL_TXN_SEQ_MAX_NUM
+} ECAL_TxnSequence;
+
+struct _Cal_Operation_Txn;
+
+/*-------------------------------------------------------------------------------
+ * Cal_Txn_Cmd
+ *
+ * holds a single resource command that was merged into an operation transaction
+ */
+typedef struct _Cal_Txn_Cmd
+{
+    McpHciSeqPrepCB             fPrepCB;            /* the resource command preparation function */
+    void                        *pPrepUserData;     /* user data for the above function (resource data) */
+    struct _Cal_Operation_Txn   *pTxn;              /* the transaction this command belongs to */
+    ECAL_Resource               eResource;          /* the resource configured by this command */
+    McpBool                     bIgnoreStatus;      /* the resource ignores the command status
+                                                       (completed by CAL_Config_Complete_Null_CB) */
+} Cal_Txn_Cmd;
+
+/*-------------------------------------------------------------------------------
+ * Cal_Operation_Txn
+ *
+ * holds the commands of all resources of an operation, started by
+ * CAL_ConfigOperation() as a single pipelined burst per transport
+ */
+typedef struct _Cal_Operation_Txn
+{
+    Cal_Config_ID           *pConfigid;         /* the owning CAL object */
+    TCAL_CB                 CB;                 /* client callback, called once for the whole operation */
+    void                    *pUserData;         /* user data for the above callback */
+    ECAL_Operation          eOperation;         /* the operation being configured */
+    TCAL_ResourceList       tResources;         /* the resources configured by the transaction */
+    MCP_HciSeq_Context      hciseq[ CAL_TXN_SEQ_MAX_NUM ];
+    McpHciSeqCmd            hciseqCmd[ CAL_TXN_SEQ_MAX_NUM ][ HCI_SEQ_MAX_CMDS_PER_SEQUENCE ];
+    Cal_Txn_Cmd             tCmds[ CAL_TXN_SEQ_MAX_NUM ][ HCI_SEQ_MAX_CMDS_PER_SEQUENCE ];
+    McpU32                  uCommandCount[ CAL_TXN_SEQ_MAX_NUM ];
+                                                /* merged commands, and their number, per transport */
+    McpU32                  uPendingCommands;   /* number of commands not completed yet */
+    McpU32                  uSentResourcesMask; /* resources the chip already received commands for */
+} Cal_Operation_Txn;
+
 typedef struct
 {
 	char	*	keyName;
@@ -339,6 +339,57 @@ ECAL_RetValue CAL_ConfigResource(Cal_Config_ID *pConfigid,
                                  TCAL_CB fCB,
                                  void *pUserData);
 
+/*-------------------------------------------------------------------------------
+ * CAL_ConfigOperation()
+ *
+ * Brief:
+ *      Configure all chip resources of an operation as a single transaction.
+ *
+ * Description:
+ *      Plans the configuration of all resources on the list before sending
+ *      anything, and merges their commands into a single sequence per
+ *      transport (BT and FM), which are then run back to back. The client
+ *      callback is called once, when all commands completed. If any command
+ *      fails, the remaining commands are cancelled and resources that already
+ *      received commands are de-configured (as with
+ *      CAL_StopResourceConfiguration) before the failure is reported.
+ *
+ * Type:
+ *      Synchronous\Asynchronous
+ *
+ * Parameters:
+ *      pConfigid [in] - idicate a pointer to stracture configuration.
+ *      eOperation[in] - Operation at the current configuration.
+ *      ptResources [in] - Resources to configure, in configuration order.
+ *      ptConfig [in] - Configuration for the current operation.
+ *      ptProperties [in] - Resource specific properties, one per resource on
+ *              the above list.
+ *      fCB [in] - Client callbackfor the current operation.
+ *      pUserData [in] - Pointer for a data specific for the current
+ *              operation.
+ *
+ * Generated Events:
+ *      CAL_STATUS_SUCCESS
+ *      CAL_STATUS_FAILURE
+ *
+ * Returns:
+ *      CAL_STATUS_PENDING - The transaction was started successfully. A
+ *          CAL_STATUS_SUCCESS or CAL_STATUS_FAILURE event will be received
+ *          when it completes.
+ *
+ *      CAL_STATUS_SUCCESS - No resource required any command.
+ *
+ *      CAL_STATUS_FAILURE - The transaction could not be planned or started.
+ *          Nothing is left configured.
+ */
+ECAL_RetValue CAL_ConfigOperation(Cal_Config_ID *pConfigid,
+                                  ECAL_Operation eOperation,
+                                  TCAL_ResourceList *ptResources,
+                                  TCAL_DigitalConfig *ptConfig,
+                                  TCAL_ResourceProperties *ptProperties[],
+                                  TCAL_CB fCB,
+                                  void *pUserData);
+
 /*-------------------------------------------------------------------------------
  * CAL_StopResourceConfiguration()
  *
@@ -33,6 +33,15 @@
 #define __CCM_VACI_DEBUG_H__
 
 #include "ccm_vac.h"
+#include "mcp_defs.h"
+
+/*-------------------------------------------------------------------------------
+ * CCM_VAC_LOG_INFO
+ *
+ *     Info-level trace for VAC hot paths. The module log level is checked
+ *     before the message (and its debug strings) is formatted.
+ */
+#define CCM_VAC_LOG_INFO(msg)   (MCP_LOG_INFO_ENABLED() ? MCP_LOG_INFO(msg) : (void)0)
 
 /*-------------------------------------------------------------------------------
  * _CCM_VAC_DebugResourceStr()
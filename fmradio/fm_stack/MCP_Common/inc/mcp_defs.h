@@ -126,6 +126,8 @@ typedef enum
 #define MCP_LOG_FATAL(msg)			MCP_HAL_LOG_FATAL(__FILE__, __LINE__, mcpHalLogModuleId, msg)	
 #define MCP_LOG_DUMPBUF(msg,pBuf,len)	MCP_HAL_LOG_DUMPBUF(__FILE__, __LINE__, msg, pBuf, len)	
 
+#define MCP_LOG_INFO_ENABLED()		MCP_HAL_LOG_IS_ENABLED(mcpHalLogModuleId, MCP_HAL_LOG_SEVERITY_INFO)
+
 
 
 #endif
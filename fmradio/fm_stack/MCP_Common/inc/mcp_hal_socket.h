@@ -63,6 +63,8 @@ handle_t mcp_hal_socket_CreateServerSocket(handle_t hMcpf, handle_t hHostSocket,
  * \fn     mcp_hal_socket_Accept
  * \brief  Socket Accept at the Server side
  * 
+ * Blocking; serves all the clients (up to SOCKET_CLIENT_NUM) from the calling 
+ * thread until the server socket is destroyed.
  */
 void mcp_hal_socket_Accept(handle_t hHalSocket);
 
@@ -79,6 +81,8 @@ void mcp_hal_socket_DestroyServerSocket(handle_t hHalSocket);
  * \fn     mcp_hal_socket_Send 
  * \brief  Send data back to the client
  * 
+ * Blocks while the client socket is full, and fails if the client does not 
+ * drain it in time.
  */
 EMcpfRes mcp_hal_socket_Send(handle_t hHalSocket, McpU32 clientSockId, McpS8 *buf, McpU16 bufLen);
 
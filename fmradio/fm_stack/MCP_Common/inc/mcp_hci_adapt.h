@@ -92,7 +92,8 @@ typedef void (*THCIA_CmdComplCb) (handle_t hHandle, THciaCmdComplEvent *event);
  * 
  * \note
  * \param	uCmdMaxNum    - max number of oustandig commands in command queue
- * \param	uOutCmdMaxNum - max number of sent commands but not acknowledged yet
+ * \param	uOutCmdMaxNum - max number of sent commands but not acknowledged yet, limits
+ *                          the credits granted by the controller (Num_HCI_Command_Packets)
  * \param  	uHciTypeMin   - minimum value of range of processed HCI packet types
  * \param  	uHciTypeMax   - maximum value of range of processed HCI packet types
  * \return 	Handle of the allocated object, NULL if allocation failed 
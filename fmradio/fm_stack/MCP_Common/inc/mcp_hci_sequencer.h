@@ -42,6 +42,11 @@
 *       new sequence needs to be started immediatly, the user may call 
 *       TI_HciSeq_RunSequence directly, which will have the same effect.
 *
+*       Sequences of independent commands (e.g. register writes that do not
+*       depend on each other's results) may be run using 
+*       MCP_HciSeq_RunPipelinedSequence, which keeps up to a window of commands
+*       outstanding, and matches their completion events by opcode.
+*
 *       Tasks
 *       -----
 *       The HCI sequencer runs in the context of its callers. 
@@ -68,6 +73,7 @@
  *
  *******************************************************************************/
 #include "mcp_hal_types.h"
+#include "mcp_hal_os.h"
 #include "ccm_adapt.h"
 
 
@@ -78,6 +84,9 @@
  *******************************************************************************/
 #define HCI_SEQ_MAX_CMDS_PER_SEQUENCE      (5)
 
+/* maximum number of commands a pipelined sequence may have outstanding */
+#define HCI_SEQ_MAX_CMDS_IN_FLIGHT         (4)
+
 /*-------------------------------------------------------------------------------
  * McpHciSeqCmdToken
  *
@@ -111,8 +120,38 @@ typedef struct _McpHciSeqCmd
 {
     McpHciSeqPrepCB         fCommandPrepCB; /* called to prepare the command before sending */
     void                    *pUserData;     /* user data supplied to the above CB */
+    McpBool                 bWaitForPrevious; /* pipelined sequences only - sent after all
+                                                 previous commands completed */
 } McpHciSeqCmd;
 
+/*-------------------------------------------------------------------------------
+ * McpHciSeqInFlightCmd
+ *
+ * holds a command sent by a pipelined sequence, until its completion arrives.
+ */
+typedef struct _McpHciSeqInFlightCmd
+{
+    McpHciSeqCmdToken       command;        /* the sent command token */
+    McpU32                  uSequenceId;    /* the sequence ID the command was sent for */
+    McpU32                  uSendOrder;     /* send order, to match the oldest command first */
+    McpBool                 bInUse;         /* whether the command is outstanding */
+} McpHciSeqInFlightCmd;
+
+/*-------------------------------------------------------------------------------
+ * McpHciSeqStatistics
+ *
+ * aggregated timing of the sequences run on a context.
+ */
+typedef struct _McpHciSeqStatistics
+{
+    McpU32                  uSequencesCompleted;    /* number of sequences that ran to completion */
+    McpU32                  uCommandsCompleted;     /* number of commands completed */
+    McpHalOsTimeInMs        uLastSequenceTime;      /* duration of the last completed sequence */
+    McpHalOsTimeInMs        uMaxSequenceTime;       /* longest completed sequence */
+    McpHalOsTimeInMs        uTotalSequenceTime;     /* accumulated duration of all completed sequences */
+    McpU32                  uMaxCmdsInFlight;       /* highest number of commands outstanding at once */
+} McpHciSeqStatistics;
+
 /*-------------------------------------------------------------------------------
  * MCP_HciSeq_Context
  *
@@ -132,6 +171,13 @@ typedef struct _MCP_HciSeq_Context
     McpHalCoreId            coreId;
     McpBool                 bCallCBOnlyForLastCmd;
     McpBool                 bPendingCommand;
+    McpHciSeqInFlightCmd    inFlightCommands[ HCI_SEQ_MAX_CMDS_IN_FLIGHT ]; /* pipelined commands outstanding */
+    McpU32                  uWindowSize;            /* commands allowed outstanding (1 - not pipelined) */
+    McpU32                  uInFlightCount;         /* number of pipelined commands outstanding */
+    McpU32                  uNextSendOrder;         /* send order of the next pipelined command */
+    McpU32                  uCompletedCount;        /* commands of the current pipelined sequence completed */
+    McpHalOsTimeInMs        uSequenceStartTime;     /* the time the current sequence was started */
+    McpHciSeqStatistics     stats;                  /* aggregated sequences timing */
 } MCP_HciSeq_Context;
 
 /********************************************************************************
@@ -217,6 +263,67 @@ CcmaStatus MCP_HciSeq_RunSequence(MCP_HciSeq_Context *pContext,
                                 const McpHciSeqCmd *pCommands,
                                 McpBool bCallCbOnlyAfterLastCmd);
 
+/*-------------------------------------------------------------------------------
+ * MCP_HciSeq_RunPipelinedSequence()
+ *
+ * Brief:  
+ *      Runs a sequence of independent HCI commands, several at a time
+ *
+ * Description:
+ *      Same as MCP_HciSeq_RunSequence, but the caller declares the commands do
+ *      not depend on each other's results. Up to uWindowSize commands are 
+ *      prepared and sent before their completion arrives, and completion 
+ *      events are matched to the sent commands by opcode. Callbacks are still
+ *      called in the order the completion events are received.
+ *      A command with bWaitForPrevious set depends on the commands before it,
+ *      and is only sent once all of them completed.
+ *      The sequence starts after all commands of the previous sequence completed.
+ *      The window is limited to HCI_SEQ_MAX_CMDS_IN_FLIGHT, and to a single 
+ *      command on the FM core, which holds one outstanding command.
+ *
+ * Type:
+ *      Synchronous / Asynchronous
+ *
+ * Parameters:
+ *      pContext [in] - Caller allocated context that stores sequence information
+ *      uCommandCount [in] - Number of commands in the sequence
+ *      pCommands [in] - actual commands in the sequence
+ *      bCallCbOnlyAfterLastCmd [in] - if true the callback will be called only at the end of the seq
+ *      uWindowSize [in] - maximal number of commands outstanding
+ *
+ * Returns:
+ *      CCMA_STATUS_FAILED
+ *      CCMA_STATUS_PENDING
+ */
+CcmaStatus MCP_HciSeq_RunPipelinedSequence(MCP_HciSeq_Context *pContext, 
+                                           const McpU32 uCommandCount,
+                                           const McpHciSeqCmd *pCommands,
+                                           McpBool bCallCbOnlyAfterLastCmd,
+                                           McpU32 uWindowSize);
+
+/*-------------------------------------------------------------------------------
+ * MCP_HciSeq_GetStatistics()
+ *
+ * Brief:  
+ *      Retrieves the aggregated timing of a sequence context
+ *
+ * Description:
+ *      Copies the number of completed sequences and commands, and the last,
+ *      longest and accumulated sequence durations, measured from the run 
+ *      request to the completion of the last command.
+ *
+ * Type:
+ *      Synchronous
+ *
+ * Parameters:
+ *      pContext [in] - Caller allocated context that stores sequence information
+ *      pStats [out] - the context statistics
+ *
+ * Returns:
+ *      N/A
+ */
+void MCP_HciSeq_GetStatistics (MCP_HciSeq_Context *pContext, McpHciSeqStatistics *pStats);
+
 /*-------------------------------------------------------------------------------
  * MCP_HciSeq_CancelSequence()
  *
@@ -64,6 +64,8 @@ extern "C" {
 
 #define	MCPF_TASK_NAME_MAX_LEN			16
 
+#define	MCPF_TASK_QUEUE_WEIGHT			8 /* messages handled from a registered queue per task loop pass */
+
 /* Discrete signals bit definition */
 #define BIT_VDD_CORE 		0
 #define BIT_GPS_EN_RESET 	1
@@ -124,6 +126,27 @@ typedef struct
 typedef void (*mcpf_msg_handler_cb)(handle_t hCaller,  TmcpfMsg *tMsg);
 
 
+/* MCPF Task's statistics counters */
+typedef struct
+{
+	McpU32				uWakeups;			/* number of task loop passes */
+	McpU32				uEmptyWakeups;		/* passes which found no event and no message */
+	McpU32				uMsgs;				/* number of handled messages */
+	McpU32				uMaxMsgsPerWakeup;	/* maximum number of messages handled in one pass */
+
+} TMcpfTaskStat;
+
+/* MCPF Task queue's statistics counters */
+typedef struct
+{
+	McpU32				uMsgs;				/* number of handled messages */
+	McpU32				uUrgentMsgs;		/* number of handled urgent lane messages */
+	McpU32				uDeferredPasses;	/* passes which left messages in queue because of the weight */
+	McpU32				uMaxDeferredPasses;	/* maximum number of consecutive deferred passes (starvation) */
+	McpU32				uCurrDeferredPasses;/* current number of consecutive deferred passes */
+
+} TMcpfQueueStat;
+
 /* MCPF Task's internal data structure */
 typedef struct
 {
@@ -132,6 +155,9 @@ typedef struct
 	mcpf_msg_handler_cb	*fQueueCb; 		/* pointers to queue callbacks */
     handle_t			*hQueCbHandler; /* pointers to queue callback handlers */
 	McpBool				*bQueueFlag;    /* pointer to array of queue enabled/disabled flags */ 
+	handle_t		 	*hUrgentQueue;	/* pointers to urgent lane queue handlers, handled before all queues */
+	McpU32				*uQueueWeight;	/* pointer to array of max messages handled per pass for each queue */
+	TMcpfQueueStat		*tQueueStat;	/* pointer to array of queue statistics */
 	handle_t			hCritSecObj;
 	handle_t		 	hSignalObj;
 	McpU32				uEvntBitmap;
@@ -140,6 +166,7 @@ typedef struct
 	McpBool				bDestroyTask;
 	char 				cName[MCPF_TASK_NAME_MAX_LEN];
 	handle_t			hOsTaskHandle;
+	TMcpfTaskStat		tStat;
 
 } TMcpfTask;
 
@@ -152,6 +152,55 @@ EMcpfRes		mcpf_UnregisterTaskQ (handle_t hMcpf, EmcpTaskId	eTaskId, McpU8 uQueue
  */ 
 EMcpfRes		mcpf_SetTaskPriority (handle_t hMcpf, EmcpTaskId eTask_id, McpInt sPriority);
 
+/** 
+ * \fn     mcpf_GetTaskStat
+ * \brief  Get the task's statistics
+ * 
+ * This function copies the statistics counters of the given task.
+ * 
+ * \note
+ * \param	hMcpf     - MCPF handler.
+ * \param	eTask_id - Task ID.
+ * \param	pStat - pointer to the statistics structure to fill.
+ * \return 	Result of operation: OK or ERROR
+ * \sa     	mcpf_GetTaskStat
+ */ 
+EMcpfRes		mcpf_GetTaskStat (handle_t hMcpf, EmcpTaskId eTask_id, TMcpfTaskStat *pStat);
+
+/** 
+ * \fn     mcpf_SetTaskQWeight
+ * \brief  Set the task queue's weight
+ * 
+ * This function sets the maximum number of messages handled from the queue 
+ * in one pass of the task loop.
+ * 
+ * \note   Messages left in the queue are handled by the next pass, after the 
+ *         other queues of the task. Urgent lane messages are not limited.
+ * \param	hMcpf - MCPF handler. 
+ * \param	eTaskId - Task ID.
+ * \param	uQueueId - Queue Index.
+ * \param	uWeight - Maximum number of messages per pass, 0 for no limit.
+ * \return 	Result of operation: OK or ERROR
+ * \sa     	mcpf_GetTaskQStat
+ */ 
+EMcpfRes		mcpf_SetTaskQWeight (handle_t hMcpf, EmcpTaskId eTaskId, McpU8 uQueueId, McpU32 uWeight);
+
+/** 
+ * \fn     mcpf_GetTaskQStat
+ * \brief  Get the task queue's statistics
+ * 
+ * This function copies the statistics counters of the given task queue.
+ * 
+ * \note
+ * \param	hMcpf - MCPF handler. 
+ * \param	eTaskId - Task ID.
+ * \param	uQueueId - Queue Index.
+ * \param	pStat - pointer to the statistics structure to fill.
+ * \return 	Result of operation: OK or ERROR
+ * \sa     	mcpf_SetTaskQWeight
+ */ 
+EMcpfRes		mcpf_GetTaskQStat (handle_t hMcpf, EmcpTaskId eTaskId, McpU8 uQueueId, TMcpfQueueStat *pStat);
+
 #ifdef __cplusplus
 }
 #endif 
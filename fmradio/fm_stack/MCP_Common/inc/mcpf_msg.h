@@ -63,6 +63,38 @@ EMcpfRes	mcpf_SendMsg (handle_t		hMcpf,
 						  McpU32		uUserDefined,
 						  void 			*pData);
 
+/** 
+ * \fn     mcpf_SendUrgentMsg
+ * \brief  Send urgent MCPF message
+ * 
+ * Allocate MCPF message, populate it's fields and send to the urgent lane of specified 
+ * target queue of the destination task. Urgent lanes are handled before all the task 
+ * queues and are not limited by the queue weight.
+ * 
+ * \note   Sent as normal message if the destination is an external client or 
+ *         the target queue is not registered
+ * \param	hMcpf     - handle to OS Framework
+ * \param	eDestTaskId - destination task ID
+ * \param   uDestQId  - destination queue ID 
+ * \param   eSrcTaskId- source task ID
+ * \param   eSrcQId   - source queue ID to return response if any
+ * \param   uOpcode   - message opcode
+ * \param   uLen      - number of bytes in data buffer pointed by pData
+ * \param   uUserDefined - user defined parameter
+ * \param	pData		 - message data buffer
+ * \return 	Result of operation: OK or ERROR
+ * \sa     	mcpf_SendMsg
+ */ 
+EMcpfRes	mcpf_SendUrgentMsg (handle_t		hMcpf,
+								EmcpTaskId	eDestTaskId,
+								McpU8			uDestQId,
+								EmcpTaskId	eSrcTaskId,
+								McpU8			uSrcQId,
+								McpU16		uOpcode,
+								McpU32		uLen,
+								McpU32		uUserDefined,
+								void 			*pData);
+
 
 /** 
  * \fn     mcpf_MsgqEnable
@@ -44,6 +44,8 @@ EMcpfRes que_Enqueue (handle_t hQue, handle_t hItem);
 handle_t que_Dequeue (handle_t hQue);
 EMcpfRes que_Requeue (handle_t hQue, handle_t hItem);
 McpU32 que_Size    (handle_t hQue);
+McpU32 que_DequeueBatch (handle_t hQue, MCP_DL_LIST_Node *pList, McpU32 uMaxCount);
+void   que_RequeueAll (handle_t hQue, MCP_DL_LIST_Node *pList, McpU32 uCount);
 
 #ifdef _DEBUG
 void      que_Print   (handle_t hQue);
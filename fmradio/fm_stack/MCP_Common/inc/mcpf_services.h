@@ -126,6 +126,94 @@ McpS32 mcpf_getSignedBits(McpU8* pBuf, McpU32 *pBitOffset, McpU32 uBitLength);
  */ 
 void mcpf_putBits(McpU8* pBuf, McpU32 *pBitOffset, McpU32 uInputVal, McpU32 uInputBitLength);
 
+/* Bit stream reader/writer, for parsing and building long runs of packed fields */
+typedef struct
+{
+	McpU8	*pBuf;			/* stream buffer */
+	McpU32	uBufLen;		/* buffer length in bytes */
+	McpU32	uBitOffset;		/* current position in bits from pBuf */
+} TMcpfBitStream;
+
+/** 
+ * \fn     mcpf_bitStream_Init
+ * \brief  Initialize bit stream
+ * 
+ * Attach bit stream object to buffer, for reading or for writing
+ * 
+ * \note
+ * \param	pStream 	- bit stream object
+ * \param	pBuf 		- stream buffer
+ * \param	uBufLen  	- buffer length in bytes, the stream never accesses beyond it
+ * \param	uBitOffset  - offset in bits from pBuf to start from
+ * \return 	void
+ * \sa     	mcpf_bitStream_GetBits
+ */ 
+void mcpf_bitStream_Init(TMcpfBitStream *pStream, McpU8 *pBuf, McpU32 uBufLen, McpU32 uBitOffset);
+
+/** 
+ * \fn     mcpf_bitStream_GetBits
+ * \brief  Get bits field from stream
+ * 
+ * Get bits field (up to 32 bits) at the current stream position and advance it.
+ * Bits beyond the end of the buffer are read as zero.
+ * 
+ * \note
+ * \param	pStream 	- bit stream object
+ * \param	uBitLength  - number of bits to read
+ * \return 	bits field
+ * \sa     	mcpf_getBits
+ */ 
+McpU32 mcpf_bitStream_GetBits(TMcpfBitStream *pStream, McpU32 uBitLength);
+
+/** 
+ * \fn     mcpf_bitStream_GetSignedBits
+ * \brief  Get signed bits field from stream
+ * 
+ * Get bits field at the current stream position, sign extended, and advance it.
+ * 
+ * \note
+ * \param	pStream 	- bit stream object
+ * \param	uBitLength  - number of bits to read
+ * \return 	signed bits field
+ * \sa     	mcpf_getSignedBits
+ */ 
+McpS32 mcpf_bitStream_GetSignedBits(TMcpfBitStream *pStream, McpU32 uBitLength);
+
+/** 
+ * \fn     mcpf_bitStream_GetFields
+ * \brief  Get consecutive bits fields from stream
+ * 
+ * Get a run of consecutive bits fields, described by their widths, 
+ * at the current stream position and advance it.
+ * 
+ * \note
+ * \param	pStream 	- bit stream object
+ * \param	pWidths 	- width in bits of each field (up to 32)
+ * \param	uNumOfFields - number of fields to read
+ * \param	pValues 	- returned fields values
+ * \return 	void
+ * \sa     	mcpf_bitStream_GetBits
+ */ 
+void mcpf_bitStream_GetFields(TMcpfBitStream *pStream, const McpU8 *pWidths, 
+							  McpU32 uNumOfFields, McpU32 *pValues);
+
+/** 
+ * \fn     mcpf_bitStream_PutBits
+ * \brief  Put bits field into stream
+ * 
+ * Put bits field (up to 32 bits) at the current stream position and advance it.
+ * The bits following the field in its last byte are cleared, bits beyond 
+ * the end of the buffer are dropped.
+ * 
+ * \note
+ * \param	pStream 	- bit stream object
+ * \param	uInputVal  	- value to write
+ * \param	uInputBitLength  - number of bits of uInputVal to write
+ * \return 	void
+ * \sa     	mcpf_putBits
+ */ 
+void mcpf_bitStream_PutBits(TMcpfBitStream *pStream, McpU32 uInputVal, McpU32 uInputBitLength);
+
 
 /* Critical Section */
 
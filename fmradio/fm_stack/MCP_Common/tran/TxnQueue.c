@@ -59,6 +59,10 @@
 #define TXN_QUE_SIZE        64  /* Txn-queue size */
 #define TXN_DONE_QUE_SIZE   64  /* TxnDone-queue size */
 
+/* Index of the lowest set bit in a functions mask (covers TXN_MAX_FUNCTIONS bits) */
+#define TXN_FIRST_FUNC(uMask)   (aTxnFirstFunc[(uMask) & 0xF])
+#define TXN_FUNC_BIT(uFuncId)   ((McpU32)1 << (uFuncId))
+
 
 /************************************************************************
  * Types
@@ -95,8 +99,17 @@ typedef struct _TTxnQObj
     handle_t       	aTxnQueues[TXN_MAX_FUNCTIONS][TXN_MAX_PRIORITY];  /* Handle of the Transactions-Queue */
     handle_t       	hTxnDoneQueue;      /* Queue for completed transactions not reported to yet to the upper layer */
     TTxnStruct *    pCurrTxn;           /* The transaction currently processed in the bus driver (NULL if none) */
-    McpU32       	uMinFuncId;         /* The minimal function ID actually registered (through txnQ_Open) */
-    McpU32      	uMaxFuncId;         /* The maximal function ID actually registered (through txnQ_Open) */
+    TTxnStruct *    aCurrBatch[BUSDRV_BATCH_MAX_TXNS]; /* The transactions currently processed in the bus driver */
+    McpU32          uCurrBatchNum;      /* Number of transactions in aCurrBatch */
+    McpU32          uCurrBatchDone;     /* Number of aCurrBatch transactions already completed */
+
+    /* Ready bitmaps (bit per function), updated on enqueue, dequeue and function state change */
+    McpU32          uSingleStepMask;    /* Functions with a single step Txn waiting */
+    McpU32          aQueuedMask[TXN_MAX_PRIORITY]; /* Per priority - functions with a non empty queue */
+    McpU32          uRunningMask;       /* Functions in RUNNING state */
+
+    /* TRUE if small queued transactions may be sent to the bus driver together */
+    McpBool         bBatchTxns;
     
     /* Environment dependent: TRUE if needed and allowed to protect TxnDone in critical section */
     McpBool         bProtectTxnDone; 
@@ -112,10 +125,15 @@ typedef struct _TTxnQObj
 static void         txnQ_TxnDoneCb    (handle_t hTxnQ, void *hTxn);
 static ETxnStatus   txnQ_RunScheduler (TTxnQObj *pTxnQ, TTxnStruct *pCurrTxn, McpBool bExternalContext);
 static TTxnStruct  *txnQ_SelectTxn    (TTxnQObj *pTxnQ);
+static McpU32       txnQ_SelectBatch  (TTxnQObj *pTxnQ, TTxnStruct *pFirstTxn);
+static void         txnQ_SetFuncState (TTxnQObj *pTxnQ, McpU32 uFuncId, EFuncState eState);
 static void         txnQ_ClearQueues  (TTxnQObj *pTxnQ, McpU32 uFuncId, McpBool bExternalContext);
 static void         txnQ_ConnectCB    (handle_t hTxnQ, void *hTxn);
 
 
+/* Lowest set bit index of each 4 bits functions mask */
+static const McpU8 aTxnFirstFunc[16] = {0, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0};
+
 
 /************************************************************************
  *
@@ -150,9 +168,8 @@ handle_t txnQ_Create (const handle_t hMcpf)
     
     pTxnQ->hMcpf           = hMcpf;
     pTxnQ->pCurrTxn        = NULL;
-    pTxnQ->uMinFuncId      = TXN_MAX_FUNCTIONS; /* Start at maximum and save minimal value in txnQ_Open */
-    pTxnQ->uMaxFuncId      = 0;             /* Start at minimum and save maximal value in txnQ_Open */
     pTxnQ->bProtectTxnDone = MCP_TRUE;
+    pTxnQ->bBatchTxns      = MCP_FALSE;
 
     for (i = 0; i < TXN_MAX_FUNCTIONS; i++)
     {
@@ -345,7 +362,7 @@ EMcpfRes txnQ_Open (handle_t       		hTxnQ,
     McpU32     uNodeHeaderOffset;
     McpU32     i;
 
-    if (uFuncId > TXN_MAX_FUNCTIONS  ||  uNumPrios > TXN_MAX_PRIORITY) 
+    if (uFuncId >= TXN_MAX_FUNCTIONS  ||  uNumPrios > TXN_MAX_PRIORITY) 
     {
         MCPF_REPORT_ERROR(pTxnQ->hMcpf, QUEUE_MODULE_LOG,
             ("%s: Invalid Params!  uFuncId = %d, uNumPrios = %d\n", __FUNCTION__, uFuncId, uNumPrios));
@@ -360,7 +377,7 @@ EMcpfRes txnQ_Open (handle_t       		hTxnQ,
     pTxnQ->aFuncInfo[uFuncId].hCbHandle       = hCbHandle;
 
     /* Set state as running, since the chip init state is awake. */
-    pTxnQ->aFuncInfo[uFuncId].eState = FUNC_STATE_RUNNING;
+    txnQ_SetFuncState (pTxnQ, uFuncId, FUNC_STATE_RUNNING);
     
     /* Create the functional driver's queues. */
     uNodeHeaderOffset = MCPF_FIELD_OFFSET(TTxnStruct, tTxnQNode); 
@@ -375,16 +392,6 @@ EMcpfRes txnQ_Open (handle_t       		hTxnQ,
         }
     }
 
-    /* Update functions actual range (to optimize Txn selection loops - see txnQ_SelectTxn) */
-    if (uFuncId < pTxnQ->uMinFuncId) 
-    {
-        pTxnQ->uMinFuncId = uFuncId;
-    }
-    if (uFuncId > pTxnQ->uMaxFuncId) 
-    {
-        pTxnQ->uMaxFuncId = uFuncId;
-    }
-
     MCPF_EXIT_CRIT_SEC (pTxnQ->hMcpf);
 
     MCPF_REPORT_INFORMATION(pTxnQ->hMcpf, QUEUE_MODULE_LOG,
@@ -425,24 +432,14 @@ void txnQ_Close (handle_t  hTxnQ, const McpU32 uFuncId)
     pTxnQ->aFuncInfo[uFuncId].uNumPrios       = 0;
     pTxnQ->aFuncInfo[uFuncId].fTxnQueueDoneCb = NULL;
     pTxnQ->aFuncInfo[uFuncId].hCbHandle       = NULL;
-    pTxnQ->aFuncInfo[uFuncId].eState          = FUNC_STATE_NONE;
-    
-    /* Update functions actual range (to optimize Txn selection loops - see txnQ_SelectTxn) */
-    pTxnQ->uMinFuncId      = TXN_MAX_FUNCTIONS; 
-    pTxnQ->uMaxFuncId      = 0;             
-    for (i = 0; i < TXN_MAX_FUNCTIONS; i++) 
+    pTxnQ->aFuncInfo[uFuncId].pSingleStep     = NULL;
+    txnQ_SetFuncState (pTxnQ, uFuncId, FUNC_STATE_NONE);
+
+    /* Remove the function from the ready bitmaps */
+    pTxnQ->uSingleStepMask &= ~TXN_FUNC_BIT(uFuncId);
+    for (i = 0; i < TXN_MAX_PRIORITY; i++)
     {
-        if (pTxnQ->aFuncInfo[i].eState != FUNC_STATE_NONE) 
-        {
-            if (i < pTxnQ->uMinFuncId) 
-            {
-                pTxnQ->uMinFuncId = i;
-            }
-            if (i > pTxnQ->uMaxFuncId) 
-            {
-                pTxnQ->uMaxFuncId = i;
-            }
-        }
+        pTxnQ->aQueuedMask[i] &= ~TXN_FUNC_BIT(uFuncId);
     }
 
     MCPF_EXIT_CRIT_SEC (pTxnQ->hMcpf);
@@ -487,14 +484,19 @@ ETxnStatus txnQ_Restart (handle_t hTxnQ, const McpU32 uFuncId)
     /* If a Txn from the calling function is in progress, set state to RESTART return PENDING */
     if (pTxnQ->pCurrTxn) 
     {
-        if (TXN_PARAM_GET_FUNC_ID(pTxnQ->pCurrTxn) == uFuncId)
+        McpU32 uTxn;
+
+        for (uTxn = pTxnQ->uCurrBatchDone; uTxn < pTxnQ->uCurrBatchNum; uTxn++)
         {
-            pTxnQ->aFuncInfo[uFuncId].eState = FUNC_STATE_RESTART;
+            if (TXN_PARAM_GET_FUNC_ID(pTxnQ->aCurrBatch[uTxn]) == uFuncId)
+            {
+                txnQ_SetFuncState (pTxnQ, uFuncId, FUNC_STATE_RESTART);
 
-            MCPF_EXIT_CRIT_SEC (pTxnQ->hMcpf);
+                MCPF_EXIT_CRIT_SEC (pTxnQ->hMcpf);
 
-            /* Return PENDING to indicate that the restart will be completed later (in TxnDone) */
-            return TXN_STATUS_PENDING;
+                /* Return PENDING to indicate that the restart will be completed later (in TxnDone) */
+                return TXN_STATUS_PENDING;
+            }
         }
     }
 
@@ -538,7 +540,7 @@ void txnQ_Run (handle_t hTxnQ, const McpU32 uFuncId)
     MCPF_ENTER_CRIT_SEC (pTxnQ->hMcpf);
 
     /* Enable function's queues */
-    pTxnQ->aFuncInfo[uFuncId].eState = FUNC_STATE_RUNNING;
+    txnQ_SetFuncState (pTxnQ, uFuncId, FUNC_STATE_RUNNING);
 
     /* Send queued transactions as possible */
     txnQ_RunScheduler (pTxnQ, NULL, MCP_FALSE); 
@@ -572,8 +574,12 @@ void txnQ_Stop (handle_t hTxnQ, const McpU32 uFuncId)
     }
 #endif
 
-    /* Enable function's queues */
-    pTxnQ->aFuncInfo[uFuncId].eState = FUNC_STATE_STOPPED;
+    MCPF_ENTER_CRIT_SEC (pTxnQ->hMcpf);
+
+    /* Disable function's queues */
+    txnQ_SetFuncState (pTxnQ, uFuncId, FUNC_STATE_STOPPED);
+
+    MCPF_EXIT_CRIT_SEC (pTxnQ->hMcpf);
 }
 
 
@@ -601,11 +607,14 @@ ETxnStatus txnQ_Transact (handle_t hTxnQ, TTxnStruct *pTxn)
     if (TXN_PARAM_GET_SINGLE_STEP(pTxn)) 
     {
         pTxnQ->aFuncInfo[uFuncId].pSingleStep = pTxn;
+        pTxnQ->uSingleStepMask |= TXN_FUNC_BIT(uFuncId);
     }
     else 
     {
-        handle_t hQueue = pTxnQ->aTxnQueues[uFuncId][TXN_PARAM_GET_PRIORITY(pTxn)];
+        McpU32   uPrio  = TXN_PARAM_GET_PRIORITY(pTxn);
+        handle_t hQueue = pTxnQ->aTxnQueues[uFuncId][uPrio];
         que_Enqueue (hQueue, (handle_t)pTxn);
+        pTxnQ->aQueuedMask[uPrio] |= TXN_FUNC_BIT(uFuncId);
     }
 
     /* Send queued transactions as possible */
@@ -660,10 +669,11 @@ static void txnQ_TxnDoneCb (handle_t hTxnQ, void *hTxn)
     McpU32   uFuncId = TXN_PARAM_GET_FUNC_ID(pTxn);
 
 #ifdef TRAN_DBG
-    if (pTxn != pTxnQ->pCurrTxn) 
+    if (pTxn != pTxnQ->aCurrBatch[pTxnQ->uCurrBatchDone]) 
     {
         MCPF_REPORT_ERROR(pTxnQ->hMcpf, QUEUE_MODULE_LOG,
-            ("%s: CB returned pTxn 0x%p  while pCurrTxn is 0x%p !!\n", __FUNCTION__, pTxn, pTxnQ->pCurrTxn));
+            ("%s: CB returned pTxn 0x%p  while pCurrTxn is 0x%p !!\n", 
+             __FUNCTION__, pTxn, pTxnQ->aCurrBatch[pTxnQ->uCurrBatchDone]));
     }
 #endif
 
@@ -690,11 +700,16 @@ static void txnQ_TxnDoneCb (handle_t hTxnQ, void *hTxn)
         que_Enqueue (pTxnQ->hTxnDoneQueue, (handle_t)pTxn);
     }
 
-    /* Indicate that no transaction is currently processed in the bus-driver */
-    pTxnQ->pCurrTxn = NULL;
+    /* If other transactions sent together with this one are not completed yet, wait for them */
+    pTxnQ->uCurrBatchDone++;
+    if (pTxnQ->uCurrBatchDone >= pTxnQ->uCurrBatchNum)
+    {
+        /* Indicate that no transaction is currently processed in the bus-driver */
+        pTxnQ->pCurrTxn = NULL;
 
-    /* Send queued transactions as possible (TRUE indicates we are in external context) */
-    txnQ_RunScheduler (pTxnQ, NULL, MCP_TRUE); 
+        /* Send queued transactions as possible (TRUE indicates we are in external context) */
+        txnQ_RunScheduler (pTxnQ, NULL, MCP_TRUE); 
+    }
 
     /* Leave critical section if configured to do so */
     if (pTxnQ->bProtectTxnDone)
@@ -725,6 +740,7 @@ static ETxnStatus txnQ_RunScheduler (TTxnQObj *pTxnQ, TTxnStruct *pInputTxn, Mcp
     /* Use as return value the status of the input transaction (PENDING unless sent and completed here) */
     ETxnStatus eInputTxnStatus = TXN_STATUS_PENDING; 
 	McpBool loopCond = MCP_TRUE;
+    McpU32     uTxn;
 
     /* if a previous transaction is in progress, return PENDING */
     if (pTxnQ->pCurrTxn)
@@ -737,6 +753,7 @@ static ETxnStatus txnQ_RunScheduler (TTxnQObj *pTxnQ, TTxnStruct *pInputTxn, Mcp
     {
         TTxnStruct   *pSelectedTxn;
         ETxnStatus    eStatus;
+        McpU32        uBatchNum;
 
 #ifdef TRAN_DBG
 #define TXN_MAX_LOOP_ITERATES 	100
@@ -756,32 +773,43 @@ static ETxnStatus txnQ_RunScheduler (TTxnQObj *pTxnQ, TTxnStruct *pInputTxn, Mcp
             break;
         }
 
-        /* Send selected transaction to bus driver */
-        eStatus = busDrv_Transact (pTxnQ->hBusDrv, pSelectedTxn);
+        /* If enabled, add more small queued transactions to be sent together with the selected one */
+        uBatchNum = txnQ_SelectBatch (pTxnQ, pSelectedTxn);
 
-        /* If we've just sent the input transaction, use the status as the return value */
-        if (pSelectedTxn == pInputTxn)
+        /* Send selected transaction(s) to bus driver */
+        if (uBatchNum > 1)
+        {
+            eStatus = busDrv_TransactBatch (pTxnQ->hBusDrv, pTxnQ->aCurrBatch, uBatchNum);
+        }
+        else
         {
-            eInputTxnStatus = eStatus;
+            eStatus = busDrv_Transact (pTxnQ->hBusDrv, pSelectedTxn);
         }
 
-        /* If transaction completed */
-        if (eStatus == TXN_STATUS_COMPLETE)
+        for (uTxn = 0; uTxn < uBatchNum; uTxn++)
         {
-            /* If it's not the input transaction, enqueue it in TxnDone queue */
-            if (pSelectedTxn != pInputTxn)
+            /* If we've just sent the input transaction, use the status as the return value */
+            if (pTxnQ->aCurrBatch[uTxn] == pInputTxn)
+            {
+                eInputTxnStatus = eStatus;
+            }
+
+            /* If transaction completed and it's not the input transaction, enqueue it in TxnDone queue */
+            else if (eStatus == TXN_STATUS_COMPLETE)
             {
-                que_Enqueue (pTxnQ->hTxnDoneQueue, (handle_t)pSelectedTxn);
+                que_Enqueue (pTxnQ->hTxnDoneQueue, (handle_t)pTxnQ->aCurrBatch[uTxn]);
             }
         }
 
         /* If pending or error */
-        else 
+        if (eStatus != TXN_STATUS_COMPLETE)
         {
             /* If transaction pending, save it to indicate that the bus driver is busy */
             if (eStatus == TXN_STATUS_PENDING)
             {
-                pTxnQ->pCurrTxn = pSelectedTxn;
+                pTxnQ->pCurrTxn       = pSelectedTxn;
+                pTxnQ->uCurrBatchNum  = uBatchNum;
+                pTxnQ->uCurrBatchDone = 0;
             }
 
             /* Exit loop! */
@@ -822,6 +850,8 @@ static ETxnStatus txnQ_RunScheduler (TTxnQObj *pTxnQ, TTxnStruct *pInputTxn, Mcp
  * 
  * Called from txnQ_RunScheduler() which is protected in critical section.
  * Select the next enabled transaction by priority.
+ * The ready bitmaps are used to find the first function with a transaction waiting,
+ *     instead of polling all functions queues.
  * 
  * \note   
  * \param  pTxnQ - The module's object
@@ -833,35 +863,40 @@ static TTxnStruct *txnQ_SelectTxn (TTxnQObj *pTxnQ)
     TTxnStruct *pSelectedTxn;
     McpU32   uFunc;
     McpU32   uPrio;
+    McpU32   uReadyMask;
 
-    /* For all functions, if single-step Txn waiting, return it (sent even if function is stopped) */
-    for (uFunc = pTxnQ->uMinFuncId; uFunc <= pTxnQ->uMaxFuncId; uFunc++)
+    /* If single-step Txn waiting, return the lowest function one (sent even if function is stopped) */
+    if (pTxnQ->uSingleStepMask)
     {
+        uFunc = TXN_FIRST_FUNC(pTxnQ->uSingleStepMask);
         pSelectedTxn = pTxnQ->aFuncInfo[uFunc].pSingleStep;
-        if (pSelectedTxn != NULL)
-        {
-            pTxnQ->aFuncInfo[uFunc].pSingleStep = NULL;
-            return pSelectedTxn;
-        }
+        pTxnQ->aFuncInfo[uFunc].pSingleStep = NULL;
+        pTxnQ->uSingleStepMask &= ~TXN_FUNC_BIT(uFunc);
+        return pSelectedTxn;
     }
 
     /* For all priorities from high to low */
     for (uPrio = 0; uPrio < TXN_MAX_PRIORITY; uPrio++)
     {
-        /* For all functions */
-        for (uFunc = pTxnQ->uMinFuncId; uFunc <= pTxnQ->uMaxFuncId; uFunc++)
+        /* Functions running with Txns waiting in this priority */
+        uReadyMask = pTxnQ->aQueuedMask[uPrio] & pTxnQ->uRunningMask;
+
+        while (uReadyMask)
         {
-            /* If function running and uses this priority */
-            if (pTxnQ->aFuncInfo[uFunc].eState == FUNC_STATE_RUNNING  &&
-                pTxnQ->aFuncInfo[uFunc].uNumPrios > uPrio)
+            uFunc = TXN_FIRST_FUNC(uReadyMask);
+
+            /* Dequeue Txn from current func and priority queue, and update the bitmap if emptied */
+            pSelectedTxn = (TTxnStruct *) que_Dequeue (pTxnQ->aTxnQueues[uFunc][uPrio]);
+            if (que_Size (pTxnQ->aTxnQueues[uFunc][uPrio]) == 0)
+            {
+                pTxnQ->aQueuedMask[uPrio] &= ~TXN_FUNC_BIT(uFunc);
+            }
+
+            if (pSelectedTxn != NULL)
             {
-                /* Dequeue Txn from current func and priority queue, and if not NULL return it */
-                pSelectedTxn = (TTxnStruct *) que_Dequeue (pTxnQ->aTxnQueues[uFunc][uPrio]);
-                if (pSelectedTxn != NULL)
-                {
-                    return pSelectedTxn;
-                }
+                return pSelectedTxn;
             }
+            uReadyMask &= ~TXN_FUNC_BIT(uFunc);
         }
     }
 
@@ -870,6 +905,69 @@ static TTxnStruct *txnQ_SelectTxn (TTxnQObj *pTxnQ)
 }
 
 
+/** 
+ * \fn     txnQ_SelectBatch
+ * \brief  Select transactions to send together
+ * 
+ * Called from txnQ_RunScheduler() which is protected in critical section.
+ * If batching is enabled, select more transactions by priority to be sent together with 
+ *     the already selected one, as long as their total length fits the bus driver batch.
+ * A selected transaction that doesn't fit is returned to the head of its queue.
+ * The selected transactions are saved in aCurrBatch.
+ * 
+ * \note   
+ * \param  pTxnQ     - The module's object
+ * \param  pFirstTxn - The transaction already selected to send
+ * \return The number of transactions to send (at least 1)
+ * \sa     txnQ_SelectTxn
+ */ 
+static McpU32 txnQ_SelectBatch (TTxnQObj *pTxnQ, TTxnStruct *pFirstTxn)
+{
+    TTxnStruct *pTxn;
+    McpU32   uBatchNum = 1;
+    McpU32   uBatchLen;
+    McpU32   uTxnLen;
+
+    pTxnQ->aCurrBatch[0] = pFirstTxn;
+
+    /* Single step transactions are always sent alone */
+    if (!pTxnQ->bBatchTxns  ||  TXN_PARAM_GET_SINGLE_STEP(pFirstTxn))
+    {
+        return 1;
+    }
+
+    uBatchLen = busDrv_GetTxnLen (pFirstTxn);
+
+    /* Stop if a single step transaction is waiting - it goes first */
+    while (uBatchNum < BUSDRV_BATCH_MAX_TXNS  &&  !pTxnQ->uSingleStepMask)
+    {
+        pTxn = txnQ_SelectTxn (pTxnQ);
+        if (pTxn == NULL)
+        {
+            break;
+        }
+
+        uTxnLen = busDrv_GetTxnLen (pTxn);
+        if (uBatchLen + uTxnLen > BUSDRV_BATCH_BUF_SIZE)
+        {
+            McpU32 uFuncId = TXN_PARAM_GET_FUNC_ID(pTxn);
+            McpU32 uPrio   = TXN_PARAM_GET_PRIORITY(pTxn);
+
+            /* Doesn't fit - return it to be the next one selected */
+            que_Requeue (pTxnQ->aTxnQueues[uFuncId][uPrio], (handle_t)pTxn);
+            pTxnQ->aQueuedMask[uPrio] |= TXN_FUNC_BIT(uFuncId);
+            break;
+        }
+
+        pTxnQ->aCurrBatch[uBatchNum++] = pTxn;
+        uBatchLen += uTxnLen;
+    }
+
+    /* Note that a first transaction longer than the batch is sent alone, as nothing fits with it */
+    return uBatchNum;
+}
+
+
 /** 
  * \fn     txnQ_ClearQueues
  * \brief  Clear the function queues
@@ -895,6 +993,8 @@ static void txnQ_ClearQueues (TTxnQObj *pTxnQ, McpU32 uFuncId, McpBool bExternal
     pTxn = pTxnQ->aFuncInfo[uFuncId].pSingleStep;
     if (pTxn != NULL)
     {
+        pTxnQ->aFuncInfo[uFuncId].pSingleStep = NULL;
+        pTxnQ->uSingleStepMask &= ~TXN_FUNC_BIT(uFuncId);
         TXN_PARAM_SET_STATUS(pTxn, TXN_STATUS_RECOVERY);
         fTxnQueueDoneCb (hCbHandle, pTxn, bExternalContext);
     }
@@ -917,10 +1017,64 @@ static void txnQ_ClearQueues (TTxnQObj *pTxnQ, McpU32 uFuncId, McpBool bExternal
             TXN_PARAM_SET_STATUS(pTxn, TXN_STATUS_RECOVERY);
             fTxnQueueDoneCb (hCbHandle, pTxn, bExternalContext);
         }
+
+        pTxnQ->aQueuedMask[uPrio] &= ~TXN_FUNC_BIT(uFuncId);
     }
 }
 
 
+/** 
+ * \fn     txnQ_SetFuncState
+ * \brief  Set function state
+ * 
+ * Set the function SM state and update the running functions bitmap accordingly.
+ * 
+ * \note   Called in critical section.
+ * \param  pTxnQ   - The module's object
+ * \param  uFuncId - The functional driver
+ * \param  eState  - The new state
+ * \return void
+ * \sa     txnQ_SelectTxn
+ */ 
+static void txnQ_SetFuncState (TTxnQObj *pTxnQ, McpU32 uFuncId, EFuncState eState)
+{
+    pTxnQ->aFuncInfo[uFuncId].eState = eState;
+
+    if (eState == FUNC_STATE_RUNNING)
+    {
+        pTxnQ->uRunningMask |= TXN_FUNC_BIT(uFuncId);
+    }
+    else
+    {
+        pTxnQ->uRunningMask &= ~TXN_FUNC_BIT(uFuncId);
+    }
+}
+
+
+/** 
+ * \fn     txnQ_EnableBatching
+ * \brief  Enable or disable transactions batching
+ * 
+ * When enabled, the scheduler hands several small queued transactions to the 
+ *     bus driver together (see busDrv_TransactBatch), saving a bus write and 
+ *     completion per transaction. Single step transactions are always sent alone.
+ * 
+ * \note   Disabled by default.
+ * \param  hTxnQ   - The module's object
+ * \param  bEnable - TRUE to enable batching, FALSE to disable
+ * \return void
+ * \sa     
+ */ 
+void txnQ_EnableBatching (handle_t hTxnQ, const McpBool bEnable)
+{
+    TTxnQObj *pTxnQ = (TTxnQObj*)hTxnQ;
+
+    MCPF_ENTER_CRIT_SEC (pTxnQ->hMcpf);
+    pTxnQ->bBatchTxns = bEnable;
+    MCPF_EXIT_CRIT_SEC (pTxnQ->hMcpf);
+}
+
+
 /** 
  * \fn     txnQ_GetBusDrvHandle
  * \brief  Gets bus driver handle
@@ -41,6 +41,19 @@
 /* MS to wait for HCI events */
 #define COMMAND_COMPL_WAIT_TIME  (500)
 
+/* Minimum number of slots in client dispatch table, must be power of 2 */
+#define CLIENT_TABLE_MIN_SIZE	 (8)
+
+/* Client dispatch table slot hash of HCI opcode, event codes fall to direct index */
+#define CLIENT_TABLE_HASH(_opcode)	((McpU32)(_opcode) ^ ((McpU32)(_opcode) >> 8))
+
+/* Orders the dispatch table publishing against the lock-free lookup of receive path */
+#ifdef __GNUC__
+#define HCIA_MEM_BARRIER()		 __sync_synchronize()
+#else
+#define HCIA_MEM_BARRIER()
+#endif
+
 #if 0
 #define WATCHDOG_COMMANDS
 #endif
@@ -56,6 +69,7 @@ typedef struct
 	handle_t       		hCbParam;		/* call back parameter to pass 				*/
 	TTxnStruct 			*pTxn;			/* Transaction structure containing HCI command packet */			
     McpBool             needFreeMem;    /* indication if need to free transaction buffer when command complete */		
+	McpU16				uOpcode;		/* HCI command opcode, used to match the completion event */
 
 } TCmdNode;
 
@@ -69,17 +83,41 @@ typedef struct
 
 } TClientNode;
 
+/* Client Dispatch Entry */
+typedef struct
+{
+	McpU32				uOpcode;        /* Hci message opcode 						  */
+	TI_TransRxIndCb   	fRxIndCb;		/* User receive indicaiton call back function, NULL for empty slot */
+	handle_t       		hCbParam;		/* call back parameter to pass 				  */
+
+} TClientEntry;
+
+/* 
+ * Client Dispatch Table, built from the client list of HCI packet type on each register 
+ * and unregister, never modified once published
+ */
+typedef struct _TClientTable
+{
+	struct _TClientTable *pNextRetired;	/* Next replaced table waiting to be freed 	  */
+	McpU32				uRetireSeq;		/* Receive sequence number when the table was replaced */
+	TClientEntry		tAnyClient;		/* Client registered to HCIA_ANY_OPCODE 	  */
+	McpU32				uMask;			/* Number of slots minus one 				  */
+	TClientEntry		aSlot[1];		/* Open addressed slots indexed by opcode hash */
+
+} TClientTable;
+
 /* Command Queue */
 typedef struct
 {
 	handle_t       	hMcpf;                        
 	handle_t		hOutQue;
-	handle_t		hSentQue;
+	MCP_DL_LIST_Node tSentList;			/* commands sent but not completed yet, matched by opcode */
 	handle_t		hPool;
 
 	McpU32			uCmdMaxNum;			/* maximum number of command nodes in pool */
 	McpU32			uOutCmdMaxNum;		/* maximum number of commands to send while waiting for compl. event 	 */
 	McpU32			uOutCmdNum;			/* current number of commands already already sent but not completed yet */
+	McpU32			uCredits;			/* number of commands the controller accepts (Num_HCI_Command_Packets) */
     handle_t        watchdogTimer;      /* Watchdog timer for HCI events */
     mcpf_timer_cb   watchDogTimerCB;    /* watchdog callback routine */
     McpBool         unackedCommand;     /* TRUE when there is an unacknowledged command */
@@ -95,6 +133,9 @@ typedef struct
 	McpU32       		uIndexOfs;			/* Offset to convert HCI packet type to client list index 	*/
     MCP_DL_LIST_Node  	*pListArray;     	/* Array of list headers, list per HCI packet type  		*/
     McpBool   		  	*pChanStateArray;  	/* Array of bool flags whether the transport channel is open*/
+	TClientTable * volatile *pTableArray;	/* Array of published dispatch tables, per HCI packet type */
+	TClientTable		*pRetiredList;		/* Replaced dispatch tables not freed yet 				  */
+	volatile McpU32		uRxSeq;				/* Receive sequence number, odd while looking up a table  */
 
 } TClientRegister;
 
@@ -142,6 +183,12 @@ static  EMcpfRes cmdQueue_complete (TCmdQueue   	*pCmdQue,
 
 static void cmdQueue_freeCmdTxn (const TCmdQueue *pCmdQue, TCmdNode *pCmd);
 
+static McpU16 cmdQueue_getOpcode (TTxnStruct *pTxn);
+
+static EMcpfRes cmdQueue_send (TCmdQueue *pCmdQue, TCmdNode *pCmd);
+
+static void cmdQueue_sendQueued (TCmdQueue *pCmdQue);
+
 static void cmdQueue_flush (TCmdQueue *pCmdQue);
 
 static TClientRegister * clientRegister_Create (const THciaObj 	*pHcia,
@@ -166,6 +213,8 @@ static EMcpfRes clientRegister_searchAndInvoke (TClientRegister 	*pClientReg,
 												handle_t			hTrans,
 												TTxnStruct 			*pTxn);
 
+static void clientRegister_publish (TClientRegister *pClientReg, const McpU32 uList);
+
 static EMcpfRes clientRegister_openTransChan (TClientRegister 	  		*pClientReg, 
 											  const McpU8 				uHciMsgType,
 											  const TI_TransRxIndCb 	fCallBack,
@@ -578,14 +627,14 @@ static TCmdQueue * cmdQueue_Create (const THciaObj 	*pHcia,
 	pCmdQue->hMcpf 	   	   = pHcia->hMcpf;
 	pCmdQue->uCmdMaxNum    = uCmdMaxNum;
 	pCmdQue->uOutCmdMaxNum = uOutCmdMaxNum;
+	pCmdQue->uCredits      = uOutCmdMaxNum;
+
+	MCP_DL_LIST_InitializeHead (&pCmdQue->tSentList);
 
 	uNodeHeaderOffset = MCPF_FIELD_OFFSET(TCmdNode, tHead);
 	pCmdQue->hOutQue     = mcpf_que_Create(pHcia->hMcpf, uCmdMaxNum, uNodeHeaderOffset);
 	MCPF_Assert(pCmdQue->hOutQue);
 
-	pCmdQue->hSentQue    = mcpf_que_Create(pHcia->hMcpf, uOutCmdMaxNum + 1, uNodeHeaderOffset);
-	MCPF_Assert(pCmdQue->hSentQue);
-
 	pCmdQue->hPool = mcpf_memory_pool_create((handle_t)pHcia->hMcpf, sizeof(TCmdNode), (McpU16) uCmdMaxNum);
 	MCPF_Assert(pCmdQue->hPool);
 
@@ -608,7 +657,6 @@ static void cmdQueue_Destroy (TCmdQueue * pCmdQue)
 	cmdQueue_flush (pCmdQue);
 
 	mcpf_que_Destroy (pCmdQue->hOutQue);
-	mcpf_que_Destroy (pCmdQue->hSentQue);
 
 	if (pCmdQue->hPool)
 	{
@@ -624,7 +672,8 @@ static void cmdQueue_Destroy (TCmdQueue * pCmdQue)
  * 
  * Send the command, if flow control allows or enqueue it, if not.
  * 
- * \note
+ * \note  The command is sent out of the critical section, it is linked to the sent
+ *         list before, so that its completion event may be matched at any time.
  * \param	pCmdQue - pointer to Command Queue object
  * \param	pTxn    - pointer to transaction structure to send
  * \param	fCallBack - command completion call back function
@@ -653,16 +702,25 @@ static EMcpfRes cmdQueue_add (TCmdQueue 				*pCmdQue,
 		pCmd->fCmdComplCb = fCallBack;
 		pCmd->hCbParam 	  = hCbParam;
 		pCmd->needFreeMem = needFreeMem;
+		pCmd->uOpcode	  = cmdQueue_getOpcode (pTxn);
 
-		/* Check command flow control, whether it is possible to send the command */
-
+		/* 
+		 * Check command flow control, whether it is possible to send the command: the controller
+		 * has credits and no earlier command is waiting in the output queue
+		 */
 		MCPF_ENTER_CRIT_SEC (pCmdQue->hMcpf);
-		if (pCmdQue->uOutCmdNum < pCmdQue->uOutCmdMaxNum)
+		if ((pCmdQue->uCredits > 0) && 
+			(pCmdQue->uOutCmdNum < pCmdQue->uOutCmdMaxNum) &&
+			(mcpf_que_Size (pCmdQue->hOutQue) == 0))
 		{
+			pCmdQue->uCredits--;
 			pCmdQue->uOutCmdNum++;
+			MCP_DL_LIST_InsertTail (&pCmdQue->tSentList, &pCmd->tHead);
 			bSend = MCP_TRUE;
-        /*    MCPF_REPORT_INFORMATION (pCmdQue->hMcpf, TRANS_MODULE_LOG, 
-								  ("pCmdQue->uOutCmdNum increased %d", pCmdQue->uOutCmdNum));*/
+		}
+		else
+		{
+			eRes = mcpf_que_Enqueue (pCmdQue->hOutQue, pCmd);	/* add to command output queue tail */
 		}
 		MCPF_EXIT_CRIT_SEC (pCmdQue->hMcpf);
 
@@ -693,36 +751,19 @@ static EMcpfRes cmdQueue_add (TCmdQueue 				*pCmdQue,
             }
 #endif
 			/* Flow control allows to send the command */
-            MCPF_ENTER_CRIT_SEC (pCmdQue->hMcpf);
-			eRes = mcpf_trans_TxData(pCmdQue->hMcpf, pCmd->pTxn);
-			if (eRes == RES_OK)
-			{
-				EMcpfRes eResQ;
-
-				eResQ = mcpf_que_Enqueue (pCmdQue->hSentQue, pCmd);  /* add to queue of commands waiting for completion */
-
-				if (eResQ != RES_OK)
-				{
-					MCPF_REPORT_ERROR (pCmdQue->hMcpf, TRANS_MODULE_LOG, 
-									  ("cmdQueue_add: completion queue is full\n"));
-				}
-			}
-			else
+			eRes = cmdQueue_send (pCmdQue, pCmd);
+			if (eRes != RES_OK)
 			{
-				MCPF_REPORT_ERROR (pCmdQue->hMcpf, TRANS_MODULE_LOG, 
-								  ("cmdQueue_add: cmd send error\n"));
+				/* the caller owns and frees the transaction on failure */
+				mcpf_mem_free_from_pool (pCmdQue->hMcpf, pCmd); 
 			}
-            MCPF_EXIT_CRIT_SEC (pCmdQue->hMcpf);
 		}
 		else
 		{
-			/* Flow control does not allow to send the command, en-queue it */
+			/* Flow control does not allow to send the command, it was en-queued */
             MCPF_REPORT_WARNING (pCmdQue->hMcpf, TRANS_MODULE_LOG, 
-                                 ("cmdQueue_add: flow control command not sent out %d max %d ",
-                                  pCmdQue->uOutCmdNum ,pCmdQue->uOutCmdMaxNum));
-			MCPF_ENTER_CRIT_SEC (pCmdQue->hMcpf);
-			eRes = mcpf_que_Enqueue (pCmdQue->hOutQue, pCmd);	/* add to command output queue tail */
-			MCPF_EXIT_CRIT_SEC (pCmdQue->hMcpf);
+                                 ("cmdQueue_add: flow control command not sent out %d max %d credits %d",
+                                  pCmdQue->uOutCmdNum ,pCmdQue->uOutCmdMaxNum, pCmdQue->uCredits));
 
 			if (eRes != RES_OK)
 			{
@@ -747,10 +788,13 @@ static EMcpfRes cmdQueue_add (TCmdQueue 				*pCmdQue,
  * \fn     cmdQueue_complete 
  * \brief  Command queue complete event
  * 
- * Process command complete event: sent the next command from queue and 
- * invoke completion call back funciton
+ * Process command complete or command status event: update the controller 
+ * credits, send the queued commands the credits allow and invoke completion 
+ * call back function of the command matching the event opcode
  * 
- * \note
+ * \note   Completions may arrive in any order, the event is matched to the oldest
+ *         sent command with the same opcode. Event with zero (NOP) opcode only
+ *         updates the credits.
  * \param	pCmdQue - pointer to Command Queue object
  * \param	uEvtOpcode   - event opcode
  * \param	uEvtParamLen - lenght of event parameters
@@ -764,61 +808,59 @@ static EMcpfRes cmdQueue_complete (TCmdQueue   	*pCmdQue,
 								   McpU8		*pEvtParams,
                                    McpBool          *needFreeMem)
 {
-	TCmdNode 	*pCmd;
-	EMcpfRes	eRes 	= RES_ERROR;
+	TCmdNode 	*pCmd = NULL;
+	MCP_DL_LIST_Node *pNode;
+	EMcpfRes	eRes;
+	McpU8		uCredits;
+	McpU16		uCmdOpcode;
     *needFreeMem = MCP_TRUE;
 #ifdef WATCHDOG_COMMANDS
     pCmdQue->unackedCommand = MCP_FALSE;
 #endif    
-	/* Fetch the next command to send from output command queue */
-	MCPF_ENTER_CRIT_SEC (pCmdQue->hMcpf);
-	pCmd = (TCmdNode *) mcpf_que_Dequeue (pCmdQue->hOutQue);
-	if (!pCmd)
+
+	/* Parse Num_HCI_Command_Packets and command opcode of the event */
+	if ((uEvtOpcode == CCMA_HCI_EVENT_COMMAND_STATUS) && (uEvtParamLen >= 4))
 	{
-		/* The output command queue is empty, nothing to send, decrement flow control counter */
-		if (pCmdQue->uOutCmdNum > 0)
-		{
-		    pCmdQue->uOutCmdNum--;
-		}
-		else
-		{
-		    MCPF_REPORT_ERROR (pCmdQue->hMcpf, TRANS_MODULE_LOG, 
-		                                         ("cmdQueue_complete: trying to decrement zero uOutCmdNum!\n"));
-		}
-/*        MCPF_REPORT_INFORMATION (pCmdQue->hMcpf, TRANS_MODULE_LOG, 
-								  ("cmdQueue_complete: pCmdQue->uOutCmdNum decreased %d", pCmdQue->uOutCmdNum));*/
+		uCredits   = pEvtParams[1];
+		uCmdOpcode = mcpf_endian_LEtoHost16 (&pEvtParams[2]);
+	}
+	else if ((uEvtOpcode != CCMA_HCI_EVENT_COMMAND_STATUS) && (uEvtParamLen >= 3))
+	{
+		uCredits   = pEvtParams[0];
+		uCmdOpcode = mcpf_endian_LEtoHost16 (&pEvtParams[1]);
+	}
+	else
+	{
+		MCPF_REPORT_ERROR (pCmdQue->hMcpf, TRANS_MODULE_LOG, 
+						  ("cmdQueue_complete: event 0x%02x too short (%d)\n", uEvtOpcode, uEvtParamLen));
+		return RES_ERROR;
 	}
-	MCPF_EXIT_CRIT_SEC (pCmdQue->hMcpf);
 
-	if (pCmd)
+	/* Update the controller credits and remove the matching command from the sent list */
+	MCPF_ENTER_CRIT_SEC (pCmdQue->hMcpf);
+	if (uCmdOpcode != 0)
 	{
-		eRes = mcpf_trans_TxData(pCmdQue->hMcpf, pCmd->pTxn);
-		if (eRes == RES_OK)
+		MCP_DL_LIST_ITERATE (&pCmdQue->tSentList, pNode)
 		{
-			MCPF_ENTER_CRIT_SEC (pCmdQue->hMcpf);
-			eRes = mcpf_que_Enqueue (pCmdQue->hSentQue, pCmd);   /* items waiting for completion */
-			MCPF_EXIT_CRIT_SEC (pCmdQue->hMcpf);
-
-			if (eRes != RES_OK)
+			if (((TCmdNode *) pNode)->uOpcode == uCmdOpcode)
 			{
-				mcpf_mem_free_from_pool(pCmdQue->hMcpf, pCmd); 
-				MCPF_REPORT_ERROR (pCmdQue->hMcpf, TRANS_MODULE_LOG, 
-								  ("cmdQueue_complete: sent cmd queue is full\n"));
+				pCmd = (TCmdNode *) pNode;
+				break;
 			}
 		}
-		else
+
+		if (pCmd)
 		{
-			cmdQueue_freeCmdTxn (pCmdQue, pCmd);
-			MCPF_REPORT_ERROR (pCmdQue->hMcpf, TRANS_MODULE_LOG, 
-							  ("cmdQueue_add: cmd send error\n"));
+			MCP_DL_LIST_RemoveNode (&pCmd->tHead);
+			pCmdQue->uOutCmdNum--;
 		}
 	}
-
-	/* Dequeue command pending for completion and invoke completion function */
-	MCPF_ENTER_CRIT_SEC (pCmdQue->hMcpf);
-	pCmd = mcpf_que_Dequeue (pCmdQue->hSentQue);
+	pCmdQue->uCredits = (uCredits < pCmdQue->uOutCmdMaxNum) ? uCredits : pCmdQue->uOutCmdMaxNum;
 	MCPF_EXIT_CRIT_SEC (pCmdQue->hMcpf);
 
+	/* Send the next commands from output command queue */
+	cmdQueue_sendQueued (pCmdQue);
+
 	if (pCmd)
 	{
 		if (pCmd->fCmdComplCb)
@@ -845,16 +887,133 @@ static EMcpfRes cmdQueue_complete (TCmdQueue   	*pCmdQue,
 	}
 	else
 	{
-		eRes = RES_ERROR;
+		/* credits update or completion of not queued command, deliver it to the registered clients */
+		eRes = RES_PENDING;
+		if (uCmdOpcode != 0)
+		{
+			MCPF_REPORT_WARNING (pCmdQue->hMcpf, TRANS_MODULE_LOG, 
+				("cmdQueue_complete: no sent command matches opcode 0x%04x\n", uCmdOpcode));
+		}
+	}
+
+	return eRes;
+}
+
+
+/** 
+ * \fn     cmdQueue_getOpcode 
+ * \brief  Get HCI command opcode
+ * 
+ * Returns the opcode of HCI command packet contained in transaction structure
+ * 
+ * \note   The opcode is located in txn header if txn flag is set or in data buffer otherwise
+ * \param	pTxn - pointer to transaction structure
+ * \return 	HCI command opcode
+ * \sa     	cmdQueue_add
+ */ 
+static McpU16 cmdQueue_getOpcode (TTxnStruct *pTxn)
+{
+	if (TXN_PARAM_GET_TXN_FLAG(pTxn))
+	{
+		return mcpf_endian_LEtoHost16 (&pTxn->tHeader.tHciHeader.aHeader[0]);
+	}
+	return mcpf_endian_LEtoHost16 (&pTxn->pData[1]);
+}
+
+
+/** 
+ * \fn     cmdQueue_send 
+ * \brief  Send command
+ * 
+ * Sends command already linked to the sent list and accounted by flow control
+ * 
+ * \note   Called out of critical section. On failure the command is unlinked 
+ *         from the sent list and its credit is returned. A command that was already
+ *         completed and freed meanwhile is no longer on the sent list, RES_OK is then 
+ *         returned so the caller does not free it again.
+ * \param	pCmdQue - pointer to Command Queue object
+ * \param	pCmd    - pointer to command node
+ * \return 	result of operation: RES_OK or RES_ERROR
+ * \sa     	cmdQueue_add, cmdQueue_sendQueued
+ */ 
+static EMcpfRes cmdQueue_send (TCmdQueue *pCmdQue, TCmdNode *pCmd)
+{
+	EMcpfRes eRes;
+
+	McpBool	 bOnList;
+
+	eRes = mcpf_trans_TxData(pCmdQue->hMcpf, pCmd->pTxn);
+	if (eRes != RES_OK)
+	{
+		/* 
+		 * The node is looked up on the sent list rather than through its own links: 
+		 * cmdQueue_complete may have removed it, which clears the links, and freed it
+		 */
+		MCPF_ENTER_CRIT_SEC (pCmdQue->hMcpf);
+		bOnList = MCP_DL_LIST_IsNodeOnList (&pCmdQue->tSentList, &pCmd->tHead);
+		if (bOnList)
+		{
+			MCP_DL_LIST_RemoveNode (&pCmd->tHead);
+			pCmdQue->uOutCmdNum--;
+			pCmdQue->uCredits++;
+		}
+		MCPF_EXIT_CRIT_SEC (pCmdQue->hMcpf);
+
 		MCPF_REPORT_ERROR (pCmdQue->hMcpf, TRANS_MODULE_LOG, 
-		    ("cmdQueue_complete: sent queue (handle 0x%08x) is unexpectedly empty\n",
-		     (McpU32)pCmdQue->hSentQue));
+						  ("cmdQueue_send: cmd send error\n"));
+
+		if (!bOnList)
+		{
+			/* The command was completed meanwhile and belongs to the caller no more */
+			eRes = RES_OK;
+		}
 	}
 
 	return eRes;
 }
 
 
+/** 
+ * \fn     cmdQueue_sendQueued 
+ * \brief  Send queued commands
+ * 
+ * Sends commands from output command queue while the controller has credits
+ * 
+ * \note
+ * \param	pCmdQue - pointer to Command Queue object
+ * \return 	void
+ * \sa     	cmdQueue_complete
+ */ 
+static void cmdQueue_sendQueued (TCmdQueue *pCmdQue)
+{
+	TCmdNode *pCmd;
+
+	do
+	{
+		pCmd = NULL;
+
+		MCPF_ENTER_CRIT_SEC (pCmdQue->hMcpf);
+		if ((pCmdQue->uCredits > 0) && (pCmdQue->uOutCmdNum < pCmdQue->uOutCmdMaxNum))
+		{
+			pCmd = (TCmdNode *) mcpf_que_Dequeue (pCmdQue->hOutQue);
+			if (pCmd)
+			{
+				pCmdQue->uCredits--;
+				pCmdQue->uOutCmdNum++;
+				MCP_DL_LIST_InsertTail (&pCmdQue->tSentList, &pCmd->tHead);
+			}
+		}
+		MCPF_EXIT_CRIT_SEC (pCmdQue->hMcpf);
+
+		if (pCmd && (cmdQueue_send (pCmdQue, pCmd) != RES_OK))
+		{
+			cmdQueue_freeCmdTxn (pCmdQue, pCmd);
+		}
+
+	} while (pCmd);
+}
+
+
 /** 
  * \fn     cmdQueue_freeCmdTxn 
  * \brief  Free command node and linked transaction structure
@@ -884,7 +1043,7 @@ static void cmdQueue_freeCmdTxn (const TCmdQueue *pCmdQue, TCmdNode *pCmd)
  * \fn     cmdQueue_flush
  * \brief  Resets the command queue
  * 
- * Flushes the command otput and pending queues, resets the flow control
+ * Flushes the command otput queue and sent list, resets the flow control
  * 
  * \note
  * \param	pCmdQue - pointer to command queue object
@@ -910,8 +1069,14 @@ static void cmdQueue_flush (TCmdQueue *pCmdQue)
 
 	do
 	{
+		pCmd = NULL;
+
 		MCPF_ENTER_CRIT_SEC (pCmdQue->hMcpf);
-		pCmd = (TCmdNode *) mcpf_que_Dequeue (pCmdQue->hSentQue);
+		if (!MCP_DL_LIST_IsEmpty (&pCmdQue->tSentList))
+		{
+			pCmd = (TCmdNode *) MCP_DL_LIST_GetHead (&pCmdQue->tSentList);
+			MCP_DL_LIST_RemoveNode (&pCmd->tHead);
+		}
 		MCPF_EXIT_CRIT_SEC (pCmdQue->hMcpf);
 
 		if (pCmd)
@@ -922,6 +1087,7 @@ static void cmdQueue_flush (TCmdQueue *pCmdQue)
 	} while (pCmd);
 
 	pCmdQue->uOutCmdNum = 0;
+	pCmdQue->uCredits   = pCmdQue->uOutCmdMaxNum;
 }
 
 /** 
@@ -959,6 +1125,10 @@ static TClientRegister * clientRegister_Create (const THciaObj 	*pHcia,
 	MCPF_Assert(pClientReg->pListArray);
 	mcpf_mem_zero (pHcia->hMcpf, pClientReg->pChanStateArray, sizeof(McpBool) * pClientReg->uListNum);
 
+	pClientReg->pTableArray = mcpf_mem_alloc (pHcia->hMcpf, (McpU16) (sizeof(TClientTable *) * pClientReg->uListNum));
+	MCPF_Assert(pClientReg->pTableArray);
+	mcpf_mem_zero (pHcia->hMcpf, (void *) pClientReg->pTableArray, sizeof(TClientTable *) * pClientReg->uListNum);
+
 	for ( uInx=0; uInx < pClientReg->uListNum; uInx++)
 	{
 		MCP_DL_LIST_InitializeHead (&pClientReg->pListArray[uInx]);
@@ -983,6 +1153,7 @@ static TClientRegister * clientRegister_Create (const THciaObj 	*pHcia,
 static void clientRegister_Destroy (TClientRegister * pClientReg)
 {
 	McpU32	uListInx;
+	TClientTable *pTable;
 
 
 	MCPF_ENTER_CRIT_SEC (pClientReg->hMcpf);
@@ -998,10 +1169,24 @@ static void clientRegister_Destroy (TClientRegister * pClientReg)
 			mcpf_mem_free (pClientReg->hMcpf, pNode);
 			pNode = pNext;
 		}
+
+		if (pClientReg->pTableArray[uListInx])
+		{
+			mcpf_mem_free (pClientReg->hMcpf, pClientReg->pTableArray[uListInx]);
+		}
+	}
+
+	/* Free the replaced dispatch tables */
+	while (pClientReg->pRetiredList)
+	{
+		pTable = pClientReg->pRetiredList;
+		pClientReg->pRetiredList = pTable->pNextRetired;
+		mcpf_mem_free (pClientReg->hMcpf, pTable);
 	}
 
 	MCPF_EXIT_CRIT_SEC (pClientReg->hMcpf);
 
+	mcpf_mem_free (pClientReg->hMcpf, (void *) pClientReg->pTableArray);
 	mcpf_mem_free (pClientReg->hMcpf, pClientReg->pListArray);
 	mcpf_mem_free (pClientReg->hMcpf, pClientReg->pChanStateArray);
 	mcpf_mem_free (pClientReg->hMcpf, pClientReg);
@@ -1056,6 +1241,7 @@ static EMcpfRes clientRegister_add (TClientRegister 	  	*pClientReg,
 		{
 			MCP_DL_LIST_InsertHead (&pClientReg->pListArray[uList], &pClient->tHead);
 		}
+		clientRegister_publish (pClientReg, uList);
 		MCPF_EXIT_CRIT_SEC (pClientReg->hMcpf);
 
 		if (listEmpty)
@@ -1113,6 +1299,10 @@ static EMcpfRes clientRegister_delete (TClientRegister *pClientReg,
 				break;
 			}
 		}
+		if (eRes == RES_OK)
+		{
+			clientRegister_publish (pClientReg, uList);
+		}
 		listEmpty = MCP_DL_LIST_IsEmpty (&pClientReg->pListArray[uList]);
 		MCPF_EXIT_CRIT_SEC (pClientReg->hMcpf);
 
@@ -1144,12 +1334,14 @@ static EMcpfRes clientRegister_delete (TClientRegister *pClientReg,
  * 
  * Searches for client node by type & opcode and, if found, invokes the call back function
  * 
- * \note
+ * \note   Lock free lookup in the published dispatch table of HCI type, may be called
+ *         from the single receive context only. The receive sequence number tells
+ *         the publisher when a replaced table is no longer looked up.
  * \param	pClientReg - pointer to ClientRegister object
  * \param	uHciMsgType - de-register from message of HCI type
  * \param	uHciOpcode - de-register from message of HCI opcode
  * \return 	status of operation RES_OK or RES_ERROR
- * \sa     	clientRegister_delete
+ * \sa     	clientRegister_publish
  */ 
 static EMcpfRes clientRegister_searchAndInvoke (TClientRegister 	*pClientReg, 
 												const McpU8 		uHciMsgType,
@@ -1163,28 +1355,43 @@ static EMcpfRes clientRegister_searchAndInvoke (TClientRegister 	*pClientReg,
 
 	if (uList < pClientReg->uListNum)
 	{
-		MCP_DL_LIST_Node  *pNode;
+		TClientTable  *pTable;
+		TClientEntry  tClient;
+		McpU32		  uSlot;
 
-		MCPF_ENTER_CRIT_SEC (pClientReg->hMcpf);
+		pClientReg->uRxSeq++;
+		HCIA_MEM_BARRIER();
 
-		/* traverse the list to find the item */
-		MCP_DL_LIST_ITERATE(&pClientReg->pListArray[uList], pNode)
+		pTable = pClientReg->pTableArray[uList];
+		if (pTable)
 		{
-			if ( ((TClientNode *)pNode)->uOpcode == uHciOpcode   ||  
-				 ((TClientNode *)pNode)->uOpcode == HCIA_ANY_OPCODE)
+			/* probe the slots starting from opcode hash up to the empty one */
+			for (uSlot = CLIENT_TABLE_HASH(uHciOpcode) & pTable->uMask; 
+				 pTable->aSlot[uSlot].fRxIndCb != NULL; 
+				 uSlot = (uSlot + 1) & pTable->uMask)
 			{
-				/* Item found */
-				bFound = MCP_TRUE;
-				break;
+				if (pTable->aSlot[uSlot].uOpcode == uHciOpcode)
+				{
+					/* Item found */
+					tClient = pTable->aSlot[uSlot];
+					bFound  = MCP_TRUE;
+					break;
+				}
+			}
+
+			if (!bFound && pTable->tAnyClient.fRxIndCb)
+			{
+				tClient = pTable->tAnyClient;
+				bFound  = MCP_TRUE;
 			}
 		}
-		MCPF_EXIT_CRIT_SEC (pClientReg->hMcpf);
+
+		HCIA_MEM_BARRIER();
+		pClientReg->uRxSeq++;
 
 		if (bFound)
 		{
-			TClientNode * pClient =  (TClientNode *) pNode;
-
-			eRes = pClient->fRxIndCb (hTrans, pClient->hCbParam, pTxn);
+			eRes = tClient.fRxIndCb (hTrans, tClient.hCbParam, pTxn);
 		}
 		else
 		{
@@ -1203,6 +1410,117 @@ static EMcpfRes clientRegister_searchAndInvoke (TClientRegister 	*pClientReg,
 }
 
 
+/** 
+ * \fn     clientRegister_publish 
+ * \brief  Publish client dispatch table
+ * 
+ * Builds the dispatch table from the client list of HCI type and replaces the 
+ * published one. The replaced table is freed once the receive path does not 
+ * look it up any more.
+ * 
+ * \note   Called inside the critical section after the client list is changed.
+ *         The first client in the list order is taken for each opcode, as by the 
+ *         list traversal.
+ * \param	pClientReg - pointer to ClientRegister object
+ * \param	uList      - index of client list of HCI type
+ * \return 	void
+ * \sa     	clientRegister_searchAndInvoke
+ */ 
+static void clientRegister_publish (TClientRegister *pClientReg, const McpU32 uList)
+{
+	MCP_DL_LIST_Node *pNode;
+	TClientNode 	 *pClient;
+	TClientTable	 *pTable = NULL;
+	TClientTable	 *pOldTable;
+	TClientTable	 **ppRetired;
+	McpU32			 uClientNum = 0;
+	McpU32			 uSlotNum   = CLIENT_TABLE_MIN_SIZE;
+	McpU32			 uSlot;
+
+	MCP_DL_LIST_ITERATE(&pClientReg->pListArray[uList], pNode)
+	{
+		uClientNum++;
+	}
+
+	if (uClientNum)
+	{
+		/* Keep the table at most half full for short probe sequences */
+		while (uSlotNum < (uClientNum * 2))
+		{
+			uSlotNum <<= 1;
+		}
+
+		pTable = mcpf_mem_alloc (pClientReg->hMcpf, 
+								 (McpU16) (sizeof(TClientTable) + sizeof(TClientEntry) * (uSlotNum - 1)));
+		MCPF_Assert(pTable);
+		mcpf_mem_zero (pClientReg->hMcpf, pTable, sizeof(TClientTable) + sizeof(TClientEntry) * (uSlotNum - 1));
+		pTable->uMask = uSlotNum - 1;
+
+		MCP_DL_LIST_ITERATE(&pClientReg->pListArray[uList], pNode)
+		{
+			pClient = (TClientNode *) pNode;
+
+			if (pClient->uOpcode == HCIA_ANY_OPCODE)
+			{
+				if (pTable->tAnyClient.fRxIndCb == NULL)
+				{
+					pTable->tAnyClient.uOpcode  = pClient->uOpcode;
+					pTable->tAnyClient.fRxIndCb = pClient->fRxIndCb;
+					pTable->tAnyClient.hCbParam = pClient->hCbParam;
+				}
+				continue;
+			}
+
+			for (uSlot = CLIENT_TABLE_HASH(pClient->uOpcode) & pTable->uMask; 
+				 (pTable->aSlot[uSlot].fRxIndCb != NULL) && (pTable->aSlot[uSlot].uOpcode != pClient->uOpcode); 
+				 uSlot = (uSlot + 1) & pTable->uMask)
+			{
+			}
+
+			if (pTable->aSlot[uSlot].fRxIndCb == NULL)
+			{
+				pTable->aSlot[uSlot].uOpcode  = pClient->uOpcode;
+				pTable->aSlot[uSlot].fRxIndCb = pClient->fRxIndCb;
+				pTable->aSlot[uSlot].hCbParam = pClient->hCbParam;
+			}
+		}
+	}
+
+	/* Publish the new table, the receive path sees either the old or the new one */
+	pOldTable = pClientReg->pTableArray[uList];
+	HCIA_MEM_BARRIER();
+	pClientReg->pTableArray[uList] = pTable;
+	HCIA_MEM_BARRIER();
+
+	if (pOldTable)
+	{
+		pOldTable->uRetireSeq   = pClientReg->uRxSeq;
+		pOldTable->pNextRetired = pClientReg->pRetiredList;
+		pClientReg->pRetiredList = pOldTable;
+	}
+
+	/* 
+	 * Free the replaced tables not looked up any more: the receive path was idle 
+	 * when the table was replaced or has finished the lookup since then
+	 */
+	ppRetired = &pClientReg->pRetiredList;
+	while (*ppRetired)
+	{
+		pOldTable = *ppRetired;
+
+		if (((pOldTable->uRetireSeq & 1) == 0) || (pOldTable->uRetireSeq != pClientReg->uRxSeq))
+		{
+			*ppRetired = pOldTable->pNextRetired;
+			mcpf_mem_free (pClientReg->hMcpf, pOldTable);
+		}
+		else
+		{
+			ppRetired = &pOldTable->pNextRetired;
+		}
+	}
+}
+
+
 /** 
  * \fn     clientRegister_openTransChan 
  * \brief  Open transport channel
@@ -227,6 +227,9 @@ EMcpfRes trans_Init (handle_t hTrans, const TBusDrvCfg * pBusDrvConf)
 		return RES_ERROR;
 	}
 
+	/* coalesce small queued transactions into a single UART write */
+	txnQ_EnableBatching (pTrans->hTxnQ, MCP_TRUE);
+
 	/* report initialization completion to upper layer */
 	tEvent.eEventType = Txn_InitComplInd;
 	pTrans->fEventCb (pTrans->hHandleCb, &tEvent);
@@ -89,6 +89,9 @@ typedef struct _TBusDrvObj
 	McpS16         	 iOutBufNum;   	/* Current transaction buffer number for transmission */
 	McpU16        	 uOutLen;   	/* Current number of bytes sent from buffer */
 	McpU8       	*pOutData;   	/* Current data pointer for transmission */
+	TTxnStruct 		*aOutBatch[BUSDRV_BATCH_MAX_TXNS]; /* The transactions being transmitted together */
+	McpU32			 uOutBatchNum;	/* Number of transactions in aOutBatch (0 if not a batch) */
+	McpU8			 aOutBatchBuf[BUSDRV_BATCH_BUF_SIZE]; /* Data of the transactions being transmitted together */
 
 	/* Rx state */
 	TTxnStruct 		*pInTxn;        /* The transaction currently being received */
@@ -112,6 +115,7 @@ static void drvTxnDone (TBusDrvObj  *pBusDrv);
 static ETxnStatus startTxnSend (TBusDrvObj * pBusDrv, TTxnStruct * pTxn);
 static ETxnStatus startIfSlpMngSend (TBusDrvObj * pBusDrv, TTxnStruct * pTxn);
 static ETxnStatus drvSendData (TBusDrvObj * pBusDrv);
+static McpBool getTxnChunk (TTxnStruct * pTxn, McpS16 iBufNum, McpU8 **ppData, McpU16 *pLen);
 static void drvRxInd (TBusDrvObj *pBusDrv);
 static EMcpfRes prepareNextPacketRx (TBusDrvObj *pBusDrv);
 /* static McpU16 getHeaderLenFromPktType (McpU8 pktType); */
@@ -384,6 +388,107 @@ ETxnStatus busDrv_Transact (handle_t hBusDrv, TTxnStruct *pTxn)
 }
 
 
+/** 
+ * \fn     busDrv_TransactBatch
+ * \brief  Send several transactions together
+ * 
+ * Called by the TxnQ module to send several small normal transactions at once.
+ * Copy all transactions parts into the batch buffer and send it to the HAL UART
+ * with a single write. Upon write completion the TxnDone CB is called for each 
+ * transaction, in order.
+ * 
+ * \note   It's assumed that this function is called only when idle (i.e. previous Txn is done),
+ *         that the transactions are not single step and that their total length, as returned
+ *         by busDrv_GetTxnLen, doesn't exceed BUSDRV_BATCH_BUF_SIZE.
+ * \param  hBusDrv  - The bus driver handle
+ * \param  aTxn     - The transaction objects 
+ * \param  uNumTxns - The number of transactions, up to BUSDRV_BATCH_MAX_TXNS
+ * \return PENDING (all send transactoions are asynch), ERROR if failed
+ * \sa     busDrv_Transact
+ */ 
+ETxnStatus busDrv_TransactBatch (handle_t hBusDrv, TTxnStruct *aTxn[], const McpU32 uNumTxns)
+{
+    TBusDrvObj *pBusDrv = (TBusDrvObj*)hBusDrv;
+	ETxnStatus  eStatus;
+	McpU32		uTxn;
+	McpS16		iBufNum;
+	McpU8		*pData;
+	McpU16		uLen;
+	McpU16		uBatchLen = 0;
+
+	for (uTxn = 0; uTxn < uNumTxns; uTxn++)
+	{
+		iBufNum = (McpS16)(TXN_PARAM_GET_TXN_FLAG(aTxn[uTxn]) ? -1 : 0);
+
+		while (getTxnChunk (aTxn[uTxn], iBufNum, &pData, &uLen))
+		{
+			if ((McpU32)(uBatchLen + uLen) > BUSDRV_BATCH_BUF_SIZE)
+			{
+				MCPF_REPORT_ERROR (pBusDrv->hMcpf, BUS_DRV_MODULE_LOG,
+								  ("%s: batch exceeds %u bytes!\n", __FUNCTION__, BUSDRV_BATCH_BUF_SIZE));
+				pBusDrv->stat.TxErr++;
+				transportError (pBusDrv, Txn_TxErr);
+				return TXN_STATUS_ERROR;
+			}
+			mcpf_mem_copy (pBusDrv->hMcpf, &(pBusDrv->aOutBatchBuf[uBatchLen]), pData, uLen);
+			uBatchLen = (McpU16)(uBatchLen + uLen);
+			iBufNum++;
+		}
+		pBusDrv->aOutBatch[uTxn] = aTxn[uTxn];
+	}
+
+	/* the whole batch is sent as a single chunk, completing all transactions at once */
+	pBusDrv->uOutBatchNum = uNumTxns;
+	pBusDrv->pOutTxn 	= aTxn[uNumTxns - 1];
+	pBusDrv->iOutBufNum = MAX_XFER_BUFS;
+	pBusDrv->pOutData 	= pBusDrv->aOutBatchBuf;
+	pBusDrv->uOutLen  	= uBatchLen;
+
+	eStatus = drvSendData (pBusDrv);
+	pBusDrv->stat.Tx += uNumTxns;
+
+	if (eStatus == TXN_STATUS_ERROR)
+	{
+		/* Transport Error */
+        MCPF_REPORT_ERROR (pBusDrv->hMcpf, BUS_DRV_MODULE_LOG,
+						  ("%s: Tx failed!\n", __FUNCTION__));
+		pBusDrv->uOutBatchNum = 0;
+		pBusDrv->stat.TxErr++;
+		transportError (pBusDrv, Txn_TxErr);
+	}
+
+	return eStatus;
+}
+
+
+/** 
+ * \fn     busDrv_GetTxnLen
+ * \brief  Get transaction length
+ * 
+ * Return the number of bytes the transaction puts on the bus (header and all buffers).
+ * 
+ * \note   Used by the TxnQ module to select transactions for busDrv_TransactBatch.
+ * \param  pTxn - The transaction object 
+ * \return The transaction length
+ * \sa     busDrv_TransactBatch
+ */ 
+McpU32 busDrv_GetTxnLen (TTxnStruct *pTxn)
+{
+	McpS16	iBufNum = (McpS16)(TXN_PARAM_GET_TXN_FLAG(pTxn) ? -1 : 0);
+	McpU8	*pData;
+	McpU16	uLen;
+	McpU32	uTxnLen = 0;
+
+	while (getTxnChunk (pTxn, iBufNum, &pData, &uLen))
+	{
+		uTxnLen += uLen;
+		iBufNum++;
+	}
+
+	return uTxnLen;
+}
+
+
 /** 
  * \fn     busDrv_BufAvailable
  * \brief  Buffer available indication 
@@ -583,13 +688,32 @@ static void drvTxnDone (TBusDrvObj  *pBusDrv)
 	
 			eStatus = drvSendData (pBusDrv);
 		}
+		else if (pBusDrv->uOutBatchNum)
+		{
+			TTxnStruct	*aDoneTxn[BUSDRV_BATCH_MAX_TXNS];
+			McpU32		uDoneNum = pBusDrv->uOutBatchNum;
+			McpU32		uTxn;
+
+			/* Copy the batch, since the last TxnDone CB may already start the next one */
+			mcpf_mem_copy (pBusDrv->hMcpf, aDoneTxn, pBusDrv->aOutBatch, uDoneNum * sizeof(TTxnStruct *));
+			pBusDrv->uOutBatchNum = 0;
+
+			MCPF_EXIT_CRIT_SEC (pBusDrv->hMcpf);
+
+			/* transmit of all batch transactions is complete */
+			for (uTxn = 0; uTxn < uDoneNum; uTxn++)
+			{
+				pBusDrv->fTxnDoneCb (pBusDrv->hCbHandle, aDoneTxn[uTxn]);
+			}
+			eStatus = TXN_STATUS_OK;
+		}
 		else
 		{
 			MCPF_EXIT_CRIT_SEC (pBusDrv->hMcpf);
 
 			/* transmit transaction is complete */
 			pBusDrv->fTxnDoneCb (pBusDrv->hCbHandle, pBusDrv->pOutTxn);
-			eStatus = RES_OK;
+			eStatus = TXN_STATUS_OK;
 		}
 	}
 	else
@@ -754,6 +878,50 @@ static ETxnStatus drvSendData (TBusDrvObj * pBusDrv)
 }
 
 
+/** 
+ * \fn     getTxnChunk
+ * \brief  Get transaction part
+ * 
+ * Return the data and length of the transaction part sent at the specified buffer number, 
+ * in the same order the parts are sent by startTxnSend and drvTxnDone.
+ * 
+ * \note   
+ * \param  pTxn    - The transaction object 
+ * \param  iBufNum - Buffer number, -1 for the transaction header
+ * \param  ppData  - [out] The part data
+ * \param  pLen    - [out] The part length
+ * \return TRUE if the part exists, FALSE if all parts were already returned
+ * \sa     busDrv_TransactBatch, busDrv_GetTxnLen
+ */ 
+static McpBool getTxnChunk (TTxnStruct * pTxn, McpS16 iBufNum, McpU8 **ppData, McpU16 *pLen)
+{
+	if (iBufNum < 0)
+	{
+		/* txn header */
+		*ppData = &(pTxn->tHeader.tHciHeader.uPktType);
+		*pLen   = pTxn->tHeader.tHciHeader.uLen;
+		return MCP_TRUE;
+	}
+
+	if ((iBufNum == 0) && !TXN_PARAM_GET_TXN_FLAG(pTxn))
+	{
+		/* transmitting starts from the data pointer */
+		*ppData = pTxn->pData;
+		*pLen   = pTxn->aLen[0];
+		return MCP_TRUE;
+	}
+
+	if ((iBufNum < MAX_XFER_BUFS) && pTxn->aBuf[iBufNum] && pTxn->aLen[iBufNum])
+	{
+		*ppData = pTxn->aBuf[iBufNum];
+		*pLen   = pTxn->aLen[iBufNum];
+		return MCP_TRUE;
+	}
+
+	return MCP_FALSE;
+}
+
+
 /** 
  * \fn     drvRxInd
  * \brief  Data receive indication
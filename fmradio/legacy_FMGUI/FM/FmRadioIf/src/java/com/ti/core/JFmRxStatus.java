@@ -31,7 +31,7 @@ public enum JFmRxStatus implements IJFmEnum<Integer> {
                                                                                                        */
     PENDING_UPDATE_CMD_PARAMS(110), FAILED_ALREADY_PENDING(111), INVALID_TYPE(112), CMD_TYPE_WAS_ALREADY_ALLOCATED(
             113), AF_SWITCH_FAILED_LIST_EXHAUSTED(114), COMPLETE_SCAN_IS_NOT_IN_PROGRESS(115), COMPLETE_SCAN_STOPPED(
-            116), NO_VALUE(100);
+            116), AF_SWITCH_ABORTED(117), NO_VALUE(100);
 
     private final int value;
 